@@ -21,17 +21,65 @@ namespace Aws
 namespace IoTFleetWise
 {
 
+// The consumer is shared by all CAN data sources, each calling processMessage from its own thread. Hence the storage
+// reused across frames is kept per thread.
+static thread_local std::vector<CANDecodedSignal> gDecodedSignals; // NOLINT Thread local decoding scratch buffer
+static thread_local CollectedDataFrame gCollectedDataFrame;        // NOLINT Thread local recycled data frame
+
 CANDataConsumer::CANDataConsumer( SignalBufferPtr signalBufferPtr )
     : mSignalBufferPtr{ std::move( signalBufferPtr ) }
 {
 }
 
-bool
+namespace
+{
+const CANMessageDecoderMethod *
+lookupDecoderMethod( const CANChannelDecoderMethodLookup &lookup, uint32_t messageId )
+{
+    if ( messageId < CAN_STANDARD_FRAME_ID_COUNT )
+    {
+        return lookup.standardFrames.empty() ? nullptr : lookup.standardFrames[messageId];
+    }
+    auto it = std::lower_bound( lookup.otherFrames.begin(),
+                                lookup.otherFrames.end(),
+                                messageId,
+                                []( const std::pair<CANRawFrameID, const CANMessageDecoderMethod *> &entry,
+                                    uint32_t id ) {
+                                    return entry.first < id;
+                                } );
+    if ( ( it != lookup.otherFrames.end() ) && ( it->first == messageId ) )
+    {
+        return it->second;
+    }
+    return nullptr;
+}
+} // namespace
+
+const CANMessageDecoderMethod *
 CANDataConsumer::findDecoderMethod( CANChannelNumericID channelId,
                                     uint32_t &messageId,
-                                    const CANDecoderDictionary::CANMsgDecoderMethodType &decoderMethod,
-                                    CANMessageDecoderMethod &currentMessageDecoderMethod )
+                                    const CANDecoderDictionary &dictionary )
 {
+    if ( dictionary.isDecoderMethodLookupBuilt )
+    {
+        if ( channelId >= dictionary.canMessageDecoderMethodLookup.size() )
+        {
+            return nullptr;
+        }
+        const auto &lookup = dictionary.canMessageDecoderMethodLookup[channelId];
+        const auto *method = lookupDecoderMethod( lookup, messageId );
+        if ( ( method == nullptr ) && ( ( messageId & CAN_EFF_MASK ) != messageId ) )
+        {
+            method = lookupDecoderMethod( lookup, messageId & CAN_EFF_MASK );
+            if ( method != nullptr )
+            {
+                messageId = messageId & CAN_EFF_MASK;
+            }
+        }
+        return method;
+    }
+
+    const auto &decoderMethod = dictionary.canMessageDecoderMethod;
     auto outerMapIt = decoderMethod.find( channelId );
     if ( outerMapIt != decoderMethod.cend() )
     {
@@ -39,19 +87,17 @@ CANDataConsumer::findDecoderMethod( CANChannelNumericID channelId,
 
         if ( it != outerMapIt->second.cend() )
         {
-            currentMessageDecoderMethod = it->second;
-            return true;
+            return &it->second;
         }
         it = outerMapIt->second.find( messageId & CAN_EFF_MASK );
 
         if ( it != outerMapIt->second.cend() )
         {
             messageId = messageId & CAN_EFF_MASK;
-            currentMessageDecoderMethod = it->second;
-            return true;
+            return &it->second;
         }
     }
-    return false;
+    return nullptr;
 }
 
 void
@@ -61,6 +107,16 @@ CANDataConsumer::processMessage( CANChannelNumericID channelId,
                                  const uint8_t *data,
                                  size_t dataLength,
                                  Timestamp timestamp )
+{
+    CANFrameInfo frame{ messageId, data, dataLength, timestamp };
+    processMessages( channelId, dictionary, &frame, 1 );
+}
+
+void
+CANDataConsumer::processMessages( CANChannelNumericID channelId,
+                                  std::shared_ptr<const CANDecoderDictionary> &dictionary,
+                                  const CANFrameInfo *frames,
+                                  size_t numFrames )
 {
     // Skip if the dictionary was invalidated during message processing:
     if ( dictionary == nullptr )
@@ -73,39 +129,54 @@ CANDataConsumer::processMessage( CANChannelNumericID channelId,
               ? static_cast<TraceSection>( channelId + toUType( TraceSection::CAN_DECODER_CYCLE_0 ) )
               : TraceSection::CAN_DECODER_CYCLE_19 );
     TraceModule::get().sectionBegin( traceSection );
-    // get decoderMethod from the decoder dictionary
-    const auto &decoderMethod = dictionary->canMessageDecoderMethod;
     // a set of signalID specifying which signal to collect
     const auto &signalIDsToCollect = dictionary->signalIDsToCollect;
-    // check if this CAN message ID on this CAN Channel has the decoder method
-    CANMessageDecoderMethod currentMessageDecoderMethod;
-    // The value of messageId may be changed by the findDecoderMethod function. This is a
-    // workaround as the cloud as of now does not send extended id messages.
-    // If the decoder method for this message is not found in
-    // decoderMethod dictionary, we check for the same id without the MSB set.
-    // The message id which has a decoderMethod gets passed into messageId
-    if ( findDecoderMethod( channelId, messageId, decoderMethod, currentMessageDecoderMethod ) )
+
+    // Reuse the thread local data frame. Its storage is swapped with a recycled signal buffer slot on every push,
+    // so in steady state neither the signals nor the raw frame need an allocation.
+    CollectedDataFrame &collectedDataFrame = gCollectedDataFrame;
+    // Drop any leftovers in case the previous push failed
+    recycleQueueElement( collectedDataFrame );
+    // Only the dictionary lookup and the trace section are shared by the batch. Each CAN frame still gets its own data
+    // frame, because the conditions are evaluated once per data frame and would otherwise only see the last value of
+    // each signal in the batch.
+    for ( size_t i = 0; i < numFrames; i++ )
     {
+        const auto &frame = frames[i];
+        auto messageId = frame.messageId;
+        // check if this CAN message ID on this CAN Channel has the decoder method
+        // The value of messageId may be changed by the findDecoderMethod function. This is a
+        // workaround as the cloud as of now does not send extended id messages.
+        // If the decoder method for this message is not found in
+        // decoderMethod dictionary, we check for the same id without the MSB set.
+        // The message id which has a decoderMethod gets passed into messageId
+        const auto *currentMessageDecoderMethod = findDecoderMethod( channelId, messageId, *dictionary );
+        if ( currentMessageDecoderMethod == nullptr )
+        {
+            continue;
+        }
         // format to be used for decoding
-        const auto &format = currentMessageDecoderMethod.format;
-        const auto &collectType = currentMessageDecoderMethod.collectType;
+        const auto &format = currentMessageDecoderMethod->format;
+        const auto &collectType = currentMessageDecoderMethod->collectType;
 
-        // Create Collected Data Frame
-        CollectedDataFrame collectedDataFrame;
         // Check if we want to collect RAW CAN Frame; If so we also need to ensure Buffer is valid
         if ( ( mSignalBufferPtr.get() != nullptr ) && ( ( collectType == CANMessageCollectType::RAW ) ||
                                                         ( collectType == CANMessageCollectType::RAW_AND_DECODE ) ) )
         {
             // prepare the raw CAN Frame
-            struct CollectedCanRawFrame canRawFrame;
-            canRawFrame.frameID = messageId;
-            canRawFrame.channelId = channelId;
-            canRawFrame.receiveTime = timestamp;
+            CollectedRawCanFramePtr canRawFrame = std::move( collectedDataFrame.mRecycledCanRawFrame );
+            if ( canRawFrame == nullptr )
+            {
+                canRawFrame = std::make_shared<CollectedCanRawFrame>();
+            }
+            canRawFrame->frameID = messageId;
+            canRawFrame->channelId = channelId;
+            canRawFrame->receiveTime = frame.timestamp;
             // CollectedCanRawFrame receive up to 64 CAN Raw Bytes
-            canRawFrame.size = std::min( static_cast<uint8_t>( dataLength ), MAX_CAN_FRAME_BYTE_SIZE );
-            std::copy( data, data + canRawFrame.size, canRawFrame.data.begin() );
+            canRawFrame->size = std::min( static_cast<uint8_t>( frame.dataLength ), MAX_CAN_FRAME_BYTE_SIZE );
+            std::copy( frame.data, frame.data + canRawFrame->size, canRawFrame->data.begin() );
             // collectedDataFrame will be pushed to the Buffer for next stage to consume
-            collectedDataFrame.mCollectedCanRawFrame = std::make_shared<CollectedCanRawFrame>( canRawFrame );
+            collectedDataFrame.mCollectedCanRawFrame = std::move( canRawFrame );
         }
         // check if we want to decode can frame into signals and collect signals
         if ( ( mSignalBufferPtr.get() != nullptr ) && ( ( collectType == CANMessageCollectType::DECODE ) ||
@@ -113,44 +184,19 @@ CANDataConsumer::processMessage( CANChannelNumericID channelId,
         {
             if ( format.isValid() )
             {
-                std::vector<CANDecodedSignal> decodedSignals;
-                if ( CANDecoder::decodeCANMessage( data, dataLength, format, signalIDsToCollect, decodedSignals ) )
+                std::vector<CANDecodedSignal> &decodedSignals = gDecodedSignals;
+                decodedSignals.clear();
+                const auto &decodePlan = currentMessageDecoderMethod->decodePlan;
+                // Dictionaries from the CollectionSchemeManager come with compiled plans. Otherwise the plan has to be
+                // compiled for each frame.
+                bool decodingSucceeded =
+                    decodePlan.isCompiled()
+                        ? CANDecoder::decodeCANMessage( frame.data, frame.dataLength, decodePlan, decodedSignals )
+                        : CANDecoder::decodeCANMessage(
+                              frame.data, frame.dataLength, format, signalIDsToCollect, decodedSignals );
+                if ( decodingSucceeded )
                 {
-                    // Create vector of Collected Signal Object
-                    CollectedSignalsGroup collectedSignalsGroup;
-                    for ( auto const &signal : decodedSignals )
-                    {
-                        // Create Collected Signal Object
-                        struct CollectedSignal collectedSignal;
-                        const auto signalType = signal.mSignalType;
-                        switch ( signalType )
-                        {
-                        case SignalType::UINT64:
-                            collectedSignal = CollectedSignal{ signal.mSignalID,
-                                                               timestamp,
-                                                               signal.mPhysicalValue.signalValue.uint64Val,
-                                                               signal.mSignalType };
-                            break;
-                        case SignalType::INT64:
-                            collectedSignal = CollectedSignal{ signal.mSignalID,
-                                                               timestamp,
-                                                               signal.mPhysicalValue.signalValue.int64Val,
-                                                               signal.mSignalType };
-                            break;
-                        default:
-                            collectedSignal = CollectedSignal{ signal.mSignalID,
-                                                               timestamp,
-                                                               signal.mPhysicalValue.signalValue.doubleVal,
-                                                               signal.mSignalType };
-                            break;
-                        }
-                        // Only add valid signals to the vector
-                        if ( collectedSignal.signalID != INVALID_SIGNAL_ID )
-                        {
-                            collectedSignalsGroup.push_back( collectedSignal );
-                        }
-                    }
-                    collectedDataFrame.mCollectedSignals = collectedSignalsGroup;
+                    appendDecodedSignals( decodedSignals, frame.timestamp, collectedDataFrame.mCollectedSignals );
                 }
                 else
                 {
@@ -166,36 +212,74 @@ CANDataConsumer::processMessage( CANChannelNumericID channelId,
                               " on CAN Channel Id: " + std::to_string( channelId ) );
             }
         }
+        pushDataFrame( collectedDataFrame );
+    }
 
-        TraceModule::get().sectionEnd( traceSection );
-
-        // Increase all queue metrics before pushing data to the buffer
-        TraceModule::get().incrementAtomicVariable( TraceAtomicVariable::QUEUE_CONSUMER_TO_INSPECTION_DATA_FRAMES );
-
-        auto collectedSignals = collectedDataFrame.mCollectedSignals.size();
-        TraceModule::get().addToAtomicVariable( TraceAtomicVariable::QUEUE_CONSUMER_TO_INSPECTION_SIGNALS,
-                                                collectedSignals );
+    TraceModule::get().sectionEnd( traceSection );
+}
 
-        bool canRawFrameCollected = collectedDataFrame.mCollectedCanRawFrame != nullptr;
-        if ( canRawFrameCollected )
+void
+CANDataConsumer::appendDecodedSignals( const std::vector<CANDecodedSignal> &decodedSignals,
+                                       Timestamp timestamp,
+                                       CollectedSignalsGroup &collectedSignalsGroup )
+{
+    for ( auto const &signal : decodedSignals )
+    {
+        // Only add valid signals to the vector
+        if ( signal.mSignalID == INVALID_SIGNAL_ID )
         {
-            TraceModule::get().incrementAtomicVariable( TraceAtomicVariable::QUEUE_CONSUMER_TO_INSPECTION_CAN );
+            continue;
         }
-
-        if ( !mSignalBufferPtr->push( std::move( collectedDataFrame ) ) )
+        const auto signalType = signal.mSignalType;
+        switch ( signalType )
         {
-            TraceModule::get().decrementAtomicVariable( TraceAtomicVariable::QUEUE_CONSUMER_TO_INSPECTION_DATA_FRAMES );
+        case SignalType::UINT64:
+            collectedSignalsGroup.emplace_back(
+                signal.mSignalID, timestamp, signal.mPhysicalValue.signalValue.uint64Val, signal.mSignalType );
+            break;
+        case SignalType::INT64:
+            collectedSignalsGroup.emplace_back(
+                signal.mSignalID, timestamp, signal.mPhysicalValue.signalValue.int64Val, signal.mSignalType );
+            break;
+        default:
+            collectedSignalsGroup.emplace_back(
+                signal.mSignalID, timestamp, signal.mPhysicalValue.signalValue.doubleVal, signal.mSignalType );
+            break;
+        }
+    }
+}
 
-            if ( canRawFrameCollected )
-            {
-                TraceModule::get().decrementAtomicVariable( TraceAtomicVariable::QUEUE_CONSUMER_TO_INSPECTION_CAN );
-            }
+void
+CANDataConsumer::pushDataFrame( CollectedDataFrame &collectedDataFrame )
+{
+    // Increase all queue metrics before pushing data to the buffer
+    TraceModule::get().incrementAtomicVariable( TraceAtomicVariable::QUEUE_CONSUMER_TO_INSPECTION_DATA_FRAMES );
 
-            TraceModule::get().subtractFromAtomicVariable( TraceAtomicVariable::QUEUE_CONSUMER_TO_INSPECTION_SIGNALS,
-                                                           collectedSignals );
+    auto collectedSignals = collectedDataFrame.mCollectedSignals.size();
+    TraceModule::get().addToAtomicVariable( TraceAtomicVariable::QUEUE_CONSUMER_TO_INSPECTION_SIGNALS,
+                                            collectedSignals );
+
+    bool canRawFrameCollected = collectedDataFrame.mCollectedCanRawFrame != nullptr;
+    if ( canRawFrameCollected )
+    {
+        TraceModule::get().incrementAtomicVariable( TraceAtomicVariable::QUEUE_CONSUMER_TO_INSPECTION_CAN );
+    }
 
-            FWE_LOG_WARN( "Signal buffer full" );
+    if ( !mSignalBufferPtr->push( std::move( collectedDataFrame ) ) )
+    {
+        TraceModule::get().decrementAtomicVariable( TraceAtomicVariable::QUEUE_CONSUMER_TO_INSPECTION_DATA_FRAMES );
+
+        if ( canRawFrameCollected )
+        {
+            TraceModule::get().decrementAtomicVariable( TraceAtomicVariable::QUEUE_CONSUMER_TO_INSPECTION_CAN );
         }
+
+        TraceModule::get().subtractFromAtomicVariable( TraceAtomicVariable::QUEUE_CONSUMER_TO_INSPECTION_SIGNALS,
+                                                       collectedSignals );
+
+        FWE_LOG_WARN( "Signal buffer full" );
+        // Drop the content that could not be pushed, but keep the storage
+        recycleQueueElement( collectedDataFrame );
     }
 }
 
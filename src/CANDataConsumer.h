@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "CANDataTypes.h"
 #include "CollectionInspectionAPITypes.h"
 #include "IDecoderDictionary.h"
 #include "SignalTypes.h"
@@ -10,12 +11,24 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 namespace Aws
 {
 namespace IoTFleetWise
 {
 
+/**
+ * @brief A received CAN frame, as passed to CANDataConsumer::processMessages
+ */
+struct CANFrameInfo
+{
+    uint32_t messageId;
+    const uint8_t *data;
+    size_t dataLength;
+    Timestamp timestamp;
+};
+
 /**
  * @brief CAN Network Data Consumer impl, outputs data to an in-memory buffer.
  *        Operates in Polling mode.
@@ -38,17 +51,40 @@ public:
                          size_t dataLength,
                          Timestamp timestamp );
 
+    /**
+     * @brief Decodes a batch of frames received on the same channel. Each frame with a decoder method is pushed to the
+     * signal buffer as its own data frame, so that the conditions are evaluated for every received value.
+     * @param channelId channel the frames were received on
+     * @param dictionary decoder dictionary to use for all frames
+     * @param frames pointer to the first frame of the batch
+     * @param numFrames number of frames in the batch
+     */
+    void processMessages( CANChannelNumericID channelId,
+                          std::shared_ptr<const CANDecoderDictionary> &dictionary,
+                          const CANFrameInfo *frames,
+                          size_t numFrames );
+
 private:
     /**
      * @brief Finds whether there exists a decoder method for a message id or not
-     * If found, returns the method by reference
+     * If found, returns a pointer to the method inside the dictionary, otherwise nullptr
      * messageId is an input-output parameter that has the correct value
      * for the current message's id with either the MSB set or unset
+     * Uses the flat lookup of the dictionary if it was built, otherwise the maps.
+     */
+    static const CANMessageDecoderMethod *findDecoderMethod( CANChannelNumericID channelId,
+                                                             uint32_t &messageId,
+                                                             const CANDecoderDictionary &dictionary );
+
+    static void appendDecodedSignals( const std::vector<CANDecodedSignal> &decodedSignals,
+                                      Timestamp timestamp,
+                                      CollectedSignalsGroup &collectedSignalsGroup );
+
+    /**
+     * @brief Pushes the data frame to the signal buffer and updates the queue metrics. Afterwards the data frame only
+     * holds recycled storage.
      */
-    static bool findDecoderMethod( CANChannelNumericID channelId,
-                                   uint32_t &messageId,
-                                   const CANDecoderDictionary::CANMsgDecoderMethodType &decoderMethod,
-                                   CANMessageDecoderMethod &currentMessageDecoderMethod );
+    void pushDataFrame( CollectedDataFrame &collectedDataFrame );
 
     SignalBufferPtr mSignalBufferPtr;
 };
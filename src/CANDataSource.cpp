@@ -6,7 +6,10 @@
 #include "EnumUtility.h"
 #include "LoggingModule.h"
 #include "TraceModule.h"
+#include <algorithm>
+#include <array>
 #include <cerrno>
+#include <climits>
 #include <cstring>
 #include <ctime> // IWYU pragma: keep
 #include <linux/can.h>
@@ -14,6 +17,8 @@
 #include <linux/errqueue.h>
 #include <linux/net_tstamp.h>
 #include <net/if.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/ioctl.h>
 #include <unistd.h>
 #include <utility>
@@ -23,19 +28,45 @@ namespace Aws
 namespace IoTFleetWise
 {
 
+namespace
+{
+// we expect only one timestamp to return
+constexpr size_t CONTROL_BUFFER_SIZE_PER_FRAME = CMSG_SPACE( sizeof( struct scm_timestamping ) );
+// The socket and the wake up event
+constexpr size_t MAX_EPOLL_EVENTS = 2;
+} // namespace
+
+constexpr uint32_t CANDataSource::DEFAULT_RECEIVE_BATCH_SIZE; // NOLINT
+constexpr uint32_t CANDataSource::MAX_RECEIVE_BATCH_SIZE;     // NOLINT
+constexpr uint32_t CANDataSource::DEFAULT_MAX_KERNEL_FILTERS; // NOLINT
+
 CANDataSource::CANDataSource( CANChannelNumericID channelId,
                               CanTimestampType timestampTypeToUse,
                               std::string interfaceName,
                               bool forceCanFD,
                               uint32_t threadIdleTimeMs,
-                              CANDataConsumer &consumer )
+                              CANDataConsumer &consumer,
+                              uint32_t receiveBatchSize,
+                              uint32_t maxKernelFilters )
     : mIdleTimeMs{ threadIdleTimeMs }
     , mTimestampTypeToUse{ timestampTypeToUse }
     , mForceCanFD{ forceCanFD }
     , mChannelId{ channelId }
     , mIfName{ std::move( interfaceName ) }
     , mConsumer{ consumer }
+    , mReceiveBatchSize{ std::min( std::max( receiveBatchSize, 1U ), MAX_RECEIVE_BATCH_SIZE ) }
+    , mMaxKernelFilters{ std::min( maxKernelFilters, static_cast<uint32_t>( CAN_RAW_FILTER_MAX ) ) }
+    , mReceiveFrames( mReceiveBatchSize )
+    , mReceiveIoVectors( mReceiveBatchSize )
+    , mReceiveMessageHeaders( mReceiveBatchSize )
+    , mReceiveControlBuffer( mReceiveBatchSize * CONTROL_BUFFER_SIZE_PER_FRAME )
 {
+    mReceivedFrames.reserve( mReceiveBatchSize );
+    if ( mReceiveBatchSize != receiveBatchSize )
+    {
+        FWE_LOG_WARN( "Invalid receive batch size " + std::to_string( receiveBatchSize ) + ", using " +
+                      std::to_string( mReceiveBatchSize ) );
+    }
 }
 
 CANDataSource::~CANDataSource()
@@ -88,6 +119,7 @@ CANDataSource::stop()
     std::lock_guard<std::mutex> lock( mThreadMutex );
     mShouldStop.store( true, std::memory_order_relaxed );
     mWait.notify();
+    wakeUp();
     mThread.release();
     mShouldStop.store( false, std::memory_order_relaxed );
     FWE_LOG_TRACE( "Thread stopped" );
@@ -172,69 +204,69 @@ CANDataSource::doWork( void *data )
         }
 
         dataSource->mTimer.reset();
-        struct canfd_frame frame[PARALLEL_RECEIVED_FRAMES_FROM_KERNEL];
-        struct iovec frame_buffer[PARALLEL_RECEIVED_FRAMES_FROM_KERNEL];
-        struct mmsghdr msg[PARALLEL_RECEIVED_FRAMES_FROM_KERNEL];
-        // we expect only one timestamp to return
-        char cmsgReturnBuffer[PARALLEL_RECEIVED_FRAMES_FROM_KERNEL][CMSG_SPACE( sizeof( struct scm_timestamping ) )]{};
+        auto batchSize = dataSource->mReceiveBatchSize;
+        auto &frames = dataSource->mReceiveFrames;
+        auto &msg = dataSource->mReceiveMessageHeaders;
 
         // Setup all buffer to receive data
-        for ( int i = 0; i < PARALLEL_RECEIVED_FRAMES_FROM_KERNEL; i++ )
+        for ( uint32_t i = 0; i < batchSize; i++ )
         {
-            frame_buffer[i].iov_base = &frame[i];
-            frame_buffer[i].iov_len = sizeof( frame );
+            dataSource->mReceiveIoVectors[i].iov_base = &frames[i];
+            dataSource->mReceiveIoVectors[i].iov_len = sizeof( frames[i] );
             msg[i].msg_hdr.msg_name = nullptr; // not interested in the source address
             msg[i].msg_hdr.msg_namelen = 0;
-            msg[i].msg_hdr.msg_iov = &frame_buffer[i];
+            msg[i].msg_hdr.msg_iov = &dataSource->mReceiveIoVectors[i];
             msg[i].msg_hdr.msg_iovlen = 1;
-            msg[i].msg_hdr.msg_control = &cmsgReturnBuffer[i];
-            msg[i].msg_hdr.msg_controllen = sizeof( cmsgReturnBuffer[i] );
+            msg[i].msg_hdr.msg_control = &dataSource->mReceiveControlBuffer[i * CONTROL_BUFFER_SIZE_PER_FRAME];
+            msg[i].msg_hdr.msg_controllen = CONTROL_BUFFER_SIZE_PER_FRAME;
         }
-        // In one syscall receive up to PARALLEL_RECEIVED_FRAMES_FROM_KERNEL frames in parallel
-        int nmsgs = recvmmsg( dataSource->mSocket, &msg[0], PARALLEL_RECEIVED_FRAMES_FROM_KERNEL, 0, nullptr );
+        // In one syscall receive up to batchSize frames in parallel
+        int nmsgs = recvmmsg( dataSource->mSocket, msg.data(), batchSize, 0, nullptr );
         // coverity[autosar_cpp14_m19_3_1_violation]
         // coverity[misra_cpp_2008_rule_19_3_1_violation] errno needs to be used to recognize network down
         FWE_GRACEFUL_FATAL_ASSERT( ( nmsgs != -1 ) || ( errno != ENETDOWN ), "Network interface went down", );
-        for ( int i = 0; i < nmsgs; i++ )
+        // After waking up the Socket Can old messages in the kernel queue need to be ignored
+        if ( ( nmsgs > 0 ) && ( !wokeUpFromSleep ) )
         {
-            // After waking up the Socket Can old messages in the kernel queue need to be ignored
-            if ( !wokeUpFromSleep )
+            auto &receivedFrames = dataSource->mReceivedFrames;
+            receivedFrames.clear();
+            for ( int i = 0; i < nmsgs; i++ )
             {
-                Timestamp timestamp = dataSource->extractTimestamp( &msg[i].msg_hdr );
+                Timestamp timestamp = dataSource->extractTimestamp( &msg[static_cast<size_t>( i )].msg_hdr );
                 if ( timestamp < lastFrameTime )
                 {
                     TraceModule::get().incrementAtomicVariable( TraceAtomicVariable::NOT_TIME_MONOTONIC_FRAMES );
                 }
                 lastFrameTime = timestamp;
-                dataSource->mReceivedMessages++;
-                TraceVariable traceFrames = static_cast<TraceVariable>(
-                    dataSource->mChannelId + toUType( TraceVariable::READ_SOCKET_FRAMES_0 ) );
-                TraceModule::get().setVariable( ( traceFrames < TraceVariable::READ_SOCKET_FRAMES_19 )
-                                                    ? traceFrames
-                                                    : TraceVariable::READ_SOCKET_FRAMES_19,
-                                                dataSource->mReceivedMessages );
-                std::lock_guard<std::mutex> lock( dataSource->mDecoderDictMutex );
-                dataSource->mConsumer.processMessage( dataSource->mChannelId,
-                                                      dataSource->mDecoderDictionary,
-                                                      frame[i].can_id,
-                                                      frame[i].data,
-                                                      frame[i].len,
-                                                      timestamp );
+                const auto &frame = frames[static_cast<size_t>( i )];
+                receivedFrames.push_back( CANFrameInfo{ frame.can_id, frame.data, frame.len, timestamp } );
             }
+            dataSource->mReceivedMessages += static_cast<uint64_t>( nmsgs );
+            TraceVariable traceFrames =
+                static_cast<TraceVariable>( dataSource->mChannelId + toUType( TraceVariable::READ_SOCKET_FRAMES_0 ) );
+            TraceModule::get().setVariable( ( traceFrames < TraceVariable::READ_SOCKET_FRAMES_19 )
+                                                ? traceFrames
+                                                : TraceVariable::READ_SOCKET_FRAMES_19,
+                                            dataSource->mReceivedMessages );
+            std::lock_guard<std::mutex> lock( dataSource->mDecoderDictMutex );
+            dataSource->mConsumer.processMessages( dataSource->mChannelId,
+                                                   dataSource->mDecoderDictionary,
+                                                   receivedFrames.data(),
+                                                   receivedFrames.size() );
         }
-        if ( nmsgs < PARALLEL_RECEIVED_FRAMES_FROM_KERNEL )
+        if ( nmsgs < static_cast<int>( batchSize ) )
         {
             if ( logTimer.getElapsedMs().count() > static_cast<int64_t>( LoggingModule::LOG_AGGREGATION_TIME_MS ) )
             {
-                // Nothing is in the ring buffer to consume. Go to idle mode for some time.
-                FWE_LOG_TRACE(
-                    "Activations: " + std::to_string( activations ) +
-                    ". Waiting for some data to come. Idling for: " + std::to_string( dataSource->mIdleTimeMs ) +
-                    " ms, processed " + std::to_string( dataSource->mReceivedMessages ) + " frames" );
+                // The socket is drained. Wait until new frames arrive.
+                FWE_LOG_TRACE( "Activations: " + std::to_string( activations ) +
+                               ". Waiting for some data to come for up to: " +
+                               std::to_string( dataSource->mIdleTimeMs ) + " ms, processed " +
+                               std::to_string( dataSource->mReceivedMessages ) + " frames" );
                 activations = 0;
                 logTimer.reset();
             }
-            dataSource->mWait.wait( static_cast<uint32_t>( dataSource->mIdleTimeMs ) );
+            dataSource->waitForFrames();
             wokeUpFromSleep = false;
         }
         if ( dataSource->shouldStop() )
@@ -311,14 +343,176 @@ CANDataSource::connect()
         close( mSocket );
         return false;
     }
+    if ( !createEpoll() )
+    {
+        close( mSocket );
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock( mDecoderDictMutex );
+        applyKernelFilters();
+    }
     // Start the main thread.
     return start();
 }
 
+bool
+CANDataSource::createEpoll()
+{
+    mWakeUpFd = eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC );
+    if ( mWakeUpFd < 0 )
+    {
+        FWE_LOG_ERROR( "Failed to create wake up event: " + getErrnoString() );
+        return false;
+    }
+    mEpollFd = epoll_create1( EPOLL_CLOEXEC );
+    if ( mEpollFd < 0 )
+    {
+        FWE_LOG_ERROR( "Failed to create epoll instance: " + getErrnoString() );
+        closeEpoll();
+        return false;
+    }
+    for ( auto fd : { mSocket, mWakeUpFd } )
+    {
+        struct epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if ( epoll_ctl( mEpollFd, EPOLL_CTL_ADD, fd, &event ) != 0 )
+        {
+            FWE_LOG_ERROR( "Failed to add file descriptor to epoll instance: " + getErrnoString() );
+            closeEpoll();
+            return false;
+        }
+    }
+    return true;
+}
+
+void
+CANDataSource::closeEpoll()
+{
+    if ( mEpollFd >= 0 )
+    {
+        close( mEpollFd );
+        mEpollFd = -1;
+    }
+    if ( mWakeUpFd >= 0 )
+    {
+        close( mWakeUpFd );
+        mWakeUpFd = -1;
+    }
+}
+
+void
+CANDataSource::waitForFrames()
+{
+    std::array<struct epoll_event, MAX_EPOLL_EVENTS> events{};
+    int timeoutMs = static_cast<int>( std::min( mIdleTimeMs, static_cast<uint32_t>( INT_MAX ) ) );
+    int numEvents = epoll_wait( mEpollFd, events.data(), static_cast<int>( events.size() ), timeoutMs );
+    for ( int i = 0; i < numEvents; i++ )
+    {
+        if ( events[static_cast<size_t>( i )].data.fd == mWakeUpFd )
+        {
+            // Reset the event, the reason for the wake up is checked by the caller
+            uint64_t counter = 0;
+            (void)read( mWakeUpFd, &counter, sizeof( counter ) );
+        }
+    }
+}
+
+void
+CANDataSource::wakeUp()
+{
+    if ( mWakeUpFd >= 0 )
+    {
+        uint64_t increment = 1;
+        (void)write( mWakeUpFd, &increment, sizeof( increment ) );
+    }
+}
+
+bool
+CANDataSource::createKernelFilters( const CANDecoderDictionary *dictionary,
+                                    CANChannelNumericID channelId,
+                                    uint32_t maxFilters,
+                                    std::vector<struct can_filter> &filters )
+{
+    filters.clear();
+    if ( dictionary == nullptr )
+    {
+        return true;
+    }
+    auto channelIt = dictionary->canMessageDecoderMethod.find( channelId );
+    if ( channelIt == dictionary->canMessageDecoderMethod.end() )
+    {
+        return true;
+    }
+    if ( channelIt->second.size() > maxFilters )
+    {
+        return false;
+    }
+    for ( const auto &decoderMethod : channelIt->second )
+    {
+        struct can_filter filter = {};
+        filter.can_id = decoderMethod.first & CAN_EFF_MASK;
+        filter.can_mask = CAN_EFF_MASK;
+        filters.push_back( filter );
+    }
+    std::sort( filters.begin(), filters.end(), []( const struct can_filter &a, const struct can_filter &b ) {
+        return a.can_id < b.can_id;
+    } );
+    // IDs that only differ in the flags result in the same filter
+    filters.erase( std::unique( filters.begin(),
+                                filters.end(),
+                                []( const struct can_filter &a, const struct can_filter &b ) {
+                                    return a.can_id == b.can_id;
+                                } ),
+                   filters.end() );
+    return true;
+}
+
+void
+CANDataSource::applyKernelFilters()
+{
+    if ( ( mMaxKernelFilters == 0 ) || ( mSocket < 0 ) )
+    {
+        return;
+    }
+    std::vector<struct can_filter> filters;
+    bool useFilters = createKernelFilters( mDecoderDictionary.get(), mChannelId, mMaxKernelFilters, filters );
+    if ( !useFilters )
+    {
+        // Receive all frames, same as the default of a new socket
+        struct can_filter filter = {};
+        filter.can_id = 0;
+        filter.can_mask = 0;
+        filters.push_back( filter );
+    }
+    // An empty filter list means that no frames are received at all
+    const struct can_filter *filtersData = filters.empty() ? nullptr : filters.data();
+    auto filtersSize = static_cast<socklen_t>( filters.size() * sizeof( struct can_filter ) );
+    if ( setsockopt( mSocket, SOL_CAN_RAW, CAN_RAW_FILTER, filtersData, filtersSize ) != 0 )
+    {
+        FWE_LOG_ERROR( "Failed to set CAN filters on channel " + std::to_string( mChannelId ) + ": " +
+                       getErrnoString() );
+        return;
+    }
+    if ( useFilters )
+    {
+        FWE_LOG_TRACE( "Installed " + std::to_string( filters.size() ) + " kernel CAN filters on channel " +
+                       std::to_string( mChannelId ) );
+    }
+    else
+    {
+        FWE_LOG_INFO( "More than " + std::to_string( mMaxKernelFilters ) + " frame IDs are needed on channel " +
+                      std::to_string( mChannelId ) + ", receiving all frames" );
+    }
+}
+
 bool
 CANDataSource::disconnect()
 {
-    return stop() && ( close( mSocket ) == 0 );
+    bool stopped = stop();
+    closeEpoll();
+    return stopped && ( close( mSocket ) == 0 );
 }
 
 bool
@@ -345,6 +539,7 @@ CANDataSource::onChangeOfActiveDictionary( ConstDecoderDictionaryConstPtr &dicti
     }
     std::lock_guard<std::mutex> lock( mDecoderDictMutex );
     mDecoderDictionary = std::dynamic_pointer_cast<const CANDecoderDictionary>( dictionary );
+    applyKernelFilters();
     if ( dictionary == nullptr )
     {
         FWE_LOG_TRACE( "Going to sleep until a the resume signal. CAN Data Source: " + std::to_string( mChannelId ) );
@@ -354,6 +549,7 @@ CANDataSource::onChangeOfActiveDictionary( ConstDecoderDictionaryConstPtr &dicti
         FWE_LOG_TRACE( "Resuming Network data acquisition on Data Source: " + std::to_string( mChannelId ) );
         // Wake up the worker thread.
         mWait.notify();
+        wakeUp();
     }
 }
 
@@ -15,10 +15,13 @@
 #include "VehicleDataSourceTypes.h"
 #include <atomic>
 #include <cstdint>
+#include <linux/can.h>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <sys/socket.h> // IWYU pragma: keep
+#include <sys/uio.h>
+#include <vector>
 
 namespace Aws
 {
@@ -64,7 +67,9 @@ stringToCanTimestampType( std::string const &timestampType, CanTimestampType &ou
 class CANDataSource
 {
 public:
-    static constexpr int PARALLEL_RECEIVED_FRAMES_FROM_KERNEL = 10;
+    static constexpr uint32_t DEFAULT_RECEIVE_BATCH_SIZE = 10;
+    static constexpr uint32_t MAX_RECEIVE_BATCH_SIZE = 1024;
+    static constexpr uint32_t DEFAULT_MAX_KERNEL_FILTERS = 128;
     static constexpr int DEFAULT_THREAD_IDLE_TIME_MS = 1000;
 
     /**
@@ -75,15 +80,23 @@ public:
      * @param interfaceName SocketCAN interface name, e.g. vcan0
      * @param forceCanFD True to force CAN-FD mode, which will cause #connect to return an error if not available.
      * False to use CAN-FD if available.
-     * @param threadIdleTimeMs Poll period of SocketCAN interface.
+     * @param threadIdleTimeMs Maximum time to wait for frames on the SocketCAN interface. The thread wakes up as soon
+     * as frames are available, so this only bounds the wait when the bus is silent.
      * @param consumer CAN data consumer
+     * @param receiveBatchSize Maximum number of frames received from the kernel with one syscall and handed over to
+     * the consumer as one batch. Higher values reduce the per frame overhead on high load buses.
+     * @param maxKernelFilters Maximum number of frame IDs that are filtered by the kernel, see createKernelFilters.
+     * If the decoder dictionary needs more frame IDs on this channel, all frames are received. 0 disables the kernel
+     * filters. Values above CAN_RAW_FILTER_MAX are limited to CAN_RAW_FILTER_MAX.
      */
     CANDataSource( CANChannelNumericID channelId,
                    CanTimestampType timestampTypeToUse,
                    std::string interfaceName,
                    bool forceCanFD,
                    uint32_t threadIdleTimeMs,
-                   CANDataConsumer &consumer );
+                   CANDataConsumer &consumer,
+                   uint32_t receiveBatchSize = DEFAULT_RECEIVE_BATCH_SIZE,
+                   uint32_t maxKernelFilters = DEFAULT_MAX_KERNEL_FILTERS );
     ~CANDataSource();
 
     CANDataSource( const CANDataSource & ) = delete;
@@ -101,6 +114,22 @@ public:
     void onChangeOfActiveDictionary( ConstDecoderDictionaryConstPtr &dictionary,
                                      VehicleDataSourceProtocol networkProtocol );
 
+    /**
+     * @brief Creates the CAN_RAW_FILTERs that let only the frames with a decoder method on the channel pass the kernel
+     *
+     * There is one filter per frame ID. The filters ignore the EFF and RTR flags, so that standard and extended frames
+     * with the same ID both pass, as CANDataConsumer also falls back to the ID without flags.
+     * @param dictionary decoder dictionary, nullptr if there is none
+     * @param channelId channel of the socket
+     * @param maxFilters maximum number of filters
+     * @param filters filled with the sorted filters. Empty if no frame should pass.
+     * @return false if more than maxFilters filters would be needed, in which case all frames should pass
+     */
+    static bool createKernelFilters( const CANDecoderDictionary *dictionary,
+                                     CANChannelNumericID channelId,
+                                     uint32_t maxFilters,
+                                     std::vector<struct can_filter> &filters );
+
 private:
     // Start the bus thread
     bool start();
@@ -114,12 +143,25 @@ private:
 
     Timestamp extractTimestamp( struct msghdr *msgHeader );
 
+    // Creates the epoll instance that waits for the socket and for wake up requests
+    bool createEpoll();
+    // Closes the epoll instance and the wake up event
+    void closeEpoll();
+    // Blocks until frames are available on the socket, a wake up is requested or the idle time elapsed
+    void waitForFrames();
+    // Interrupts waitForFrames()
+    void wakeUp();
+    // Installs the kernel filters for the current decoder dictionary. Must be called with mDecoderDictMutex locked.
+    void applyKernelFilters();
+
     Thread mThread;
     std::atomic<bool> mShouldStop{ false };
     mutable std::mutex mThreadMutex;
     Timer mTimer;
     std::shared_ptr<const Clock> mClock = ClockHandler::getClock();
     int mSocket{ -1 };
+    int mEpollFd{ -1 };
+    int mWakeUpFd{ -1 };
     Signal mWait;
     uint32_t mIdleTimeMs{ DEFAULT_THREAD_IDLE_TIME_MS };
     uint64_t mReceivedMessages{ 0 };
@@ -130,6 +172,14 @@ private:
     CANChannelNumericID mChannelId{ INVALID_CAN_SOURCE_NUMERIC_ID };
     std::string mIfName;
     CANDataConsumer &mConsumer;
+    uint32_t mReceiveBatchSize{ DEFAULT_RECEIVE_BATCH_SIZE };
+    uint32_t mMaxKernelFilters{ DEFAULT_MAX_KERNEL_FILTERS };
+    // Receive buffers, only used by the worker thread
+    std::vector<struct canfd_frame> mReceiveFrames;
+    std::vector<struct iovec> mReceiveIoVectors;
+    std::vector<struct mmsghdr> mReceiveMessageHeaders;
+    std::vector<char> mReceiveControlBuffer;
+    std::vector<CANFrameInfo> mReceivedFrames;
 };
 
 } // namespace IoTFleetWise
@@ -6,6 +6,7 @@
 #include "SignalTypes.h"
 #include "TimeTypes.h"
 #include <cstdint>
+#include <vector>
 
 namespace Aws
 {
@@ -64,6 +65,64 @@ struct CANDecodedSignal
     SignalType mSignalType{ SignalType::DOUBLE };
 };
 
+/**
+ * @brief Extraction parameters of a single signal, precomputed from its CANSignalFormat
+ */
+struct CANSignalDecodeInfo
+{
+    SignalID mSignalID{ INVALID_SIGNAL_ID };
+    SignalType mSignalType{ SignalType::DOUBLE };
+    bool mIsBigEndian{ false };
+    bool mIsSigned{ false };
+    uint8_t mStartByte{ 0 };
+    uint8_t mStartBitInByte{ 0 };
+    uint8_t mEndByte{ 0 };
+    uint8_t mMultiplexorValue{ UINT8_MAX };
+    uint16_t mSizeInBits{ 0 };
+    /**
+     * @brief Minimum frame size in bits the signal fits into. UINT32_MAX if the signal can never be decoded.
+     */
+    uint32_t mMinFrameSizeInBits{ UINT32_MAX };
+    /**
+     * @brief Set if the signal can be extracted from a single 64-bit load of the padded frame at mWordOffset
+     */
+    bool mUseWordExtraction{ false };
+    uint8_t mWordOffset{ 0 };
+    uint64_t mMask{ 0 };
+    uint64_t mSignMask{ 0 };
+    double mFactor{ 0.0 };
+    double mOffset{ 0.0 };
+};
+
+/**
+ * @brief Decode plan of a CAN message, compiled once per decoder dictionary
+ *
+ * Only contains the signals that are collected, so decoding a frame does not need to look up any signal ID.
+ * For multiplexed messages the signals are additionally bucketed by multiplexor value: the signals for value v are
+ * the range [mMultiplexorValueOffsets[v], mMultiplexorValueOffsets[v + 1]) of mSignalsByMultiplexorValue.
+ */
+struct CANMessageDecodePlan
+{
+    bool mIsCompiled{ false };
+    CANRawFrameID mMessageID{ 0 };
+    bool mIsMultiplexed{ false };
+    bool mHasMultiplexor{ false };
+    bool mCollectMultiplexor{ false };
+    CANSignalDecodeInfo mMultiplexor;
+    /**
+     * @brief Collected signals in the order of the message format
+     */
+    std::vector<CANSignalDecodeInfo> mSignals;
+    std::vector<CANSignalDecodeInfo> mSignalsByMultiplexorValue;
+    std::vector<uint32_t> mMultiplexorValueOffsets;
+
+    bool
+    isCompiled() const
+    {
+        return mIsCompiled;
+    }
+};
+
 /**
  * @brief Cloud does not send information about each CAN message, so we set every CAN message size to the maximum.
  */
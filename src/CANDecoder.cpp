@@ -4,16 +4,23 @@
 #include "CANDecoder.h"
 #include "LoggingModule.h"
 #include <algorithm>
+#include <cstring>
+#include <endian.h>
 #include <string>
-#include <typeinfo>
-
-#define MASK64( nbits ) ( static_cast<uint64_t>( 0xFFFFFFFFFFFFFFFFULL ) >> ( 64 - ( nbits ) ) )
 
 namespace Aws
 {
 namespace IoTFleetWise
 {
 
+namespace
+{
+/**
+ * @brief Upper bound for CAN channel IDs that can be indexed by the decoder method lookup
+ */
+constexpr CANChannelNumericID MAX_CAN_CHANNELS_WITH_LOOKUP = 1024;
+} // namespace
+
 bool
 CANDecoder::decodeCANMessage( const uint8_t *frameData,
                               size_t frameSize,
@@ -21,158 +28,340 @@ CANDecoder::decodeCANMessage( const uint8_t *frameData,
                               const std::unordered_set<uint32_t> &signalIDsToCollect,
                               std::vector<CANDecodedSignal> &decodedSignals )
 {
-    uint8_t errorCounter = 0;
-    uint32_t frameSizeInBits = static_cast<uint32_t>( frameSize * 8 );
-    uint8_t multiplexorValue = UINT8_MAX;
+    return decodeCANMessage( frameData, frameSize, compileDecodePlan( format, signalIDsToCollect ), decodedSignals );
+}
+
+bool
+CANDecoder::decodeCANMessage( const uint8_t *frameData,
+                              size_t frameSize,
+                              const CANMessageDecodePlan &decodePlan,
+                              std::vector<CANDecodedSignal> &decodedSignals )
+{
+    uint32_t frameSizeInBits = static_cast<uint32_t>( frameSize * BYTE_SIZE );
+    // Copy the frame once into a zero padded buffer, so that the signals can be read with 64-bit loads
+    PaddedFrame paddedFrame{};
+    const PaddedFrame *paddedFramePtr = nullptr;
+    if ( frameSize <= MAX_CAN_FRAME_BYTE_SIZE )
+    {
+        std::copy( frameData, frameData + frameSize, paddedFrame.begin() + FRAME_PADDING );
+        paddedFramePtr = &paddedFrame;
+    }
 
     // Check if the message is multiplexed
-    if ( format.isMultiplexed() )
+    if ( decodePlan.mIsMultiplexed )
     {
-        // Lookup the multiplexor signal
-        // complexity. Try to fix in the scheme not in the code.
-        auto it = std::find_if( format.mSignals.begin(), format.mSignals.end(), []( CANSignalFormat signal ) -> bool {
-            return signal.isMultiplexor();
-        } );
-        if ( it == format.mSignals.end() )
+        if ( !decodePlan.mHasMultiplexor )
         {
-            FWE_LOG_ERROR( "Message ID" + std::to_string( format.mMessageID ) +
+            FWE_LOG_ERROR( "Message ID" + std::to_string( decodePlan.mMessageID ) +
                            " is multiplexed but no Multiplexor signal has been found" );
             return false;
         }
-        if ( signalIDsToCollect.find( it->mSignalID ) != signalIDsToCollect.end() )
+        if ( decodePlan.mCollectMultiplexor )
         {
             // Decode the multiplexor Value
-            int64_t rawValue = extractSignalFromFrame( frameData, *it );
-            multiplexorValue = static_cast<uint8_t>( static_cast<uint8_t>( rawValue ) * it->mFactor + it->mOffset );
-
-            const auto CANsignalType = it->mSignalType;
-            switch ( CANsignalType )
+            const auto &multiplexor = decodePlan.mMultiplexor;
+            int64_t rawValue = extractSignal( frameData, paddedFramePtr, multiplexor );
+            auto multiplexorValue =
+                static_cast<uint8_t>( static_cast<uint8_t>( rawValue ) * multiplexor.mFactor + multiplexor.mOffset );
+            decodedSignals.emplace_back( multiplexor.mSignalID,
+                                         rawValue,
+                                         CANPhysicalValueType( multiplexorValue, multiplexor.mSignalType ),
+                                         multiplexor.mSignalType );
+            // Only the signals that match the MUX value are decoded
+            if ( multiplexorValue != UINT8_MAX )
             {
-            case ( SignalType::UINT64 ): {
-                if ( typeid( it->mFactor ) == typeid( double ) )
-                {
-                    FWE_LOG_WARN( "Scaling Factor is double for signal ID " + std::to_string( it->mSignalID ) +
-                                  " and type as uint64" );
-                }
-                auto physicalRawValue = static_cast<uint64_t>( multiplexorValue );
-                auto physicalValue = CANPhysicalValueType( physicalRawValue, CANsignalType );
-                decodedSignals.emplace_back(
-                    CANDecodedSignal( it->mSignalID, rawValue, physicalValue, CANsignalType ) );
-                break;
+                return decodeSignals( frameData,
+                                      paddedFramePtr,
+                                      frameSizeInBits,
+                                      decodePlan.mSignalsByMultiplexorValue,
+                                      decodePlan.mMultiplexorValueOffsets[multiplexorValue],
+                                      decodePlan.mMultiplexorValueOffsets[multiplexorValue + 1U],
+                                      decodedSignals );
             }
-            case ( SignalType::INT64 ): {
+        }
+    }
 
-                auto physicalRawValue = static_cast<int64_t>( multiplexorValue );
-                auto physicalValue = CANPhysicalValueType( physicalRawValue, CANsignalType );
-                decodedSignals.emplace_back(
-                    CANDecodedSignal( it->mSignalID, rawValue, physicalValue, CANsignalType ) );
-                break;
-            }
-            default: {
+    return decodeSignals( frameData,
+                          paddedFramePtr,
+                          frameSizeInBits,
+                          decodePlan.mSignals,
+                          0,
+                          decodePlan.mSignals.size(),
+                          decodedSignals );
+}
 
-                auto physicalRawValue = static_cast<double>( multiplexorValue );
-                auto physicalValue = CANPhysicalValueType( physicalRawValue, CANsignalType );
-                decodedSignals.emplace_back(
-                    CANDecodedSignal( it->mSignalID, rawValue, physicalValue, CANsignalType ) );
-                break;
-            }
-            }
+bool
+CANDecoder::decodeSignals( const uint8_t *frameData,
+                           const PaddedFrame *paddedFrame,
+                           uint32_t frameSizeInBits,
+                           const std::vector<CANSignalDecodeInfo> &signals,
+                           size_t begin,
+                           size_t end,
+                           std::vector<CANDecodedSignal> &decodedSignals )
+{
+    uint8_t errorCounter = 0;
+    for ( size_t i = begin; i < end; ++i )
+    {
+        const auto &signal = signals[i];
+        if ( frameSizeInBits < signal.mMinFrameSizeInBits )
+        {
+            // Wrongly coded Signal, skip it
+            FWE_LOG_ERROR( "Signal Out of Range for signal ID " + std::to_string( signal.mSignalID ) );
+            errorCounter++;
+            continue;
+        }
+
+        // Start decoding the signal, extract the value before scaling from the Frame.
+        int64_t rawValue = extractSignal( frameData, paddedFrame, signal );
+        const auto CANsignalType = signal.mSignalType;
+        switch ( CANsignalType )
+        {
+        case ( SignalType::UINT64 ): {
+            uint64_t physicalRawValue = static_cast<uint64_t>( rawValue ) * static_cast<uint64_t>( signal.mFactor ) +
+                                        static_cast<uint64_t>( signal.mOffset );
+            decodedSignals.emplace_back( signal.mSignalID,
+                                         rawValue,
+                                         CANPhysicalValueType( physicalRawValue, CANsignalType ),
+                                         CANsignalType );
+            break;
+        }
+        case ( SignalType::INT64 ): {
+            auto physicalRawValue = static_cast<int64_t>( rawValue ) * static_cast<int64_t>( signal.mFactor ) +
+                                    static_cast<int64_t>( signal.mOffset );
+            decodedSignals.emplace_back( signal.mSignalID,
+                                         rawValue,
+                                         CANPhysicalValueType( physicalRawValue, CANsignalType ),
+                                         CANsignalType );
+            break;
+        }
+        default: {
+            auto physicalRawValue = static_cast<double>( rawValue ) * signal.mFactor + signal.mOffset;
+            decodedSignals.emplace_back( signal.mSignalID,
+                                         rawValue,
+                                         CANPhysicalValueType( physicalRawValue, CANsignalType ),
+                                         CANsignalType );
+        }
         }
     }
 
-    for ( size_t i = 0; i < format.mSignals.size(); ++i )
+    // Should not harm, callers will ignore the return code.
+    return errorCounter == 0;
+}
+
+CANMessageDecodePlan
+CANDecoder::compileDecodePlan( const CANMessageFormat &format, const std::unordered_set<SignalID> &signalIDsToCollect )
+{
+    CANMessageDecodePlan decodePlan;
+    decodePlan.mMessageID = format.mMessageID;
+    decodePlan.mIsMultiplexed = format.isMultiplexed();
+    for ( const auto &signalFormat : format.mSignals )
     {
-        if ( signalIDsToCollect.find( format.mSignals[i].mSignalID ) != signalIDsToCollect.end() )
+        if ( signalIDsToCollect.find( signalFormat.mSignalID ) == signalIDsToCollect.end() )
+        {
+            continue;
+        }
+        if ( signalFormat.mSignalType == SignalType::UINT64 )
+        {
+            FWE_LOG_WARN( "Scaling Factor is double for signal ID " + std::to_string( signalFormat.mSignalID ) +
+                          " and type as uint64" );
+        }
+        decodePlan.mSignals.emplace_back( compileSignal( signalFormat ) );
+    }
+
+    if ( decodePlan.mIsMultiplexed )
+    {
+        // Lookup the multiplexor signal
+        auto it = std::find_if( format.mSignals.begin(), format.mSignals.end(), []( const CANSignalFormat &signal ) {
+            return signal.isMultiplexor();
+        } );
+        if ( it != format.mSignals.end() )
         {
-            // Skip the signals that don't match the MUX value
-            if ( ( multiplexorValue != UINT8_MAX ) && ( format.mSignals[i].mMultiplexorValue != multiplexorValue ) )
+            decodePlan.mHasMultiplexor = true;
+            decodePlan.mMultiplexor = compileSignal( *it );
+            decodePlan.mCollectMultiplexor = signalIDsToCollect.find( it->mSignalID ) != signalIDsToCollect.end();
+        }
+        if ( decodePlan.mCollectMultiplexor )
+        {
+            // Bucket the signals by multiplexor value with a counting sort, which keeps the order of the format inside
+            // each bucket. UINT8_MAX is not a valid multiplexor value, so it doesn't get a bucket.
+            decodePlan.mMultiplexorValueOffsets.assign( UINT8_MAX + 1U, 0 );
+            for ( const auto &signal : decodePlan.mSignals )
+            {
+                if ( signal.mMultiplexorValue != UINT8_MAX )
+                {
+                    decodePlan.mMultiplexorValueOffsets[signal.mMultiplexorValue + 1U]++;
+                }
+            }
+            for ( size_t i = 1; i < decodePlan.mMultiplexorValueOffsets.size(); i++ )
             {
-                continue;
+                decodePlan.mMultiplexorValueOffsets[i] += decodePlan.mMultiplexorValueOffsets[i - 1];
             }
-
-            if ( ( format.mSignals[i].mFirstBitPosition >= frameSizeInBits ) ||
-                 ( ( format.mSignals[i].mSizeInBits < 1 ) || ( format.mSignals[i].mSizeInBits > frameSizeInBits ) ) )
+            decodePlan.mSignalsByMultiplexorValue.resize( decodePlan.mMultiplexorValueOffsets.back() );
+            auto nextPositions = decodePlan.mMultiplexorValueOffsets;
+            for ( const auto &signal : decodePlan.mSignals )
             {
-                // Wrongly coded Signal, skip it
-                FWE_LOG_ERROR( "Signal Out of Range" );
-                errorCounter++;
-                continue;
+                if ( signal.mMultiplexorValue != UINT8_MAX )
+                {
+                    decodePlan.mSignalsByMultiplexorValue[nextPositions[signal.mMultiplexorValue]++] = signal;
+                }
             }
+        }
+    }
+    decodePlan.mIsCompiled = true;
+    return decodePlan;
+}
 
-            if ( ( !format.mSignals[i].mIsBigEndian ) &&
-                 ( format.mSignals[i].mFirstBitPosition + format.mSignals[i].mSizeInBits > frameSizeInBits ) )
+void
+CANDecoder::compileDictionary( CANDecoderDictionary &dictionary )
+{
+    dictionary.canMessageDecoderMethodLookup.clear();
+    dictionary.isDecoderMethodLookupBuilt = false;
+    CANChannelNumericID maxChannelId = 0;
+    for ( auto &channel : dictionary.canMessageDecoderMethod )
+    {
+        maxChannelId = std::max( maxChannelId, channel.first );
+        for ( auto &decoderMethod : channel.second )
+        {
+            if ( decoderMethod.second.collectType != CANMessageCollectType::RAW )
             {
-                // Wrongly coded Signal, skip it
-                FWE_LOG_ERROR( "Little endian signal Out of Range" );
-                errorCounter++;
-                continue;
+                decoderMethod.second.decodePlan =
+                    compileDecodePlan( decoderMethod.second.format, dictionary.signalIDsToCollect );
             }
+        }
+    }
 
-            // Start decoding the signal, extract the value before scaling from the Frame.
-            int64_t rawValue = extractSignalFromFrame( frameData, format.mSignals[i] );
-            const auto CANsignalType = format.mSignals[i].mSignalType;
-            switch ( CANsignalType )
+    // Channel IDs are handed out consecutively, so they can index the lookup directly. Otherwise the frames are still
+    // looked up in canMessageDecoderMethod.
+    if ( maxChannelId >= MAX_CAN_CHANNELS_WITH_LOOKUP )
+    {
+        FWE_LOG_WARN( "CAN channel ID " + std::to_string( maxChannelId ) + " too large for the decoder method lookup" );
+        return;
+    }
+    dictionary.canMessageDecoderMethodLookup.resize( dictionary.canMessageDecoderMethod.empty() ? 0
+                                                                                                : maxChannelId + 1U );
+    for ( const auto &channel : dictionary.canMessageDecoderMethod )
+    {
+        auto &lookup = dictionary.canMessageDecoderMethodLookup[channel.first];
+        for ( const auto &decoderMethod : channel.second )
+        {
+            if ( decoderMethod.first < CAN_STANDARD_FRAME_ID_COUNT )
             {
-            case ( SignalType::UINT64 ): {
-                if ( typeid( format.mSignals[i].mFactor ) == typeid( double ) )
+                if ( lookup.standardFrames.empty() )
                 {
-                    FWE_LOG_WARN( "Scaling Factor is double for signal ID " +
-                                  std::to_string( format.mSignals[i].mSignalID ) + " and type as uint64" );
+                    lookup.standardFrames.resize( CAN_STANDARD_FRAME_ID_COUNT, nullptr );
                 }
-                uint64_t physicalRawValue =
-                    static_cast<uint64_t>( rawValue ) * static_cast<uint64_t>( format.mSignals[i].mFactor ) +
-                    static_cast<uint64_t>( format.mSignals[i].mOffset );
-                auto physicalValue = CANPhysicalValueType( physicalRawValue, CANsignalType );
-                decodedSignals.emplace_back(
-                    CANDecodedSignal( format.mSignals[i].mSignalID, rawValue, physicalValue, CANsignalType ) );
-                break;
+                lookup.standardFrames[decoderMethod.first] = &decoderMethod.second;
             }
-            case ( SignalType::INT64 ): {
-                auto physicalRawValue =
-                    static_cast<int64_t>( rawValue ) * static_cast<int64_t>( format.mSignals[i].mFactor ) +
-                    static_cast<int64_t>( format.mSignals[i].mOffset );
-                auto physicalValue = CANPhysicalValueType( physicalRawValue, CANsignalType );
-                decodedSignals.emplace_back(
-                    CANDecodedSignal( format.mSignals[i].mSignalID, rawValue, physicalValue, CANsignalType ) );
-                break;
-            }
-            default: {
-                auto physicalRawValue =
-                    static_cast<double>( rawValue ) * format.mSignals[i].mFactor + format.mSignals[i].mOffset;
-                auto physicalValue = CANPhysicalValueType( physicalRawValue, CANsignalType );
-                decodedSignals.emplace_back(
-                    CANDecodedSignal( format.mSignals[i].mSignalID, rawValue, physicalValue, CANsignalType ) );
+            else
+            {
+                lookup.otherFrames.emplace_back( decoderMethod.first, &decoderMethod.second );
             }
+        }
+        std::sort( lookup.otherFrames.begin(), lookup.otherFrames.end() );
+    }
+    dictionary.isDecoderMethodLookupBuilt = true;
+}
+
+CANSignalDecodeInfo
+CANDecoder::compileSignal( const CANSignalFormat &signalFormat )
+{
+    CANSignalDecodeInfo signalInfo;
+    signalInfo.mSignalID = signalFormat.mSignalID;
+    signalInfo.mSignalType = signalFormat.mSignalType;
+    signalInfo.mIsBigEndian = signalFormat.mIsBigEndian;
+    signalInfo.mIsSigned = signalFormat.mIsSigned;
+    signalInfo.mMultiplexorValue = signalFormat.mMultiplexorValue;
+    signalInfo.mSizeInBits = signalFormat.mSizeInBits;
+    signalInfo.mFactor = signalFormat.mFactor;
+    signalInfo.mOffset = signalFormat.mOffset;
+
+    // NOTE: The start bit here is different from how it appears in a DBC file. In a DBC file, the
+    // start bit indicates the LSB for little endian and MSB for big endian signals.
+    // But AWS IoT Fleetwise considers start bit to always be the LSB regardless of endianess.
+    uint16_t startBit = signalFormat.mFirstBitPosition;
+    signalInfo.mStartByte = static_cast<uint8_t>( startBit / BYTE_SIZE );
+    signalInfo.mStartBitInByte = static_cast<uint8_t>( startBit % BYTE_SIZE );
+    if ( signalFormat.mIsBigEndian ) // Motorola (big endian)
+    {
+        signalInfo.mEndByte = static_cast<uint8_t>( ( signalInfo.mStartByte * BYTE_SIZE + BYTE_SIZE -
+                                                      signalInfo.mStartBitInByte - signalFormat.mSizeInBits ) /
+                                                    BYTE_SIZE );
+    }
+    else // Intel (little endian)
+    {
+        signalInfo.mEndByte = static_cast<uint8_t>( ( startBit + signalFormat.mSizeInBits - 1 ) / BYTE_SIZE );
+    }
+
+    if ( signalFormat.mSizeInBits >= 64U )
+    {
+        signalInfo.mMask = UINT64_MAX;
+    }
+    else
+    {
+        signalInfo.mMask = ( static_cast<uint64_t>( 1U ) << signalFormat.mSizeInBits ) - 1U;
+    }
+    if ( ( signalFormat.mSizeInBits >= 1U ) && ( signalFormat.mSizeInBits <= 64U ) )
+    {
+        signalInfo.mSignMask = static_cast<uint64_t>( 1U ) << ( signalFormat.mSizeInBits - 1U );
+    }
+
+    // A single 64-bit load covers the signal if it doesn't span more than 8 bytes. Big endian signals whose end byte
+    // wrapped around, because they extend beyond the first byte of the frame, keep the byte wise extraction so that
+    // the result stays the same.
+    if ( ( signalFormat.mSizeInBits >= 1U ) && ( signalInfo.mStartByte < MAX_CAN_FRAME_BYTE_SIZE ) )
+    {
+        if ( signalFormat.mIsBigEndian )
+        {
+            if ( ( signalInfo.mEndByte <= signalInfo.mStartByte ) &&
+                 ( static_cast<size_t>( signalInfo.mStartByte - signalInfo.mEndByte ) < sizeof( uint64_t ) ) )
+            {
+                signalInfo.mUseWordExtraction = true;
+                // The word ends with the start byte, which holds the least significant bits
+                signalInfo.mWordOffset =
+                    static_cast<uint8_t>( FRAME_PADDING + signalInfo.mStartByte + 1U - sizeof( uint64_t ) );
             }
         }
+        else if ( ( signalInfo.mStartBitInByte + signalFormat.mSizeInBits ) <= 64U )
+        {
+            signalInfo.mUseWordExtraction = true;
+            signalInfo.mWordOffset = static_cast<uint8_t>( FRAME_PADDING + signalInfo.mStartByte );
+        }
     }
 
-    // Should not harm, callers will ignore the return code.
-    return errorCounter == 0;
+    // The first bit has to be inside the frame and the signal can't be larger than the frame. Little endian signals
+    // additionally must not extend beyond the end of the frame.
+    if ( signalFormat.mSizeInBits >= 1U )
+    {
+        signalInfo.mMinFrameSizeInBits =
+            std::max( static_cast<uint32_t>( startBit ) + 1U, static_cast<uint32_t>( signalFormat.mSizeInBits ) );
+        if ( !signalFormat.mIsBigEndian )
+        {
+            signalInfo.mMinFrameSizeInBits =
+                std::max( signalInfo.mMinFrameSizeInBits,
+                          static_cast<uint32_t>( startBit ) + static_cast<uint32_t>( signalFormat.mSizeInBits ) );
+        }
+    }
+    return signalInfo;
 }
 
 int64_t
 CANDecoder::extractSignalFromFrame( const uint8_t *frameData, const CANSignalFormat &signalDescription )
 {
-    uint16_t startBit = static_cast<uint16_t>( signalDescription.mFirstBitPosition );
-    uint8_t startByte = static_cast<uint8_t>( startBit / BYTE_SIZE );
-    uint8_t startBitInByte = startBit % BYTE_SIZE;
-    uint8_t resultLength = static_cast<uint8_t>( BYTE_SIZE - startBitInByte );
-    uint8_t endByte = 0U;
+    return extractSignalFromFrame( frameData, compileSignal( signalDescription ) );
+}
+
+int64_t
+CANDecoder::extractSignalFromFrame( const uint8_t *frameData, const CANSignalDecodeInfo &signalInfo )
+{
+    uint8_t resultLength = static_cast<uint8_t>( BYTE_SIZE - signalInfo.mStartBitInByte );
 
     // Write first bits to result
-    // NOTE: The start bit here is different from how it appears in a DBC file. In a DBC file, the
-    // start bit indicates the LSB for little endian and MSB for big endian signals.
-    // But AWS IoT Fleetwise considers start bit to always be the LSB regardless of endianess.
-    uint64_t result = frameData[startByte] >> startBitInByte;
+    uint64_t result = frameData[signalInfo.mStartByte] >> signalInfo.mStartBitInByte;
 
     // Write residual bytes
-    if ( signalDescription.mIsBigEndian ) // Motorola (big endian)
+    if ( signalInfo.mIsBigEndian ) // Motorola (big endian)
     {
-        endByte = static_cast<uint8_t>(
-            ( startByte * BYTE_SIZE + BYTE_SIZE - startBitInByte - signalDescription.mSizeInBits ) / BYTE_SIZE );
-
-        for ( int count = startByte - 1; count >= endByte; count-- )
+        for ( int count = signalInfo.mStartByte - 1; count >= signalInfo.mEndByte; count-- )
         {
             result |= static_cast<uint64_t>( frameData[count] ) << resultLength;
             resultLength = static_cast<uint8_t>( resultLength + BYTE_SIZE );
@@ -180,9 +369,7 @@ CANDecoder::extractSignalFromFrame( const uint8_t *frameData, const CANSignalFor
     }
     else // Intel (little endian)
     {
-        endByte = static_cast<uint8_t>( ( startBit + signalDescription.mSizeInBits - 1 ) / BYTE_SIZE );
-
-        for ( int count = startByte + 1; count <= endByte; count++ )
+        for ( int count = signalInfo.mStartByte + 1; count <= signalInfo.mEndByte; count++ )
         {
             result |= static_cast<uint64_t>( frameData[count] ) << resultLength;
             resultLength = static_cast<uint8_t>( resultLength + BYTE_SIZE );
@@ -190,16 +377,49 @@ CANDecoder::extractSignalFromFrame( const uint8_t *frameData, const CANSignalFor
     }
 
     // Mask value
-    result &= MASK64( signalDescription.mSizeInBits );
+    result &= signalInfo.mMask;
 
     // perform sign extension
-    if ( signalDescription.mIsSigned )
+    if ( signalInfo.mIsSigned )
     {
-        uint64_t msbSignMask = static_cast<uint64_t>( 1U ) << ( signalDescription.mSizeInBits - 1 );
-        result = ( ( result ^ msbSignMask ) - msbSignMask );
+        result = ( ( result ^ signalInfo.mSignMask ) - signalInfo.mSignMask );
     }
     return static_cast<int64_t>( result );
 }
 
+int64_t
+CANDecoder::extractSignalFromPaddedFrame( const PaddedFrame &paddedFrame, const CANSignalDecodeInfo &signalInfo )
+{
+    if ( !signalInfo.mUseWordExtraction )
+    {
+        return extractSignalFromFrame( paddedFrame.data() + FRAME_PADDING, signalInfo );
+    }
+
+    uint64_t word = 0;
+    std::memcpy( &word, paddedFrame.data() + signalInfo.mWordOffset, sizeof( word ) );
+    word = signalInfo.mIsBigEndian ? be64toh( word ) : le64toh( word );
+    uint64_t result = ( word >> signalInfo.mStartBitInByte ) & signalInfo.mMask;
+
+    // perform sign extension
+    if ( signalInfo.mIsSigned )
+    {
+        result = ( ( result ^ signalInfo.mSignMask ) - signalInfo.mSignMask );
+    }
+    return static_cast<int64_t>( result );
+}
+
+int64_t
+CANDecoder::extractSignal( const uint8_t *frameData,
+                           const PaddedFrame *paddedFrame,
+                           const CANSignalDecodeInfo &signalInfo )
+{
+    if ( paddedFrame != nullptr )
+    {
+        return extractSignalFromPaddedFrame( *paddedFrame, signalInfo );
+    }
+    // Frames that are larger than a CAN-FD frame are not padded
+    return extractSignalFromFrame( frameData, signalInfo );
+}
+
 } // namespace IoTFleetWise
 } // namespace Aws
@@ -4,8 +4,10 @@
 #pragma once
 
 #include "CANDataTypes.h"
+#include "IDecoderDictionary.h"
 #include "MessageTypes.h"
 #include "SignalTypes.h"
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <unordered_set>
@@ -25,6 +27,14 @@ class CANDecoder
 {
 
 public:
+    /**
+     * @brief Zero bytes in front of and behind a frame copied into a PaddedFrame, so that every signal can be
+     * read with a 64-bit load without touching memory outside of the buffer
+     */
+    static constexpr size_t FRAME_PADDING = 8;
+
+    using PaddedFrame = std::array<uint8_t, FRAME_PADDING + MAX_CAN_FRAME_BYTE_SIZE + FRAME_PADDING>;
+
     /**
      * @brief Decode a given frameData of frameSize using the DBC format.
      * @param frameData pointer to the frame data
@@ -41,6 +51,36 @@ public:
                                   const std::unordered_set<SignalID> &signalIDsToCollect,
                                   std::vector<CANDecodedSignal> &decodedSignals );
 
+    /**
+     * @brief Decode a given frameData of frameSize using a precompiled decode plan.
+     * @param frameData pointer to the frame data
+     * @param frameSize size in bytes of the frame.
+     * @param decodePlan plan compiled by compileDecodePlan()
+     * @param decodedSignals result of the decoding.
+     * @return True if the decoding is successful, False means that the decoding was
+     * partially not successful
+     */
+    static bool decodeCANMessage( const uint8_t *frameData,
+                                  size_t frameSize,
+                                  const CANMessageDecodePlan &decodePlan,
+                                  std::vector<CANDecodedSignal> &decodedSignals );
+
+    /**
+     * @brief Compiles the decode plan of a message, which only contains the signals to be collected.
+     * @param format of the frame according to the DBC file.
+     * @param signalIDsToCollect the id for the signals to be collected
+     * @return the compiled plan
+     */
+    static CANMessageDecodePlan compileDecodePlan( const CANMessageFormat &format,
+                                                   const std::unordered_set<SignalID> &signalIDsToCollect );
+
+    /**
+     * @brief Compiles the decode plans of all messages of the dictionary that have signals to decode and builds the
+     * flat frame ID lookup of each channel. Has to be called again after canMessageDecoderMethod was modified.
+     * @param dictionary the CAN decoder dictionary to be updated
+     */
+    static void compileDictionary( CANDecoderDictionary &dictionary );
+
     /**
      * @brief extracts a signal raw value from a frame.
      * @param frameData pointer to the frame data
@@ -48,6 +88,39 @@ public:
      * @return 8 bytes representation of the physical value of the signal.
      */
     static int64_t extractSignalFromFrame( const uint8_t *frameData, const CANSignalFormat &signalDescription );
+
+    /**
+     * @brief extracts a signal raw value from a frame byte by byte.
+     * @param frameData pointer to the frame data
+     * @param signalInfo compiled description of the signal
+     * @return 8 bytes representation of the physical value of the signal.
+     */
+    static int64_t extractSignalFromFrame( const uint8_t *frameData, const CANSignalDecodeInfo &signalInfo );
+
+    /**
+     * @brief extracts a signal raw value from a padded frame, with a single 64-bit load if possible. The result is
+     * bit-exact with extractSignalFromFrame().
+     * @param paddedFrame the frame data starting at FRAME_PADDING, all other bytes zero
+     * @param signalInfo compiled description of the signal
+     * @return 8 bytes representation of the physical value of the signal.
+     */
+    static int64_t extractSignalFromPaddedFrame( const PaddedFrame &paddedFrame,
+                                                 const CANSignalDecodeInfo &signalInfo );
+
+private:
+    static CANSignalDecodeInfo compileSignal( const CANSignalFormat &signalFormat );
+
+    static int64_t extractSignal( const uint8_t *frameData,
+                                  const PaddedFrame *paddedFrame,
+                                  const CANSignalDecodeInfo &signalInfo );
+
+    static bool decodeSignals( const uint8_t *frameData,
+                               const PaddedFrame *paddedFrame,
+                               uint32_t frameSizeInBits,
+                               const std::vector<CANSignalDecodeInfo> &signals,
+                               size_t begin,
+                               size_t end,
+                               std::vector<CANDecodedSignal> &decodedSignals );
 };
 
 } // namespace IoTFleetWise
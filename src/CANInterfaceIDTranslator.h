@@ -5,6 +5,9 @@
 
 #include "CollectionInspectionAPITypes.h"
 #include "SignalTypes.h"
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace Aws
 {
@@ -12,6 +15,8 @@ namespace IoTFleetWise
 {
 /**
  * @brief Translate the internal used Id to the Id used in config file and decoder manifest
+ * The numeric IDs are assigned in the order the interfaces are added, so the interface IDs are stored in a vector
+ * indexed by numeric ID and the reverse direction uses a hash map. Both lookups are O(1) and don't copy strings.
  * Adding new items is not thread safe
  */
 class CANInterfaceIDTranslator
@@ -21,39 +26,35 @@ public:
     void
     add( InterfaceID iid )
     {
-        mLookup.emplace_back( mCounter, iid );
-        mCounter++;
+        // If an interface ID is added twice, the first numeric ID stays valid for the lookup
+        mChannelNumericIDs.emplace( iid, static_cast<CANChannelNumericID>( mInterfaceIDs.size() ) );
+        mInterfaceIDs.emplace_back( std::move( iid ) );
     }
 
     CANChannelNumericID
-    getChannelNumericID( const InterfaceID &iid )
+    getChannelNumericID( const InterfaceID &iid ) const
     {
-        for ( auto l : mLookup )
+        auto it = mChannelNumericIDs.find( iid );
+        if ( it == mChannelNumericIDs.end() )
         {
-            if ( l.second == iid )
-            {
-                return l.first;
-            }
+            return INVALID_CAN_SOURCE_NUMERIC_ID;
         }
-        return INVALID_CAN_SOURCE_NUMERIC_ID;
+        return it->second;
     };
 
-    InterfaceID
-    getInterfaceID( CANChannelNumericID cid )
+    const InterfaceID &
+    getInterfaceID( CANChannelNumericID cid ) const
     {
-        for ( auto l : mLookup )
+        if ( cid >= mInterfaceIDs.size() )
         {
-            if ( l.first == cid )
-            {
-                return l.second;
-            }
+            return INVALID_INTERFACE_ID;
         }
-        return INVALID_INTERFACE_ID;
+        return mInterfaceIDs[cid];
     };
 
 private:
-    std::vector<std::pair<CANChannelNumericID, InterfaceID>> mLookup;
-    CANChannelNumericID mCounter{ 0 };
+    std::vector<InterfaceID> mInterfaceIDs;
+    std::unordered_map<InterfaceID, CANChannelNumericID> mChannelNumericIDs;
 };
 
 } // namespace IoTFleetWise
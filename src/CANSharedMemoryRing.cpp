@@ -0,0 +1,242 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "CANSharedMemoryRing.h"
+#include "LoggingModule.h"
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <new>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <utility>
+
+namespace Aws
+{
+namespace IoTFleetWise
+{
+
+constexpr uint32_t CANSharedMemoryRing::MAGIC;   // NOLINT
+constexpr uint32_t CANSharedMemoryRing::VERSION; // NOLINT
+
+CANSharedMemoryRing::CANSharedMemoryRing( std::string path )
+    : mPath( std::move( path ) )
+{
+}
+
+CANSharedMemoryRing::~CANSharedMemoryRing()
+{
+    if ( mMemory != nullptr )
+    {
+        munmap( mMemory, mMemorySize );
+    }
+    if ( mFd >= 0 )
+    {
+        // Only remove the file created by create(), not one that replaced it in the meantime
+        struct stat createdStatus = {};
+        struct stat pathStatus = {};
+        if ( mIsOwner && ( fstat( mFd, &createdStatus ) == 0 ) && ( stat( mPath.c_str(), &pathStatus ) == 0 ) &&
+             ( createdStatus.st_dev == pathStatus.st_dev ) && ( createdStatus.st_ino == pathStatus.st_ino ) )
+        {
+            unlink( mPath.c_str() );
+        }
+        close( mFd );
+    }
+}
+
+bool
+CANSharedMemoryRing::map( size_t size )
+{
+    void *memory = mmap( nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, mFd, 0 );
+    if ( memory == MAP_FAILED )
+    {
+        FWE_LOG_ERROR( "Failed to map shared memory " + mPath + ": " + getErrnoString() );
+        return false;
+    }
+    mMemory = memory;
+    mMemorySize = size;
+    mHeader = static_cast<CANSharedMemoryRingHeader *>( mMemory );
+    mFrames = reinterpret_cast<CANSharedMemoryFrame *>( static_cast<uint8_t *>( mMemory ) +
+                                                        sizeof( CANSharedMemoryRingHeader ) );
+    return true;
+}
+
+bool
+CANSharedMemoryRing::create( uint32_t capacity )
+{
+    if ( ( capacity == 0 ) || ( mFd >= 0 ) )
+    {
+        return false;
+    }
+    // Existing files are never removed or reused, as the path might point to anything
+    mFd = ::open( mPath.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, S_IRUSR | S_IWUSR );
+    if ( mFd < 0 )
+    {
+        FWE_LOG_ERROR( "Failed to create shared memory " + mPath + ": " + getErrnoString() +
+                       ". If the file is a leftover of a previous run, remove it before starting." );
+        return false;
+    }
+    mIsOwner = true;
+    size_t size =
+        sizeof( CANSharedMemoryRingHeader ) + ( static_cast<size_t>( capacity ) * sizeof( CANSharedMemoryFrame ) );
+    if ( ftruncate( mFd, static_cast<off_t>( size ) ) != 0 )
+    {
+        FWE_LOG_ERROR( "Failed to resize shared memory " + mPath + ": " + getErrnoString() );
+        return false;
+    }
+    if ( !map( size ) )
+    {
+        return false;
+    }
+    mHeader = new ( mMemory ) CANSharedMemoryRingHeader();
+    mHeader->capacity = capacity;
+    mCapacity = capacity;
+    mHeader->frameSize = sizeof( CANSharedMemoryFrame );
+    mHeader->version = VERSION;
+    mHeader->writeIndex.store( 0, std::memory_order_relaxed );
+    mHeader->readIndex.store( 0, std::memory_order_relaxed );
+    mHeader->consumerWaiting.store( 0, std::memory_order_relaxed );
+    // Written last, so that a producer that attaches concurrently does not see a half initialized header
+    std::atomic_thread_fence( std::memory_order_release );
+    mHeader->magic = MAGIC;
+    return true;
+}
+
+bool
+CANSharedMemoryRing::open()
+{
+    if ( mFd >= 0 )
+    {
+        return false;
+    }
+    mFd = ::open( mPath.c_str(), O_RDWR | O_CLOEXEC );
+    if ( mFd < 0 )
+    {
+        FWE_LOG_ERROR( "Failed to open shared memory " + mPath + ": " + getErrnoString() );
+        return false;
+    }
+    struct stat status = {};
+    if ( ( fstat( mFd, &status ) != 0 ) ||
+         ( static_cast<size_t>( status.st_size ) < sizeof( CANSharedMemoryRingHeader ) ) )
+    {
+        FWE_LOG_ERROR( "Invalid shared memory " + mPath );
+        return false;
+    }
+    auto size = static_cast<size_t>( status.st_size );
+    if ( !map( size ) )
+    {
+        return false;
+    }
+    std::atomic_thread_fence( std::memory_order_acquire );
+    if ( ( mHeader->magic != MAGIC ) || ( mHeader->version != VERSION ) ||
+         ( mHeader->frameSize != sizeof( CANSharedMemoryFrame ) ) ||
+         ( size < ( sizeof( CANSharedMemoryRingHeader ) +
+                    ( static_cast<size_t>( mHeader->capacity ) * sizeof( CANSharedMemoryFrame ) ) ) ) )
+    {
+        FWE_LOG_ERROR( "Incompatible shared memory " + mPath );
+        return false;
+    }
+    mCapacity = mHeader->capacity;
+    return true;
+}
+
+bool
+CANSharedMemoryRing::push( Timestamp timestamp, uint32_t messageId, const uint8_t *data, size_t dataLength )
+{
+    if ( ( mHeader == nullptr ) || ( dataLength > MAX_CAN_FRAME_BYTE_SIZE ) )
+    {
+        return false;
+    }
+    uint64_t writeIndex = mHeader->writeIndex.load( std::memory_order_relaxed );
+    if ( ( writeIndex - mHeader->readIndex.load( std::memory_order_acquire ) ) >= mCapacity )
+    {
+        return false;
+    }
+    auto &frame = mFrames[writeIndex % mCapacity];
+    frame.timestamp = timestamp;
+    frame.messageId = messageId;
+    frame.dataLength = static_cast<uint8_t>( dataLength );
+    std::memcpy( frame.data, data, dataLength );
+    // Sequentially consistent, so that either the consumer sees the new frame before it sleeps or this sees that the
+    // consumer is waiting
+    mHeader->writeIndex.store( writeIndex + 1 );
+    if ( mHeader->consumerWaiting.load() != 0 )
+    {
+        wakeUp();
+    }
+    return true;
+}
+
+size_t
+CANSharedMemoryRing::peek( std::vector<CANFrameInfo> &frames, size_t maxFrames )
+{
+    frames.clear();
+    if ( mHeader == nullptr )
+    {
+        return 0;
+    }
+    uint64_t readIndex = mHeader->readIndex.load( std::memory_order_relaxed );
+    uint64_t writeIndex = mHeader->writeIndex.load( std::memory_order_acquire );
+    // Do not trust the other process more than necessary
+    auto available = static_cast<size_t>( std::min<uint64_t>( writeIndex - readIndex, mCapacity ) );
+    auto numFrames = std::min( available, maxFrames );
+    for ( size_t i = 0; i < numFrames; i++ )
+    {
+        const auto &frame = mFrames[( readIndex + i ) % mCapacity];
+        frames.push_back( CANFrameInfo{ frame.messageId,
+                                        frame.data,
+                                        std::min( static_cast<size_t>( frame.dataLength ),
+                                                  static_cast<size_t>( MAX_CAN_FRAME_BYTE_SIZE ) ),
+                                        frame.timestamp } );
+    }
+    return numFrames;
+}
+
+void
+CANSharedMemoryRing::release( size_t numFrames )
+{
+    if ( mHeader == nullptr )
+    {
+        return;
+    }
+    mHeader->readIndex.store( mHeader->readIndex.load( std::memory_order_relaxed ) + numFrames,
+                              std::memory_order_release );
+}
+
+void
+CANSharedMemoryRing::waitForFrames( uint32_t timeoutMs, const std::atomic<bool> &cancel )
+{
+    if ( mHeader == nullptr )
+    {
+        return;
+    }
+    mHeader->consumerWaiting.store( 1 );
+    if ( ( mHeader->writeIndex.load() == mHeader->readIndex.load( std::memory_order_relaxed ) ) && ( !cancel.load() ) )
+    {
+        struct timespec timeout = {};
+        timeout.tv_sec = static_cast<time_t>( timeoutMs / 1000 );
+        timeout.tv_nsec = static_cast<long>( ( timeoutMs % 1000 ) * 1000000 );
+        // Not FUTEX_WAIT_PRIVATE, as the producer is another process. Returns immediately if the word is not 1
+        // anymore.
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        syscall( SYS_futex, reinterpret_cast<uint32_t *>( &mHeader->consumerWaiting ), FUTEX_WAIT, 1, &timeout );
+    }
+    mHeader->consumerWaiting.store( 0, std::memory_order_relaxed );
+}
+
+void
+CANSharedMemoryRing::wakeUp()
+{
+    if ( ( mHeader != nullptr ) && ( mHeader->consumerWaiting.exchange( 0 ) != 0 ) )
+    {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        syscall( SYS_futex, reinterpret_cast<uint32_t *>( &mHeader->consumerWaiting ), FUTEX_WAKE, 1 );
+    }
+}
+
+} // namespace IoTFleetWise
+} // namespace Aws
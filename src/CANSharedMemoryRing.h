@@ -0,0 +1,151 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "CANDataConsumer.h"
+#include "SignalTypes.h"
+#include "TimeTypes.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Aws
+{
+namespace IoTFleetWise
+{
+
+/**
+ * @brief One slot of the shared memory ring. The layout is part of the interface to external processes.
+ */
+struct CANSharedMemoryFrame
+{
+    // Milliseconds since epoch, or zero if unknown
+    uint64_t timestamp;
+    // CAN message ID in Linux SocketCAN format
+    uint32_t messageId;
+    uint8_t dataLength;
+    uint8_t reserved[3];
+    uint8_t data[MAX_CAN_FRAME_BYTE_SIZE];
+};
+
+/**
+ * @brief Header at the start of the shared memory, followed by `capacity` CANSharedMemoryFrame slots
+ *
+ * The producer only writes writeIndex and the consumer only writes readIndex. Both only ever increase, the slot of an
+ * index is `index % capacity`. Both are on their own cache line.
+ *
+ * consumerWaiting is the futex word the consumer sleeps on while the ring is empty. It is set to 1 by the consumer
+ * before sleeping and reset to 0 by whoever wakes it up.
+ */
+struct CANSharedMemoryRingHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t capacity;
+    uint32_t frameSize;
+    alignas( 64 ) std::atomic<uint64_t> writeIndex;
+    alignas( 64 ) std::atomic<uint64_t> readIndex;
+    alignas( 64 ) std::atomic<uint32_t> consumerWaiting;
+};
+
+static_assert( ATOMIC_LLONG_LOCK_FREE == 2, "The ring indices must be lock free to be shared between processes" );
+static_assert( ( ATOMIC_INT_LOCK_FREE == 2 ) && ( sizeof( std::atomic<uint32_t> ) == sizeof( uint32_t ) ),
+               "The futex word must be a plain 32 bit integer" );
+
+/**
+ * @brief Single-producer single-consumer ring of CAN frames in shared memory, backed by a memory mapped file
+ *
+ * Allows an external process to hand over CAN frames without a copy per frame on the FWE side: the consumer passes
+ * CANFrameInfos that point into the shared memory slots to the CANDataConsumer and only releases the slots afterwards.
+ *
+ * FWE creates the ring with create() and consumes it with peek()/release()/waitForFrames(). The external process
+ * attaches with open() and writes with push(), or implements the same protocol on the CANSharedMemoryRingHeader
+ * layout: fill the slot at writeIndex % capacity, increase writeIndex with sequentially consistent semantics, then if
+ * consumerWaiting is not 0, exchange it with 0 and call FUTEX_WAKE on it. So the producer only makes a syscall when
+ * the consumer sleeps on an empty ring. A producer that does not wake the consumer still works, but its frames are
+ * only picked up when the consumer's wait times out.
+ */
+class CANSharedMemoryRing
+{
+public:
+    static constexpr uint32_t MAGIC = 0x46574543; // "FWEC"
+    static constexpr uint32_t VERSION = 2;
+
+    /**
+     * @param path path of the file backing the shared memory, e.g. "/dev/shm/fwe-can0"
+     */
+    CANSharedMemoryRing( std::string path );
+    ~CANSharedMemoryRing();
+
+    CANSharedMemoryRing( const CANSharedMemoryRing & ) = delete;
+    CANSharedMemoryRing &operator=( const CANSharedMemoryRing & ) = delete;
+    CANSharedMemoryRing( CANSharedMemoryRing && ) = delete;
+    CANSharedMemoryRing &operator=( CANSharedMemoryRing && ) = delete;
+
+    /**
+     * @brief Creates the shared memory file and initializes an empty ring. Fails if the file already exists. The
+     * file is removed again when this instance is destroyed, unless the path was replaced by another file.
+     * @param capacity number of frame slots
+     * @return true on success
+     */
+    bool create( uint32_t capacity );
+
+    /**
+     * @brief Attaches to a ring created by another instance, for the producer side
+     * @return true on success
+     */
+    bool open();
+
+    /**
+     * @brief Writes a frame to the ring. Must only be called by the single producer.
+     * @return false if the ring is full or the data is too long
+     */
+    bool push( Timestamp timestamp, uint32_t messageId, const uint8_t *data, size_t dataLength );
+
+    /**
+     * @brief Gets the frames written to the ring, without releasing their slots. Must only be called by the consumer.
+     * @param frames filled with the frames, pointing into the shared memory. They stay valid until release().
+     * @param maxFrames maximum number of frames to get
+     * @return number of frames
+     */
+    size_t peek( std::vector<CANFrameInfo> &frames, size_t maxFrames );
+
+    /**
+     * @brief Hands the slots of the frames got with peek() back to the producer
+     * @param numFrames number of frames returned by the last peek()
+     */
+    void release( size_t numFrames );
+
+    /**
+     * @brief Sleeps until the producer pushes a frame, wakeUp() is called or the timeout expires. Returns immediately
+     * if the ring is not empty or cancel is set. Must only be called by the consumer.
+     * @param timeoutMs maximum time to sleep
+     * @param cancel flag that is set before wakeUp() is called to stop the consumer
+     */
+    void waitForFrames( uint32_t timeoutMs, const std::atomic<bool> &cancel );
+
+    /**
+     * @brief Wakes up the consumer if it sleeps in waitForFrames()
+     */
+    void wakeUp();
+
+private:
+    // Maps the file of mFd
+    bool map( size_t size );
+
+    std::string mPath;
+    bool mIsOwner{ false };
+    int mFd{ -1 };
+    void *mMemory{ nullptr };
+    size_t mMemorySize{ 0 };
+    CANSharedMemoryRingHeader *mHeader{ nullptr };
+    CANSharedMemoryFrame *mFrames{ nullptr };
+    // Local copy of the capacity, so that the other process can't make this one access memory out of bounds
+    uint32_t mCapacity{ 0 };
+};
+
+} // namespace IoTFleetWise
+} // namespace Aws
@@ -5,11 +5,13 @@
 
 #include "CANDataTypes.h"
 #include "EventTypes.h"
+#include "LockFreeQueue.h"
 #include "MessageTypes.h"
 #include "OBDDataTypes.h"
+#include "PayloadCompression.h"
+#include "SignalReduction.h"
 #include "SignalTypes.h"
-#include <mutex>
-#include <queue>
+#include <memory>
 #include <vector>
 
 namespace Aws
@@ -19,8 +21,7 @@ namespace IoTFleetWise
 
 struct ExpressionNode;
 
-static constexpr uint32_t MAX_NUMBER_OF_ACTIVE_CONDITION = 256; /**< More active conditions will be ignored */
-static constexpr uint32_t ALL_CONDITIONS = 0xFFFFFFFF;
+static constexpr uint32_t MAX_NUMBER_OF_ACTIVE_CONDITION = 10000; /**< More active conditions will be ignored */
 static constexpr uint32_t MAX_EQUATION_DEPTH =
     10; /**< If the AST of the expression is deeper than this value the equation is not accepted */
 static constexpr uint32_t MAX_DIFFERENT_SIGNAL_IDS =
@@ -36,6 +37,8 @@ struct PassThroughMetadata
 {
     bool compress{ false };
     bool persist{ false };
+    bool columnarSignalEncoding{ false };
+    CompressionOptions compressionOptions; /**< only used if compress is true */
     uint32_t priority{ 0 };
     std::string decoderID;
     std::string collectionSchemeID;
@@ -52,6 +55,7 @@ struct InspectionMatrixSignalCollectionInfo
                                        * of samples in the buffer only necessary for condition evaluation
                                        */
     SignalType signalType{ SignalType::DOUBLE };
+    SignalReduction reduction; /**< applied to the samples when they are collected */
 };
 
 struct InspectionMatrixCanFrameCollectionInfo
@@ -309,6 +313,65 @@ struct CollectedSignal
     }
 };
 
+/**
+ * @brief Samples of one signal that are referenced in the history buffer of the inspection engine instead of copied
+ *
+ * The slice keeps the segment of the history buffer alive that holds the samples. The engine never writes into a
+ * segment that is still referenced, it continues with a copy of the segment instead. So the samples do not change
+ * as long as the slice exists. Like for the collected signals the newest sample comes first.
+ */
+struct CollectedSignalSlice
+{
+    SignalID signalID{ INVALID_SIGNAL_ID };
+    SignalType type{ SignalType::DOUBLE };
+    std::shared_ptr<const void> segment; /**< owns the arrays of values and timestamps */
+    const void *values{ nullptr };       /**< array of the C++ type that matches type */
+    const Timestamp *timestamps{ nullptr };
+    uint32_t newestIndex{ 0 }; /**< index of the newest sample in both arrays, the older ones have lower indices */
+    uint32_t size{ 0 };
+
+    /**
+     * @brief Returns a sample of the slice
+     * @param i 0 for the newest sample, has to be smaller than size
+     */
+    CollectedSignal
+    getSample( uint32_t i ) const
+    {
+        auto index = newestIndex - i;
+        auto timestamp = timestamps[index];
+        switch ( type )
+        {
+        case SignalType::UINT8:
+            return CollectedSignal( signalID, timestamp, static_cast<const uint8_t *>( values )[index], type );
+        case SignalType::INT8:
+            return CollectedSignal( signalID, timestamp, static_cast<const int8_t *>( values )[index], type );
+        case SignalType::UINT16:
+            return CollectedSignal( signalID, timestamp, static_cast<const uint16_t *>( values )[index], type );
+        case SignalType::INT16:
+            return CollectedSignal( signalID, timestamp, static_cast<const int16_t *>( values )[index], type );
+        case SignalType::UINT32:
+            return CollectedSignal( signalID, timestamp, static_cast<const uint32_t *>( values )[index], type );
+        case SignalType::INT32:
+            return CollectedSignal( signalID, timestamp, static_cast<const int32_t *>( values )[index], type );
+        case SignalType::UINT64:
+            return CollectedSignal( signalID, timestamp, static_cast<const uint64_t *>( values )[index], type );
+        case SignalType::INT64:
+            return CollectedSignal( signalID, timestamp, static_cast<const int64_t *>( values )[index], type );
+        case SignalType::FLOAT:
+            return CollectedSignal( signalID, timestamp, static_cast<const float *>( values )[index], type );
+        case SignalType::DOUBLE:
+            return CollectedSignal( signalID, timestamp, static_cast<const double *>( values )[index], type );
+        case SignalType::BOOLEAN:
+            return CollectedSignal( signalID, timestamp, static_cast<const bool *>( values )[index], type );
+#ifdef FWE_FEATURE_VISION_SYSTEM_DATA
+        case SignalType::RAW_DATA_BUFFER_HANDLE:
+            return CollectedSignal( signalID, timestamp, static_cast<const uint32_t *>( values )[index], type );
+#endif
+        }
+        return CollectedSignal();
+    }
+};
+
 #ifdef FWE_FEATURE_VISION_SYSTEM_DATA
 enum class UploadedS3ObjectDataFormat
 {
@@ -348,69 +411,33 @@ struct CollectedDataFrame
     CollectedSignalsGroup mCollectedSignals;
     CollectedRawCanFramePtr mCollectedCanRawFrame;
     DTCInfoPtr mActiveDTCs;
+    /**
+     * Raw frame storage of an already consumed frame that the producer can fill again instead of allocating a new
+     * one. Never read by the consumer, see recycleQueueElement()
+     */
+    CollectedRawCanFramePtr mRecycledCanRawFrame;
 };
 
-// Thread-safe queue with mutex
-template <typename T>
-struct LockedQueue
+/**
+ * @brief Drops the content of a consumed data frame but keeps the signal vector capacity and the raw CAN frame
+ * storage, so that the producer that gets this frame back from the signal buffer can fill it without allocations.
+ */
+inline void
+recycleQueueElement( CollectedDataFrame &dataFrame )
 {
-public:
-    LockedQueue( size_t maxSize )
-        : mMaxSize( maxSize )
-    {
-    }
-    bool
-    push( const T &&element )
+    dataFrame.mCollectedSignals.clear();
+    // The raw frame can only be reused if nobody else holds a reference to it
+    if ( dataFrame.mCollectedCanRawFrame.use_count() == 1 )
     {
-        std::lock_guard<std::mutex> lock( mMutex );
-        if ( ( mQueue.size() + 1 ) > mMaxSize )
-        {
-            return false;
-        }
-        mQueue.push( element );
-        return true;
+        dataFrame.mRecycledCanRawFrame = std::move( dataFrame.mCollectedCanRawFrame );
     }
-    bool
-    pop( T &element )
-    {
-        std::lock_guard<std::mutex> lock( mMutex );
-        if ( mQueue.empty() )
-        {
-            return false;
-        }
-        element = mQueue.front();
-        mQueue.pop();
-        return true;
-    }
-    template <typename Functor>
-    size_t
-    consumeAll( const Functor &functor )
-    {
-        size_t consumed = 0;
-        T element;
-        while ( pop( element ) )
-        {
-            functor( element );
-            consumed++;
-        }
-        return consumed;
-    }
-    // coverity[misra_cpp_2008_rule_14_7_1_violation] Required in unit tests
-    bool
-    isEmpty()
-    {
-        std::lock_guard<std::mutex> lock( mMutex );
-        return mQueue.empty();
-    }
-
-private:
-    std::mutex mMutex;
-    size_t mMaxSize;
-    std::queue<T> mQueue;
-};
+    dataFrame.mCollectedCanRawFrame.reset();
+    dataFrame.mActiveDTCs.reset();
+}
 
-// Buffer that sends data to Collection Engine
-using SignalBuffer = LockedQueue<CollectedDataFrame>;
+// Buffer that sends data to Collection Engine. All data sources (CAN channels, OBD, custom sources, ...) push into it
+// from their own threads while only the inspection thread consumes it.
+using SignalBuffer = MpscQueue<CollectedDataFrame>;
 // Shared Pointer type to the buffer that sends data to Collection Engine
 using SignalBufferPtr = std::shared_ptr<SignalBuffer>;
 
@@ -420,6 +447,8 @@ struct TriggeredCollectionSchemeData
     PassThroughMetadata metadata;
     Timestamp triggerTime;
     std::vector<CollectedSignal> signals;
+    std::vector<CollectedSignalSlice> signalSlices; /**< samples collected without copying them, see
+                                                       CollectionInspectionEngine::setZeroCopySignalCollection() */
     std::vector<CollectedCanRawFrame> canFrames;
 #ifdef FWE_FEATURE_VISION_SYSTEM_DATA
     std::vector<UploadedS3Object> uploadedS3Objects;
@@ -429,7 +458,9 @@ struct TriggeredCollectionSchemeData
 };
 
 using TriggeredCollectionSchemeDataPtr = std::shared_ptr<const TriggeredCollectionSchemeData>;
-using CollectedDataReadyToPublish = LockedQueue<TriggeredCollectionSchemeDataPtr>;
+// All inspection engine shards push into this queue, and with vision system data also the S3 upload completion
+// callbacks. Only the data sender thread consumes.
+using CollectedDataReadyToPublish = MpscQueue<TriggeredCollectionSchemeDataPtr>;
 
 } // namespace IoTFleetWise
 } // namespace Aws
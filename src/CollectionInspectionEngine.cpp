@@ -4,6 +4,7 @@
 #include "CollectionInspectionEngine.h"
 #include "TraceModule.h"
 #include <algorithm>
+#include <array>
 #include <cstdlib>
 
 namespace Aws
@@ -11,10 +12,12 @@ namespace Aws
 namespace IoTFleetWise
 {
 
+constexpr size_t CollectionInspectionEngine::NUMBER_OF_WINDOW_QUANTILES; // NOLINT
+constexpr uint32_t CollectionInspectionEngine::SAMPLES_PER_SEGMENT;       // NOLINT
+
 CollectionInspectionEngine::CollectionInspectionEngine( bool sendDataOnlyOncePerCondition )
     : mSendDataOnlyOncePerCondition( sendDataOnlyOncePerCondition )
 {
-    setActiveDTCsConsumed( ALL_CONDITIONS, false );
 }
 
 bool
@@ -41,16 +44,14 @@ template <typename T>
 void
 CollectionInspectionEngine::addSignalToBuffer( const InspectionMatrixSignalCollectionInfo &signalIn )
 {
-    std::vector<SignalHistoryBuffer<T>> *signalHistoryBufferPtr = nullptr;
-    const auto signalIDIn = signalIn.signalID;
-
-    signalHistoryBufferPtr = getSignalHistoryBufferPtr<T>( signalIDIn );
-
-    if ( signalHistoryBufferPtr == nullptr )
+    auto &store = getSignalHistoryBufferStore<T>();
+    // The next dense index is used if the signal has no buffers yet
+    auto index = store.mIndices.emplace( signalIn.signalID, static_cast<uint32_t>( store.mBuffers.size() ) );
+    if ( index.second )
     {
-        return;
+        store.mBuffers.emplace_back();
     }
-    auto &bufferVec = *signalHistoryBufferPtr;
+    auto &bufferVec = store.mBuffers[index.first->second];
     for ( auto &buffer : bufferVec )
     {
         if ( buffer.mMinimumSampleIntervalMs == signalIn.minimumSampleIntervalMs )
@@ -78,7 +79,12 @@ CollectionInspectionEngine::onChangeInspectionMatrix( const std::shared_ptr<cons
     clear();
     mActiveInspectionMatrix = inspectionMatrix; // Pointers and references into this memory are maintained so hold
                                                 // a shared_ptr to it so it does not get deleted
-    mConditionsNotTriggeredWaitingPublished.set();
+    auto numberOfConditions = std::min( mActiveInspectionMatrix->conditions.size(),
+                                        static_cast<size_t>( MAX_NUMBER_OF_ACTIVE_CONDITION ) );
+    mConditions.reserve( numberOfConditions );
+    mConditionsWithInputSignalChanged.resize( numberOfConditions, false );
+    mConditionsWithConditionCurrentlyTrue.resize( numberOfConditions, false );
+    mConditionsNotTriggeredWaitingPublished.resize( numberOfConditions, true );
     for ( auto &p : mActiveInspectionMatrix->conditions )
     {
         // Check if we can add an additional condition to mConditions
@@ -116,7 +122,12 @@ CollectionInspectionEngine::onChangeInspectionMatrix( const std::shared_ptr<cons
                 return;
             }
             auto signalIDIn = s.signalID;
-            mSignalToBufferTypeMap.insert( { signalIDIn, s.signalType } );
+            if ( mSignalToBufferTypeMap.insert( { signalIDIn, s.signalType } ).first->second != s.signalType )
+            {
+                FWE_LOG_WARN( "Signal " + std::to_string( signalIDIn ) +
+                              " is used with different types, only the first type is collected" );
+                continue;
+            }
             switch ( s.signalType )
             {
             case SignalType::UINT8:
@@ -183,53 +194,79 @@ CollectionInspectionEngine::onChangeInspectionMatrix( const std::shared_ptr<cons
     for ( size_t conditionIndex = 0; conditionIndex < mConditions.size(); conditionIndex++ )
     {
         auto &ac = mConditions[conditionIndex];
+        ac.mIndex = static_cast<uint32_t>( conditionIndex );
         for ( auto &s : ac.mCondition.signals )
         {
             switch ( s.signalType )
             {
             case SignalType::UINT8:
-                updateConditionBuffer<uint8_t>( s, ac, conditionIndex );
+                updateConditionBuffer<uint8_t>( s, ac );
                 break;
             case SignalType::INT8:
-                updateConditionBuffer<int8_t>( s, ac, conditionIndex );
+                updateConditionBuffer<int8_t>( s, ac );
                 break;
             case SignalType::UINT16:
-                updateConditionBuffer<uint16_t>( s, ac, conditionIndex );
+                updateConditionBuffer<uint16_t>( s, ac );
                 break;
             case SignalType::INT16:
-                updateConditionBuffer<int16_t>( s, ac, conditionIndex );
+                updateConditionBuffer<int16_t>( s, ac );
                 break;
             case SignalType::UINT32:
-                updateConditionBuffer<uint32_t>( s, ac, conditionIndex );
+                updateConditionBuffer<uint32_t>( s, ac );
                 break;
             case SignalType::INT32:
-                updateConditionBuffer<int32_t>( s, ac, conditionIndex );
+                updateConditionBuffer<int32_t>( s, ac );
                 break;
             case SignalType::UINT64:
-                updateConditionBuffer<uint64_t>( s, ac, conditionIndex );
+                updateConditionBuffer<uint64_t>( s, ac );
                 break;
             case SignalType::INT64:
-                updateConditionBuffer<int64_t>( s, ac, conditionIndex );
+                updateConditionBuffer<int64_t>( s, ac );
                 break;
             case SignalType::FLOAT:
-                updateConditionBuffer<float>( s, ac, conditionIndex );
+                updateConditionBuffer<float>( s, ac );
                 break;
             case SignalType::DOUBLE:
-                updateConditionBuffer<double>( s, ac, conditionIndex );
+                updateConditionBuffer<double>( s, ac );
                 break;
             case SignalType::BOOLEAN:
-                updateConditionBuffer<bool>( s, ac, conditionIndex );
+                updateConditionBuffer<bool>( s, ac );
                 break;
             default:
                 break;
             }
         }
+        // All signals and windows used by the condition are known now
+        ac.mCompileResult = compileExpression( ac.mCondition.condition, ac, MAX_EQUATION_DEPTH );
+        if ( ac.mCompileResult != ExpressionErrorCode::SUCCESSFUL )
+        {
+            ac.mInstructions.clear();
+            ac.mSegments.clear();
+        }
+        ac.mChangedSegments = std::numeric_limits<uint64_t>::max();
         // Overwrite last trigger time 0 with current time to avoid trigger at time 0
         ac.mLastTrigger = currentTime;
     }
 
     // Assume all conditions are currently true;
     mConditionsWithConditionCurrentlyTrue.set();
+    for ( uint32_t i = 0; i < mConditions.size(); i++ )
+    {
+        mCurrentlyTrueConditions.push_back( i );
+    }
+
+    // All windows are due immediately, so that they start with the next evaluation or their first sample
+    scheduleFixedWindows<uint8_t>();
+    scheduleFixedWindows<int8_t>();
+    scheduleFixedWindows<uint16_t>();
+    scheduleFixedWindows<int16_t>();
+    scheduleFixedWindows<uint32_t>();
+    scheduleFixedWindows<int32_t>();
+    scheduleFixedWindows<uint64_t>();
+    scheduleFixedWindows<int64_t>();
+    scheduleFixedWindows<float>();
+    scheduleFixedWindows<double>();
+    scheduleFixedWindows<bool>();
 
     (void)preAllocateBuffers();
 }
@@ -238,8 +275,7 @@ template <typename T>
 void
 CollectionInspectionEngine::updateConditionBuffer(
     const InspectionMatrixSignalCollectionInfo &inspectionMatrixCollectionInfoIn,
-    ActiveCondition &acIn,
-    const long unsigned int conditionIndexIn )
+    ActiveCondition &acIn )
 {
     SignalID signalIDIn = inspectionMatrixCollectionInfoIn.signalID;
     SignalHistoryBuffer<T> *buf = nullptr;
@@ -261,7 +297,6 @@ CollectionInspectionEngine::updateConditionBuffer(
     }
     if ( ( buf != nullptr ) && isSignalPartOfEval( acIn.mCondition.condition, signalIDIn, MAX_EQUATION_DEPTH ) )
     {
-        buf->mConditionsThatEvaluateOnThisSignal.set( conditionIndexIn );
         // acIn.mEvaluationSignals[signalIDIn] = buf;
         acIn.mEvaluationSignals.insert( { signalIDIn, buf } );
         FixedTimeWindowFunctionData<T> *window =
@@ -276,23 +311,28 @@ CollectionInspectionEngine::updateConditionBuffer(
 
 template <typename T>
 bool
-CollectionInspectionEngine::allocateBufferVector( SignalID signalIDIn, uint32_t &usedBytes )
+CollectionInspectionEngine::allocateBufferVectors( uint32_t &usedBytes )
 {
-    std::vector<SignalHistoryBuffer<T>> *signalHistoryBufferPtr = nullptr;
-    signalHistoryBufferPtr = getSignalHistoryBufferPtr<T>( signalIDIn );
-
-    if ( signalHistoryBufferPtr != nullptr )
+    for ( auto &bufferVec : getSignalHistoryBufferStore<T>().mBuffers )
     {
-        auto &bufferVec = *signalHistoryBufferPtr;
         for ( auto &signal : bufferVec )
         {
-            uint64_t requiredBytes = signal.mSize * static_cast<uint64_t>( sizeof( struct SignalSample<T> ) );
-            if ( usedBytes + requiredBytes > MAX_SAMPLE_MEMORY )
+            uint64_t requiredBytes =
+                signal.mSize * static_cast<uint64_t>( sizeof( T ) + sizeof( InspectionTimestamp ) );
+            // The sliding windows keep as many samples as the buffer
+            for ( auto &window : signal.mWindowFunctionData )
+            {
+                if ( window.mSlidingWindowEnabled )
+                {
+                    requiredBytes += signal.mSize * static_cast<uint64_t>( SlidingWindowStatistics::BYTES_PER_VALUE );
+                }
+            }
+            if ( usedBytes + requiredBytes > mMaxSampleMemory )
             {
                 FWE_LOG_WARN( "The requested " + std::to_string( signal.mSize ) +
                               " number of signal samples leads to a memory requirement  that's above the maximum "
                               "configured of " +
-                              std::to_string( MAX_SAMPLE_MEMORY ) + "Bytes" );
+                              std::to_string( mMaxSampleMemory ) + "Bytes" );
                 signal.mSize = 0;
                 TraceModule::get().incrementAtomicVariable( TraceAtomicVariable::COLLECTION_SCHEME_ERROR );
                 return false;
@@ -300,7 +340,14 @@ CollectionInspectionEngine::allocateBufferVector( SignalID signalIDIn, uint32_t
             usedBytes += static_cast<uint32_t>( requiredBytes );
 
             // reserve the size like new[]
-            signal.mBuffer.resize( signal.mSize );
+            signal.allocate();
+            for ( auto &window : signal.mWindowFunctionData )
+            {
+                if ( window.mSlidingWindowEnabled )
+                {
+                    window.mSlidingWindow.init( signal.mSize, window.mWindowSizeMs );
+                }
+            }
         }
     }
     return true;
@@ -313,104 +360,25 @@ CollectionInspectionEngine::preAllocateBuffers()
     uint32_t usedBytes = 0;
 
     // Allocate Signal Buffer
-    for ( auto &bufferVector : mSignalBuffers )
+    if ( ( !allocateBufferVectors<uint8_t>( usedBytes ) ) || ( !allocateBufferVectors<int8_t>( usedBytes ) ) ||
+         ( !allocateBufferVectors<uint16_t>( usedBytes ) ) || ( !allocateBufferVectors<int16_t>( usedBytes ) ) ||
+         ( !allocateBufferVectors<uint32_t>( usedBytes ) ) || ( !allocateBufferVectors<int32_t>( usedBytes ) ) ||
+         ( !allocateBufferVectors<uint64_t>( usedBytes ) ) || ( !allocateBufferVectors<int64_t>( usedBytes ) ) ||
+         ( !allocateBufferVectors<float>( usedBytes ) ) || ( !allocateBufferVectors<double>( usedBytes ) ) ||
+         ( !allocateBufferVectors<bool>( usedBytes ) ) )
     {
-        auto signalID = bufferVector.first;
-        if ( mSignalToBufferTypeMap.find( signalID ) != mSignalToBufferTypeMap.end() )
-        {
-            auto signalType = mSignalToBufferTypeMap[signalID];
-            switch ( signalType )
-            {
-            case SignalType::UINT8:
-                if ( !allocateBufferVector<uint8_t>( signalID, usedBytes ) )
-                {
-                    return false;
-                }
-                break;
-            case SignalType::INT8:
-                if ( !allocateBufferVector<int8_t>( signalID, usedBytes ) )
-                {
-                    return false;
-                }
-                break;
-            case SignalType::UINT16:
-                if ( !allocateBufferVector<uint16_t>( signalID, usedBytes ) )
-                {
-                    return false;
-                }
-                break;
-            case SignalType::INT16:
-                if ( !allocateBufferVector<int16_t>( signalID, usedBytes ) )
-                {
-                    return false;
-                }
-                break;
-            case SignalType::UINT32:
-                if ( !allocateBufferVector<uint32_t>( signalID, usedBytes ) )
-                {
-                    return false;
-                }
-                break;
-            case SignalType::INT32:
-                if ( !allocateBufferVector<int32_t>( signalID, usedBytes ) )
-                {
-                    return false;
-                }
-                break;
-            case SignalType::UINT64:
-                if ( !allocateBufferVector<uint64_t>( signalID, usedBytes ) )
-                {
-                    return false;
-                }
-                break;
-            case SignalType::INT64:
-                if ( !allocateBufferVector<int64_t>( signalID, usedBytes ) )
-                {
-                    return false;
-                }
-                break;
-            case SignalType::FLOAT:
-                if ( !allocateBufferVector<float>( signalID, usedBytes ) )
-                {
-                    return false;
-                }
-                break;
-            case SignalType::DOUBLE:
-                if ( !allocateBufferVector<double>( signalID, usedBytes ) )
-                {
-                    return false;
-                }
-                break;
-            case SignalType::BOOLEAN:
-                if ( !allocateBufferVector<bool>( signalID, usedBytes ) )
-                {
-                    return false;
-                }
-                break;
-#ifdef FWE_FEATURE_VISION_SYSTEM_DATA
-            case SignalType::RAW_DATA_BUFFER_HANDLE:
-                if ( !allocateBufferVector<RawData::BufferHandle>( signalID, usedBytes ) )
-                {
-                    return false;
-                }
-                break;
-#endif
-            default:
-                FWE_LOG_WARN( "Unknown type :" + std::to_string( static_cast<uint32_t>( signalType ) ) );
-                break;
-            }
-        }
+        return false;
     }
     // Allocate Can buffer
     for ( auto &buf : mCanFrameBuffers )
     {
         uint64_t requiredBytes = buf.mSize * static_cast<uint64_t>( sizeof( struct CanFrameSample ) );
-        if ( usedBytes + requiredBytes > MAX_SAMPLE_MEMORY )
+        if ( usedBytes + requiredBytes > mMaxSampleMemory )
         {
             FWE_LOG_WARN( "The requested " + std::to_string( buf.mSize ) +
                           " number of CAN raw samples leads to a memory requirement  that's above the maximum "
                           "configured of" +
-                          std::to_string( MAX_SAMPLE_MEMORY ) + "Bytes" );
+                          std::to_string( mMaxSampleMemory ) + "Bytes" );
             buf.mSize = 0;
             return false;
         }
@@ -426,15 +394,18 @@ CollectionInspectionEngine::preAllocateBuffers()
 void
 CollectionInspectionEngine::clear()
 {
-    mSignalBuffers.clear();
+    mSignalBuffers = SignalHistoryBufferCollection();
     mSignalToBufferTypeMap.clear();
     mCanFrameBuffers.clear();
     mConditions.clear();
     mNextConditionToCollectedIndex = 0;
     mNextWindowFunctionTimesOut = 0;
-    mConditionsWithInputSignalChanged.reset();
-    mConditionsWithConditionCurrentlyTrue.reset();
-    mConditionsNotTriggeredWaitingPublished.reset();
+    mFixedWindowTimeouts = FixedWindowTimeoutQueue();
+    mConditionsWithInputSignalChanged.clear();
+    mConditionsWithConditionCurrentlyTrue.clear();
+    mConditionsNotTriggeredWaitingPublished.clear();
+    mChangedConditions.clear();
+    mCurrentlyTrueConditions.clear();
 #ifdef FWE_FEATURE_VISION_SYSTEM_DATA
     if ( mRawBufferManager != nullptr )
     {
@@ -444,93 +415,55 @@ CollectionInspectionEngine::clear()
 #endif
 }
 
+template <typename T>
+bool
+CollectionInspectionEngine::updateFixedWindow( void *window,
+                                               InspectionTimestamp timestamp,
+                                               InspectionTimestamp &nextWindowFunctionTimesOut )
+{
+    return static_cast<FixedTimeWindowFunctionData<T> *>( window )->updateWindow( timestamp,
+                                                                                   nextWindowFunctionTimesOut );
+}
+
 template <typename T>
 void
-CollectionInspectionEngine::updateBufferFixedWindowFunction( SignalID signalIDIn, InspectionTimestamp timestamp )
+CollectionInspectionEngine::scheduleFixedWindows()
 {
-    std::vector<SignalHistoryBuffer<T>> *signalHistoryBufferPtr = nullptr;
-    try
-    {
-        if ( mSignalBuffers.find( signalIDIn ) != mSignalBuffers.end() )
-        {
-            auto &mapVal = mSignalBuffers.at( signalIDIn );
-            signalHistoryBufferPtr = boost::get<std::vector<SignalHistoryBuffer<T>>>( &mapVal );
-        }
-    }
-    catch ( ... )
-    {
-        FWE_LOG_ERROR( "Failed to retrieve signalHistoryBuffer vector for signal ID " + std::to_string( signalIDIn ) );
-        return;
-    }
-    if ( signalHistoryBufferPtr != nullptr )
+    for ( auto &bufferVec : getSignalHistoryBufferStore<T>().mBuffers )
     {
-        auto &bufferVec = *signalHistoryBufferPtr;
         for ( auto &signal : bufferVec )
         {
             for ( auto &functionWindow : signal.mWindowFunctionData )
             {
-                bool changed = functionWindow.updateWindow( timestamp, mNextWindowFunctionTimesOut );
-                if ( changed )
-                {
-                    mConditionsWithInputSignalChanged |= signal.mConditionsThatEvaluateOnThisSignal;
-                }
+                FixedWindowTimeout timeout;
+                timeout.mTimeout = 0;
+                timeout.mWindow = &functionWindow;
+                timeout.mUpdateWindow = &updateFixedWindow<T>;
+                timeout.mDependentConditions = &functionWindow.mDependentConditions;
+                mFixedWindowTimeouts.push( timeout );
             }
         }
     }
 }
 
 void
-CollectionInspectionEngine::updateAllFixedWindowFunctions( InspectionTimestamp timestamp )
+CollectionInspectionEngine::updateExpiredFixedWindowFunctions( InspectionTimestamp timestamp )
 {
-    mNextWindowFunctionTimesOut = std::numeric_limits<InspectionTimestamp>::max();
-    for ( auto &signalVector : mSignalBuffers )
+    while ( ( !mFixedWindowTimeouts.empty() ) && ( mFixedWindowTimeouts.top().mTimeout <= timestamp ) )
     {
-        auto signalID = signalVector.first;
-        if ( mSignalToBufferTypeMap.find( signalID ) != mSignalToBufferTypeMap.end() )
+        auto timeout = mFixedWindowTimeouts.top();
+        mFixedWindowTimeouts.pop();
+        // A window that a new sample already rolled over does not change, it only gets its real timeout
+        InspectionTimestamp nextTimeout = std::numeric_limits<InspectionTimestamp>::max();
+        if ( timeout.mUpdateWindow( timeout.mWindow, timestamp, nextTimeout ) )
         {
-
-            auto signalType = mSignalToBufferTypeMap[signalID];
-            switch ( signalType )
-            {
-            case SignalType::UINT8:
-                updateBufferFixedWindowFunction<uint8_t>( signalID, timestamp );
-                break;
-            case SignalType::INT8:
-                updateBufferFixedWindowFunction<int8_t>( signalID, timestamp );
-                break;
-            case SignalType::UINT16:
-                updateBufferFixedWindowFunction<uint16_t>( signalID, timestamp );
-                break;
-            case SignalType::INT16:
-                updateBufferFixedWindowFunction<int16_t>( signalID, timestamp );
-                break;
-            case SignalType::UINT32:
-                updateBufferFixedWindowFunction<uint32_t>( signalID, timestamp );
-                break;
-            case SignalType::INT32:
-                updateBufferFixedWindowFunction<int32_t>( signalID, timestamp );
-                break;
-            case SignalType::UINT64:
-
-                updateBufferFixedWindowFunction<uint64_t>( signalID, timestamp );
-                break;
-            case SignalType::INT64:
-                updateBufferFixedWindowFunction<int64_t>( signalID, timestamp );
-                break;
-            case SignalType::FLOAT:
-                updateBufferFixedWindowFunction<float>( signalID, timestamp );
-                break;
-            case SignalType::DOUBLE:
-                updateBufferFixedWindowFunction<double>( signalID, timestamp );
-                break;
-            case SignalType::BOOLEAN:
-                updateBufferFixedWindowFunction<bool>( signalID, timestamp );
-                break;
-            default:
-                break;
-            }
+            markConditionsChanged( *timeout.mDependentConditions );
         }
+        timeout.mTimeout = nextTimeout;
+        mFixedWindowTimeouts.push( timeout );
     }
+    mNextWindowFunctionTimesOut = mFixedWindowTimeouts.empty() ? std::numeric_limits<InspectionTimestamp>::max()
+                                                                : mFixedWindowTimeouts.top().mTimeout;
 }
 
 bool
@@ -540,49 +473,76 @@ CollectionInspectionEngine::evaluateConditions( const TimePoint &currentTime )
     // if any sampling window times out there is a new value available to be processed by a condition
     if ( currentTime.monotonicTimeMs >= mNextWindowFunctionTimesOut )
     {
-        updateAllFixedWindowFunctions( currentTime.monotonicTimeMs );
+        updateExpiredFixedWindowFunctions( currentTime.monotonicTimeMs );
     }
-    auto conditionsToEvaluate = ( mConditionsWithConditionCurrentlyTrue | mConditionsWithInputSignalChanged ) &
-                                mConditionsNotTriggeredWaitingPublished;
-    if ( conditionsToEvaluate.none() )
+    // Conditions that wait for their data to be published are neither evaluated nor lose their changed state. The
+    // evaluated conditions are removed from the lists and added again depending on the result.
+    mConditionsToEvaluate.clear();
+    size_t kept = 0;
+    for ( auto i : mCurrentlyTrueConditions )
     {
-        // No conditions to evaluate
-        return false;
+        if ( mConditionsNotTriggeredWaitingPublished.test( i ) )
+        {
+            mConditionsToEvaluate.push_back( i );
+        }
+        else
+        {
+            mCurrentlyTrueConditions[kept++] = i;
+        }
     }
-    // faster implementation like find next bit set to one would be possible but for example
-    // conditionsToEvaluate._Find_first is not part of C++ standard
-    for ( uint32_t i = 0; i < mConditions.size(); i++ )
+    mCurrentlyTrueConditions.resize( kept );
+    kept = 0;
+    for ( auto i : mChangedConditions )
     {
-        if ( conditionsToEvaluate.test( i ) )
+        if ( mConditionsNotTriggeredWaitingPublished.test( i ) )
         {
-            ActiveCondition &condition = mConditions[i];
-            InspectionValue result = 0;
-            bool resultBool = false;
             mConditionsWithInputSignalChanged.reset( i );
-            ExpressionErrorCode ret =
-                eval( condition.mCondition.condition, condition, result, resultBool, MAX_EQUATION_DEPTH );
-            if ( ( ret == ExpressionErrorCode::SUCCESSFUL ) && resultBool )
+            // Conditions that are currently true are already in the list
+            if ( !mConditionsWithConditionCurrentlyTrue.test( i ) )
             {
-                // Only evaluate condition to true if minimumPublishIntervalMs has passed
-                if ( currentTime.monotonicTimeMs >=
-                     condition.mLastTrigger.monotonicTimeMs + condition.mCondition.minimumPublishIntervalMs )
+                mConditionsToEvaluate.push_back( i );
+            }
+        }
+        else
+        {
+            mChangedConditions[kept++] = i;
+        }
+    }
+    mChangedConditions.resize( kept );
+
+    for ( auto i : mConditionsToEvaluate )
+    {
+        ActiveCondition &condition = mConditions[i];
+        InspectionValue result = 0;
+        bool resultBool = false;
+        ExpressionErrorCode ret = eval( condition, result, resultBool );
+        if ( ( ret == ExpressionErrorCode::SUCCESSFUL ) && resultBool )
+        {
+            // Only evaluate condition to true if minimumPublishIntervalMs has passed
+            if ( currentTime.monotonicTimeMs >=
+                 condition.mLastTrigger.monotonicTimeMs + condition.mCondition.minimumPublishIntervalMs )
+            {
+                if ( ( !condition.mCondition.triggerOnlyOnRisingEdge ) ||
+                     ( !mConditionsWithConditionCurrentlyTrue.test( i ) ) )
                 {
-                    if ( ( !condition.mCondition.triggerOnlyOnRisingEdge ) ||
-                         ( !mConditionsWithConditionCurrentlyTrue.test( i ) ) )
-                    {
-                        // Mark condition for the upload
-                        mConditionsNotTriggeredWaitingPublished.reset( i );
-                        condition.mLastTrigger = currentTime;
-                    }
-                    mConditionsWithConditionCurrentlyTrue.set( i );
-                    oneConditionIsTrue = true;
+                    // Mark condition for the upload
+                    mConditionsNotTriggeredWaitingPublished.reset( i );
+                    condition.mLastTrigger = currentTime;
                 }
+                mConditionsWithConditionCurrentlyTrue.set( i );
+                mCurrentlyTrueConditions.push_back( i );
+                oneConditionIsTrue = true;
             }
-            else
+            else if ( mConditionsWithConditionCurrentlyTrue.test( i ) )
             {
-                mConditionsWithConditionCurrentlyTrue.reset( i );
+                // Keep the state until the interval passed
+                mCurrentlyTrueConditions.push_back( i );
             }
         }
+        else
+        {
+            mConditionsWithConditionCurrentlyTrue.reset( i );
+        }
     }
     return oneConditionIsTrue;
 }
@@ -592,21 +552,16 @@ void
 CollectionInspectionEngine::collectLastSignals( InspectionSignalID id,
                                                 uint32_t minimumSamplingInterval,
                                                 uint32_t maxNumberOfSignalsToCollect,
-                                                uint32_t conditionId,
+                                                uint32_t &collectedCounter,
                                                 SignalType signalTypeIn,
+                                                const SignalReduction &reduction,
                                                 InspectionTimestamp &newestSignalTimestamp,
-                                                std::vector<CollectedSignal> &output )
+                                                TriggeredCollectionSchemeData &output )
 {
-    if ( mSignalBuffers[id].empty() )
-    {
-        // Signal not collected by any active condition
-        return;
-    }
-    std::vector<SignalHistoryBuffer<T>> *signalHistoryBufferPtr = nullptr;
-    signalHistoryBufferPtr = getSignalHistoryBufferPtr<T>( id );
+    auto *signalHistoryBufferPtr = getSignalHistoryBufferPtr<T>( id );
     if ( signalHistoryBufferPtr == nullptr )
     {
-        // Access by Invalid DataType
+        // Signal not collected by any active condition
         return;
     }
     auto &bufferVec = *signalHistoryBufferPtr;
@@ -614,6 +569,33 @@ CollectionInspectionEngine::collectLastSignals( InspectionSignalID id,
     {
         if ( ( buf.mMinimumSampleIntervalMs == minimumSamplingInterval ) && ( buf.mSize > 0 ) )
         {
+            // Samples are collected from the newest to the oldest, so the ones not collected by this condition yet
+            // come first. The difference stays correct when the counters wrap around.
+            uint32_t notCollectedSamples = mSendDataOnlyOncePerCondition ? ( buf.mCounter - collectedCounter )
+                                                                         : std::numeric_limits<uint32_t>::max();
+            collectedCounter = buf.mCounter;
+            bool reduce = reduction.type != SignalReductionType::NONE;
+#ifdef FWE_FEATURE_VISION_SYSTEM_DATA
+            // Raw data handles are references and can not be reduced
+            reduce = reduce && ( signalTypeIn != SignalType::RAW_DATA_BUFFER_HANDLE );
+#endif
+            bool zeroCopy = mZeroCopySignalCollection && ( !reduce );
+#ifdef FWE_FEATURE_VISION_SYSTEM_DATA
+            // The usage of each raw data handle has to be tracked, so they are always copied
+            zeroCopy = zeroCopy && ( signalTypeIn != SignalType::RAW_DATA_BUFFER_HANDLE );
+#endif
+            if ( zeroCopy )
+            {
+                collectSignalSlices( buf,
+                                     id,
+                                     signalTypeIn,
+                                     std::min( maxNumberOfSignalsToCollect, buf.mCounter ),
+                                     notCollectedSamples,
+                                     newestSignalTimestamp,
+                                     output.signalSlices );
+                return;
+            }
+            mReductionPositions.clear();
             int pos = static_cast<int>( buf.mCurrentPosition );
             for ( uint32_t i = 0; i < std::min( maxNumberOfSignalsToCollect, buf.mCounter ); i++ )
             {
@@ -626,11 +608,15 @@ CollectionInspectionEngine::collectLastSignals( InspectionSignalID id,
                 {
                     pos = 0;
                 }
-                auto &sample = buf.mBuffer[static_cast<uint32_t>( pos )];
-                if ( ( !sample.isAlreadyConsumed( conditionId ) ) || ( !mSendDataOnlyOncePerCondition ) )
+                auto timestamp = buf.getTimestamp( static_cast<uint32_t>( pos ) );
+                if ( ( i < notCollectedSamples ) && reduce )
+                {
+                    mReductionPositions.push_back( static_cast<uint32_t>( pos ) );
+                }
+                else if ( i < notCollectedSamples )
                 {
-                    output.emplace_back( id, sample.mTimestamp, sample.mValue, signalTypeIn );
-                    sample.setAlreadyConsumed( conditionId, true );
+                    T value = buf.getValue( static_cast<uint32_t>( pos ) );
+                    output.signals.emplace_back( id, timestamp, value, signalTypeIn );
 #ifdef FWE_FEATURE_VISION_SYSTEM_DATA
                     if ( signalTypeIn == SignalType::RAW_DATA_BUFFER_HANDLE )
                     {
@@ -638,24 +624,84 @@ CollectionInspectionEngine::collectLastSignals( InspectionSignalID id,
                             id,
                             mRawBufferManager.get(),
                             RawData::BufferHandleUsageStage::COLLECTION_INSPECTION_ENGINE_SELECTED_FOR_UPLOAD,
-                            sample.mValue );
+                            value );
                     }
 #endif
                 }
-                newestSignalTimestamp = std::max( newestSignalTimestamp, sample.mTimestamp );
+                newestSignalTimestamp = std::max( newestSignalTimestamp, timestamp );
                 pos--;
             }
+            if ( reduce )
+            {
+                // The positions are ordered from the newest to the oldest sample, the reduction expects the opposite
+                auto count = mReductionPositions.size();
+                mReductionTimestamps.resize( count );
+                mReductionValues.resize( count );
+                for ( size_t j = 0; j < count; j++ )
+                {
+                    auto position = mReductionPositions[count - 1 - j];
+                    mReductionTimestamps[j] = buf.getTimestamp( position );
+                    mReductionValues[j] = static_cast<double>( buf.getValue( position ) );
+                }
+                reduceSignalSamples( reduction, mReductionTimestamps, mReductionValues, mReductionKeptIndices );
+                for ( auto it = mReductionKeptIndices.rbegin(); it != mReductionKeptIndices.rend(); it++ )
+                {
+                    auto position = mReductionPositions[count - 1 - *it];
+                    output.signals.emplace_back(
+                        id, buf.getTimestamp( position ), buf.getValue( position ), signalTypeIn );
+                }
+            }
             return;
         }
     }
 }
 
+template <typename T>
+void
+CollectionInspectionEngine::collectSignalSlices( const SignalHistoryBuffer<T> &buf,
+                                                 InspectionSignalID id,
+                                                 SignalType signalType,
+                                                 uint32_t numberOfSamples,
+                                                 uint32_t notCollectedSamples,
+                                                 InspectionTimestamp &newestSignalTimestamp,
+                                                 std::vector<CollectedSignalSlice> &output )
+{
+    numberOfSamples = std::min( numberOfSamples, buf.mSize );
+    uint32_t position = buf.mCurrentPosition;
+    uint32_t i = 0;
+    while ( i < numberOfSamples )
+    {
+        // Going back from the position the samples are contiguous until the beginning of the segment
+        const auto &segment = buf.mSegments[position / SAMPLES_PER_SEGMENT];
+        uint32_t newestIndex = position % SAMPLES_PER_SEGMENT;
+        uint32_t runSize = std::min( numberOfSamples - i, newestIndex + 1 );
+        const auto *timestamps = segment->mTimestamps.get();
+        const auto *runEnd = timestamps + newestIndex + 1;
+        newestSignalTimestamp = std::max( newestSignalTimestamp, *std::max_element( runEnd - runSize, runEnd ) );
+        if ( i < notCollectedSamples )
+        {
+            CollectedSignalSlice slice;
+            slice.signalID = id;
+            slice.type = signalType;
+            slice.segment = segment;
+            slice.values = segment->mValues.get();
+            slice.timestamps = timestamps;
+            slice.newestIndex = newestIndex;
+            slice.size = std::min( runSize, notCollectedSamples - i );
+            output.push_back( std::move( slice ) );
+        }
+        i += runSize;
+        // After the first sample of the buffer continue with the last one
+        position = ( position >= runSize ) ? ( position - runSize ) : ( buf.mSize - 1 );
+    }
+}
+
 void
 CollectionInspectionEngine::collectLastCanFrames( CANRawFrameID canID,
                                                   CANChannelNumericID channelID,
                                                   uint32_t minimumSamplingInterval,
                                                   uint32_t maxNumberOfSignalsToCollect,
-                                                  uint32_t conditionId,
+                                                  uint32_t &collectedCounter,
                                                   InspectionTimestamp &newestSignalTimestamp,
                                                   std::vector<CollectedCanRawFrame> &output )
 {
@@ -664,6 +710,10 @@ CollectionInspectionEngine::collectLastCanFrames( CANRawFrameID canID,
         if ( ( buf.mFrameID == canID ) && ( buf.mChannelID == channelID ) &&
              ( buf.mMinimumSampleIntervalMs == minimumSamplingInterval ) )
         {
+            // Like for signals, the frames not collected by this condition yet come first
+            uint32_t notCollectedFrames = mSendDataOnlyOncePerCondition ? ( buf.mCounter - collectedCounter )
+                                                                        : std::numeric_limits<uint32_t>::max();
+            collectedCounter = buf.mCounter;
             int pos = static_cast<int>( buf.mCurrentPosition );
             for ( uint32_t i = 0; i < std::min( maxNumberOfSignalsToCollect, buf.mCounter ); i++ )
             {
@@ -677,10 +727,9 @@ CollectionInspectionEngine::collectLastCanFrames( CANRawFrameID canID,
                     pos = 0;
                 }
                 auto &sample = buf.mBuffer[static_cast<uint32_t>( pos )];
-                if ( ( !sample.isAlreadyConsumed( conditionId ) ) || ( !mSendDataOnlyOncePerCondition ) )
+                if ( i < notCollectedFrames )
                 {
                     output.emplace_back( canID, channelID, sample.mTimestamp, sample.mBuffer, sample.mSize );
-                    sample.setAlreadyConsumed( conditionId, true );
                 }
                 newestSignalTimestamp = std::max( newestSignalTimestamp, sample.mTimestamp );
                 pos--;
@@ -691,16 +740,15 @@ CollectionInspectionEngine::collectLastCanFrames( CANRawFrameID canID,
 }
 
 std::shared_ptr<const TriggeredCollectionSchemeData>
-CollectionInspectionEngine::collectData( ActiveCondition &condition,
-                                         uint32_t conditionId,
-                                         InspectionTimestamp &newestSignalTimestamp )
+CollectionInspectionEngine::collectData( ActiveCondition &condition, InspectionTimestamp &newestSignalTimestamp )
 {
     std::shared_ptr<TriggeredCollectionSchemeData> collectedData = std::make_shared<TriggeredCollectionSchemeData>();
     collectedData->metadata = condition.mCondition.metadata;
     collectedData->triggerTime = condition.mLastTrigger.systemTimeMs;
     // Pack signals
-    for ( auto &s : condition.mCondition.signals )
+    for ( size_t signalIndex = 0; signalIndex < condition.mCondition.signals.size(); signalIndex++ )
     {
+        const auto &s = condition.mCondition.signals[signalIndex];
         if ( !s.isConditionOnlySignal )
         {
             switch ( s.signalType )
@@ -709,110 +757,122 @@ CollectionInspectionEngine::collectData( ActiveCondition &condition,
                 collectLastSignals<uint8_t>( s.signalID,
                                              s.minimumSampleIntervalMs,
                                              s.sampleBufferSize,
-                                             conditionId,
+                                             condition.mCollectedSignalCounters[signalIndex],
                                              s.signalType,
+                                             s.reduction,
                                              newestSignalTimestamp,
-                                             collectedData->signals );
+                                             *collectedData );
                 break;
             case SignalType::INT8:
                 collectLastSignals<int8_t>( s.signalID,
                                             s.minimumSampleIntervalMs,
                                             s.sampleBufferSize,
-                                            conditionId,
+                                            condition.mCollectedSignalCounters[signalIndex],
                                             s.signalType,
+                                            s.reduction,
                                             newestSignalTimestamp,
-                                            collectedData->signals );
+                                            *collectedData );
                 break;
             case SignalType::UINT16:
                 collectLastSignals<uint16_t>( s.signalID,
                                               s.minimumSampleIntervalMs,
                                               s.sampleBufferSize,
-                                              conditionId,
+                                              condition.mCollectedSignalCounters[signalIndex],
                                               s.signalType,
+                                              s.reduction,
                                               newestSignalTimestamp,
-                                              collectedData->signals );
+                                              *collectedData );
                 break;
             case SignalType::INT16:
                 collectLastSignals<int16_t>( s.signalID,
                                              s.minimumSampleIntervalMs,
                                              s.sampleBufferSize,
-                                             conditionId,
+                                             condition.mCollectedSignalCounters[signalIndex],
                                              s.signalType,
+                                             s.reduction,
                                              newestSignalTimestamp,
-                                             collectedData->signals );
+                                             *collectedData );
                 break;
             case SignalType::UINT32:
                 collectLastSignals<uint32_t>( s.signalID,
                                               s.minimumSampleIntervalMs,
                                               s.sampleBufferSize,
-                                              conditionId,
+                                              condition.mCollectedSignalCounters[signalIndex],
                                               s.signalType,
+                                              s.reduction,
                                               newestSignalTimestamp,
-                                              collectedData->signals );
+                                              *collectedData );
                 break;
             case SignalType::INT32:
                 collectLastSignals<int32_t>( s.signalID,
                                              s.minimumSampleIntervalMs,
                                              s.sampleBufferSize,
-                                             conditionId,
+                                             condition.mCollectedSignalCounters[signalIndex],
                                              s.signalType,
+                                             s.reduction,
                                              newestSignalTimestamp,
-                                             collectedData->signals );
+                                             *collectedData );
                 break;
             case SignalType::UINT64:
                 collectLastSignals<uint64_t>( s.signalID,
                                               s.minimumSampleIntervalMs,
                                               s.sampleBufferSize,
-                                              conditionId,
+                                              condition.mCollectedSignalCounters[signalIndex],
                                               s.signalType,
+                                              s.reduction,
                                               newestSignalTimestamp,
-                                              collectedData->signals );
+                                              *collectedData );
                 break;
             case SignalType::INT64:
                 collectLastSignals<int64_t>( s.signalID,
                                              s.minimumSampleIntervalMs,
                                              s.sampleBufferSize,
-                                             conditionId,
+                                             condition.mCollectedSignalCounters[signalIndex],
                                              s.signalType,
+                                             s.reduction,
                                              newestSignalTimestamp,
-                                             collectedData->signals );
+                                             *collectedData );
                 break;
             case SignalType::FLOAT:
                 collectLastSignals<float>( s.signalID,
                                            s.minimumSampleIntervalMs,
                                            s.sampleBufferSize,
-                                           conditionId,
+                                           condition.mCollectedSignalCounters[signalIndex],
                                            s.signalType,
+                                           s.reduction,
                                            newestSignalTimestamp,
-                                           collectedData->signals );
+                                           *collectedData );
                 break;
             case SignalType::DOUBLE:
                 collectLastSignals<double>( s.signalID,
                                             s.minimumSampleIntervalMs,
                                             s.sampleBufferSize,
-                                            conditionId,
+                                            condition.mCollectedSignalCounters[signalIndex],
                                             s.signalType,
+                                            s.reduction,
                                             newestSignalTimestamp,
-                                            collectedData->signals );
+                                            *collectedData );
                 break;
             case SignalType::BOOLEAN:
                 collectLastSignals<bool>( s.signalID,
                                           s.minimumSampleIntervalMs,
                                           s.sampleBufferSize,
-                                          conditionId,
+                                          condition.mCollectedSignalCounters[signalIndex],
                                           s.signalType,
+                                          s.reduction,
                                           newestSignalTimestamp,
-                                          collectedData->signals );
+                                          *collectedData );
                 break;
 #ifdef FWE_FEATURE_VISION_SYSTEM_DATA
             case SignalType::RAW_DATA_BUFFER_HANDLE:
                 collectLastSignals<RawData::BufferHandle>( s.signalID,
                                                            s.minimumSampleIntervalMs,
                                                            s.sampleBufferSize,
-                                                           conditionId,
+                                                           condition.mCollectedSignalCounters[signalIndex],
                                                            s.signalType,
+                                                           s.reduction,
                                                            newestSignalTimestamp,
-                                                           collectedData->signals );
+                                                           *collectedData );
 #endif
                 break;
             }
@@ -820,22 +880,23 @@ CollectionInspectionEngine::collectData( ActiveCondition &condition,
     }
 
     // Pack raw frames
-    for ( auto &c : condition.mCondition.canFrames )
+    for ( size_t canFrameIndex = 0; canFrameIndex < condition.mCondition.canFrames.size(); canFrameIndex++ )
     {
+        const auto &c = condition.mCondition.canFrames[canFrameIndex];
         collectLastCanFrames( c.frameID,
                               c.channelID,
                               c.minimumSampleIntervalMs,
                               c.sampleBufferSize,
-                              conditionId,
+                              condition.mCollectedCanFrameCounters[canFrameIndex],
                               newestSignalTimestamp,
                               collectedData->canFrames );
     }
     // Pack active DTCs if any
     if ( condition.mCondition.includeActiveDtcs &&
-         ( ( !isActiveDTCsConsumed( conditionId ) ) || mSendDataOnlyOncePerCondition ) )
+         ( ( !condition.mActiveDTCsCollected ) || mSendDataOnlyOncePerCondition ) )
     {
         collectedData->mDTCInfo = mActiveDTCs;
-        setActiveDTCsConsumed( conditionId, true );
+        condition.mActiveDTCsCollected = true;
     }
     // Propagate the event ID
     collectedData->eventID = condition.mEventID;
@@ -870,7 +931,7 @@ CollectionInspectionEngine::collectNextDataToSend( const TimePoint &currentTime,
                 condition.mEventID = generateEventID( currentTime.systemTimeMs );
                 // Return the collected data
                 InspectionTimestamp newestSignalTimeStamp = 0;
-                auto cd = collectData( condition, mNextConditionToCollectedIndex, newestSignalTimeStamp );
+                auto cd = collectData( condition, newestSignalTimeStamp );
                 // After collecting the data set the newest timestamp from any data that was
                 // collected
                 condition.mLastDataTimestampPublished = std::min( newestSignalTimeStamp, currentTime.monotonicTimeMs );
@@ -922,7 +983,6 @@ CollectionInspectionEngine::addNewRawCanFrame( CANRawFrameID canID,
                     buf.mBuffer[buf.mCurrentPosition].mBuffer[i] = buffer[i];
                 }
                 buf.mBuffer[buf.mCurrentPosition].mTimestamp = receiveTime.systemTimeMs;
-                buf.mBuffer[buf.mCurrentPosition].setAlreadyConsumed( ALL_CONDITIONS, false );
                 buf.mCounter++;
                 buf.mLastSample = receiveTime;
             }
@@ -933,284 +993,497 @@ CollectionInspectionEngine::addNewRawCanFrame( CANRawFrameID canID,
 void
 CollectionInspectionEngine::setActiveDTCs( const DTCInfo &activeDTCs )
 {
-    setActiveDTCsConsumed( ALL_CONDITIONS, false );
+    for ( auto &condition : mConditions )
+    {
+        condition.mActiveDTCsCollected = false;
+    }
     mActiveDTCs = activeDTCs;
 }
 
 template <typename T>
 CollectionInspectionEngine::ExpressionErrorCode
-CollectionInspectionEngine::getLatestBufferSignalValue( InspectionSignalID id,
-                                                        ActiveCondition &condition,
-                                                        InspectionValue &result )
+CollectionInspectionEngine::getSampleWindowFunctionType( const void *window,
+                                                         WindowFunction function,
+                                                         InspectionValue &result )
 {
-
-    auto *s = condition.getEvaluationSignalsBufferPtr<T>( id );
-    if ( s == nullptr )
-    {
-        FWE_LOG_WARN( "SIGNAL_NOT_FOUND" );
-        // Signal not collected by any active condition
-        return ExpressionErrorCode::SIGNAL_NOT_FOUND;
-    }
-    if ( s->mCounter == 0 )
+    const auto *w = static_cast<const FixedTimeWindowFunctionData<T> *>( window );
+    switch ( function )
     {
-        // Not a single sample collected yet
-        return ExpressionErrorCode::SIGNAL_NOT_FOUND;
+    case WindowFunction::LAST_FIXED_WINDOW_AVG:
+        result = static_cast<double>( w->mLastAvg );
+        return w->mLastAvailable ? ExpressionErrorCode::SUCCESSFUL : ExpressionErrorCode::FUNCTION_DATA_NOT_AVAILABLE;
+    case WindowFunction::LAST_FIXED_WINDOW_MIN:
+        result = static_cast<double>( w->mLastMin );
+        return w->mLastAvailable ? ExpressionErrorCode::SUCCESSFUL : ExpressionErrorCode::FUNCTION_DATA_NOT_AVAILABLE;
+    case WindowFunction::LAST_FIXED_WINDOW_MAX:
+        result = static_cast<double>( w->mLastMax );
+        return w->mLastAvailable ? ExpressionErrorCode::SUCCESSFUL : ExpressionErrorCode::FUNCTION_DATA_NOT_AVAILABLE;
+    case WindowFunction::PREV_LAST_FIXED_WINDOW_AVG:
+        result = static_cast<double>( w->mPreviousLastAvg );
+        return w->mPreviousLastAvailable ? ExpressionErrorCode::SUCCESSFUL
+                                         : ExpressionErrorCode::FUNCTION_DATA_NOT_AVAILABLE;
+    case WindowFunction::PREV_LAST_FIXED_WINDOW_MIN:
+        result = static_cast<double>( w->mPreviousLastMin );
+        return w->mPreviousLastAvailable ? ExpressionErrorCode::SUCCESSFUL
+                                         : ExpressionErrorCode::FUNCTION_DATA_NOT_AVAILABLE;
+    case WindowFunction::PREV_LAST_FIXED_WINDOW_MAX:
+        result = static_cast<double>( w->mPreviousLastMax );
+        return w->mPreviousLastAvailable ? ExpressionErrorCode::SUCCESSFUL
+                                         : ExpressionErrorCode::FUNCTION_DATA_NOT_AVAILABLE;
+    case WindowFunction::LAST_FIXED_WINDOW_COUNT:
+    case WindowFunction::LAST_FIXED_WINDOW_SUM:
+    case WindowFunction::LAST_FIXED_WINDOW_STDDEV:
+    case WindowFunction::LAST_FIXED_WINDOW_FIRST:
+    case WindowFunction::LAST_FIXED_WINDOW_LAST:
+    case WindowFunction::LAST_FIXED_WINDOW_RATE_OF_CHANGE:
+    case WindowFunction::LAST_FIXED_WINDOW_P50:
+    case WindowFunction::LAST_FIXED_WINDOW_P95:
+    case WindowFunction::LAST_FIXED_WINDOW_P99:
+        return getFixedWindowStatistic( w->mLastStatistics, function, result );
+    case WindowFunction::PREV_LAST_FIXED_WINDOW_COUNT:
+    case WindowFunction::PREV_LAST_FIXED_WINDOW_SUM:
+    case WindowFunction::PREV_LAST_FIXED_WINDOW_STDDEV:
+    case WindowFunction::PREV_LAST_FIXED_WINDOW_FIRST:
+    case WindowFunction::PREV_LAST_FIXED_WINDOW_LAST:
+    case WindowFunction::PREV_LAST_FIXED_WINDOW_RATE_OF_CHANGE:
+    case WindowFunction::PREV_LAST_FIXED_WINDOW_P50:
+    case WindowFunction::PREV_LAST_FIXED_WINDOW_P95:
+    case WindowFunction::PREV_LAST_FIXED_WINDOW_P99:
+        return getFixedWindowStatistic( w->mPreviousLastStatistics, function, result );
+    case WindowFunction::SLIDING_WINDOW_COUNT:
+    case WindowFunction::SLIDING_WINDOW_SUM:
+    case WindowFunction::SLIDING_WINDOW_AVG:
+    case WindowFunction::SLIDING_WINDOW_MIN:
+    case WindowFunction::SLIDING_WINDOW_MAX:
+    case WindowFunction::SLIDING_WINDOW_STDDEV:
+        return getSlidingWindowStatistic( w->mSlidingWindow, function, result );
+    default:
+        return ExpressionErrorCode::NOT_IMPLEMENTED_FUNCTION;
     }
-    result = static_cast<double>( s->mBuffer[s->mCurrentPosition].mValue );
-    return ExpressionErrorCode::SUCCESSFUL;
 }
 
 CollectionInspectionEngine::ExpressionErrorCode
-CollectionInspectionEngine::getLatestSignalValue( InspectionSignalID id,
-                                                  ActiveCondition &condition,
-                                                  InspectionValue &result )
+CollectionInspectionEngine::getFixedWindowStatistic( const FixedWindowStatistics &statistics,
+                                                     WindowFunction function,
+                                                     InspectionValue &result )
 {
-    if ( mSignalToBufferTypeMap.find( id ) == mSignalToBufferTypeMap.end() )
-    {
-        FWE_LOG_WARN( "SIGNAL_NOT_FOUND" );
-        // Signal not collected by any active condition
-        return ExpressionErrorCode::SIGNAL_NOT_FOUND;
-    }
-    auto signalType = mSignalToBufferTypeMap[id];
-    switch ( signalType )
+    // Count and sum are also known for a window without samples
+    bool available = statistics.mCompleted && ( statistics.mCount > 0 );
+    switch ( function )
     {
-    case SignalType::UINT8:
-        return getLatestBufferSignalValue<uint8_t>( id, condition, result );
+    case WindowFunction::LAST_FIXED_WINDOW_COUNT:
+    case WindowFunction::PREV_LAST_FIXED_WINDOW_COUNT:
+        result = statistics.mCount;
+        available = statistics.mCompleted;
         break;
-    case SignalType::INT8:
-        return getLatestBufferSignalValue<int8_t>( id, condition, result );
+    case WindowFunction::LAST_FIXED_WINDOW_SUM:
+    case WindowFunction::PREV_LAST_FIXED_WINDOW_SUM:
+        result = statistics.mSum;
+        available = statistics.mCompleted;
         break;
-    case SignalType::UINT16:
-        return getLatestBufferSignalValue<uint16_t>( id, condition, result );
+    case WindowFunction::LAST_FIXED_WINDOW_STDDEV:
+    case WindowFunction::PREV_LAST_FIXED_WINDOW_STDDEV:
+        result = statistics.mStandardDeviation;
         break;
-    case SignalType::INT16:
-        return getLatestBufferSignalValue<uint16_t>( id, condition, result );
+    case WindowFunction::LAST_FIXED_WINDOW_FIRST:
+    case WindowFunction::PREV_LAST_FIXED_WINDOW_FIRST:
+        result = statistics.mFirst;
         break;
-    case SignalType::UINT32:
-        return getLatestBufferSignalValue<uint32_t>( id, condition, result );
+    case WindowFunction::LAST_FIXED_WINDOW_LAST:
+    case WindowFunction::PREV_LAST_FIXED_WINDOW_LAST:
+        result = statistics.mLast;
         break;
-    case SignalType::INT32:
-        return getLatestBufferSignalValue<int32_t>( id, condition, result );
+    case WindowFunction::LAST_FIXED_WINDOW_RATE_OF_CHANGE:
+    case WindowFunction::PREV_LAST_FIXED_WINDOW_RATE_OF_CHANGE:
+        result = statistics.mRateOfChange;
+        available = statistics.mRateOfChangeAvailable;
         break;
-    case SignalType::UINT64:
-        return getLatestBufferSignalValue<uint64_t>( id, condition, result );
+    case WindowFunction::LAST_FIXED_WINDOW_P50:
+    case WindowFunction::PREV_LAST_FIXED_WINDOW_P50:
+        result = statistics.mQuantiles[0];
+        available = statistics.mQuantilesAvailable;
         break;
-    case SignalType::INT64:
-        return getLatestBufferSignalValue<int64_t>( id, condition, result );
+    case WindowFunction::LAST_FIXED_WINDOW_P95:
+    case WindowFunction::PREV_LAST_FIXED_WINDOW_P95:
+        result = statistics.mQuantiles[1];
+        available = statistics.mQuantilesAvailable;
         break;
-    case SignalType::FLOAT:
-        return getLatestBufferSignalValue<float>( id, condition, result );
+    case WindowFunction::LAST_FIXED_WINDOW_P99:
+    case WindowFunction::PREV_LAST_FIXED_WINDOW_P99:
+        result = statistics.mQuantiles[2];
+        available = statistics.mQuantilesAvailable;
         break;
-    case SignalType::DOUBLE:
-        return getLatestBufferSignalValue<double>( id, condition, result );
+    default:
+        return ExpressionErrorCode::NOT_IMPLEMENTED_FUNCTION;
+    }
+    return available ? ExpressionErrorCode::SUCCESSFUL : ExpressionErrorCode::FUNCTION_DATA_NOT_AVAILABLE;
+}
+
+CollectionInspectionEngine::ExpressionErrorCode
+CollectionInspectionEngine::getSlidingWindowStatistic( const SlidingWindowStatistics &statistics,
+                                                       WindowFunction function,
+                                                       InspectionValue &result )
+{
+    auto count = statistics.getCount();
+    // The count and the sum of an empty window are 0, all other values are not available
+    switch ( function )
+    {
+    case WindowFunction::SLIDING_WINDOW_COUNT:
+        result = count;
+        return ExpressionErrorCode::SUCCESSFUL;
+    case WindowFunction::SLIDING_WINDOW_SUM:
+        result = statistics.getSum();
+        return ExpressionErrorCode::SUCCESSFUL;
+    case WindowFunction::SLIDING_WINDOW_AVG:
+        result = ( count > 0 ) ? ( statistics.getSum() / count ) : 0;
         break;
-    case SignalType::BOOLEAN:
-        return getLatestBufferSignalValue<bool>( id, condition, result );
+    case WindowFunction::SLIDING_WINDOW_MIN:
+        result = statistics.getMin();
         break;
-    default:
-        return ExpressionErrorCode::SIGNAL_NOT_FOUND;
+    case WindowFunction::SLIDING_WINDOW_MAX:
+        result = statistics.getMax();
         break;
+    case WindowFunction::SLIDING_WINDOW_STDDEV:
+        result = statistics.getStandardDeviation();
+        break;
+    default:
+        return ExpressionErrorCode::NOT_IMPLEMENTED_FUNCTION;
     }
+    return ( count > 0 ) ? ExpressionErrorCode::SUCCESSFUL : ExpressionErrorCode::FUNCTION_DATA_NOT_AVAILABLE;
 }
 
-template <typename T = double>
+template <typename T>
 CollectionInspectionEngine::ExpressionErrorCode
-CollectionInspectionEngine::getSampleWindowFunctionType( WindowFunction function,
-                                                         InspectionSignalID signalID,
-                                                         ActiveCondition &condition,
-                                                         InspectionValue &result )
+CollectionInspectionEngine::compileOperandType( const ExpressionNode *expression,
+                                                ActiveCondition &condition,
+                                                uint8_t segment,
+                                                ConditionInstruction &instruction )
 {
-    auto w = condition.getFixedTimeWindowFunctionDataPtr<T>( signalID );
-    if ( w == nullptr )
+    if ( expression->nodeType == ExpressionNodeType::SIGNAL )
     {
-        // Signal not collected by any active condition
-        return ExpressionErrorCode::SIGNAL_NOT_FOUND;
+        auto *buffer = condition.getEvaluationSignalsBufferPtr<T>( expression->signalID );
+        if ( buffer == nullptr )
+        {
+            // Signal not collected by this condition
+            return ExpressionErrorCode::SIGNAL_NOT_FOUND;
+        }
+        instruction.mLatestSignalValue = &buffer->mLatestValue;
+        instruction.mSignalCounter = &buffer->mCounter;
+        addConditionDependency( buffer->mDependentConditions, condition, segment );
     }
+    else
+    {
+        auto *window = condition.getFixedTimeWindowFunctionDataPtr<T>( expression->signalID );
+        if ( window == nullptr )
+        {
+            return ExpressionErrorCode::SIGNAL_NOT_FOUND;
+        }
+        window->enableFunction( expression->function.windowFunction );
+        // The window changes when it rolls over and with every sample added to its buffer
+        addConditionDependency( window->mDependentConditions, condition, segment );
+        auto *buffer = condition.getEvaluationSignalsBufferPtr<T>( expression->signalID );
+        if ( buffer != nullptr )
+        {
+            addConditionDependency( buffer->mDependentConditions, condition, segment );
+        }
+        instruction.mWindow = window;
+        instruction.mGetWindowValue = &getSampleWindowFunctionType<T>;
+    }
+    return ExpressionErrorCode::SUCCESSFUL;
+}
 
-    switch ( function )
+void
+CollectionInspectionEngine::addConditionDependency( std::vector<ConditionDependency> &dependencies,
+                                                    const ActiveCondition &condition,
+                                                    uint8_t segment )
+{
+    uint64_t segmentBit = ( segment == NO_SEGMENT ) ? 0 : ( uint64_t{ 1 } << segment );
+    // The conditions are compiled one after the other, so an earlier entry of this condition can only be the last one
+    if ( ( !dependencies.empty() ) && ( dependencies.back().mConditionIndex == condition.mIndex ) )
     {
-    case WindowFunction::LAST_FIXED_WINDOW_AVG:
-        result = static_cast<double>( w->mLastAvg );
-        return w->mLastAvailable ? ExpressionErrorCode::SUCCESSFUL : ExpressionErrorCode::FUNCTION_DATA_NOT_AVAILABLE;
-    case WindowFunction::LAST_FIXED_WINDOW_MIN:
-        result = static_cast<double>( w->mLastMin );
-        return w->mLastAvailable ? ExpressionErrorCode::SUCCESSFUL : ExpressionErrorCode::FUNCTION_DATA_NOT_AVAILABLE;
-    case WindowFunction::LAST_FIXED_WINDOW_MAX:
-        result = static_cast<double>( w->mLastMax );
-        return w->mLastAvailable ? ExpressionErrorCode::SUCCESSFUL : ExpressionErrorCode::FUNCTION_DATA_NOT_AVAILABLE;
-    case WindowFunction::PREV_LAST_FIXED_WINDOW_AVG:
-        result = static_cast<double>( w->mPreviousLastAvg );
-        return w->mPreviousLastAvailable ? ExpressionErrorCode::SUCCESSFUL
-                                         : ExpressionErrorCode::FUNCTION_DATA_NOT_AVAILABLE;
-    case WindowFunction::PREV_LAST_FIXED_WINDOW_MIN:
-        result = static_cast<double>( w->mPreviousLastMin );
-        return w->mPreviousLastAvailable ? ExpressionErrorCode::SUCCESSFUL
-                                         : ExpressionErrorCode::FUNCTION_DATA_NOT_AVAILABLE;
-    case WindowFunction::PREV_LAST_FIXED_WINDOW_MAX:
-        result = static_cast<double>( w->mPreviousLastMax );
-        return w->mPreviousLastAvailable ? ExpressionErrorCode::SUCCESSFUL
-                                         : ExpressionErrorCode::FUNCTION_DATA_NOT_AVAILABLE;
-    default:
-        return ExpressionErrorCode::NOT_IMPLEMENTED_FUNCTION;
+        dependencies.back().mSegments |= segmentBit;
+        return;
     }
+    ConditionDependency dependency;
+    dependency.mConditionIndex = condition.mIndex;
+    dependency.mSegments = segmentBit;
+    dependencies.push_back( dependency );
 }
 
 CollectionInspectionEngine::ExpressionErrorCode
-CollectionInspectionEngine::getSampleWindowFunction( WindowFunction function,
-                                                     InspectionSignalID signalID,
-                                                     ActiveCondition &condition,
-                                                     InspectionValue &result )
+CollectionInspectionEngine::compileOperand( const ExpressionNode *expression,
+                                            ActiveCondition &condition,
+                                            uint8_t segment )
 {
-    if ( mSignalToBufferTypeMap.find( signalID ) == mSignalToBufferTypeMap.end() )
+    auto signalType = mSignalToBufferTypeMap.find( expression->signalID );
+    if ( signalType == mSignalToBufferTypeMap.end() )
     {
         FWE_LOG_WARN( "SIGNAL_NOT_FOUND" );
         // Signal not collected by any active condition
         return ExpressionErrorCode::SIGNAL_NOT_FOUND;
     }
-    auto signalType = mSignalToBufferTypeMap[signalID];
-    switch ( signalType )
+    ConditionInstruction instruction;
+    instruction.mNodeType = expression->nodeType;
+    instruction.mWindowFunction = expression->function.windowFunction;
+    ExpressionErrorCode ret = ExpressionErrorCode::SIGNAL_NOT_FOUND;
+    switch ( signalType->second )
     {
     case SignalType::UINT8:
-        return getSampleWindowFunctionType<uint8_t>( function, signalID, condition, result );
+        ret = compileOperandType<uint8_t>( expression, condition, segment, instruction );
         break;
     case SignalType::INT8:
-        return getSampleWindowFunctionType<int8_t>( function, signalID, condition, result );
+        ret = compileOperandType<int8_t>( expression, condition, segment, instruction );
         break;
     case SignalType::UINT16:
-        return getSampleWindowFunctionType<uint16_t>( function, signalID, condition, result );
+        ret = compileOperandType<uint16_t>( expression, condition, segment, instruction );
         break;
     case SignalType::INT16:
-        return getSampleWindowFunctionType<int16_t>( function, signalID, condition, result );
+        ret = compileOperandType<int16_t>( expression, condition, segment, instruction );
         break;
     case SignalType::UINT32:
-        return getSampleWindowFunctionType<uint32_t>( function, signalID, condition, result );
+        ret = compileOperandType<uint32_t>( expression, condition, segment, instruction );
         break;
     case SignalType::INT32:
-        return getSampleWindowFunctionType<int32_t>( function, signalID, condition, result );
+        ret = compileOperandType<int32_t>( expression, condition, segment, instruction );
         break;
     case SignalType::UINT64:
-        return getSampleWindowFunctionType<uint64_t>( function, signalID, condition, result );
+        ret = compileOperandType<uint64_t>( expression, condition, segment, instruction );
         break;
     case SignalType::INT64:
-        return getSampleWindowFunctionType<int64_t>( function, signalID, condition, result );
+        ret = compileOperandType<int64_t>( expression, condition, segment, instruction );
         break;
     case SignalType::FLOAT:
-        return getSampleWindowFunctionType<float>( function, signalID, condition, result );
+        ret = compileOperandType<float>( expression, condition, segment, instruction );
         break;
     case SignalType::DOUBLE:
-        return getSampleWindowFunctionType<double>( function, signalID, condition, result );
+        ret = compileOperandType<double>( expression, condition, segment, instruction );
         break;
     case SignalType::BOOLEAN:
-        return getSampleWindowFunctionType<bool>( function, signalID, condition, result );
+        ret = compileOperandType<bool>( expression, condition, segment, instruction );
         break;
     default:
-        return ExpressionErrorCode::SIGNAL_NOT_FOUND;
         break;
     }
+    if ( ret == ExpressionErrorCode::SUCCESSFUL )
+    {
+        condition.mInstructions.push_back( instruction );
+    }
+    return ret;
 }
 
 CollectionInspectionEngine::ExpressionErrorCode
-CollectionInspectionEngine::eval( const ExpressionNode *expression,
-                                  ActiveCondition &condition,
-                                  InspectionValue &resultValueDouble,
-                                  bool &resultValueBool,
-                                  int remainingStackDepth )
+CollectionInspectionEngine::compileExpression( const ExpressionNode *expression,
+                                               ActiveCondition &condition,
+                                               int remainingStackDepth,
+                                               uint8_t segment )
 {
     if ( ( remainingStackDepth <= 0 ) || ( expression == nullptr ) )
     {
         FWE_LOG_WARN( "STACK_DEPTH_REACHED or nullptr" );
         return ExpressionErrorCode::STACK_DEPTH_REACHED;
     }
-    if ( expression->nodeType == ExpressionNodeType::FLOAT )
+    ConditionInstruction instruction;
+    instruction.mNodeType = expression->nodeType;
+    switch ( expression->nodeType )
     {
-        resultValueDouble = expression->floatingValue;
+    case ExpressionNodeType::FLOAT:
+        instruction.mFloatingValue = expression->floatingValue;
+        condition.mInstructions.push_back( instruction );
         return ExpressionErrorCode::SUCCESSFUL;
-    }
-    if ( expression->nodeType == ExpressionNodeType::BOOLEAN )
-    {
-        resultValueBool = expression->booleanValue;
+    case ExpressionNodeType::BOOLEAN:
+        instruction.mBooleanValue = expression->booleanValue;
+        condition.mInstructions.push_back( instruction );
         return ExpressionErrorCode::SUCCESSFUL;
-    }
-    if ( expression->nodeType == ExpressionNodeType::SIGNAL )
-    {
-        return getLatestSignalValue( expression->signalID, condition, resultValueDouble );
-    }
-    if ( expression->nodeType == ExpressionNodeType::WINDOWFUNCTION )
-    {
-        return getSampleWindowFunction(
-            expression->function.windowFunction, expression->signalID, condition, resultValueDouble );
-    }
-
-    InspectionValue leftDouble = 0;
-    InspectionValue rightDouble = 0;
-    bool leftBool = false;
-    bool rightBool = false;
-    ExpressionErrorCode leftRet = ExpressionErrorCode::SUCCESSFUL;
-    ExpressionErrorCode rightRet = ExpressionErrorCode::SUCCESSFUL;
-    // Recursion limited depth through last parameter
-    leftRet = eval( expression->left, condition, leftDouble, leftBool, remainingStackDepth - 1 );
-
-    if ( leftRet != ExpressionErrorCode::SUCCESSFUL )
-    {
-        return leftRet;
-    }
-
-    // Logical NOT operator does not have a right operand, hence expression->right can be nullptr
-    if ( expression->nodeType != ExpressionNodeType::OPERATOR_LOGICAL_NOT )
-    {
-        // No short-circuit evaluation so always evaluate right part
-        rightRet = eval( expression->right, condition, rightDouble, rightBool, remainingStackDepth - 1 );
-
-        if ( rightRet != ExpressionErrorCode::SUCCESSFUL )
-        {
-            return rightRet;
-        }
-    }
-
-    switch ( expression->nodeType )
-    {
+    case ExpressionNodeType::SIGNAL:
+    case ExpressionNodeType::WINDOWFUNCTION:
+        return compileOperand( expression, condition, segment );
     case ExpressionNodeType::OPERATOR_SMALLER:
-        resultValueBool = leftDouble < rightDouble;
-        return ExpressionErrorCode::SUCCESSFUL;
     case ExpressionNodeType::OPERATOR_BIGGER:
-        resultValueBool = leftDouble > rightDouble;
-        return ExpressionErrorCode::SUCCESSFUL;
     case ExpressionNodeType::OPERATOR_SMALLER_EQUAL:
-        resultValueBool = leftDouble <= rightDouble;
-        return ExpressionErrorCode::SUCCESSFUL;
     case ExpressionNodeType::OPERATOR_BIGGER_EQUAL:
-        resultValueBool = leftDouble >= rightDouble;
-        return ExpressionErrorCode::SUCCESSFUL;
     case ExpressionNodeType::OPERATOR_EQUAL:
-        resultValueBool = std::abs( leftDouble - rightDouble ) < EVAL_EQUAL_DISTANCE();
-        return ExpressionErrorCode::SUCCESSFUL;
     case ExpressionNodeType::OPERATOR_NOT_EQUAL:
-        resultValueBool = !( std::abs( leftDouble - rightDouble ) < EVAL_EQUAL_DISTANCE() );
-        return ExpressionErrorCode::SUCCESSFUL;
     case ExpressionNodeType::OPERATOR_LOGICAL_AND:
-        resultValueBool = leftBool && rightBool;
-        return ExpressionErrorCode::SUCCESSFUL;
     case ExpressionNodeType::OPERATOR_LOGICAL_OR:
-        resultValueBool = leftBool || rightBool;
-        return ExpressionErrorCode::SUCCESSFUL;
     case ExpressionNodeType::OPERATOR_LOGICAL_NOT:
-        resultValueBool = !leftBool;
-        return ExpressionErrorCode::SUCCESSFUL;
     case ExpressionNodeType::OPERATOR_ARITHMETIC_PLUS:
-        resultValueDouble = leftDouble + rightDouble;
-        return ExpressionErrorCode::SUCCESSFUL;
     case ExpressionNodeType::OPERATOR_ARITHMETIC_MINUS:
-        resultValueDouble = leftDouble - rightDouble;
-        return ExpressionErrorCode::SUCCESSFUL;
     case ExpressionNodeType::OPERATOR_ARITHMETIC_MULTIPLY:
-        resultValueDouble = leftDouble * rightDouble;
-        return ExpressionErrorCode::SUCCESSFUL;
     case ExpressionNodeType::OPERATOR_ARITHMETIC_DIVIDE:
-        resultValueDouble = leftDouble / rightDouble;
-        return ExpressionErrorCode::SUCCESSFUL;
+        break;
     default:
         return ExpressionErrorCode::NOT_IMPLEMENTED_TYPE;
     }
+
+    bool isLogicalOperator = ( expression->nodeType == ExpressionNodeType::OPERATOR_LOGICAL_AND ) ||
+                             ( expression->nodeType == ExpressionNodeType::OPERATOR_LOGICAL_OR ) ||
+                             ( expression->nodeType == ExpressionNodeType::OPERATOR_LOGICAL_NOT );
+    if ( ( segment == NO_SEGMENT ) && ( !isLogicalOperator ) &&
+         ( condition.mSegments.size() < MAX_CONDITION_SEGMENTS ) )
+    {
+        // The first operator below the logical operators starts a new segment, which ends with this operator
+        auto newSegment = static_cast<uint8_t>( condition.mSegments.size() );
+        condition.mSegments.emplace_back();
+        auto start = condition.mInstructions.size();
+        ExpressionErrorCode ret = compileExpression( expression, condition, remainingStackDepth, newSegment );
+        if ( ret == ExpressionErrorCode::SUCCESSFUL )
+        {
+            condition.mInstructions[start].mSegmentStart = newSegment;
+            condition.mInstructions.back().mSegmentEnd = newSegment;
+            condition.mSegments[newSegment].mEnd = static_cast<uint32_t>( condition.mInstructions.size() - 1 );
+        }
+        return ret;
+    }
+
+    // Recursion limited depth through last parameter. The operands come before their operator.
+    ExpressionErrorCode ret = compileExpression( expression->left, condition, remainingStackDepth - 1, segment );
+    if ( ret != ExpressionErrorCode::SUCCESSFUL )
+    {
+        return ret;
+    }
+    // Logical NOT operator does not have a right operand, hence expression->right can be nullptr
+    if ( expression->nodeType != ExpressionNodeType::OPERATOR_LOGICAL_NOT )
+    {
+        ret = compileExpression( expression->right, condition, remainingStackDepth - 1, segment );
+        if ( ret != ExpressionErrorCode::SUCCESSFUL )
+        {
+            return ret;
+        }
+    }
+    condition.mInstructions.push_back( instruction );
+    return ExpressionErrorCode::SUCCESSFUL;
+}
+
+CollectionInspectionEngine::ExpressionErrorCode
+CollectionInspectionEngine::eval( ActiveCondition &condition,
+                                  InspectionValue &resultValueDouble,
+                                  bool &resultValueBool )
+{
+    if ( condition.mCompileResult != ExpressionErrorCode::SUCCESSFUL )
+    {
+        return condition.mCompileResult;
+    }
+    // An expression compiles only if it is at most MAX_EQUATION_DEPTH deep, so it never needs more values than that
+    std::array<InspectionValue, MAX_EQUATION_DEPTH> doubleStack;
+    std::array<bool, MAX_EQUATION_DEPTH> boolStack;
+    size_t stackSize = 0;
+    const auto &instructions = condition.mInstructions;
+    for ( size_t i = 0; i < instructions.size(); i++ )
+    {
+        const auto &instruction = instructions[i];
+        if ( instruction.mSegmentStart != NO_SEGMENT )
+        {
+            const auto &segment = condition.mSegments[instruction.mSegmentStart];
+            bool changed = ( condition.mChangedSegments & ( uint64_t{ 1 } << instruction.mSegmentStart ) ) != 0;
+            if ( segment.mValid && ( !changed ) )
+            {
+                // No input of the segment changed since it was computed
+                doubleStack[stackSize] = segment.mDoubleValue;
+                boolStack[stackSize] = segment.mBoolValue;
+                stackSize++;
+                i = segment.mEnd;
+                continue;
+            }
+        }
+        // Each node only sets one of the values, the other stays at its default
+        InspectionValue resultDouble = 0;
+        bool resultBool = false;
+        if ( instruction.mNodeType == ExpressionNodeType::FLOAT )
+        {
+            resultDouble = instruction.mFloatingValue;
+        }
+        else if ( instruction.mNodeType == ExpressionNodeType::BOOLEAN )
+        {
+            resultBool = instruction.mBooleanValue;
+        }
+        else if ( instruction.mNodeType == ExpressionNodeType::SIGNAL )
+        {
+            if ( *instruction.mSignalCounter == 0 )
+            {
+                // Not a single sample collected yet
+                return ExpressionErrorCode::SIGNAL_NOT_FOUND;
+            }
+            resultDouble = *instruction.mLatestSignalValue;
+        }
+        else if ( instruction.mNodeType == ExpressionNodeType::WINDOWFUNCTION )
+        {
+            ExpressionErrorCode ret =
+                instruction.mGetWindowValue( instruction.mWindow, instruction.mWindowFunction, resultDouble );
+            if ( ret != ExpressionErrorCode::SUCCESSFUL )
+            {
+                return ret;
+            }
+        }
+        else if ( instruction.mNodeType == ExpressionNodeType::OPERATOR_LOGICAL_NOT )
+        {
+            stackSize--;
+            resultBool = !boolStack[stackSize];
+        }
+        else
+        {
+            stackSize -= 2;
+            InspectionValue leftDouble = doubleStack[stackSize];
+            InspectionValue rightDouble = doubleStack[stackSize + 1];
+            bool leftBool = boolStack[stackSize];
+            bool rightBool = boolStack[stackSize + 1];
+            switch ( instruction.mNodeType )
+            {
+            case ExpressionNodeType::OPERATOR_SMALLER:
+                resultBool = leftDouble < rightDouble;
+                break;
+            case ExpressionNodeType::OPERATOR_BIGGER:
+                resultBool = leftDouble > rightDouble;
+                break;
+            case ExpressionNodeType::OPERATOR_SMALLER_EQUAL:
+                resultBool = leftDouble <= rightDouble;
+                break;
+            case ExpressionNodeType::OPERATOR_BIGGER_EQUAL:
+                resultBool = leftDouble >= rightDouble;
+                break;
+            case ExpressionNodeType::OPERATOR_EQUAL:
+                resultBool = std::abs( leftDouble - rightDouble ) < EVAL_EQUAL_DISTANCE();
+                break;
+            case ExpressionNodeType::OPERATOR_NOT_EQUAL:
+                resultBool = !( std::abs( leftDouble - rightDouble ) < EVAL_EQUAL_DISTANCE() );
+                break;
+            case ExpressionNodeType::OPERATOR_LOGICAL_AND:
+                resultBool = leftBool && rightBool;
+                break;
+            case ExpressionNodeType::OPERATOR_LOGICAL_OR:
+                resultBool = leftBool || rightBool;
+                break;
+            case ExpressionNodeType::OPERATOR_ARITHMETIC_PLUS:
+                resultDouble = leftDouble + rightDouble;
+                break;
+            case ExpressionNodeType::OPERATOR_ARITHMETIC_MINUS:
+                resultDouble = leftDouble - rightDouble;
+                break;
+            case ExpressionNodeType::OPERATOR_ARITHMETIC_MULTIPLY:
+                resultDouble = leftDouble * rightDouble;
+                break;
+            case ExpressionNodeType::OPERATOR_ARITHMETIC_DIVIDE:
+                resultDouble = leftDouble / rightDouble;
+                break;
+            default:
+                return ExpressionErrorCode::NOT_IMPLEMENTED_TYPE;
+            }
+        }
+        doubleStack[stackSize] = resultDouble;
+        boolStack[stackSize] = resultBool;
+        stackSize++;
+        if ( instruction.mSegmentEnd != NO_SEGMENT )
+        {
+            // Errors return before, so only successfully computed values are kept
+            auto &segment = condition.mSegments[instruction.mSegmentEnd];
+            segment.mDoubleValue = resultDouble;
+            segment.mBoolValue = resultBool;
+            segment.mValid = true;
+            condition.mChangedSegments &= ~( uint64_t{ 1 } << instruction.mSegmentEnd );
+        }
+    }
+    resultValueDouble = doubleStack[0];
+    resultValueBool = boolStack[0];
+    return ExpressionErrorCode::SUCCESSFUL;
 }
 
 EventID
@@ -11,16 +11,22 @@
 #include "MessageTypes.h"
 #include "OBDDataTypes.h"
 #include "SignalTypes.h"
+#include "StreamingStatistics.h"
 #include "TimeTypes.h"
 #include <algorithm>
 #include <array>
 #include <atomic>
-#include <bitset> // As _Find_first() is not part of C++ standard and compiler specific other structure could be considered
+#include <boost/dynamic_bitset.hpp>
 #include <boost/variant.hpp>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <limits>
 #include <memory>
+#include <queue>
 #include <string>
+#include <tuple>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -205,52 +211,39 @@ public:
 
     void setActiveDTCs( const DTCInfo &activeDTCs );
 
-private:
+    /**
+     * @brief Collects the samples of signals as slices of the history buffers instead of copying them
+     *
+     * The slices end up in TriggeredCollectionSchemeData::signalSlices. Signals with a reduction and raw data handles
+     * are still copied.
+     */
+    void
+    setZeroCopySignalCollection( bool zeroCopySignalCollection )
+    {
+        mZeroCopySignalCollection = zeroCopySignalCollection;
+    }
+
     static const uint32_t MAX_SAMPLE_MEMORY = 20 * 1024 * 1024; // 20MB max for all samples
+
+    /**
+     * @brief Limits the memory of the sample and CAN frame buffers of this engine
+     *
+     * Several engines, e.g. the shards of the inspection, share the budget of MAX_SAMPLE_MEMORY this way.
+     */
+    void
+    setMaxSampleMemory( uint32_t maxSampleMemory )
+    {
+        mMaxSampleMemory = maxSampleMemory;
+    }
+
+private:
     static inline InspectionValue
     EVAL_EQUAL_DISTANCE()
     {
         return 0.001;
     } // because static const double (non-integral type) not possible
 
-    struct SampleConsumed
-    {
-        bool
-        isAlreadyConsumed( uint32_t conditionId )
-        {
-            return mAlreadyConsumed.test( conditionId );
-        }
-        void
-        setAlreadyConsumed( uint32_t conditionId, bool value )
-        {
-            if ( conditionId == ALL_CONDITIONS )
-            {
-                if ( value )
-                {
-                    mAlreadyConsumed.set();
-                }
-                else
-                {
-                    mAlreadyConsumed.reset();
-                }
-            }
-            else
-            {
-                mAlreadyConsumed[conditionId] = value;
-            }
-        }
-
-    private:
-        std::bitset<MAX_NUMBER_OF_ACTIVE_CONDITION> mAlreadyConsumed{ 0 };
-    };
-    template <typename T = double>
-    struct SignalSample : SampleConsumed
-    {
-        T mValue;
-        InspectionTimestamp mTimestamp{ 0 };
-    };
-
-    struct CanFrameSample : SampleConsumed
+    struct CanFrameSample
     {
         uint8_t mSize{ 0 }; /**< elements in buffer variable used. So if the raw can messages is only 3 bytes big this
                            uint8_t will be 3 and only the first three bytes of buffer will contain meaningful data. size
@@ -260,6 +253,36 @@ private:
         InspectionTimestamp mTimestamp{ 0 };
     };
 
+    static constexpr size_t NUMBER_OF_WINDOW_QUANTILES = 3; /**< p50, p95 and p99 */
+    static constexpr uint8_t MAX_CONDITION_SEGMENTS = 64; /**< limited by the width of the segment masks */
+    static constexpr uint8_t NO_SEGMENT = 0xFF;
+
+    /**
+     * @brief A condition that has to be reevaluated when a signal buffer or a window changes
+     */
+    struct ConditionDependency
+    {
+        uint32_t mConditionIndex{ 0 }; /**< index in mConditions */
+        uint64_t mSegments{ 0 };       /**< bits of the segments of the condition that use the buffer or window */
+    };
+
+    /**
+     * @brief Aggregates of one complete fixed window, besides min, max and avg
+     */
+    struct FixedWindowStatistics
+    {
+        bool mCompleted{ false }; /**< the window is over, count and sum are also valid without any sample */
+        uint32_t mCount{ 0 };
+        double mSum{ 0 };
+        double mStandardDeviation{ 0 };
+        double mFirst{ 0 };
+        double mLast{ 0 };
+        double mRateOfChange{ 0 }; /**< change per second from the first to the last sample */
+        bool mRateOfChangeAvailable{ false };
+        std::array<double, NUMBER_OF_WINDOW_QUANTILES> mQuantiles{};
+        bool mQuantilesAvailable{ false };
+    };
+
     /**
      * @brief maintains values like avg, min or max calculated over a certain time window
      *
@@ -267,6 +290,9 @@ private:
      * there is a new value for a signal all internal values are updated. There is no
      * need to look at historic values. The window is time based and not sample based.
      * Currently the last 2 windows are maintained inside this class.
+     *
+     * Quantiles and the sliding window over the same period are only calculated if a condition uses them, see
+     * enableFunction().
      * */
     template <typename T = double>
     class FixedTimeWindowFunctionData
@@ -288,11 +314,13 @@ private:
                                        * is 30 minutes long in the first 30 minutes of running FWE receiving the signal
                                        * no data is available
                                        */
+        FixedWindowStatistics mLastStatistics;
         // This values represents the value before the newest window
         T mPreviousLastMin{ std::numeric_limits<T>::min() };
         T mPreviousLastMax{ std::numeric_limits<T>::max() };
         T mPreviousLastAvg{ 0 };
         bool mPreviousLastAvailable{ false };
+        FixedWindowStatistics mPreviousLastStatistics;
 
         // This values are changed online with every new signal sample and will be used to calculate
         // the next window as soon as the window time is over
@@ -300,6 +328,23 @@ private:
         T mCollectingMax{ std::numeric_limits<T>::max() };
         double mCollectingSum{ 0 };
         uint32_t mCollectedSignals{ 0 };
+        // Welford's algorithm, numerically stable also for long windows
+        double mCollectingMean{ 0 };
+        double mCollectingSquaredDistance{ 0 };
+        double mCollectingFirst{ 0 };
+        double mCollectingLast{ 0 };
+        InspectionTimestamp mCollectingFirstTime{ 0 };
+        InspectionTimestamp mCollectingLastTime{ 0 };
+        bool mQuantilesEnabled{ false };
+        std::array<QuantileEstimator, NUMBER_OF_WINDOW_QUANTILES> mCollectingQuantiles{
+            { QuantileEstimator( 0.5 ), QuantileEstimator( 0.95 ), QuantileEstimator( 0.99 ) } };
+
+        // Values of the last mWindowSizeMs, independent of the fixed window boundaries
+        bool mSlidingWindowEnabled{ false };
+        SlidingWindowStatistics mSlidingWindow;
+
+        std::vector<ConditionDependency>
+            mDependentConditions; /**< conditions to reevaluate when this window rolls over */
 
         /**
          * @brief update fixed sample windows when fixed time is over
@@ -314,17 +359,92 @@ private:
         addValue( T value, InspectionTimestamp timestamp, InspectionTimestamp &nextWindowFunctionTimesOut )
         {
             updateWindow( timestamp, nextWindowFunctionTimesOut );
-            updateInternalVariables( value );
+            updateInternalVariables( value, timestamp );
+        }
+
+        /**
+         * @brief Enables the calculation of the aggregates that are only calculated on demand
+         * @param function window function used by a condition
+         */
+        inline void
+        enableFunction( WindowFunction function )
+        {
+            switch ( function )
+            {
+            case WindowFunction::LAST_FIXED_WINDOW_P50:
+            case WindowFunction::LAST_FIXED_WINDOW_P95:
+            case WindowFunction::LAST_FIXED_WINDOW_P99:
+            case WindowFunction::PREV_LAST_FIXED_WINDOW_P50:
+            case WindowFunction::PREV_LAST_FIXED_WINDOW_P95:
+            case WindowFunction::PREV_LAST_FIXED_WINDOW_P99:
+                mQuantilesEnabled = true;
+                break;
+            case WindowFunction::SLIDING_WINDOW_COUNT:
+            case WindowFunction::SLIDING_WINDOW_SUM:
+            case WindowFunction::SLIDING_WINDOW_AVG:
+            case WindowFunction::SLIDING_WINDOW_MIN:
+            case WindowFunction::SLIDING_WINDOW_MAX:
+            case WindowFunction::SLIDING_WINDOW_STDDEV:
+                mSlidingWindowEnabled = true;
+                break;
+            default:
+                break;
+            }
         }
 
     private:
         inline void
-        updateInternalVariables( T value )
+        updateInternalVariables( T value, InspectionTimestamp timestamp )
         {
             mCollectingMin = std::min( mCollectingMin, value );
             mCollectingMax = std::max( mCollectingMax, value );
-            mCollectingSum += static_cast<double>( value );
+            auto doubleValue = static_cast<double>( value );
+            mCollectingSum += doubleValue;
+            if ( mCollectedSignals == 0 )
+            {
+                mCollectingFirst = doubleValue;
+                mCollectingFirstTime = timestamp;
+            }
+            mCollectingLast = doubleValue;
+            mCollectingLastTime = timestamp;
             mCollectedSignals++;
+            double distance = doubleValue - mCollectingMean;
+            mCollectingMean += distance / mCollectedSignals;
+            mCollectingSquaredDistance += distance * ( doubleValue - mCollectingMean );
+            if ( mQuantilesEnabled )
+            {
+                for ( auto &quantile : mCollectingQuantiles )
+                {
+                    quantile.addValue( doubleValue );
+                }
+            }
+            if ( mSlidingWindowEnabled )
+            {
+                mSlidingWindow.addValue( doubleValue, timestamp );
+            }
+        }
+        inline void
+        finishWindow( FixedWindowStatistics &statistics ) const
+        {
+            statistics.mCompleted = true;
+            statistics.mCount = mCollectedSignals;
+            statistics.mSum = mCollectingSum;
+            statistics.mStandardDeviation =
+                ( mCollectedSignals > 0 ) ? std::sqrt( mCollectingSquaredDistance / mCollectedSignals ) : 0;
+            statistics.mFirst = mCollectingFirst;
+            statistics.mLast = mCollectingLast;
+            statistics.mRateOfChangeAvailable =
+                ( mCollectedSignals > 1 ) && ( mCollectingLastTime > mCollectingFirstTime );
+            statistics.mRateOfChange =
+                statistics.mRateOfChangeAvailable
+                    ? ( ( mCollectingLast - mCollectingFirst ) * 1000.0 /
+                        static_cast<double>( mCollectingLastTime - mCollectingFirstTime ) )
+                    : 0;
+            statistics.mQuantilesAvailable = mQuantilesEnabled && ( mCollectedSignals > 0 );
+            for ( size_t i = 0; statistics.mQuantilesAvailable && ( i < NUMBER_OF_WINDOW_QUANTILES ); i++ )
+            {
+                mCollectingQuantiles[i].getValue( statistics.mQuantiles[i] );
+            }
         }
         inline void
         initNewWindow( InspectionTimestamp timestamp, InspectionTimestamp &nextWindowFunctionTimesOut )
@@ -333,12 +453,49 @@ private:
             mCollectingMax = std::numeric_limits<T>::min();
             mCollectingSum = 0;
             mCollectedSignals = 0;
+            mCollectingMean = 0;
+            mCollectingSquaredDistance = 0;
+            for ( auto &quantile : mCollectingQuantiles )
+            {
+                quantile.reset();
+            }
             mLastTimeCalculated +=
                 static_cast<uint32_t>( ( timestamp - mLastTimeCalculated ) / mWindowSizeMs ) * mWindowSizeMs;
             nextWindowFunctionTimesOut = std::min( nextWindowFunctionTimesOut, mLastTimeCalculated + mWindowSizeMs );
         }
     }; // end class FixedTimeWindowFunctionData
 
+    static constexpr uint32_t SAMPLES_PER_SEGMENT = 256;
+
+    /**
+     * @brief Part of the ring buffer of a signal, shared with the collected data that references its samples
+     */
+    template <typename T = double>
+    struct SampleSegment
+    {
+        SampleSegment( uint32_t size )
+            : mValues( new T[size]() )
+            , mTimestamps( new InspectionTimestamp[size]() )
+            , mSize( size )
+        {
+        }
+        SampleSegment( const SampleSegment &other )
+            : SampleSegment( other.mSize )
+        {
+            std::copy( other.mValues.get(), other.mValues.get() + mSize, mValues.get() );
+            std::copy( other.mTimestamps.get(), other.mTimestamps.get() + mSize, mTimestamps.get() );
+        }
+        ~SampleSegment() = default;
+        SampleSegment &operator=( const SampleSegment & ) = delete;
+        SampleSegment( SampleSegment && ) = delete;
+        SampleSegment &operator=( SampleSegment && ) = delete;
+
+        // Arrays instead of std::vector, which stores bool as bits that can not be referenced
+        std::unique_ptr<T[]> mValues;
+        std::unique_ptr<InspectionTimestamp[]> mTimestamps;
+        uint32_t mSize{ 0 };
+    };
+
     /**
      * @brief stores the history of one signal.
      *
@@ -365,20 +522,70 @@ private:
         }
 
         uint32_t mMinimumSampleIntervalMs{ 0 };
-        std::vector<struct SignalSample<T>>
-            mBuffer; // ringbuffer, Consider to move to raw pointer allocated with new[] if vector allocates too much
+        // ringbuffer of the sample values and their timestamps, stored in separate arrays to keep them compact. The
+        // ringbuffer is split into segments of SAMPLES_PER_SEGMENT samples, which collected data can reference.
+        std::vector<std::shared_ptr<SampleSegment<T>>> mSegments;
+        uint32_t mAllocatedSize{ 0 };
         uint32_t mSize{ 0 };            // minimum size needed by all conditions, buffer must be at least this big
         uint32_t mCurrentPosition{ 0 }; /**< position in ringbuffer needs to come after size as it depends on it */
-        uint32_t mCounter{ 0 };         /**< over all recorded samples*/
+        uint32_t mCounter{ 0 };         /**< over all recorded samples, also identifies the newest sample */
+        // Newest sample, converted once for the evaluation of conditions
+        InspectionValue mLatestValue{ 0 };
         TimePoint mLastSample{ 0, 0 };
 #ifdef FWE_FEATURE_VISION_SYSTEM_DATA
         bool mContainsRawDataHandles{ false };
 #endif
         std::vector<FixedTimeWindowFunctionData<T>>
             mWindowFunctionData; /**< every signal buffer can have multiple windows over different time periods*/
-        std::bitset<MAX_NUMBER_OF_ACTIVE_CONDITION>
-            mConditionsThatEvaluateOnThisSignal; /**< if bit 0 is set it means element with index 0 of vector conditions
-                                                 needs to reevaluate if this signal changes*/
+        std::vector<ConditionDependency>
+            mDependentConditions; /**< conditions to reevaluate when a sample is added, each condition only once */
+
+        void
+        allocate()
+        {
+            mSegments.clear();
+            for ( uint32_t start = 0; start < mSize; start += SAMPLES_PER_SEGMENT )
+            {
+                auto segmentSize = std::min( SAMPLES_PER_SEGMENT, mSize - start );
+                mSegments.push_back( std::make_shared<SampleSegment<T>>( segmentSize ) );
+            }
+            mAllocatedSize = mSize;
+        }
+
+        inline T
+        getValue( uint32_t position ) const
+        {
+            return mSegments[position / SAMPLES_PER_SEGMENT]->mValues[position % SAMPLES_PER_SEGMENT];
+        }
+
+        inline InspectionTimestamp
+        getTimestamp( uint32_t position ) const
+        {
+            return mSegments[position / SAMPLES_PER_SEGMENT]->mTimestamps[position % SAMPLES_PER_SEGMENT];
+        }
+
+        /**
+         * @brief Overwrites a sample
+         *
+         * If collected data still references the segment of the sample, the segment is replaced by a copy first. The
+         * copy is needed as the other samples of the segment are still part of the history.
+         */
+        inline void
+        setSample( uint32_t position, T value, InspectionTimestamp timestamp )
+        {
+            auto &segment = mSegments[position / SAMPLES_PER_SEGMENT];
+            if ( segment.use_count() > 1 )
+            {
+                segment = std::make_shared<SampleSegment<T>>( *segment );
+            }
+            else
+            {
+                // The last other owner may have released the segment on another thread after reading it
+                std::atomic_thread_fence( std::memory_order_acquire );
+            }
+            segment->mValues[position % SAMPLES_PER_SEGMENT] = value;
+            segment->mTimestamps[position % SAMPLES_PER_SEGMENT] = timestamp;
+        }
 
         inline FixedTimeWindowFunctionData<T> *
         addFixedWindow( uint32_t windowSizeMs )
@@ -469,6 +676,59 @@ private:
                                                          FixedTimeWindowFunctionData<uint64_t> *,
                                                          FixedTimeWindowFunctionData<double> *>;
 
+    enum class ExpressionErrorCode
+    {
+        SUCCESSFUL,
+        SIGNAL_NOT_FOUND,
+        FUNCTION_DATA_NOT_AVAILABLE,
+        STACK_DEPTH_REACHED,
+        NOT_IMPLEMENTED_TYPE,
+        NOT_IMPLEMENTED_FUNCTION
+    };
+
+    /**
+     * @brief Reads a value of a fixed time window without knowing its type
+     */
+    using WindowFunctionGetter = ExpressionErrorCode ( * )( const void *window,
+                                                            WindowFunction function,
+                                                            InspectionValue &result );
+
+    /**
+     * @brief One instruction of a compiled condition
+     *
+     * The instructions of a condition are stored in postfix order and work on a stack of values. Signals and window
+     * functions are resolved to their buffers when the condition is compiled, so the evaluation needs no recursion
+     * and no lookups.
+     */
+    struct ConditionInstruction
+    {
+        ExpressionNodeType mNodeType{ ExpressionNodeType::FLOAT };
+        InspectionValue mFloatingValue{ 0 };
+        bool mBooleanValue{ false };
+        const InspectionValue *mLatestSignalValue{ nullptr }; /**< for SIGNAL the latest value of the buffer */
+        const uint32_t *mSignalCounter{ nullptr };           /**< for SIGNAL the sample counter of the buffer */
+        WindowFunction mWindowFunction{ WindowFunction::NONE };
+        const void *mWindow{ nullptr }; /**< for WINDOWFUNCTION the FixedTimeWindowFunctionData of the type the
+                                           mGetWindowValue function was instantiated for */
+        WindowFunctionGetter mGetWindowValue{ nullptr };
+        uint8_t mSegmentStart{ NO_SEGMENT }; /**< segment starting with this instruction */
+        uint8_t mSegmentEnd{ NO_SEGMENT };   /**< segment whose value this instruction computes */
+    };
+
+    /**
+     * @brief A subtree of a condition below its top logical operators, whose value is kept between evaluations
+     *
+     * A condition like (a > 5) AND (b + c < 10) consists of the segments a > 5 and b + c < 10. If only a changed, the
+     * next evaluation computes a > 5 and takes the value of the other segment from the last evaluation.
+     */
+    struct ConditionSegment
+    {
+        uint32_t mEnd{ 0 }; /**< index of the last instruction of the segment */
+        InspectionValue mDoubleValue{ 0 };
+        bool mBoolValue{ false };
+        bool mValid{ false }; /**< false until the segment was evaluated successfully */
+    };
+
     /**
      * @brief Stores information specific to one condition like the last time if was true
      */
@@ -476,6 +736,8 @@ private:
     {
         ActiveCondition( const ConditionWithCollectedData &conditionIn )
             : mCondition( conditionIn )
+            , mCollectedSignalCounters( conditionIn.signals.size(), 0 )
+            , mCollectedCanFrameCounters( conditionIn.canFrames.size(), 0 )
         {
         }
         InspectionTimestamp mLastDataTimestampPublished{ 0 };
@@ -485,7 +747,18 @@ private:
             mEvaluationSignals; // for fast lookup signals used for evaluation
         std::unordered_map<InspectionSignalID, FixedTimeWindowFunctionPtrVar>
             mEvaluationFunctions; // for fast lookup functions used for evaluation
+        std::vector<ConditionInstruction> mInstructions; /**< the compiled condition */
+        std::vector<ConditionSegment> mSegments;
+        uint64_t mChangedSegments{ 0 }; /**< bit is set if an input of the segment changed since its last evaluation */
+        uint32_t mIndex{ 0 };           /**< index in mConditions */
+        ExpressionErrorCode mCompileResult{ ExpressionErrorCode::SUCCESSFUL }; /**< if not successful the compiled
+                                                                                  condition always fails with it */
         const ConditionWithCollectedData &mCondition;
+        // For each signal of mCondition the counter of its history buffer when the condition last collected it. All
+        // samples with a lower counter are already collected by this condition.
+        std::vector<uint32_t> mCollectedSignalCounters;
+        std::vector<uint32_t> mCollectedCanFrameCounters; /**< the same for each CAN frame of mCondition */
+        bool mActiveDTCsCollected{ false };               /**< the current active DTCs were collected */
         // Unique Identifier of the Event matched by this condition.
         EventID mEventID{ 0 };
 
@@ -536,60 +809,110 @@ private:
         }
     };
 
-    enum class ExpressionErrorCode
-    {
-        SUCCESSFUL,
-        SIGNAL_NOT_FOUND,
-        FUNCTION_DATA_NOT_AVAILABLE,
-        STACK_DEPTH_REACHED,
-        NOT_IMPLEMENTED_TYPE,
-        NOT_IMPLEMENTED_FUNCTION
-    };
-
     bool preAllocateBuffers();
     bool isSignalPartOfEval( const ExpressionNode *expression, InspectionSignalID signalID, int remainingStackDepth );
 
-    ExpressionErrorCode eval( const ExpressionNode *expression,
-                              ActiveCondition &condition,
-                              InspectionValue &resultValueDouble,
-                              bool &resultValueBool,
-                              int remainingStackDepth );
-    ExpressionErrorCode getLatestSignalValue( InspectionSignalID id,
-                                              ActiveCondition &condition,
-                                              InspectionValue &result );
-    ExpressionErrorCode getSampleWindowFunction( WindowFunction function,
-                                                 InspectionSignalID signalID,
-                                                 ActiveCondition &condition,
-                                                 InspectionValue &result );
+    /**
+     * @brief Compiles the expression of the condition into its instructions
+     * @return SUCCESSFUL or the error every evaluation of the expression would fail with
+     */
+    ExpressionErrorCode compileExpression( const ExpressionNode *expression,
+                                           ActiveCondition &condition,
+                                           int remainingStackDepth,
+                                           uint8_t segment = NO_SEGMENT );
+    ExpressionErrorCode compileOperand( const ExpressionNode *expression, ActiveCondition &condition, uint8_t segment );
 
     template <typename T>
-    ExpressionErrorCode getSampleWindowFunctionType( WindowFunction function,
-                                                     InspectionSignalID signalID,
-                                                     ActiveCondition &condition,
-                                                     InspectionValue &result );
+    static ExpressionErrorCode compileOperandType( const ExpressionNode *expression,
+                                                   ActiveCondition &condition,
+                                                   uint8_t segment,
+                                                   ConditionInstruction &instruction );
+
+    /**
+     * @brief Registers that a segment of the condition has to be reevaluated when a buffer or window changes
+     */
+    static void addConditionDependency( std::vector<ConditionDependency> &dependencies,
+                                        const ActiveCondition &condition,
+                                        uint8_t segment );
+
+    /**
+     * @brief Marks the dependent conditions and their segments as changed
+     */
+    inline void
+    markConditionsChanged( const std::vector<ConditionDependency> &dependencies )
+    {
+        for ( const auto &dependency : dependencies )
+        {
+            mConditions[dependency.mConditionIndex].mChangedSegments |= dependency.mSegments;
+            if ( !mConditionsWithInputSignalChanged.test( dependency.mConditionIndex ) )
+            {
+                mConditionsWithInputSignalChanged.set( dependency.mConditionIndex );
+                mChangedConditions.push_back( dependency.mConditionIndex );
+            }
+        }
+    }
+
+    /**
+     * @brief Evaluates the compiled condition
+     *
+     * Segments without changed inputs are not computed again, their value from the last evaluation is used.
+     */
+    static ExpressionErrorCode eval( ActiveCondition &condition,
+                                     InspectionValue &resultValueDouble,
+                                     bool &resultValueBool );
+
+    template <typename T>
+    static ExpressionErrorCode getSampleWindowFunctionType( const void *window,
+                                                            WindowFunction function,
+                                                            InspectionValue &result );
+    static ExpressionErrorCode getFixedWindowStatistic( const FixedWindowStatistics &statistics,
+                                                        WindowFunction function,
+                                                        InspectionValue &result );
+    static ExpressionErrorCode getSlidingWindowStatistic( const SlidingWindowStatistics &statistics,
+                                                          WindowFunction function,
+                                                          InspectionValue &result );
 
     template <typename T>
     void collectLastSignals( InspectionSignalID id,
                              uint32_t minimumSamplingInterval,
                              uint32_t maxNumberOfSignalsToCollect,
-                             uint32_t conditionId,
+                             uint32_t &collectedCounter,
                              SignalType signalTypeIn,
+                             const SignalReduction &reduction,
                              InspectionTimestamp &newestSignalTimestamp,
-                             std::vector<CollectedSignal> &output );
+                             TriggeredCollectionSchemeData &output );
+
+    /**
+     * @brief Collects the newest samples of a buffer as slices that reference its segments
+     * @param numberOfSamples samples to look at, starting with the newest one
+     * @param notCollectedSamples only this many of the newest samples are added to the output
+     */
+    template <typename T>
+    void collectSignalSlices( const SignalHistoryBuffer<T> &buf,
+                              InspectionSignalID id,
+                              SignalType signalType,
+                              uint32_t numberOfSamples,
+                              uint32_t notCollectedSamples,
+                              InspectionTimestamp &newestSignalTimestamp,
+                              std::vector<CollectedSignalSlice> &output );
     void collectLastCanFrames( CANRawFrameID canID,
                                CANChannelNumericID channelID,
                                uint32_t minimumSamplingInterval,
                                uint32_t maxNumberOfSignalsToCollect,
-                               uint32_t conditionId,
+                               uint32_t &collectedCounter,
                                InspectionTimestamp &newestSignalTimestamp,
                                std::vector<CollectedCanRawFrame> &output );
 
     template <typename T>
     void updateConditionBuffer( const InspectionMatrixSignalCollectionInfo &inspectionMatrixCollectionInfoIn,
-                                ActiveCondition &acIn,
-                                const long unsigned int conditionIndexIn );
+                                ActiveCondition &acIn );
 
-    void updateAllFixedWindowFunctions( InspectionTimestamp timestamp );
+    /**
+     * @brief Rolls over the fixed windows whose time is over and marks the conditions that use them
+     *
+     * Only the windows that expired are touched, the others stay in mFixedWindowTimeouts.
+     */
+    void updateExpiredFixedWindowFunctions( InspectionTimestamp timestamp );
 
     /**
      * @brief Generate a unique Identifier of an event. The event ID
@@ -613,110 +936,135 @@ private:
         return ++counter;
     }
 
+    /**
+     * @brief History buffers of all signals of one type
+     *
+     * When the inspection matrix changes every signal gets a dense index into mBuffers. Adding a sample then only
+     * needs the lookup of this index, without dispatching on the type at runtime.
+     */
+    template <typename T = double>
+    struct SignalHistoryBufferStore
+    {
+        std::unordered_map<InspectionSignalID, uint32_t> mIndices; /**< index of each signal in mBuffers */
+        std::vector<std::vector<SignalHistoryBuffer<T>>>
+            mBuffers; /**< per signal one buffer for each different subsampling of this signal */
+    };
+
     // VSS supported datatypes
-    using signalHistoryBufferVar = boost::variant<std::vector<SignalHistoryBuffer<uint8_t>>,
-                                                  std::vector<SignalHistoryBuffer<int8_t>>,
-                                                  std::vector<SignalHistoryBuffer<uint16_t>>,
-                                                  std::vector<SignalHistoryBuffer<int16_t>>,
-                                                  std::vector<SignalHistoryBuffer<uint32_t>>,
-                                                  std::vector<SignalHistoryBuffer<int32_t>>,
-                                                  std::vector<SignalHistoryBuffer<uint64_t>>,
-                                                  std::vector<SignalHistoryBuffer<int64_t>>,
-                                                  std::vector<SignalHistoryBuffer<float>>,
-                                                  std::vector<SignalHistoryBuffer<double>>,
-                                                  std::vector<SignalHistoryBuffer<bool>>>;
-    using SignalHistoryBufferCollection = std::unordered_map<InspectionSignalID, signalHistoryBufferVar>;
-    SignalHistoryBufferCollection
-        mSignalBuffers; /**< signal history buffer. First vector has the signalID as index. In the nested vector
-                         * the different subsampling of this signal are stored. */
+    using SignalHistoryBufferCollection = std::tuple<SignalHistoryBufferStore<uint8_t>,
+                                                     SignalHistoryBufferStore<int8_t>,
+                                                     SignalHistoryBufferStore<uint16_t>,
+                                                     SignalHistoryBufferStore<int16_t>,
+                                                     SignalHistoryBufferStore<uint32_t>,
+                                                     SignalHistoryBufferStore<int32_t>,
+                                                     SignalHistoryBufferStore<uint64_t>,
+                                                     SignalHistoryBufferStore<int64_t>,
+                                                     SignalHistoryBufferStore<float>,
+                                                     SignalHistoryBufferStore<double>,
+                                                     SignalHistoryBufferStore<bool>>;
+    SignalHistoryBufferCollection mSignalBuffers; /**< signal history buffers, segregated by type */
 
     using SignalToBufferTypeMap = std::unordered_map<InspectionSignalID, SignalType>;
     SignalToBufferTypeMap mSignalToBufferTypeMap;
 
+    template <typename T = double>
+    SignalHistoryBufferStore<T> &
+    getSignalHistoryBufferStore()
+    {
+        return std::get<SignalHistoryBufferStore<T>>( mSignalBuffers );
+    }
+
+    /**
+     * @brief Get the buffers of a signal
+     * @return nullptr if the signal is not collected by any active condition with the type T
+     */
     template <typename T = double>
     std::vector<SignalHistoryBuffer<T>> *
     getSignalHistoryBufferPtr( InspectionSignalID signalIDIn )
     {
-        std::vector<SignalHistoryBuffer<T>> *resVec = nullptr;
-        if ( mSignalBuffers.find( signalIDIn ) == mSignalBuffers.end() )
+        auto &store = getSignalHistoryBufferStore<T>();
+        auto index = store.mIndices.find( signalIDIn );
+        if ( index == store.mIndices.end() )
         {
-            // create a new map entry
-            auto mapEntryVec = std::vector<SignalHistoryBuffer<T>>{};
-            try
-            {
-                signalHistoryBufferVar mapEntry = mapEntryVec;
-                mSignalBuffers.insert( { signalIDIn, mapEntry } );
-            }
-            catch ( ... )
-            {
-                FWE_LOG_ERROR( "Cannot Insert the signalHistoryBuffer vector for Signal " +
-                               std::to_string( signalIDIn ) );
-                return nullptr;
-            }
+            return nullptr;
         }
+        return &store.mBuffers[index->second];
+    }
 
-        try
-        {
-            auto signalBufferVectorPtr = mSignalBuffers.find( signalIDIn );
-            if ( signalBufferVectorPtr != mSignalBuffers.end() )
-            {
-                resVec = boost::get<std::vector<SignalHistoryBuffer<T>>>( &( signalBufferVectorPtr->second ) );
-            }
-        }
-        catch ( ... )
+    template <typename T>
+    bool allocateBufferVectors( uint32_t &usedBytes );
+
+    using FixedWindowUpdater = bool ( * )( void *window,
+                                          InspectionTimestamp timestamp,
+                                          InspectionTimestamp &nextWindowFunctionTimesOut );
+
+    /**
+     * @brief Time at which a fixed window has to be rolled over next
+     *
+     * The window itself can roll over earlier when a new sample arrives. Then mTimeout is too early and the window is
+     * only rescheduled when the entry comes up, so every window always has exactly one entry.
+     */
+    struct FixedWindowTimeout
+    {
+        InspectionTimestamp mTimeout{ 0 };
+        void *mWindow{ nullptr };
+        FixedWindowUpdater mUpdateWindow{ nullptr };
+        const std::vector<ConditionDependency> *mDependentConditions{ nullptr };
+
+        bool
+        operator>( const FixedWindowTimeout &other ) const
         {
-            FWE_LOG_ERROR( "Cannot retrive the signalHistoryBuffer vector for Signal " + std::to_string( signalIDIn ) );
+            return mTimeout > other.mTimeout;
         }
-        return resVec;
-    }
+    };
+    // Min-heap, the window that times out first is on top
+    using FixedWindowTimeoutQueue =
+        std::priority_queue<FixedWindowTimeout, std::vector<FixedWindowTimeout>, std::greater<FixedWindowTimeout>>;
+    FixedWindowTimeoutQueue mFixedWindowTimeouts;
 
     template <typename T>
-    bool allocateBufferVector( SignalID signalIDIn, uint32_t &usedBytes );
+    static bool updateFixedWindow( void *window,
+                                   InspectionTimestamp timestamp,
+                                   InspectionTimestamp &nextWindowFunctionTimesOut );
 
     template <typename T = double>
-    void updateBufferFixedWindowFunction( SignalID signalIDIn, InspectionTimestamp timestamp );
-
-    template <typename T>
-    ExpressionErrorCode getLatestBufferSignalValue( InspectionSignalID id,
-                                                    ActiveCondition &condition,
-                                                    InspectionValue &result );
+    void scheduleFixedWindows();
 
     using CanFrameHistoryBufferCollection = std::vector<CanFrameHistoryBuffer>;
     CanFrameHistoryBufferCollection mCanFrameBuffers; /**< signal history buffer for raw can frames. */
     DTCInfo mActiveDTCs;
-    SampleConsumed mActiveDTCsConsumed;
 
-    bool
-    isActiveDTCsConsumed( uint32_t conditionId )
-    {
-        return mActiveDTCsConsumed.isAlreadyConsumed( conditionId );
-    }
-    void
-    setActiveDTCsConsumed( uint32_t conditionId, bool value )
-    {
-        mActiveDTCsConsumed.setAlreadyConsumed( conditionId, value );
-    }
-
-    // index in this bitset also the index in conditions vector.
-    std::bitset<MAX_NUMBER_OF_ACTIVE_CONDITION>
+    // index in this bitset also the index in conditions vector. Sized to the number of conditions.
+    boost::dynamic_bitset<>
         mConditionsWithInputSignalChanged; // bit is set if any signal or fixed window that this condition uses in its
                                            // condition changed
-    std::bitset<MAX_NUMBER_OF_ACTIVE_CONDITION>
+    boost::dynamic_bitset<>
         mConditionsWithConditionCurrentlyTrue; // bit is set if the condition evaluated to true the last time
-    std::bitset<MAX_NUMBER_OF_ACTIVE_CONDITION>
+    boost::dynamic_bitset<>
         mConditionsNotTriggeredWaitingPublished; // bit is set if condition is not triggered, if bit is not set it means
                                                  // condition is triggered and waits for its data to be sent out
+    // The indices of the set bits of mConditionsWithInputSignalChanged and mConditionsWithConditionCurrentlyTrue, so
+    // the evaluation does not have to look at every condition
+    std::vector<uint32_t> mChangedConditions;
+    std::vector<uint32_t> mCurrentlyTrueConditions;
+    std::vector<uint32_t> mConditionsToEvaluate; /**< reused by evaluateConditions */
 
     std::vector<ActiveCondition> mConditions;
     std::shared_ptr<const InspectionMatrix> mActiveInspectionMatrix;
 
     std::shared_ptr<const TriggeredCollectionSchemeData> collectData( ActiveCondition &condition,
-                                                                      uint32_t conditionId,
                                                                       InspectionTimestamp &newestSignalTimestamp );
     uint32_t mNextConditionToCollectedIndex{ 0 };
+    // Reused when collecting signals with a reduction to not allocate memory every time
+    std::vector<uint32_t> mReductionPositions;
+    std::vector<InspectionTimestamp> mReductionTimestamps;
+    std::vector<double> mReductionValues;
+    std::vector<uint32_t> mReductionKeptIndices;
 
     InspectionTimestamp mNextWindowFunctionTimesOut{ 0 };
     bool mSendDataOnlyOncePerCondition{ false };
+    bool mZeroCopySignalCollection{ false };
+    uint32_t mMaxSampleMemory{ MAX_SAMPLE_MEMORY };
 #ifdef FWE_FEATURE_VISION_SYSTEM_DATA
     std::shared_ptr<RawData::BufferManager> mRawBufferManager{ nullptr };
 #endif
@@ -726,23 +1074,17 @@ template <typename T>
 void
 CollectionInspectionEngine::addNewSignal( InspectionSignalID id, const TimePoint &receiveTime, T value )
 {
-    if ( mSignalBuffers.find( id ) == mSignalBuffers.end() || mSignalBuffers[id].empty() )
+    auto *signalHistoryBufferPtr = getSignalHistoryBufferPtr<T>( id );
+    if ( signalHistoryBufferPtr == nullptr )
     {
         // Signal not collected by any active condition
         return;
     }
     // Iterate through all sampling intervals of the signal
-    std::vector<SignalHistoryBuffer<T>> *signalHistoryBufferPtr = nullptr;
-    signalHistoryBufferPtr = getSignalHistoryBufferPtr<T>( id );
-    if ( signalHistoryBufferPtr == nullptr )
-    {
-        // Invalid access to the map Buffer datatype
-        return;
-    }
     auto &bufferVec = *signalHistoryBufferPtr;
     for ( auto &buf : bufferVec )
     {
-        if ( ( ( buf.mSize > 0 ) && ( buf.mSize <= buf.mBuffer.size() ) ) &&
+        if ( ( ( buf.mSize > 0 ) && ( buf.mSize <= buf.mAllocatedSize ) ) &&
              ( ( buf.mMinimumSampleIntervalMs == 0 ) ||
                ( ( buf.mLastSample.systemTimeMs == 0 ) && ( buf.mLastSample.monotonicTimeMs == 0 ) ) ||
                ( receiveTime.monotonicTimeMs >= buf.mLastSample.monotonicTimeMs + buf.mMinimumSampleIntervalMs ) ) )
@@ -760,20 +1102,19 @@ CollectionInspectionEngine::addNewSignal( InspectionSignalID id, const TimePoint
                     id,
                     mRawBufferManager.get(),
                     RawData::BufferHandleUsageStage::COLLECTION_INSPECTION_ENGINE_HISTORY_BUFFER,
-                    buf.mBuffer[buf.mCurrentPosition].mValue );
+                    buf.getValue( buf.mCurrentPosition ) );
             }
 #endif
 
-            buf.mBuffer[buf.mCurrentPosition].mValue = value;
-            buf.mBuffer[buf.mCurrentPosition].mTimestamp = receiveTime.systemTimeMs;
-            buf.mBuffer[buf.mCurrentPosition].setAlreadyConsumed( ALL_CONDITIONS, false );
+            buf.setSample( buf.mCurrentPosition, value, receiveTime.systemTimeMs );
             buf.mCounter++;
+            buf.mLatestValue = static_cast<InspectionValue>( value );
             buf.mLastSample = receiveTime;
             for ( auto &window : buf.mWindowFunctionData )
             {
                 window.addValue( value, receiveTime.monotonicTimeMs, mNextWindowFunctionTimesOut );
             }
-            mConditionsWithInputSignalChanged |= buf.mConditionsThatEvaluateOnThisSignal;
+            markConditionsChanged( buf.mDependentConditions );
 #ifdef FWE_FEATURE_VISION_SYSTEM_DATA
             if ( buf.mContainsRawDataHandles )
             {
@@ -793,6 +1134,7 @@ bool
 CollectionInspectionEngine::FixedTimeWindowFunctionData<T>::updateWindow(
     InspectionTimestamp timestamp, InspectionTimestamp &nextWindowFunctionTimesOut )
 {
+    bool changed = true;
     if ( mLastTimeCalculated == 0 )
     {
         // First time a signal arrives start the window for this signal
@@ -815,6 +1157,9 @@ CollectionInspectionEngine::FixedTimeWindowFunctionData<T>::updateWindow(
             mPreviousLastMax = mCollectingMax;
             mPreviousLastAvg = static_cast<T>( mCollectingSum / mCollectedSignals );
         }
+        finishWindow( mPreviousLastStatistics );
+        mLastStatistics = FixedWindowStatistics();
+        mLastStatistics.mCompleted = true;
         initNewWindow( timestamp, nextWindowFunctionTimesOut );
     }
     else if ( timestamp >= mLastTimeCalculated + mWindowSizeMs )
@@ -823,6 +1168,7 @@ CollectionInspectionEngine::FixedTimeWindowFunctionData<T>::updateWindow(
         mPreviousLastMax = mLastMax;
         mPreviousLastAvg = mLastAvg;
         mPreviousLastAvailable = mLastAvailable;
+        mPreviousLastStatistics = mLastStatistics;
         if ( mCollectedSignals == 0 )
         {
             mLastAvailable = false;
@@ -834,14 +1180,26 @@ CollectionInspectionEngine::FixedTimeWindowFunctionData<T>::updateWindow(
             mLastMax = mCollectingMax;
             mLastAvg = static_cast<T>( mCollectingSum / mCollectedSignals );
         }
+        finishWindow( mLastStatistics );
         initNewWindow( timestamp, nextWindowFunctionTimesOut );
     }
     else
     {
         nextWindowFunctionTimesOut = std::min( nextWindowFunctionTimesOut, mLastTimeCalculated + mWindowSizeMs );
-        return false;
+        changed = false;
+    }
+    if ( mSlidingWindowEnabled )
+    {
+        if ( mSlidingWindow.removeOldValues( timestamp ) )
+        {
+            changed = true;
+        }
+        if ( mSlidingWindow.getCount() > 0 )
+        {
+            nextWindowFunctionTimesOut = std::min( nextWindowFunctionTimesOut, mSlidingWindow.getNextRemovalTime() );
+        }
     }
-    return true;
+    return changed;
 }
 
 } // namespace IoTFleetWise
@@ -16,11 +16,96 @@ namespace Aws
 {
 namespace IoTFleetWise
 {
+namespace
+{
+
+uint64_t
+canFrameKey( CANRawFrameID frameID, CANChannelNumericID channelID )
+{
+    return ( static_cast<uint64_t>( channelID ) << 32U ) | static_cast<uint64_t>( frameID );
+}
+
+/**
+ * @brief Decrements the trace counters of the signal buffer once a data frame was taken out of it
+ */
+void
+traceDataFrameDequeued( const CollectedDataFrame &dataFrame )
+{
+    TraceModule::get().decrementAtomicVariable( TraceAtomicVariable::QUEUE_CONSUMER_TO_INSPECTION_DATA_FRAMES );
+    for ( size_t i = 0; i < dataFrame.mCollectedSignals.size(); i++ )
+    {
+        TraceModule::get().decrementAtomicVariable( TraceAtomicVariable::QUEUE_CONSUMER_TO_INSPECTION_SIGNALS );
+    }
+    if ( dataFrame.mCollectedCanRawFrame != nullptr )
+    {
+        TraceModule::get().decrementAtomicVariable( TraceAtomicVariable::QUEUE_CONSUMER_TO_INSPECTION_CAN );
+    }
+    if ( dataFrame.mActiveDTCs != nullptr )
+    {
+        TraceModule::get().decrementAtomicVariable( TraceAtomicVariable::QUEUE_CONSUMER_TO_INSPECTION_DTCS );
+    }
+}
+
+// The matrix of a shard copies the conditions, which still point to the expression nodes of the original matrix
+struct ShardInspectionMatrix
+{
+    std::shared_ptr<const InspectionMatrix> original;
+    InspectionMatrix matrix;
+};
+
+#ifdef FWE_FEATURE_VISION_SYSTEM_DATA
+void
+releaseRawDataHandles( RawData::BufferManager &rawBufferManager, const CollectedDataFrame &dataFrame )
+{
+    for ( const auto &inputSignal : dataFrame.mCollectedSignals )
+    {
+        auto signalValue = inputSignal.getValue();
+        if ( signalValue.getType() == SignalType::RAW_DATA_BUFFER_HANDLE )
+        {
+            rawBufferManager.decreaseHandleUsageHint(
+                inputSignal.signalID,
+                signalValue.value.uint32Val,
+                RawData::BufferHandleUsageStage::COLLECTED_NOT_IN_HISTORY_BUFFER );
+        }
+    }
+}
+
+// A frame shared by several shards. The raw data handles are released once the last shard added them to its history.
+struct SharedRawDataFrame
+{
+    SharedRawDataFrame( CollectedDataFrame dataFrame, std::shared_ptr<RawData::BufferManager> rawBufferManager )
+        : frame( std::move( dataFrame ) )
+        , bufferManager( std::move( rawBufferManager ) )
+    {
+    }
+    ~SharedRawDataFrame()
+    {
+        releaseRawDataHandles( *bufferManager, frame );
+    }
+    SharedRawDataFrame( const SharedRawDataFrame & ) = delete;
+    SharedRawDataFrame &operator=( const SharedRawDataFrame & ) = delete;
+    SharedRawDataFrame( SharedRawDataFrame && ) = delete;
+    SharedRawDataFrame &operator=( SharedRawDataFrame && ) = delete;
+
+    CollectedDataFrame frame;
+    std::shared_ptr<RawData::BufferManager> bufferManager;
+};
+#endif
+
+} // namespace
+
+constexpr uint32_t CollectionInspectionWorkerThread::MAX_NUMBER_OF_SHARDS;      // NOLINT
+constexpr size_t CollectionInspectionWorkerThread::SHARD_SIGNAL_BUFFER_SIZE;    // NOLINT
+constexpr size_t CollectionInspectionWorkerThread::DISPATCH_BATCH_SIZE;         // NOLINT
+constexpr uint32_t CollectionInspectionWorkerThread::SHARD_BUFFER_FULL_WAIT_MS; // NOLINT
 
 bool
 CollectionInspectionWorkerThread::init( const std::shared_ptr<SignalBuffer> &inputSignalBuffer,
                                         const std::shared_ptr<CollectedDataReadyToPublish> &outputCollectedData,
-                                        uint32_t idleTimeMs
+                                        uint32_t idleTimeMs,
+                                        uint32_t numberOfShards,
+                                        bool zeroCopySignalCollection,
+                                        size_t shardSignalBufferSize
 #ifdef FWE_FEATURE_VISION_SYSTEM_DATA
                                         ,
                                         std::shared_ptr<RawData::BufferManager> rawBufferManager
@@ -33,7 +118,41 @@ CollectionInspectionWorkerThread::init( const std::shared_ptr<SignalBuffer> &inp
     {
         fIdleTimeMs = idleTimeMs;
     }
+    if ( numberOfShards > MAX_NUMBER_OF_SHARDS )
+    {
+        FWE_LOG_WARN( "Number of inspection engine shards " + std::to_string( numberOfShards ) +
+                      " is limited to " + std::to_string( MAX_NUMBER_OF_SHARDS ) );
+        numberOfShards = MAX_NUMBER_OF_SHARDS;
+    }
+    mShards.clear();
+    if ( numberOfShards > 1 )
+    {
+        for ( uint32_t i = 0; i < numberOfShards; i++ )
+        {
+            auto shard = std::make_unique<CollectionInspectionWorkerThread>();
+            shard->fShardInputSignalBuffer = std::make_unique<ShardSignalBuffer>( shardSignalBufferSize );
+            shard->fOutputCollectedData = outputCollectedData;
+            shard->fIdleTimeMs = fIdleTimeMs;
+            shard->fThreadName = "fwDIInsShard" + std::to_string( i );
+            shard->fCollectionInspectionEngine.setZeroCopySignalCollection( zeroCopySignalCollection );
+            // A signal used by conditions of several shards is buffered in each of them, so the shards share the
+            // sample memory of a single engine instead of multiplying it
+            shard->fCollectionInspectionEngine.setMaxSampleMemory( CollectionInspectionEngine::MAX_SAMPLE_MEMORY /
+                                                                   numberOfShards );
+#ifdef FWE_FEATURE_VISION_SYSTEM_DATA
+            // Only the engine of the shard is informed, the dispatcher releases the handles of the shared frames
+            shard->fCollectionInspectionEngine.setRawDataBufferManager( rawBufferManager );
+#endif
+            shard->subscribeToDataReadyToPublish( [this]() {
+                mDataReadyListeners.notify();
+            } );
+            mShards.push_back( std::move( shard ) );
+        }
+        FWE_LOG_INFO( "Distributing the conditions over " + std::to_string( numberOfShards ) +
+                      " inspection engine shards" );
+    }
 
+    fCollectionInspectionEngine.setZeroCopySignalCollection( zeroCopySignalCollection );
 #ifdef FWE_FEATURE_VISION_SYSTEM_DATA
     fCollectionInspectionEngine.setRawDataBufferManager( rawBufferManager );
     mRawBufferManager = std::move( rawBufferManager );
@@ -44,7 +163,8 @@ CollectionInspectionWorkerThread::init( const std::shared_ptr<SignalBuffer> &inp
 bool
 CollectionInspectionWorkerThread::start()
 {
-    if ( ( fInputSignalBuffer == nullptr ) || ( fOutputCollectedData == nullptr ) )
+    if ( ( ( fInputSignalBuffer == nullptr ) && ( fShardInputSignalBuffer == nullptr ) ) ||
+         ( fOutputCollectedData == nullptr ) )
     {
         FWE_LOG_ERROR( "Collection Engine cannot be started without correct configurations" );
         return false;
@@ -54,14 +174,21 @@ CollectionInspectionWorkerThread::start()
     // On multi core systems the shared variable fShouldStop must be updated for
     // all cores before starting the thread otherwise thread will directly end
     fShouldStop.store( false );
-    if ( !fThread.create( doWork, this ) )
+    for ( auto &shard : mShards )
+    {
+        if ( !shard->start() )
+        {
+            return false;
+        }
+    }
+    if ( !fThread.create( mShards.empty() ? doWork : doDispatch, this ) )
     {
         FWE_LOG_TRACE( "Inspection Thread failed to start" );
     }
     else
     {
         FWE_LOG_TRACE( "Inspection Thread started" );
-        fThread.setThreadName( "fwDICollInsEng" );
+        fThread.setThreadName( fThreadName );
     }
 
     return fThread.isActive() && fThread.isValid();
@@ -70,18 +197,24 @@ CollectionInspectionWorkerThread::start()
 bool
 CollectionInspectionWorkerThread::stop()
 {
-    if ( ( !fThread.isValid() ) || ( !fThread.isActive() ) )
+    bool stopped = true;
+    if ( fThread.isValid() && fThread.isActive() )
     {
-        return true;
+        std::lock_guard<std::mutex> lock( fThreadMutex );
+        fShouldStop.store( true, std::memory_order_relaxed );
+        FWE_LOG_TRACE( "Request stop" );
+        fWait.notify();
+        fThread.release();
+        FWE_LOG_TRACE( "Stop finished" );
+        fShouldStop.store( false, std::memory_order_relaxed );
+        stopped = !fThread.isActive();
     }
-    std::lock_guard<std::mutex> lock( fThreadMutex );
-    fShouldStop.store( true, std::memory_order_relaxed );
-    FWE_LOG_TRACE( "Request stop" );
-    fWait.notify();
-    fThread.release();
-    FWE_LOG_TRACE( "Stop finished" );
-    fShouldStop.store( false, std::memory_order_relaxed );
-    return !fThread.isActive();
+    // The shards are stopped after the dispatching thread, which pushes to them
+    for ( auto &shard : mShards )
+    {
+        stopped = shard->stop() && stopped;
+    }
+    return stopped;
 }
 
 bool
@@ -144,135 +277,7 @@ CollectionInspectionWorkerThread::doWork( void *data )
             uint32_t waitTimeMs = consumer->fIdleTimeMs;
             // Consume any new signals and pass them over to the inspection Engine
             auto consumeSignalGroups = [&]( const CollectedDataFrame &dataFrame ) {
-                TraceModule::get().decrementAtomicVariable(
-                    TraceAtomicVariable::QUEUE_CONSUMER_TO_INSPECTION_DATA_FRAMES );
-                TraceModule::get().incrementVariable( TraceVariable::CE_PROCESSED_DATA_FRAMES );
-
-                if ( !dataFrame.mCollectedSignals.empty() )
-                {
-                    for ( auto &inputSignal : dataFrame.mCollectedSignals )
-                    {
-                        TraceModule::get().decrementAtomicVariable(
-                            TraceAtomicVariable::QUEUE_CONSUMER_TO_INSPECTION_SIGNALS );
-                        TraceModule::get().incrementVariable( TraceVariable::CE_PROCESSED_SIGNALS );
-                        auto signalValue = inputSignal.getValue();
-                        switch ( signalValue.getType() )
-                        {
-                        case SignalType::UINT8:
-                            consumer->fCollectionInspectionEngine.addNewSignal<uint8_t>(
-                                inputSignal.signalID,
-                                calculateMonotonicTime( currentTime, inputSignal.receiveTime ),
-                                signalValue.value.uint8Val );
-                            break;
-                        case SignalType::INT8:
-                            consumer->fCollectionInspectionEngine.addNewSignal<int8_t>(
-                                inputSignal.signalID,
-                                calculateMonotonicTime( currentTime, inputSignal.receiveTime ),
-                                signalValue.value.int8Val );
-                            break;
-                        case SignalType::UINT16:
-                            consumer->fCollectionInspectionEngine.addNewSignal<uint16_t>(
-                                inputSignal.signalID,
-                                calculateMonotonicTime( currentTime, inputSignal.receiveTime ),
-                                signalValue.value.uint16Val );
-                            break;
-                        case SignalType::INT16:
-                            consumer->fCollectionInspectionEngine.addNewSignal<int16_t>(
-                                inputSignal.signalID,
-                                calculateMonotonicTime( currentTime, inputSignal.receiveTime ),
-                                signalValue.value.int16Val );
-                            break;
-                        case SignalType::UINT32:
-                            consumer->fCollectionInspectionEngine.addNewSignal<uint32_t>(
-                                inputSignal.signalID,
-                                calculateMonotonicTime( currentTime, inputSignal.receiveTime ),
-                                signalValue.value.uint32Val );
-                            break;
-                        case SignalType::INT32:
-                            consumer->fCollectionInspectionEngine.addNewSignal<int32_t>(
-                                inputSignal.signalID,
-                                calculateMonotonicTime( currentTime, inputSignal.receiveTime ),
-                                signalValue.value.int32Val );
-                            break;
-                        case SignalType::UINT64:
-                            consumer->fCollectionInspectionEngine.addNewSignal<uint64_t>(
-                                inputSignal.signalID,
-                                calculateMonotonicTime( currentTime, inputSignal.receiveTime ),
-                                signalValue.value.uint64Val );
-                            break;
-                        case SignalType::INT64:
-                            consumer->fCollectionInspectionEngine.addNewSignal<int64_t>(
-                                inputSignal.signalID,
-                                calculateMonotonicTime( currentTime, inputSignal.receiveTime ),
-                                signalValue.value.int64Val );
-                            break;
-                        case SignalType::FLOAT:
-                            consumer->fCollectionInspectionEngine.addNewSignal<float>(
-                                inputSignal.signalID,
-                                calculateMonotonicTime( currentTime, inputSignal.receiveTime ),
-                                signalValue.value.floatVal );
-                            break;
-                        case SignalType::DOUBLE:
-                            consumer->fCollectionInspectionEngine.addNewSignal<double>(
-                                inputSignal.signalID,
-                                calculateMonotonicTime( currentTime, inputSignal.receiveTime ),
-                                signalValue.value.doubleVal );
-                            break;
-                        case SignalType::BOOLEAN:
-                            consumer->fCollectionInspectionEngine.addNewSignal<bool>(
-                                inputSignal.signalID,
-                                calculateMonotonicTime( currentTime, inputSignal.receiveTime ),
-                                signalValue.value.boolVal );
-                            break;
-#ifdef FWE_FEATURE_VISION_SYSTEM_DATA
-                        case SignalType::RAW_DATA_BUFFER_HANDLE:
-                            consumer->fCollectionInspectionEngine.addNewSignal<RawData::BufferHandle>(
-                                inputSignal.signalID,
-                                calculateMonotonicTime( currentTime, inputSignal.receiveTime ),
-                                signalValue.value.uint32Val );
-                            if ( consumer->mRawBufferManager != nullptr )
-                            {
-                                consumer->mRawBufferManager->decreaseHandleUsageHint(
-                                    inputSignal.signalID,
-                                    signalValue.value.uint32Val,
-                                    RawData::BufferHandleUsageStage::COLLECTED_NOT_IN_HISTORY_BUFFER );
-                            }
-                            break;
-#endif
-                        }
-                        statisticInputMessagesProcessed++;
-                    }
-                }
-                if ( dataFrame.mCollectedCanRawFrame != nullptr )
-                {
-                    // Consume any raw frames
-                    TraceModule::get().decrementAtomicVariable( TraceAtomicVariable::QUEUE_CONSUMER_TO_INSPECTION_CAN );
-                    TraceModule::get().incrementVariable( TraceVariable::CE_PROCESSED_CAN_FRAMES );
-
-                    consumer->fCollectionInspectionEngine.addNewRawCanFrame(
-                        dataFrame.mCollectedCanRawFrame->frameID,
-                        dataFrame.mCollectedCanRawFrame->channelId,
-                        calculateMonotonicTime( currentTime, dataFrame.mCollectedCanRawFrame->receiveTime ),
-                        dataFrame.mCollectedCanRawFrame->data,
-                        dataFrame.mCollectedCanRawFrame->size );
-                    statisticInputMessagesProcessed++;
-                }
-
-                // Consume any Active DTCs
-                // We could check if the DTCs have changed here, but not necessary
-                // as we are looking at only the latest known DTCs.
-                // We only pop one item from the Buffer for a reason : DTCs represent
-                // the health of all ECUs in the network. The Inspection Engine does
-                // not need to know that topology and thus counts on the OBD Module
-                // to aggregate all DTCs from all ECUs in one single Item.
-                if ( dataFrame.mActiveDTCs != nullptr )
-                {
-                    TraceModule::get().decrementAtomicVariable(
-                        TraceAtomicVariable::QUEUE_CONSUMER_TO_INSPECTION_DTCS );
-                    TraceModule::get().incrementVariable( TraceVariable::CE_PROCESSED_DTCS );
-                    consumer->fCollectionInspectionEngine.setActiveDTCs( *dataFrame.mActiveDTCs.get() );
-                    statisticInputMessagesProcessed++;
-                }
+                statisticInputMessagesProcessed += consumer->processDataFrame( dataFrame, currentTime );
 
                 lastTimeEvaluated = consumer->fClock->timeSinceEpoch();
                 consumer->fCollectionInspectionEngine.evaluateConditions( lastTimeEvaluated );
@@ -280,7 +285,20 @@ CollectionInspectionWorkerThread::doWork( void *data )
                 // Initiate data collection and upload after every condition evaluation
                 statisticDataSentOut += consumer->collectDataAndUpload();
             };
-            auto consumed = consumer->fInputSignalBuffer->consumeAll( consumeSignalGroups );
+            size_t consumed = 0;
+            if ( consumer->fShardInputSignalBuffer != nullptr )
+            {
+                consumed = consumer->fShardInputSignalBuffer->consumeAll( [&]( const SharedDataFrame &dataFrame ) {
+                    consumeSignalGroups( *dataFrame );
+                } );
+            }
+            else
+            {
+                consumed = consumer->fInputSignalBuffer->consumeAll( [&]( const CollectedDataFrame &dataFrame ) {
+                    traceDataFrameDequeued( dataFrame );
+                    consumeSignalGroups( dataFrame );
+                } );
+            }
 
             // If nothing was consumed and at least the evaluate interval has elapsed, evaluate the
             // conditions to check heartbeat campaigns:
@@ -323,6 +341,340 @@ CollectionInspectionWorkerThread::doWork( void *data )
     }
 }
 
+uint32_t
+CollectionInspectionWorkerThread::processDataFrame( const CollectedDataFrame &dataFrame, const TimePoint &currentTime )
+{
+    uint32_t processed = 0;
+    TraceModule::get().incrementVariable( TraceVariable::CE_PROCESSED_DATA_FRAMES );
+    for ( auto &inputSignal : dataFrame.mCollectedSignals )
+    {
+        TraceModule::get().incrementVariable( TraceVariable::CE_PROCESSED_SIGNALS );
+        auto signalValue = inputSignal.getValue();
+        switch ( signalValue.getType() )
+        {
+        case SignalType::UINT8:
+            fCollectionInspectionEngine.addNewSignal<uint8_t>(
+                inputSignal.signalID,
+                calculateMonotonicTime( currentTime, inputSignal.receiveTime ),
+                signalValue.value.uint8Val );
+            break;
+        case SignalType::INT8:
+            fCollectionInspectionEngine.addNewSignal<int8_t>(
+                inputSignal.signalID,
+                calculateMonotonicTime( currentTime, inputSignal.receiveTime ),
+                signalValue.value.int8Val );
+            break;
+        case SignalType::UINT16:
+            fCollectionInspectionEngine.addNewSignal<uint16_t>(
+                inputSignal.signalID,
+                calculateMonotonicTime( currentTime, inputSignal.receiveTime ),
+                signalValue.value.uint16Val );
+            break;
+        case SignalType::INT16:
+            fCollectionInspectionEngine.addNewSignal<int16_t>(
+                inputSignal.signalID,
+                calculateMonotonicTime( currentTime, inputSignal.receiveTime ),
+                signalValue.value.int16Val );
+            break;
+        case SignalType::UINT32:
+            fCollectionInspectionEngine.addNewSignal<uint32_t>(
+                inputSignal.signalID,
+                calculateMonotonicTime( currentTime, inputSignal.receiveTime ),
+                signalValue.value.uint32Val );
+            break;
+        case SignalType::INT32:
+            fCollectionInspectionEngine.addNewSignal<int32_t>(
+                inputSignal.signalID,
+                calculateMonotonicTime( currentTime, inputSignal.receiveTime ),
+                signalValue.value.int32Val );
+            break;
+        case SignalType::UINT64:
+            fCollectionInspectionEngine.addNewSignal<uint64_t>(
+                inputSignal.signalID,
+                calculateMonotonicTime( currentTime, inputSignal.receiveTime ),
+                signalValue.value.uint64Val );
+            break;
+        case SignalType::INT64:
+            fCollectionInspectionEngine.addNewSignal<int64_t>(
+                inputSignal.signalID,
+                calculateMonotonicTime( currentTime, inputSignal.receiveTime ),
+                signalValue.value.int64Val );
+            break;
+        case SignalType::FLOAT:
+            fCollectionInspectionEngine.addNewSignal<float>(
+                inputSignal.signalID,
+                calculateMonotonicTime( currentTime, inputSignal.receiveTime ),
+                signalValue.value.floatVal );
+            break;
+        case SignalType::DOUBLE:
+            fCollectionInspectionEngine.addNewSignal<double>(
+                inputSignal.signalID,
+                calculateMonotonicTime( currentTime, inputSignal.receiveTime ),
+                signalValue.value.doubleVal );
+            break;
+        case SignalType::BOOLEAN:
+            fCollectionInspectionEngine.addNewSignal<bool>(
+                inputSignal.signalID,
+                calculateMonotonicTime( currentTime, inputSignal.receiveTime ),
+                signalValue.value.boolVal );
+            break;
+#ifdef FWE_FEATURE_VISION_SYSTEM_DATA
+        case SignalType::RAW_DATA_BUFFER_HANDLE:
+            fCollectionInspectionEngine.addNewSignal<RawData::BufferHandle>(
+                inputSignal.signalID,
+                calculateMonotonicTime( currentTime, inputSignal.receiveTime ),
+                signalValue.value.uint32Val );
+            if ( mRawBufferManager != nullptr )
+            {
+                mRawBufferManager->decreaseHandleUsageHint(
+                    inputSignal.signalID,
+                    signalValue.value.uint32Val,
+                    RawData::BufferHandleUsageStage::COLLECTED_NOT_IN_HISTORY_BUFFER );
+            }
+            break;
+#endif
+        }
+        processed++;
+    }
+    if ( dataFrame.mCollectedCanRawFrame != nullptr )
+    {
+        // Consume any raw frames
+        TraceModule::get().incrementVariable( TraceVariable::CE_PROCESSED_CAN_FRAMES );
+
+        fCollectionInspectionEngine.addNewRawCanFrame(
+            dataFrame.mCollectedCanRawFrame->frameID,
+            dataFrame.mCollectedCanRawFrame->channelId,
+            calculateMonotonicTime( currentTime, dataFrame.mCollectedCanRawFrame->receiveTime ),
+            dataFrame.mCollectedCanRawFrame->data,
+            dataFrame.mCollectedCanRawFrame->size );
+        processed++;
+    }
+
+    // Consume any Active DTCs
+    // We could check if the DTCs have changed here, but not necessary
+    // as we are looking at only the latest known DTCs.
+    // We only pop one item from the Buffer for a reason : DTCs represent
+    // the health of all ECUs in the network. The Inspection Engine does
+    // not need to know that topology and thus counts on the OBD Module
+    // to aggregate all DTCs from all ECUs in one single Item.
+    if ( dataFrame.mActiveDTCs != nullptr )
+    {
+        TraceModule::get().incrementVariable( TraceVariable::CE_PROCESSED_DTCS );
+        fCollectionInspectionEngine.setActiveDTCs( *dataFrame.mActiveDTCs.get() );
+        processed++;
+    }
+    return processed;
+}
+
+void
+CollectionInspectionWorkerThread::doDispatch( void *data )
+{
+    CollectionInspectionWorkerThread *dispatcher = static_cast<CollectionInspectionWorkerThread *>( data );
+    while ( true )
+    {
+        if ( dispatcher->fUpdatedInspectionMatrixAvailable )
+        {
+            std::shared_ptr<const InspectionMatrix> newInspectionMatrix;
+            {
+                std::lock_guard<std::mutex> lock( dispatcher->fInspectionMatrixMutex );
+                dispatcher->fUpdatedInspectionMatrixAvailable = false;
+                newInspectionMatrix = dispatcher->fUpdatedInspectionMatrix;
+            }
+            dispatcher->updateShards( newInspectionMatrix );
+        }
+        if ( dispatcher->fUpdatedInspectionMatrix )
+        {
+            uint32_t notifiedShards = 0;
+            size_t dispatched = 0;
+            // Wake up the shards after a batch of frames, so they do not wait for the whole queue to be dispatched
+            while ( ( dispatched < DISPATCH_BATCH_SIZE ) &&
+                    dispatcher->fInputSignalBuffer->pop( dispatcher->mDispatchedFrame ) )
+            {
+                dispatcher->dispatchDataFrame( dispatcher->mDispatchedFrame, notifiedShards );
+                dispatched++;
+            }
+            for ( size_t i = 0; i < dispatcher->mShards.size(); i++ )
+            {
+                if ( ( notifiedShards & ( 1U << i ) ) != 0 )
+                {
+                    dispatcher->mShards[i]->onNewDataAvailable();
+                }
+            }
+            if ( dispatched < DISPATCH_BATCH_SIZE )
+            {
+                // The shards evaluate time based conditions on their own, so only wait for new data
+                dispatcher->fWait.wait( dispatcher->fIdleTimeMs );
+            }
+        }
+        else
+        {
+            // No inspection Matrix available. Wait for it from the CollectionScheme manager
+            dispatcher->fWait.wait( Signal::WaitWithPredicate );
+        }
+        if ( dispatcher->shouldStop() )
+        {
+            break;
+        }
+    }
+}
+
+void
+CollectionInspectionWorkerThread::dispatchDataFrame( CollectedDataFrame &dataFrame, uint32_t &notifiedShards )
+{
+    traceDataFrameDequeued( dataFrame );
+    uint32_t shards = 0;
+    for ( const auto &signal : dataFrame.mCollectedSignals )
+    {
+        auto it = mSignalShards.find( signal.signalID );
+        if ( it != mSignalShards.end() )
+        {
+            shards |= it->second;
+        }
+    }
+    if ( dataFrame.mCollectedCanRawFrame != nullptr )
+    {
+        auto it = mCanFrameShards.find(
+            canFrameKey( dataFrame.mCollectedCanRawFrame->frameID, dataFrame.mCollectedCanRawFrame->channelId ) );
+        if ( it != mCanFrameShards.end() )
+        {
+            shards |= it->second;
+        }
+    }
+    if ( dataFrame.mActiveDTCs != nullptr )
+    {
+        // Every engine keeps the latest DTCs
+        shards = static_cast<uint32_t>( ( uint64_t{ 1 } << mShards.size() ) - 1U );
+    }
+    // Wait instead of dropping the frame for some of the shards only. Meanwhile new frames queue up in the input
+    // signal buffer, which drops them for all conditions once it is full, like with a single engine.
+    if ( ( shards == 0 ) || ( !waitForShardCapacity( shards ) ) )
+    {
+#ifdef FWE_FEATURE_VISION_SYSTEM_DATA
+        if ( mRawBufferManager != nullptr )
+        {
+            releaseRawDataHandles( *mRawBufferManager, dataFrame );
+        }
+#endif
+        return;
+    }
+
+    SharedDataFrame sharedFrame;
+#ifdef FWE_FEATURE_VISION_SYSTEM_DATA
+    if ( mRawBufferManager != nullptr )
+    {
+        auto rawDataFrame = std::make_shared<SharedRawDataFrame>( std::move( dataFrame ), mRawBufferManager );
+        sharedFrame = SharedDataFrame( rawDataFrame, &rawDataFrame->frame );
+    }
+#endif
+    if ( sharedFrame == nullptr )
+    {
+        sharedFrame = std::make_shared<const CollectedDataFrame>( std::move( dataFrame ) );
+    }
+    for ( size_t i = 0; i < mShards.size(); i++ )
+    {
+        if ( ( shards & ( 1U << i ) ) == 0 )
+        {
+            continue;
+        }
+        SharedDataFrame shardFrame = sharedFrame;
+        // Can't fail, only this thread pushes and there was room for the frame
+        mShards[i]->fShardInputSignalBuffer->push( std::move( shardFrame ) );
+        notifiedShards |= ( 1U << i );
+    }
+}
+
+bool
+CollectionInspectionWorkerThread::waitForShardCapacity( uint32_t shards )
+{
+    bool waited = false;
+    while ( true )
+    {
+        uint32_t fullShards = 0;
+        for ( size_t i = 0; i < mShards.size(); i++ )
+        {
+            if ( ( ( shards & ( 1U << i ) ) != 0 ) && mShards[i]->fShardInputSignalBuffer->isFull() )
+            {
+                fullShards |= ( 1U << i );
+            }
+        }
+        if ( fullShards == 0 )
+        {
+            return true;
+        }
+        if ( shouldStop() )
+        {
+            return false;
+        }
+        if ( !waited )
+        {
+            TraceModule::get().incrementVariable( TraceVariable::CE_SHARD_BUFFER_FULL );
+            waited = true;
+        }
+        for ( size_t i = 0; i < mShards.size(); i++ )
+        {
+            if ( ( fullShards & ( 1U << i ) ) != 0 )
+            {
+                mShards[i]->onNewDataAvailable();
+            }
+        }
+        fWait.wait( SHARD_BUFFER_FULL_WAIT_MS );
+    }
+}
+
+void
+CollectionInspectionWorkerThread::updateShards( const std::shared_ptr<const InspectionMatrix> &inspectionMatrix )
+{
+    auto shardMatrices = shardInspectionMatrix( inspectionMatrix, static_cast<uint32_t>( mShards.size() ) );
+    mSignalShards.clear();
+    mCanFrameShards.clear();
+    for ( size_t i = 0; i < mShards.size(); i++ )
+    {
+        uint32_t shardBit = 1U << i;
+        for ( const auto &condition : shardMatrices[i]->conditions )
+        {
+            for ( const auto &signal : condition.signals )
+            {
+                mSignalShards[signal.signalID] |= shardBit;
+            }
+            for ( const auto &canFrame : condition.canFrames )
+            {
+                mCanFrameShards[canFrameKey( canFrame.frameID, canFrame.channelID )] |= shardBit;
+            }
+        }
+        mShards[i]->onChangeInspectionMatrix( shardMatrices[i] );
+    }
+}
+
+std::vector<std::shared_ptr<const InspectionMatrix>>
+CollectionInspectionWorkerThread::shardInspectionMatrix(
+    const std::shared_ptr<const InspectionMatrix> &inspectionMatrix, uint32_t numberOfShards )
+{
+    numberOfShards = std::max( numberOfShards, 1U );
+    std::vector<std::shared_ptr<ShardInspectionMatrix>> shards;
+    for ( uint32_t i = 0; i < numberOfShards; i++ )
+    {
+        shards.push_back( std::make_shared<ShardInspectionMatrix>() );
+        shards.back()->original = inspectionMatrix;
+    }
+    if ( inspectionMatrix != nullptr )
+    {
+        std::vector<size_t> loads( numberOfShards, 0 );
+        for ( const auto &condition : inspectionMatrix->conditions )
+        {
+            // The first minimum, so the lowest index wins ties
+            auto shard = static_cast<size_t>( std::min_element( loads.begin(), loads.end() ) - loads.begin() );
+            shards[shard]->matrix.conditions.push_back( condition );
+            loads[shard] += 1 + condition.signals.size() + condition.canFrames.size();
+        }
+    }
+    std::vector<std::shared_ptr<const InspectionMatrix>> matrices;
+    for ( auto &shard : shards )
+    {
+        matrices.emplace_back( shard, &shard->matrix );
+    }
+    return matrices;
+}
+
 uint32_t
 CollectionInspectionWorkerThread::collectDataAndUpload()
 {
@@ -366,6 +718,13 @@ CollectionInspectionWorkerThread::calculateMonotonicTime( const TimePoint &currT
 bool
 CollectionInspectionWorkerThread::isAlive()
 {
+    for ( auto &shard : mShards )
+    {
+        if ( !shard->isAlive() )
+        {
+            return false;
+        }
+    }
     return fThread.isValid() && fThread.isActive();
 }
 
@@ -16,6 +16,9 @@
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #ifdef FWE_FEATURE_VISION_SYSTEM_DATA
 #include "RawDataManager.h"
@@ -26,11 +29,27 @@ namespace Aws
 namespace IoTFleetWise
 {
 
+/**
+ * @brief Runs the collection inspection engine on its own thread
+ *
+ * With more than one shard the conditions are distributed over several engines, each running on its own thread. The
+ * thread of this class then only dispatches the data frames: a precomputed table tells which shards use a signal or
+ * CAN frame and each frame is handed to exactly these shards. A frame needed by several shards is shared between
+ * them, the samples are not copied. As every shard gets the frames it needs in the order they were consumed, each
+ * condition triggers exactly as it would with a single engine. If the input buffer of a shard is full, the dispatching
+ * thread waits until the shard has consumed enough, so a frame is never dropped for only some of the shards. Frames
+ * are then only dropped when the shared input signal buffer is full, for all conditions alike. Only the order of the
+ * triggered data of different shards in the output queue is not defined anymore. The shards share the sample memory
+ * budget of a single engine, so with many shards fewer samples fit into the history buffers of each shard.
+ */
 class CollectionInspectionWorkerThread
 {
 public:
     using OnDataReadyToPublishCallback = std::function<void()>;
 
+    static constexpr uint32_t MAX_NUMBER_OF_SHARDS = 32; /**< limited by the width of the shard masks */
+    static constexpr size_t SHARD_SIGNAL_BUFFER_SIZE = 10000;
+
     CollectionInspectionWorkerThread() = default;
     ~CollectionInspectionWorkerThread();
 
@@ -64,7 +83,13 @@ public:
                                                                           put relevant signals in this queue */
                const std::shared_ptr<CollectedDataReadyToPublish>
                    &outputCollectedData, /**< this thread will put data that should be sent to cloud into this queue */
-               uint32_t idleTimeMs       /**< if no new data is available sleep for this amount of milliseconds */
+               uint32_t idleTimeMs,      /**< if no new data is available sleep for this amount of milliseconds */
+               uint32_t numberOfShards = 1, /**< number of engines the conditions are distributed over, each
+                                              running on its own thread. 1 runs a single engine on this thread */
+               bool zeroCopySignalCollection =
+                   false, /**< collect signals as slices of the history buffers, see CollectedSignalSlice */
+               size_t shardSignalBufferSize =
+                   SHARD_SIGNAL_BUFFER_SIZE /**< number of data frames the input buffer of each shard can hold */
 #ifdef FWE_FEATURE_VISION_SYSTEM_DATA
                ,
                std::shared_ptr<RawData::BufferManager> rawBufferManager =
@@ -91,9 +116,27 @@ public:
      */
     bool isAlive();
 
+    /**
+     * @brief Distributes the conditions of an inspection matrix over shards
+     *
+     * In order, each condition is assigned to the shard with the least load so far, counting each condition and each
+     * of its signals and CAN frames. The lowest shard index wins ties, so the same matrix always results in the same
+     * assignment.
+     *
+     * @return one matrix per shard. The expression nodes are not copied, so each of them keeps the given matrix alive.
+     */
+    static std::vector<std::shared_ptr<const InspectionMatrix>> shardInspectionMatrix(
+        const std::shared_ptr<const InspectionMatrix> &inspectionMatrix, uint32_t numberOfShards );
+
 private:
+    using SharedDataFrame = std::shared_ptr<const CollectedDataFrame>;
+    // Only the dispatching thread pushes and only the shard thread consumes
+    using ShardSignalBuffer = SpscQueue<SharedDataFrame>;
+
     static constexpr Timestamp EVALUATE_INTERVAL_MS = 1; // Evaluate every millisecond
     static constexpr uint32_t DEFAULT_THREAD_IDLE_TIME_MS = 1000;
+    static constexpr size_t DISPATCH_BATCH_SIZE = 64; /**< frames dispatched before the shards are woken up */
+    static constexpr uint32_t SHARD_BUFFER_FULL_WAIT_MS = 1; /**< retry interval while a shard buffer is full */
 
     // Stop the  thread
     // Intercepts stop signals.
@@ -101,6 +144,36 @@ private:
 
     static void doWork( void *data );
 
+    /**
+     * @brief Thread function if there are shards, which routes the data frames to them
+     */
+    static void doDispatch( void *data );
+
+    /**
+     * @brief Passes the content of a data frame to the inspection engine
+     * @return number of processed signals, CAN frames and DTCs
+     */
+    uint32_t processDataFrame( const CollectedDataFrame &dataFrame, const TimePoint &currentTime );
+
+    /**
+     * @brief Waits until none of the given shards has a full input buffer
+     * @param shards bit mask of the shards
+     * @return false if the thread should stop
+     */
+    bool waitForShardCapacity( uint32_t shards );
+
+    /**
+     * @brief Pushes a data frame to all shards that need it
+     * @param dataFrame the frame is moved out
+     * @param notifiedShards the bits of the shards the frame was pushed to are set
+     */
+    void dispatchDataFrame( CollectedDataFrame &dataFrame, uint32_t &notifiedShards );
+
+    /**
+     * @brief Hands the matching part of the new inspection matrix to each shard and rebuilds the routing tables
+     */
+    void updateShards( const std::shared_ptr<const InspectionMatrix> &inspectionMatrix );
+
     static TimePoint calculateMonotonicTime( const TimePoint &currTime, Timestamp systemTimeMs );
 
     /**
@@ -112,6 +185,7 @@ private:
     CollectionInspectionEngine fCollectionInspectionEngine;
 
     std::shared_ptr<SignalBuffer> fInputSignalBuffer;
+    std::unique_ptr<ShardSignalBuffer> fShardInputSignalBuffer; /**< set instead of fInputSignalBuffer for a shard */
     std::shared_ptr<CollectedDataReadyToPublish> fOutputCollectedData;
     Thread fThread;
     std::atomic<bool> fShouldStop{ false };
@@ -123,6 +197,13 @@ private:
     uint32_t fIdleTimeMs{ DEFAULT_THREAD_IDLE_TIME_MS };
     std::shared_ptr<const Clock> fClock = ClockHandler::getClock();
     ThreadSafeListeners<OnDataReadyToPublishCallback> mDataReadyListeners;
+    std::string fThreadName{ "fwDICollInsEng" };
+
+    // Only set by init. The routing tables are only used by the dispatching thread.
+    std::vector<std::unique_ptr<CollectionInspectionWorkerThread>> mShards;
+    std::unordered_map<SignalID, uint32_t> mSignalShards;   /**< bit mask of the shards that use a signal */
+    std::unordered_map<uint64_t, uint32_t> mCanFrameShards; /**< same for a raw CAN frame, see canFrameKey() */
+    CollectedDataFrame mDispatchedFrame;
 #ifdef FWE_FEATURE_VISION_SYSTEM_DATA
     std::shared_ptr<RawData::BufferManager> mRawBufferManager{ nullptr };
 #endif
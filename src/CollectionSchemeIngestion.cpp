@@ -4,6 +4,7 @@
 #include "CollectionSchemeIngestion.h"
 #include "CollectionInspectionAPITypes.h"
 #include "LoggingModule.h"
+#include "PayloadCompression.h"
 #include <google/protobuf/message.h>
 
 #ifdef FWE_FEATURE_VISION_SYSTEM_DATA
@@ -63,6 +64,11 @@ CollectionSchemeIngestion::build()
 
     FWE_LOG_TRACE( "Building CollectionScheme with ID: " + mProtoCollectionSchemeMessagePtr->campaign_sync_id() );
 
+    if ( !buildCompressionOptions() )
+    {
+        return false;
+    }
+
     // Build Collected Signals
     for ( int signalIndex = 0; signalIndex < mProtoCollectionSchemeMessagePtr->signal_information_size();
           ++signalIndex )
@@ -92,6 +98,9 @@ CollectionSchemeIngestion::build()
         signalInfo.minimumSampleIntervalMs = signalInformation.minimum_sample_period_ms();
         signalInfo.fixedWindowPeriod = signalInformation.fixed_window_period_ms();
         signalInfo.isConditionOnlySignal = signalInformation.condition_only_signal();
+        signalInfo.reduction.type = convertReductionType( signalInformation.reduction_type() );
+        signalInfo.reduction.tolerance = signalInformation.reduction_tolerance();
+        signalInfo.reduction.maxSamples = signalInformation.reduction_max_samples();
 
         FWE_LOG_TRACE( "Adding signalID: " + std::to_string( signalInfo.signalID ) + " to list of signals to collect" +
                        additionalTraceInfo );
@@ -277,12 +286,151 @@ CollectionSchemeIngestion::convertFunctionType(
     case Schemas::CommonTypesMsg::ConditionNode_NodeFunction_WindowFunction_WindowType_PREV_LAST_WINDOW_AVG:
         FWE_LOG_INFO( "Converting node to: PREV_LAST_FIXED_WINDOW_AVG" );
         return WindowFunction::PREV_LAST_FIXED_WINDOW_AVG;
+    case Schemas::CommonTypesMsg::ConditionNode_NodeFunction_WindowFunction_WindowType_LAST_WINDOW_COUNT:
+        FWE_LOG_INFO( "Converting node to: LAST_FIXED_WINDOW_COUNT" );
+        return WindowFunction::LAST_FIXED_WINDOW_COUNT;
+    case Schemas::CommonTypesMsg::ConditionNode_NodeFunction_WindowFunction_WindowType_PREV_LAST_WINDOW_COUNT:
+        FWE_LOG_INFO( "Converting node to: PREV_LAST_FIXED_WINDOW_COUNT" );
+        return WindowFunction::PREV_LAST_FIXED_WINDOW_COUNT;
+    case Schemas::CommonTypesMsg::ConditionNode_NodeFunction_WindowFunction_WindowType_LAST_WINDOW_SUM:
+        FWE_LOG_INFO( "Converting node to: LAST_FIXED_WINDOW_SUM" );
+        return WindowFunction::LAST_FIXED_WINDOW_SUM;
+    case Schemas::CommonTypesMsg::ConditionNode_NodeFunction_WindowFunction_WindowType_PREV_LAST_WINDOW_SUM:
+        FWE_LOG_INFO( "Converting node to: PREV_LAST_FIXED_WINDOW_SUM" );
+        return WindowFunction::PREV_LAST_FIXED_WINDOW_SUM;
+    case Schemas::CommonTypesMsg::ConditionNode_NodeFunction_WindowFunction_WindowType_LAST_WINDOW_STDDEV:
+        FWE_LOG_INFO( "Converting node to: LAST_FIXED_WINDOW_STDDEV" );
+        return WindowFunction::LAST_FIXED_WINDOW_STDDEV;
+    case Schemas::CommonTypesMsg::ConditionNode_NodeFunction_WindowFunction_WindowType_PREV_LAST_WINDOW_STDDEV:
+        FWE_LOG_INFO( "Converting node to: PREV_LAST_FIXED_WINDOW_STDDEV" );
+        return WindowFunction::PREV_LAST_FIXED_WINDOW_STDDEV;
+    case Schemas::CommonTypesMsg::ConditionNode_NodeFunction_WindowFunction_WindowType_LAST_WINDOW_FIRST:
+        FWE_LOG_INFO( "Converting node to: LAST_FIXED_WINDOW_FIRST" );
+        return WindowFunction::LAST_FIXED_WINDOW_FIRST;
+    case Schemas::CommonTypesMsg::ConditionNode_NodeFunction_WindowFunction_WindowType_PREV_LAST_WINDOW_FIRST:
+        FWE_LOG_INFO( "Converting node to: PREV_LAST_FIXED_WINDOW_FIRST" );
+        return WindowFunction::PREV_LAST_FIXED_WINDOW_FIRST;
+    case Schemas::CommonTypesMsg::ConditionNode_NodeFunction_WindowFunction_WindowType_LAST_WINDOW_LAST:
+        FWE_LOG_INFO( "Converting node to: LAST_FIXED_WINDOW_LAST" );
+        return WindowFunction::LAST_FIXED_WINDOW_LAST;
+    case Schemas::CommonTypesMsg::ConditionNode_NodeFunction_WindowFunction_WindowType_PREV_LAST_WINDOW_LAST:
+        FWE_LOG_INFO( "Converting node to: PREV_LAST_FIXED_WINDOW_LAST" );
+        return WindowFunction::PREV_LAST_FIXED_WINDOW_LAST;
+    case Schemas::CommonTypesMsg::ConditionNode_NodeFunction_WindowFunction_WindowType_LAST_WINDOW_RATE_OF_CHANGE:
+        FWE_LOG_INFO( "Converting node to: LAST_FIXED_WINDOW_RATE_OF_CHANGE" );
+        return WindowFunction::LAST_FIXED_WINDOW_RATE_OF_CHANGE;
+    case Schemas::CommonTypesMsg::ConditionNode_NodeFunction_WindowFunction_WindowType_PREV_LAST_WINDOW_RATE_OF_CHANGE:
+        FWE_LOG_INFO( "Converting node to: PREV_LAST_FIXED_WINDOW_RATE_OF_CHANGE" );
+        return WindowFunction::PREV_LAST_FIXED_WINDOW_RATE_OF_CHANGE;
+    case Schemas::CommonTypesMsg::ConditionNode_NodeFunction_WindowFunction_WindowType_LAST_WINDOW_P50:
+        FWE_LOG_INFO( "Converting node to: LAST_FIXED_WINDOW_P50" );
+        return WindowFunction::LAST_FIXED_WINDOW_P50;
+    case Schemas::CommonTypesMsg::ConditionNode_NodeFunction_WindowFunction_WindowType_PREV_LAST_WINDOW_P50:
+        FWE_LOG_INFO( "Converting node to: PREV_LAST_FIXED_WINDOW_P50" );
+        return WindowFunction::PREV_LAST_FIXED_WINDOW_P50;
+    case Schemas::CommonTypesMsg::ConditionNode_NodeFunction_WindowFunction_WindowType_LAST_WINDOW_P95:
+        FWE_LOG_INFO( "Converting node to: LAST_FIXED_WINDOW_P95" );
+        return WindowFunction::LAST_FIXED_WINDOW_P95;
+    case Schemas::CommonTypesMsg::ConditionNode_NodeFunction_WindowFunction_WindowType_PREV_LAST_WINDOW_P95:
+        FWE_LOG_INFO( "Converting node to: PREV_LAST_FIXED_WINDOW_P95" );
+        return WindowFunction::PREV_LAST_FIXED_WINDOW_P95;
+    case Schemas::CommonTypesMsg::ConditionNode_NodeFunction_WindowFunction_WindowType_LAST_WINDOW_P99:
+        FWE_LOG_INFO( "Converting node to: LAST_FIXED_WINDOW_P99" );
+        return WindowFunction::LAST_FIXED_WINDOW_P99;
+    case Schemas::CommonTypesMsg::ConditionNode_NodeFunction_WindowFunction_WindowType_PREV_LAST_WINDOW_P99:
+        FWE_LOG_INFO( "Converting node to: PREV_LAST_FIXED_WINDOW_P99" );
+        return WindowFunction::PREV_LAST_FIXED_WINDOW_P99;
+    case Schemas::CommonTypesMsg::ConditionNode_NodeFunction_WindowFunction_WindowType_SLIDING_WINDOW_COUNT:
+        FWE_LOG_INFO( "Converting node to: SLIDING_WINDOW_COUNT" );
+        return WindowFunction::SLIDING_WINDOW_COUNT;
+    case Schemas::CommonTypesMsg::ConditionNode_NodeFunction_WindowFunction_WindowType_SLIDING_WINDOW_SUM:
+        FWE_LOG_INFO( "Converting node to: SLIDING_WINDOW_SUM" );
+        return WindowFunction::SLIDING_WINDOW_SUM;
+    case Schemas::CommonTypesMsg::ConditionNode_NodeFunction_WindowFunction_WindowType_SLIDING_WINDOW_AVG:
+        FWE_LOG_INFO( "Converting node to: SLIDING_WINDOW_AVG" );
+        return WindowFunction::SLIDING_WINDOW_AVG;
+    case Schemas::CommonTypesMsg::ConditionNode_NodeFunction_WindowFunction_WindowType_SLIDING_WINDOW_MIN:
+        FWE_LOG_INFO( "Converting node to: SLIDING_WINDOW_MIN" );
+        return WindowFunction::SLIDING_WINDOW_MIN;
+    case Schemas::CommonTypesMsg::ConditionNode_NodeFunction_WindowFunction_WindowType_SLIDING_WINDOW_MAX:
+        FWE_LOG_INFO( "Converting node to: SLIDING_WINDOW_MAX" );
+        return WindowFunction::SLIDING_WINDOW_MAX;
+    case Schemas::CommonTypesMsg::ConditionNode_NodeFunction_WindowFunction_WindowType_SLIDING_WINDOW_STDDEV:
+        FWE_LOG_INFO( "Converting node to: SLIDING_WINDOW_STDDEV" );
+        return WindowFunction::SLIDING_WINDOW_STDDEV;
     default:
         FWE_LOG_ERROR( "Function node type not supported." );
         return WindowFunction::NONE;
     }
 }
 
+SignalReductionType
+CollectionSchemeIngestion::convertReductionType(
+    Schemas::CollectionSchemesMsg::SignalInformation_ReductionType reductionType )
+{
+    switch ( reductionType )
+    {
+    case Schemas::CollectionSchemesMsg::SignalInformation_ReductionType_NO_REDUCTION:
+        return SignalReductionType::NONE;
+    case Schemas::CollectionSchemesMsg::SignalInformation_ReductionType_DEADBAND:
+        return SignalReductionType::DEADBAND;
+    case Schemas::CollectionSchemesMsg::SignalInformation_ReductionType_SWINGING_DOOR:
+        return SignalReductionType::SWINGING_DOOR;
+    case Schemas::CollectionSchemesMsg::SignalInformation_ReductionType_LARGEST_TRIANGLE_THREE_BUCKETS:
+        return SignalReductionType::LARGEST_TRIANGLE_THREE_BUCKETS;
+    default:
+        FWE_LOG_WARN( "Signal reduction type not supported, collecting all samples" );
+        return SignalReductionType::NONE;
+    }
+}
+
+bool
+CollectionSchemeIngestion::buildCompressionOptions()
+{
+    mCompressionOptions = CompressionOptions();
+    if ( !mProtoCollectionSchemeMessagePtr->compress_collected_data() )
+    {
+        return true;
+    }
+    switch ( mProtoCollectionSchemeMessagePtr->compression_codec() )
+    {
+    case Schemas::CollectionSchemesMsg::CollectionScheme_CompressionCodec_SNAPPY:
+        mCompressionOptions.codec = CompressionCodec::SNAPPY;
+        break;
+    case Schemas::CollectionSchemesMsg::CollectionScheme_CompressionCodec_LZ4:
+        mCompressionOptions.codec = CompressionCodec::LZ4;
+        break;
+    case Schemas::CollectionSchemesMsg::CollectionScheme_CompressionCodec_ZSTD:
+        mCompressionOptions.codec = CompressionCodec::ZSTD;
+        break;
+    default:
+        FWE_LOG_ERROR( "Compression codec " + std::to_string( mProtoCollectionSchemeMessagePtr->compression_codec() ) +
+                       " not supported" );
+        return false;
+    }
+    // The cloud could not decompress the data if another codec was used instead
+    if ( !isCompressionCodecSupported( mCompressionOptions.codec ) )
+    {
+        FWE_LOG_ERROR( std::string( "CollectionScheme requires the compression codec " ) +
+                       compressionCodecToString( mCompressionOptions.codec ) + ", which this agent was built without" );
+        return false;
+    }
+    mCompressionOptions.level = mProtoCollectionSchemeMessagePtr->compression_level();
+    if ( !mProtoCollectionSchemeMessagePtr->compression_dictionary().empty() )
+    {
+        if ( mCompressionOptions.codec == CompressionCodec::ZSTD )
+        {
+            mCompressionOptions.dictionary =
+                std::make_shared<const std::string>( mProtoCollectionSchemeMessagePtr->compression_dictionary() );
+        }
+        else
+        {
+            FWE_LOG_WARN( "Compression dictionary is only supported by zstd and is ignored" );
+        }
+    }
+    return true;
+}
+
 ExpressionNodeType
 CollectionSchemeIngestion::convertOperatorType( Schemas::CommonTypesMsg::ConditionNode_NodeOperator_Operator op )
 {
@@ -600,6 +748,23 @@ CollectionSchemeIngestion::isCompressionNeeded() const
     return mProtoCollectionSchemeMessagePtr->compress_collected_data();
 }
 
+bool
+CollectionSchemeIngestion::isColumnarSignalEncodingNeeded() const
+{
+    if ( !mReady )
+    {
+        return false;
+    }
+
+    return mProtoCollectionSchemeMessagePtr->columnar_signal_encoding();
+}
+
+const CompressionOptions &
+CollectionSchemeIngestion::getCompressionOptions() const
+{
+    return mCompressionOptions;
+}
+
 uint32_t
 CollectionSchemeIngestion::getMinimumPublishIntervalMs() const
 {
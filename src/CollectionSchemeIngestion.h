@@ -64,6 +64,10 @@ public:
 
     bool isCompressionNeeded() const override;
 
+    bool isColumnarSignalEncodingNeeded() const override;
+
+    const CompressionOptions &getCompressionOptions() const override;
+
     uint32_t getPriority() const override;
 
     const ExpressionNode *getCondition() const override;
@@ -116,6 +120,11 @@ private:
      */
     ExpressionNode_t mExpressionNodes;
 
+    /**
+     * @brief Codec, level and dictionary to compress the collected data with
+     */
+    CompressionOptions mCompressionOptions;
+
 #ifdef FWE_FEATURE_VISION_SYSTEM_DATA
     /**
      * @brief unordered_map from partial signal ID to pair of signal path and signal ID
@@ -151,6 +160,18 @@ private:
     static WindowFunction convertFunctionType(
         Schemas::CommonTypesMsg::ConditionNode_NodeFunction_WindowFunction_WindowType function );
 
+    /**
+     * @brief Private Local Function used by the build Function to return the reduction of a collected signal
+     */
+    static SignalReductionType convertReductionType(
+        Schemas::CollectionSchemesMsg::SignalInformation_ReductionType reductionType );
+
+    /**
+     * @brief Private Local Function used by the build Function to set up the compression options
+     * @return false if the agent does not support the requested codec
+     */
+    bool buildCompressionOptions();
+
     /**
      * @brief Private Local Function used by the serializeNode Function to return the used Operator Type
      */
@@ -7,8 +7,8 @@
 #include "OBDDataTypes.h"
 #include "TraceModule.h"
 #include <climits>
+#include <limits>
 #include <json/json.h>
-#include <snappy.h>
 #include <utility>
 #include <vector>
 
@@ -30,6 +30,10 @@ constexpr char DEFAULT_KEY_SUFFIX[] = ".10n"; // Ion is the only supported forma
 #endif
 } // namespace
 
+constexpr size_t DataSenderManager::PAYLOAD_SIZE_MARGIN;        // NOLINT
+constexpr double DataSenderManager::COMPRESSION_RATIO_HEADROOM; // NOLINT
+constexpr double DataSenderManager::COMPRESSION_RATIO_WEIGHT;   // NOLINT
+
 DataSenderManager::DataSenderManager( std::shared_ptr<ISender> mqttSender,
                                       std::shared_ptr<PayloadManager> payloadManager,
                                       CANInterfaceIDTranslator &canIDTranslator,
@@ -43,7 +47,7 @@ DataSenderManager::DataSenderManager( std::shared_ptr<ISender> mqttSender,
                                       )
     : mMQTTSender( std::move( mqttSender ) )
     , mPayloadManager( std::move( payloadManager ) )
-    , mProtoWriter( canIDTranslator )
+    , mCANIDTranslator( canIDTranslator )
 #ifdef FWE_FEATURE_VISION_SYSTEM_DATA
     , mIonWriter( std::move( ionWriter ) )
     , mS3Sender{ std::move( s3Sender ) }
@@ -51,6 +55,13 @@ DataSenderManager::DataSenderManager( std::shared_ptr<ISender> mqttSender,
 #endif
 {
     mTransmitThreshold = ( transmitThreshold > 0U ) ? transmitThreshold : UINT_MAX;
+    mSerializationContext = createSerializationContext();
+}
+
+std::unique_ptr<DataSenderManager::SerializationContext>
+DataSenderManager::createSerializationContext()
+{
+    return std::make_unique<SerializationContext>( mCANIDTranslator );
 }
 
 void
@@ -67,32 +78,119 @@ DataSenderManager::processCollectedData( const TriggeredCollectionSchemeDataPtr
         return;
     }
 
-    setCollectionSchemeParameters( triggeredCollectionSchemeDataPtr );
-
-    transformTelemetryDataToProto( triggeredCollectionSchemeDataPtr );
+    mSerializationContext->mPayloads = nullptr;
+    transformTelemetryDataToProto( triggeredCollectionSchemeDataPtr, *mSerializationContext );
 #ifdef FWE_FEATURE_VISION_SYSTEM_DATA
     transformVisionSystemDataToIon( triggeredCollectionSchemeDataPtr, reportUploadCallback );
 #endif
 }
 
 void
-DataSenderManager::setCollectionSchemeParameters(
+DataSenderManager::serializeTelemetryData( const TriggeredCollectionSchemeDataPtr &triggeredCollectionSchemeDataPtr,
+                                           SerializationContext &context,
+                                           std::vector<std::string> &payloads ) const
+{
+    if ( triggeredCollectionSchemeDataPtr == nullptr )
+    {
+        return;
+    }
+    context.mPayloads = &payloads;
+    transformTelemetryDataToProto( triggeredCollectionSchemeDataPtr, context );
+    context.mPayloads = nullptr;
+}
+
+void
+DataSenderManager::sendSerializedData( const TriggeredCollectionSchemeDataPtr triggeredCollectionSchemeDataPtr,
+                                       const std::vector<std::string> &payloads
+#ifdef FWE_FEATURE_VISION_SYSTEM_DATA
+                                       ,
+                                       std::function<void( TriggeredCollectionSchemeDataPtr )> reportUploadCallback
+#endif
+)
+{
+    if ( triggeredCollectionSchemeDataPtr == nullptr )
+    {
+        FWE_LOG_WARN( "Nothing to send as the input is empty" );
+        return;
+    }
+
+    auto collectionSchemeParams = getCollectionSchemeParameters( triggeredCollectionSchemeDataPtr );
+    for ( const auto &payload : payloads )
+    {
+        static_cast<void>( send( reinterpret_cast<const uint8_t *>( payload.data() ),
+                                 payload.size(),
+                                 mMQTTSender,
+                                 collectionSchemeParams ) );
+    }
+#ifdef FWE_FEATURE_VISION_SYSTEM_DATA
+    transformVisionSystemDataToIon( triggeredCollectionSchemeDataPtr, reportUploadCallback );
+#endif
+}
+
+CollectionSchemeParams
+DataSenderManager::getCollectionSchemeParameters(
     const TriggeredCollectionSchemeDataPtr &triggeredCollectionSchemeDataPtr )
 {
-    mCollectionSchemeParams.persist = triggeredCollectionSchemeDataPtr->metadata.persist;
-    mCollectionSchemeParams.compression = triggeredCollectionSchemeDataPtr->metadata.compress;
-    mCollectionSchemeParams.priority = triggeredCollectionSchemeDataPtr->metadata.priority;
-    mCollectionSchemeParams.eventID = triggeredCollectionSchemeDataPtr->eventID;
-    mCollectionSchemeParams.triggerTime = triggeredCollectionSchemeDataPtr->triggerTime;
-    mCollectionSchemeID = triggeredCollectionSchemeDataPtr->metadata.collectionSchemeID;
+    CollectionSchemeParams collectionSchemeParams;
+    collectionSchemeParams.persist = triggeredCollectionSchemeDataPtr->metadata.persist;
+    collectionSchemeParams.compression = triggeredCollectionSchemeDataPtr->metadata.compress;
+    collectionSchemeParams.compressionOptions = triggeredCollectionSchemeDataPtr->metadata.compressionOptions;
+    collectionSchemeParams.priority = triggeredCollectionSchemeDataPtr->metadata.priority;
+    collectionSchemeParams.eventID = triggeredCollectionSchemeDataPtr->eventID;
+    collectionSchemeParams.triggerTime = triggeredCollectionSchemeDataPtr->triggerTime;
+    return collectionSchemeParams;
 }
 
 void
 DataSenderManager::transformTelemetryDataToProto(
-    const TriggeredCollectionSchemeDataPtr &triggeredCollectionSchemeDataPtr )
+    const TriggeredCollectionSchemeDataPtr &triggeredCollectionSchemeDataPtr, SerializationContext &context ) const
 {
+    context.mCollectionSchemeParams = getCollectionSchemeParameters( triggeredCollectionSchemeDataPtr );
+    context.mMaxSendSize =
+        ( mMQTTSender != nullptr ) ? mMQTTSender->getMaxSendSize() : std::numeric_limits<size_t>::max();
+    context.mLargestMessageSize = 0;
+    if ( context.mCollectionSchemeParams.compression )
+    {
+        updateCompressor( context );
+    }
+
     // Clear old data and setup metadata
-    mProtoWriter.setupVehicleData( triggeredCollectionSchemeDataPtr, mCollectionSchemeParams.eventID );
+    auto &protoWriter = context.mProtoWriter;
+    protoWriter.setupVehicleData( triggeredCollectionSchemeDataPtr, context.mCollectionSchemeParams.eventID );
+    context.mChunkBegin = 0;
+    auto numberOfMessages = appendMessages(
+        triggeredCollectionSchemeDataPtr, context, 0, std::numeric_limits<size_t>::max(), true );
+
+    // Serialize and transmit any remaining messages
+    if ( protoWriter.getVehicleDataMsgCount() >= 1U )
+    {
+        FWE_LOG_TRACE( "Queuing message for upload" );
+        uploadProto( triggeredCollectionSchemeDataPtr, context, context.mChunkBegin, numberOfMessages );
+    }
+}
+
+size_t
+DataSenderManager::appendMessages( const TriggeredCollectionSchemeDataPtr &triggeredCollectionSchemeDataPtr,
+                                   SerializationContext &context,
+                                   size_t begin,
+                                   size_t end,
+                                   bool uploadWhenFull ) const
+{
+    size_t index = 0;
+    auto append = [&]( const auto &msg ) {
+        if ( ( index >= begin ) && ( index < end ) )
+        {
+            if ( uploadWhenFull )
+            {
+                appendMessageToProto( triggeredCollectionSchemeDataPtr, context, msg, index );
+            }
+            else
+            {
+                context.mProtoWriter.append( msg );
+            }
+        }
+        index++;
+    };
 
     // Iterate through all the signals and add to the protobuf
     for ( const auto &signal : triggeredCollectionSchemeDataPtr->signals )
@@ -103,42 +201,48 @@ DataSenderManager::transformTelemetryDataToProto(
              ( ( signal.signalID & INTERNAL_SIGNAL_ID_BITMASK ) == 0 ) )
 #endif
         {
-            appendMessageToProto( triggeredCollectionSchemeDataPtr, signal );
+            append( signal );
+        }
+    }
+    // The samples of the slices are read directly from the history buffers of the inspection engine
+    for ( const auto &slice : triggeredCollectionSchemeDataPtr->signalSlices )
+    {
+#ifdef FWE_FEATURE_VISION_SYSTEM_DATA
+        if ( ( slice.signalID & INTERNAL_SIGNAL_ID_BITMASK ) != 0 )
+        {
+            continue;
+        }
+#endif
+        for ( uint32_t i = 0; i < slice.size; i++ )
+        {
+            append( slice.getSample( i ) );
         }
     }
 
     // Iterate through all the raw CAN frames and add to the protobuf
     for ( const auto &canFrame : triggeredCollectionSchemeDataPtr->canFrames )
     {
-        appendMessageToProto( triggeredCollectionSchemeDataPtr, canFrame );
+        append( canFrame );
     }
 
-    // Add DTC info to the payload
-    if ( triggeredCollectionSchemeDataPtr->mDTCInfo.hasItems() )
+    // Add DTC info to the payload. It is set up again for each payload, as each one starts with new vehicle data.
+    const auto &dtcInfo = triggeredCollectionSchemeDataPtr->mDTCInfo;
+    for ( const auto &dtc : dtcInfo.mDTCCodes )
     {
-        mProtoWriter.setupDTCInfo( triggeredCollectionSchemeDataPtr->mDTCInfo );
-        const auto &dtcCodes = triggeredCollectionSchemeDataPtr->mDTCInfo.mDTCCodes;
-
-        // Iterate through all the DTC codes and add to the protobuf
-        for ( const auto &dtc : dtcCodes )
+        if ( ( index >= begin ) && ( index < end ) )
         {
-            appendMessageToProto( triggeredCollectionSchemeDataPtr, dtc );
+            context.mProtoWriter.setupDTCInfo( dtcInfo );
         }
+        append( dtc );
     }
 
 #ifdef FWE_FEATURE_VISION_SYSTEM_DATA
     for ( const auto &object : triggeredCollectionSchemeDataPtr->uploadedS3Objects )
     {
-        appendMessageToProto( triggeredCollectionSchemeDataPtr, object );
+        append( object );
     }
 #endif
-
-    // Serialize and transmit any remaining messages
-    if ( mProtoWriter.getVehicleDataMsgCount() >= 1U )
-    {
-        FWE_LOG_TRACE( "Queuing message for upload" );
-        uploadProto();
-    }
+    return index;
 }
 
 #ifdef FWE_FEATURE_VISION_SYSTEM_DATA
@@ -241,10 +345,10 @@ DataSenderManager::transformVisionSystemDataToIon(
 #endif
 
 bool
-DataSenderManager::serialize( std::string &output )
+DataSenderManager::serialize( SerializationContext &context )
 {
-    // Note: a class member is used to store the serialized proto output to avoid heap fragmentation
-    if ( !mProtoWriter.serializeVehicleData( &output ) )
+    // Note: the output buffer of the context is reused to avoid heap fragmentation
+    if ( !context.mProtoWriter.serializeVehicleData( &context.mProtoOutput ) )
     {
         FWE_LOG_ERROR( "Serialization failed" );
         return false;
@@ -252,13 +356,39 @@ DataSenderManager::serialize( std::string &output )
     return true;
 }
 
+size_t
+DataSenderManager::estimatePayloadSize( const SerializationContext &context, size_t serializedSize )
+{
+    if ( !context.mCollectionSchemeParams.compression )
+    {
+        return serializedSize;
+    }
+    return static_cast<size_t>( static_cast<double>( serializedSize ) * context.mCompressionRatio *
+                                COMPRESSION_RATIO_HEADROOM );
+}
+
+void
+DataSenderManager::updateCompressor( SerializationContext &context )
+{
+    const auto &options = context.mCollectionSchemeParams.compressionOptions;
+    if ( ( context.mCompressor != nullptr ) && ( context.mCompressorOptions == options ) )
+    {
+        return;
+    }
+    context.mCompressor = createPayloadCompressor( options );
+    context.mCompressorOptions = options;
+    context.mCompressionRatio = 1.0;
+}
+
 bool
-DataSenderManager::compress( std::string &input )
+DataSenderManager::compress( SerializationContext &context )
 {
-    if ( mCollectionSchemeParams.compression )
+    if ( context.mCollectionSchemeParams.compression )
     {
         FWE_LOG_TRACE( "Compress the payload before transmitting since compression flag is true" );
-        if ( snappy::Compress( input.data(), input.size(), &mCompressedProtoOutput ) == 0U )
+        if ( ( context.mCompressor == nullptr ) ||
+             ( !context.mCompressor->compress(
+                 context.mProtoOutput.data(), context.mProtoOutput.size(), context.mCompressedProtoOutput ) ) )
         {
             FWE_LOG_TRACE( "Error in compressing the payload" );
             return false;
@@ -268,7 +398,10 @@ DataSenderManager::compress( std::string &input )
 }
 
 ConnectivityError
-DataSenderManager::send( const std::uint8_t *data, size_t size, std::shared_ptr<ISender> sender )
+DataSenderManager::send( const std::uint8_t *data,
+                         size_t size,
+                         const std::shared_ptr<ISender> &sender,
+                         const CollectionSchemeParams &collectionSchemeParams )
 {
     if ( sender == nullptr )
     {
@@ -276,7 +409,7 @@ DataSenderManager::send( const std::uint8_t *data, size_t size, std::shared_ptr<
         return ConnectivityError::NotConfigured;
     }
 
-    ConnectivityError ret = sender->sendBuffer( data, size, mCollectionSchemeParams );
+    ConnectivityError ret = sender->sendBuffer( data, size, collectionSchemeParams );
     if ( ret != ConnectivityError::Success )
     {
         FWE_LOG_ERROR( "Failed to send vehicle data with error: " + std::to_string( static_cast<int>( ret ) ) );
@@ -291,29 +424,70 @@ DataSenderManager::send( const std::uint8_t *data, size_t size, std::shared_ptr<
 }
 
 void
-DataSenderManager::uploadProto()
+DataSenderManager::uploadProto( const TriggeredCollectionSchemeDataPtr &triggeredCollectionSchemeDataPtr,
+                                SerializationContext &context,
+                                size_t begin,
+                                size_t end ) const
 {
-    if ( !serialize( mProtoOutput ) )
+    if ( !serialize( context ) )
     {
         FWE_LOG_ERROR( "Data cannot be uploaded due to serialization failure" );
         return;
     }
-    if ( mCollectionSchemeParams.compression )
+    auto *output = &context.mProtoOutput;
+    if ( context.mCollectionSchemeParams.compression )
     {
-        if ( !compress( mProtoOutput ) )
+        if ( !compress( context ) )
         {
             FWE_LOG_ERROR( "Data cannot be uploaded due to compression failure" );
             return;
         }
-        static_cast<void>( send( reinterpret_cast<const uint8_t *>( mCompressedProtoOutput.data() ),
-                                 mCompressedProtoOutput.size(),
-                                 mMQTTSender ) );
+        if ( !context.mProtoOutput.empty() )
+        {
+            // Follow a worse ratio at once, so that the next payloads do not exceed the maximum size, and a better one
+            // slowly
+            auto ratio = static_cast<double>( context.mCompressedProtoOutput.size() ) /
+                         static_cast<double>( context.mProtoOutput.size() );
+            context.mCompressionRatio = ( ratio > context.mCompressionRatio )
+                                            ? ratio
+                                            : ( ( context.mCompressionRatio * ( 1.0 - COMPRESSION_RATIO_WEIGHT ) ) +
+                                                ( ratio * COMPRESSION_RATIO_WEIGHT ) );
+        }
+        output = &context.mCompressedProtoOutput;
+    }
+    if ( output->size() > context.mMaxSendSize )
+    {
+        if ( ( end - begin ) <= 1 )
+        {
+            TraceModule::get().incrementVariable( TraceVariable::MQTT_PAYLOAD_TOO_LARGE );
+            FWE_LOG_ERROR( "A single message of the collection scheme " +
+                           triggeredCollectionSchemeDataPtr->metadata.collectionSchemeID + " results in a payload of " +
+                           std::to_string( output->size() ) + " bytes, which exceeds the maximum of " +
+                           std::to_string( context.mMaxSendSize ) + " bytes. The message is dropped." );
+            return;
+        }
+        FWE_LOG_TRACE( "Payload of " + std::to_string( output->size() ) + " bytes exceeds the maximum of " +
+                       std::to_string( context.mMaxSendSize ) + " bytes, splitting its messages" );
+        auto middle = begin + ( ( end - begin ) / 2 );
+        for ( const auto &half : { std::make_pair( begin, middle ), std::make_pair( middle, end ) } )
+        {
+            context.mProtoWriter.setupVehicleData( triggeredCollectionSchemeDataPtr,
+                                                   context.mCollectionSchemeParams.eventID );
+            appendMessages( triggeredCollectionSchemeDataPtr, context, half.first, half.second, false );
+            uploadProto( triggeredCollectionSchemeDataPtr, context, half.first, half.second );
+        }
+        return;
     }
-    else
+    if ( context.mPayloads != nullptr )
     {
-        static_cast<void>(
-            send( reinterpret_cast<const uint8_t *>( mProtoOutput.data() ), mProtoOutput.size(), mMQTTSender ) );
+        context.mPayloads->emplace_back();
+        context.mPayloads->back().swap( *output );
+        return;
     }
+    static_cast<void>( send( reinterpret_cast<const uint8_t *>( output->data() ),
+                             output->size(),
+                             mMQTTSender,
+                             context.mCollectionSchemeParams ) );
 }
 
 void
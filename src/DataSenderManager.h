@@ -8,11 +8,15 @@
 #include "DataSenderProtoWriter.h"
 #include "IConnectionTypes.h"
 #include "ISender.h"
+#include "PayloadCompression.h"
 #include "PayloadManager.h"
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <limits>
 #include <memory>
 #include <string>
+#include <vector>
 
 #ifdef FWE_FEATURE_VISION_SYSTEM_DATA
 #include "DataSenderIonWriter.h"
@@ -38,6 +42,35 @@ class DataSenderManager
 {
 
 public:
+    /**
+     * @brief The state needed to turn the telemetry data of a trigger into payloads
+     *
+     * Telemetry data can be serialized in parallel with different contexts.
+     */
+    class SerializationContext
+    {
+    public:
+        SerializationContext( CANInterfaceIDTranslator &canIDTranslator )
+            : mProtoWriter( canIDTranslator )
+        {
+        }
+
+    private:
+        friend class DataSenderManager;
+
+        DataSenderProtoWriter mProtoWriter;
+        CollectionSchemeParams mCollectionSchemeParams;
+        std::string mProtoOutput;
+        std::string mCompressedProtoOutput;
+        size_t mMaxSendSize{ std::numeric_limits<size_t>::max() }; /**< queried from the sender for each trigger */
+        size_t mLargestMessageSize{ 0 }; /**< largest serialized message of the current trigger */
+        size_t mChunkBegin{ 0 };         /**< index of the first message of the current payload, see appendMessages */
+        double mCompressionRatio{ 1.0 }; /**< estimate of the compressed size divided by the serialized size */
+        std::vector<std::string> *mPayloads{ nullptr }; /**< if set, the payloads are stored here instead of sent */
+        std::unique_ptr<IPayloadCompressor> mCompressor; /**< kept as long as the compression options do not change */
+        CompressionOptions mCompressorOptions;           /**< the options mCompressor was created with */
+    };
+
     DataSenderManager( std::shared_ptr<ISender> mqttSender,
                        std::shared_ptr<PayloadManager> payloadManager,
                        CANInterfaceIDTranslator &canIDTranslator,
@@ -67,6 +100,38 @@ public:
      */
     virtual void checkAndSendRetrievedData();
 
+    /**
+     * @brief Creates a context to serialize telemetry data with serializeTelemetryData
+     */
+    std::unique_ptr<SerializationContext> createSerializationContext();
+
+    /**
+     * @brief Serializes and compresses the telemetry data of a trigger without sending it
+     *
+     * As this does not change the DataSenderManager, it can be called from several threads, each with its own
+     * context.
+     *
+     * @param triggeredCollectionSchemeDataPtr collected data
+     * @param context the context of the calling thread
+     * @param payloads the payloads are appended, ready to be passed to sendSerializedData
+     */
+    void serializeTelemetryData( const TriggeredCollectionSchemeDataPtr &triggeredCollectionSchemeDataPtr,
+                                 SerializationContext &context,
+                                 std::vector<std::string> &payloads ) const;
+
+    /**
+     * @brief Sends the payloads created by serializeTelemetryData and processes the rest of the collected data
+     *
+     * Together with serializeTelemetryData this does the same as processCollectedData.
+     */
+    virtual void sendSerializedData( const TriggeredCollectionSchemeDataPtr triggeredCollectionSchemeDataPtr,
+                                     const std::vector<std::string> &payloads
+#ifdef FWE_FEATURE_VISION_SYSTEM_DATA
+                                     ,
+                                     std::function<void( TriggeredCollectionSchemeDataPtr )> reportUploadCallback
+#endif
+    );
+
 #ifdef FWE_FEATURE_VISION_SYSTEM_DATA
     virtual void onChangeCollectionSchemeList(
         const std::shared_ptr<const ActiveCollectionSchemes> &activeCollectionSchemes );
@@ -75,33 +140,38 @@ public:
 private:
     std::shared_ptr<ISender> mMQTTSender;
     std::shared_ptr<PayloadManager> mPayloadManager;
-    DataSenderProtoWriter mProtoWriter;
+    CANInterfaceIDTranslator mCANIDTranslator;
+    std::unique_ptr<SerializationContext> mSerializationContext; /**< used by processCollectedData */
 #ifdef FWE_FEATURE_VISION_SYSTEM_DATA
     std::shared_ptr<DataSenderIonWriter> mIonWriter;
     std::shared_ptr<S3Sender> mS3Sender; // might be nullptr
     std::string mVehicleName;
     std::shared_ptr<const ActiveCollectionSchemes> mActiveCollectionSchemes;
 #endif
-    CollectionSchemeParams mCollectionSchemeParams;
-    std::string mCollectionSchemeID;
-
-    std::string mProtoOutput;
-    std::string mCompressedProtoOutput;
-
     unsigned mTransmitThreshold{ 0 }; // max number of messages that can be sent to cloud at one time
 
+    // Reserve for the header of the compression codec and the DTC info, which is not counted as a message
+    static constexpr size_t PAYLOAD_SIZE_MARGIN = 64;
+    // The compressed size is estimated with a ratio that is slightly worse than the observed one
+    static constexpr double COMPRESSION_RATIO_HEADROOM = 1.1;
+    // Weight of the latest payload if its compression ratio is better than the estimated one
+    static constexpr double COMPRESSION_RATIO_WEIGHT = 0.25;
+
     /**
      * @brief Set up collectionSchemeParams struct
      * @param triggeredCollectionSchemeDataPtr collected data
      */
-    void setCollectionSchemeParameters( const TriggeredCollectionSchemeDataPtr &triggeredCollectionSchemeDataPtr );
+    static CollectionSchemeParams getCollectionSchemeParameters(
+        const TriggeredCollectionSchemeDataPtr &triggeredCollectionSchemeDataPtr );
 
     /**
      * @brief Put collected telemetry data into protobuf in chunks. Initiates serialization, compression, and
      * upload for each partition.
      * @param triggeredCollectionSchemeDataPtr collected data
+     * @param context the context to serialize with
      */
-    void transformTelemetryDataToProto( const TriggeredCollectionSchemeDataPtr &triggeredCollectionSchemeDataPtr );
+    void transformTelemetryDataToProto( const TriggeredCollectionSchemeDataPtr &triggeredCollectionSchemeDataPtr,
+                                        SerializationContext &context ) const;
 
 #ifdef FWE_FEATURE_VISION_SYSTEM_DATA
     /**
@@ -119,44 +189,114 @@ private:
 
     /**
      * @brief Serializes, compresses, and uploads proto output.
+     *
+     * If the context has a payload list, the payload is added there instead of being uploaded.
+     *
+     * If the final payload exceeds the maximum size of the sender, because a message is larger than all before or the
+     * data compresses worse than estimated, the messages of the payload are split in half and each half is serialized
+     * again, down to a single message. A single message that is still too large is dropped.
+     *
+     * @param triggeredCollectionSchemeDataPtr collected data
+     * @param context the context with the vehicle data of the messages begin to end
+     * @param begin index of the first message of the payload, see appendMessages
+     * @param end index after the last message of the payload
+     */
+    void uploadProto( const TriggeredCollectionSchemeDataPtr &triggeredCollectionSchemeDataPtr,
+                      SerializationContext &context,
+                      size_t begin,
+                      size_t end ) const;
+
+    /**
+     * @brief Appends the messages of the collected data with an index from begin to end to the vehicle data
+     *
+     * The messages are indexed in the order signals, samples of the signal slices, raw CAN frames, DTC codes and
+     * uploaded S3 objects.
+     *
+     * @param triggeredCollectionSchemeDataPtr collected data
+     * @param context the context to serialize with
+     * @param begin index of the first message to append
+     * @param end index after the last message to append
+     * @param uploadWhenFull if true, payloads are uploaded whenever they are full, see appendMessageToProto
+     * @return number of messages of the collected data
      */
-    void uploadProto();
+    size_t appendMessages( const TriggeredCollectionSchemeDataPtr &triggeredCollectionSchemeDataPtr,
+                           SerializationContext &context,
+                           size_t begin,
+                           size_t end,
+                           bool uploadWhenFull ) const;
 
+    /**
+     * @brief Estimates the size of the payload after the optional compression
+     * @param context the context with the compression settings
+     * @param serializedSize size of the serialized vehicle data
+     */
+    static size_t estimatePayloadSize( const SerializationContext &context, size_t serializedSize );
+
+    /**
+     * @brief Appends a message and uploads the payload if it is full
+     *
+     * The payload is full if it has the maximum number of messages or if the largest message seen so far might not
+     * fit anymore without exceeding the maximum size of the sender.
+     *
+     * @param index index of the message, see appendMessages
+     */
     template <typename T>
     void
-    appendMessageToProto( const TriggeredCollectionSchemeDataPtr &triggeredCollectionSchemeDataPtr, T msg )
+    appendMessageToProto( const TriggeredCollectionSchemeDataPtr &triggeredCollectionSchemeDataPtr,
+                          SerializationContext &context,
+                          T msg,
+                          size_t index ) const
     {
-        mProtoWriter.append( msg );
-        if ( mProtoWriter.getVehicleDataMsgCount() >= mTransmitThreshold )
+        auto &protoWriter = context.mProtoWriter;
+        auto previousSize = protoWriter.getVehicleDataEstimatedSize();
+        protoWriter.append( msg );
+        auto size = protoWriter.getVehicleDataEstimatedSize();
+        context.mLargestMessageSize = std::max( context.mLargestMessageSize, size - previousSize );
+        if ( ( protoWriter.getVehicleDataMsgCount() >= mTransmitThreshold ) ||
+             ( ( estimatePayloadSize( context, size + context.mLargestMessageSize ) + PAYLOAD_SIZE_MARGIN ) >
+               context.mMaxSendSize ) )
         {
-            uploadProto();
+            uploadProto( triggeredCollectionSchemeDataPtr, context, context.mChunkBegin, index + 1 );
             // Setup the next payload chunk
-            mProtoWriter.setupVehicleData( triggeredCollectionSchemeDataPtr, mCollectionSchemeParams.eventID );
+            context.mChunkBegin = index + 1;
+            protoWriter.setupVehicleData( triggeredCollectionSchemeDataPtr, context.mCollectionSchemeParams.eventID );
         }
     }
 
     /**
-     * @brief Serializes data
-     * @param output Output string
+     * @brief Serializes data into the proto output of the context
+     * @param context the context with the data
      * @return True if serialization succeeds
      */
-    bool serialize( std::string &output );
+    static bool serialize( SerializationContext &context );
+
+    /**
+     * @brief Creates the compressor for the compression options of the collection scheme if they changed
+     *
+     * The compression ratio estimate is reset in this case, as it depends on the codec.
+     * @param context the context with the collection scheme parameters
+     */
+    static void updateCompressor( SerializationContext &context );
 
     /**
-     * @brief Compresses data
-     * @param input Input data string
+     * @brief Compresses the proto output of the context
+     * @param context the context with the data
      * @return True if compression succeeds
      */
-    bool compress( std::string &input );
+    static bool compress( SerializationContext &context );
 
     /**
      * @brief Forwards data from buffer to the provided sender
      * @param data Data to send
      * @param size Buffer size
      * @param sender sender to use for the upload
+     * @param collectionSchemeParams metadata of the collection scheme the data belongs to
      * @return Success if upload succeeds
      */
-    ConnectivityError send( const std::uint8_t *data, size_t size, std::shared_ptr<ISender> sender );
+    static ConnectivityError send( const std::uint8_t *data,
+                                   size_t size,
+                                   const std::shared_ptr<ISender> &sender,
+                                   const CollectionSchemeParams &collectionSchemeParams );
 
     /**
      * @brief Upload file from persistency folder
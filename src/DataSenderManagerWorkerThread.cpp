@@ -17,17 +17,38 @@ namespace IoTFleetWise
 {
 
 const uint32_t DataSenderManagerWorkerThread::MAX_NUMBER_OF_SIGNAL_TO_TRACE_LOG = 6;
+constexpr uint32_t DataSenderManagerWorkerThread::MAX_NUMBER_OF_SERIALIZATION_THREADS; // NOLINT
 
 DataSenderManagerWorkerThread::DataSenderManagerWorkerThread(
     std::shared_ptr<IConnectivityModule> connectivityModule,
     std::shared_ptr<DataSenderManager> dataSenderManager,
     uint64_t persistencyUploadRetryIntervalMs,
-    std::shared_ptr<CollectedDataReadyToPublish> &collectedDataQueue )
+    std::shared_ptr<CollectedDataReadyToPublish> &collectedDataQueue,
+    uint32_t numberOfSerializationThreads )
     : mCollectedDataQueue( collectedDataQueue )
     , mPersistencyUploadRetryIntervalMs{ persistencyUploadRetryIntervalMs }
     , mDataSenderManager( std::move( dataSenderManager ) )
     , mConnectivityModule( std::move( connectivityModule ) )
 {
+    if ( numberOfSerializationThreads > MAX_NUMBER_OF_SERIALIZATION_THREADS )
+    {
+        FWE_LOG_WARN( "Number of serialization threads " + std::to_string( numberOfSerializationThreads ) +
+                      " is limited to " + std::to_string( MAX_NUMBER_OF_SERIALIZATION_THREADS ) );
+        numberOfSerializationThreads = MAX_NUMBER_OF_SERIALIZATION_THREADS;
+    }
+    if ( numberOfSerializationThreads > 1 )
+    {
+        mSerializationContext = mDataSenderManager->createSerializationContext();
+        for ( uint32_t i = 1; i < numberOfSerializationThreads; i++ )
+        {
+            auto thread = std::make_unique<SerializationThread>();
+            thread->mOwner = this;
+            thread->mContext = mDataSenderManager->createSerializationContext();
+            mSerializationThreads.push_back( std::move( thread ) );
+        }
+        FWE_LOG_INFO( "Serializing the collected data with " + std::to_string( numberOfSerializationThreads ) +
+                      " threads" );
+    }
 }
 
 bool
@@ -36,9 +57,23 @@ DataSenderManagerWorkerThread::start()
     // Prevent concurrent stop/init
     std::lock_guard<std::mutex> lock( mThreadMutex );
     mShouldStop.store( false );
+    for ( size_t i = 0; i < mSerializationThreads.size(); i++ )
+    {
+        auto &thread = mSerializationThreads[i];
+        thread->mShouldStop.store( false );
+        if ( ( !thread->mThread.create( doSerialize, thread.get() ) ) || ( !thread->mThread.isActive() ) )
+        {
+            FWE_LOG_ERROR( "Serialization Thread failed to start" );
+            // Don't leave the threads of the pool running that were already started
+            stopSerializationThreads();
+            return false;
+        }
+        thread->mThread.setThreadName( "fwDSSerialize" + std::to_string( i + 1 ) );
+    }
     if ( !mThread.create( doWork, this ) )
     {
         FWE_LOG_TRACE( "Data Sender Manager Thread failed to start" );
+        stopSerializationThreads();
     }
     else
     {
@@ -52,19 +87,38 @@ DataSenderManagerWorkerThread::start()
 bool
 DataSenderManagerWorkerThread::stop()
 {
+    std::lock_guard<std::mutex> lock( mThreadMutex );
     // It might take several seconds to finish all running S3 async PutObject requests
-    if ( ( !mThread.isValid() ) || ( !mThread.isActive() ) )
+    if ( mThread.isValid() && mThread.isActive() )
     {
-        return true;
+        mShouldStop.store( true, std::memory_order_relaxed );
+        FWE_LOG_TRACE( "Request stop" );
+        mWait.notify();
+        mThread.release();
+        mShouldStop.store( false, std::memory_order_relaxed );
     }
-    std::lock_guard<std::mutex> lock( mThreadMutex );
-    mShouldStop.store( true, std::memory_order_relaxed );
-    FWE_LOG_TRACE( "Request stop" );
-    mWait.notify();
-    mThread.release();
+    // The serialization threads are stopped after this thread, which hands them the jobs. They are stopped even if
+    // this thread is not active, e.g. because it failed to start.
+    auto success = stopSerializationThreads();
     FWE_LOG_TRACE( "Stop finished" );
-    mShouldStop.store( false, std::memory_order_relaxed );
-    return !mThread.isActive();
+    return success && ( ( !mThread.isValid() ) || ( !mThread.isActive() ) );
+}
+
+bool
+DataSenderManagerWorkerThread::stopSerializationThreads()
+{
+    bool success = true;
+    for ( auto &thread : mSerializationThreads )
+    {
+        if ( thread->mThread.isValid() )
+        {
+            thread->mShouldStop.store( true, std::memory_order_relaxed );
+            thread->mWait.notify();
+            thread->mThread.release();
+        }
+        success = success && ( ( !thread->mThread.isValid() ) || ( !thread->mThread.isActive() ) );
+    }
+    return success;
 }
 
 bool
@@ -183,8 +237,13 @@ DataSenderManagerWorkerThread::doWork( void *data )
                 }
             }
             firstSignalValues += "]";
+            size_t numberOfSignals = triggeredCollectionSchemeDataPtr->signals.size();
+            for ( const auto &slice : triggeredCollectionSchemeDataPtr->signalSlices )
+            {
+                numberOfSignals += slice.size;
+            }
             // Avoid invoking Data Collection Sender if there is nothing to send.
-            if ( triggeredCollectionSchemeDataPtr->signals.empty() &&
+            if ( ( numberOfSignals == 0 ) &&
                  triggeredCollectionSchemeDataPtr->canFrames.empty() &&
                  triggeredCollectionSchemeDataPtr->mDTCInfo.mDTCCodes.empty()
 #ifdef FWE_FEATURE_VISION_SYSTEM_DATA
@@ -203,7 +262,7 @@ DataSenderManagerWorkerThread::doWork( void *data )
                     "FWE data ready to send with eventID " +
                     std::to_string( triggeredCollectionSchemeDataPtr->eventID ) + " from " +
                     triggeredCollectionSchemeDataPtr->metadata.collectionSchemeID +
-                    " Signals:" + std::to_string( triggeredCollectionSchemeDataPtr->signals.size() ) + " " +
+                    " Signals:" + std::to_string( numberOfSignals ) + " " +
                     firstSignalValues + firstSignalTimestamp +
                     " trigger timestamp: " + std::to_string( triggeredCollectionSchemeDataPtr->triggerTime ) +
                     " raw CAN frames:" + std::to_string( triggeredCollectionSchemeDataPtr->canFrames.size() ) +
@@ -214,25 +273,34 @@ DataSenderManagerWorkerThread::doWork( void *data )
 #endif
                     ;
                 FWE_LOG_INFO( message );
-                sender->mDataSenderManager->processCollectedData(
-                    triggeredCollectionSchemeDataPtr
+                if ( !sender->mSerializationThreads.empty() )
+                {
+                    auto job = std::make_unique<SerializationJob>();
+                    job->mData = triggeredCollectionSchemeDataPtr;
+                    std::lock_guard<std::mutex> lock( sender->mSerializationJobsMutex );
+                    sender->mSerializationJobs.push_back( std::move( job ) );
+                }
+                else
+                {
+                    sender->mDataSenderManager->processCollectedData(
+                        triggeredCollectionSchemeDataPtr
 #ifdef FWE_FEATURE_VISION_SYSTEM_DATA
-                    ,
-                    [sender]( TriggeredCollectionSchemeDataPtr uploadedData ) {
-                        if ( !sender->mCollectedDataQueue->push( std::move( uploadedData ) ) )
-                        {
-                            FWE_LOG_WARN( "Collected data output buffer is full" );
-                            return;
+                        ,
+                        [sender]( TriggeredCollectionSchemeDataPtr uploadedData ) {
+                            sender->reportUploadedData( std::move( uploadedData ) );
                         }
-                        sender->mWait.notify();
-                    }
 #endif
-                );
+                    );
+                }
             }
         };
 
         auto consumedElements = sender->mCollectedDataQueue->consumeAll( consumeData );
         TraceModule::get().setVariable( TraceVariable::QUEUE_INSPECTION_TO_SENDER, consumedElements );
+        if ( !sender->mSerializationJobs.empty() )
+        {
+            sender->processSerializationJobs();
+        }
         if ( ( !uploadedPersistedDataOnce ) ||
              ( ( sender->mPersistencyUploadRetryIntervalMs > 0 ) &&
                ( static_cast<uint64_t>( sender->mRetrySendingPersistedDataTimer.getElapsedMs().count() ) >=
@@ -248,7 +316,94 @@ DataSenderManagerWorkerThread::doWork( void *data )
     }
 }
 
+void
+DataSenderManagerWorkerThread::doSerialize( void *data )
+{
+    auto *thread = static_cast<SerializationThread *>( data );
+    while ( !thread->mShouldStop.load( std::memory_order_relaxed ) )
+    {
+        thread->mWait.wait( Signal::WaitWithPredicate );
+        while ( thread->mOwner->serializeNextJob( *thread->mContext ) )
+        {
+            // Continue until all jobs are taken
+        }
+    }
+}
+
+bool
+DataSenderManagerWorkerThread::serializeNextJob( DataSenderManager::SerializationContext &context )
+{
+    SerializationJob *job = nullptr;
+    {
+        std::lock_guard<std::mutex> lock( mSerializationJobsMutex );
+        if ( mNextSerializationJob >= mSerializationJobs.size() )
+        {
+            return false;
+        }
+        job = mSerializationJobs[mNextSerializationJob].get();
+        mNextSerializationJob++;
+    }
+    mDataSenderManager->serializeTelemetryData( job->mData, context, job->mPayloads );
+    {
+        std::lock_guard<std::mutex> lock( mSerializationJobsMutex );
+        job->mDone = true;
+    }
+    mSerializationJobDone.notify();
+    return true;
+}
+
+void
+DataSenderManagerWorkerThread::processSerializationJobs()
+{
+    for ( auto &thread : mSerializationThreads )
+    {
+        thread->mWait.notify();
+    }
+    auto isDone = [this]( const SerializationJob &job ) -> bool {
+        std::lock_guard<std::mutex> lock( mSerializationJobsMutex );
+        return job.mDone;
+    };
+    // Only this thread changes the list of jobs, so it can read it without the lock
+    for ( auto &job : mSerializationJobs )
+    {
+        // Help with the serialization until the next job to send is done
+        while ( !isDone( *job ) )
+        {
+            if ( !serializeNextJob( *mSerializationContext ) )
+            {
+                mSerializationJobDone.wait( Signal::WaitWithPredicate );
+            }
+        }
+        mDataSenderManager->sendSerializedData( job->mData,
+                                                job->mPayloads
+#ifdef FWE_FEATURE_VISION_SYSTEM_DATA
+                                                ,
+                                                [this]( TriggeredCollectionSchemeDataPtr uploadedData ) {
+                                                    reportUploadedData( std::move( uploadedData ) );
+                                                }
+#endif
+        );
+        // Release the memory as soon as possible
+        job->mData.reset();
+        job->mPayloads.clear();
+    }
+    std::lock_guard<std::mutex> lock( mSerializationJobsMutex );
+    mSerializationJobs.clear();
+    mNextSerializationJob = 0;
+}
+
 #ifdef FWE_FEATURE_VISION_SYSTEM_DATA
+void
+DataSenderManagerWorkerThread::reportUploadedData( TriggeredCollectionSchemeDataPtr uploadedData )
+{
+    if ( !mCollectedDataQueue->push( std::move( uploadedData ) ) )
+    {
+        FWE_LOG_WARN( "Collected data output buffer is full" );
+        return;
+    }
+    mWait.notify();
+}
+
 void
 DataSenderManagerWorkerThread::onChangeCollectionSchemeList(
     const std::shared_ptr<const ActiveCollectionSchemes> &activeCollectionSchemes )
@@ -275,11 +430,9 @@ DataSenderManagerWorkerThread::onDataReadyToPublish()
 
 DataSenderManagerWorkerThread::~DataSenderManagerWorkerThread()
 {
-    // To make sure the thread stops during teardown of tests.
-    if ( isAlive() )
-    {
-        stop();
-    }
+    // To make sure the threads stop during teardown of tests, including the serialization threads when this thread
+    // failed to start
+    stop();
 }
 
 } // namespace IoTFleetWise
@@ -10,9 +10,12 @@
 #include "Thread.h"
 #include "Timer.h"
 #include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <mutex>
+#include <string>
+#include <vector>
 
 #ifdef FWE_FEATURE_VISION_SYSTEM_DATA
 #include "ICollectionSchemeList.h"
@@ -23,13 +26,24 @@ namespace Aws
 namespace IoTFleetWise
 {
 
+/**
+ * @brief Sends the collected data to the cloud on its own thread
+ *
+ * With more than one serialization thread, all triggers waiting in the queue are serialized and compressed in
+ * parallel by a pool of threads, each with its own DataSenderManager::SerializationContext. This thread takes part in
+ * the serialization and sends the payloads in the order the triggers were queued.
+ */
 class DataSenderManagerWorkerThread
 {
 public:
-    DataSenderManagerWorkerThread( std::shared_ptr<IConnectivityModule> connectivityModule,
-                                   std::shared_ptr<DataSenderManager> dataSenderManager,
-                                   uint64_t persistencyUploadRetryIntervalMs,
-                                   std::shared_ptr<CollectedDataReadyToPublish> &collectedDataQueue );
+    static constexpr uint32_t MAX_NUMBER_OF_SERIALIZATION_THREADS = 16;
+
+    DataSenderManagerWorkerThread(
+        std::shared_ptr<IConnectivityModule> connectivityModule,
+        std::shared_ptr<DataSenderManager> dataSenderManager,
+        uint64_t persistencyUploadRetryIntervalMs,
+        std::shared_ptr<CollectedDataReadyToPublish> &collectedDataQueue,
+        uint32_t numberOfSerializationThreads = 1 /**< including this thread. 1 serializes only on this thread */ );
     ~DataSenderManagerWorkerThread();
 
     DataSenderManagerWorkerThread( const DataSenderManagerWorkerThread & ) = delete;
@@ -69,11 +83,56 @@ public:
     bool isAlive();
 
 private:
+    /**
+     * @brief Telemetry data of a trigger to be serialized by the pool
+     */
+    struct SerializationJob
+    {
+        TriggeredCollectionSchemeDataPtr mData;
+        std::vector<std::string> mPayloads;
+        bool mDone{ false };
+    };
+
+    /**
+     * @brief Additional thread of the pool
+     */
+    struct SerializationThread
+    {
+        DataSenderManagerWorkerThread *mOwner{ nullptr };
+        std::unique_ptr<DataSenderManager::SerializationContext> mContext;
+        Thread mThread;
+        Signal mWait;
+        std::atomic<bool> mShouldStop{ false };
+    };
+
     // Stop the  thread
     bool shouldStop() const;
 
     static void doWork( void *data );
 
+    static void doSerialize( void *data );
+
+    /**
+     * @brief Stops and joins the threads of the pool that were started
+     * @return true if all threads of the pool are stopped
+     */
+    bool stopSerializationThreads();
+
+    /**
+     * @brief Serializes the next job of the batch that is not taken yet
+     * @return false if all jobs were already taken
+     */
+    bool serializeNextJob( DataSenderManager::SerializationContext &context );
+
+    /**
+     * @brief Serializes the queued jobs with the pool and sends the payloads in the order of the jobs
+     */
+    void processSerializationJobs();
+
+#ifdef FWE_FEATURE_VISION_SYSTEM_DATA
+    void reportUploadedData( TriggeredCollectionSchemeDataPtr uploadedData );
+#endif
+
     std::shared_ptr<CollectedDataReadyToPublish> mCollectedDataQueue;
     uint64_t mPersistencyUploadRetryIntervalMs{ 0 };
 
@@ -84,6 +143,14 @@ private:
     std::shared_ptr<DataSenderManager> mDataSenderManager;
     std::shared_ptr<IConnectivityModule> mConnectivityModule;
 
+    // Empty if there is only this thread
+    std::vector<std::unique_ptr<SerializationThread>> mSerializationThreads;
+    std::unique_ptr<DataSenderManager::SerializationContext> mSerializationContext; /**< used by this thread */
+    std::vector<std::unique_ptr<SerializationJob>> mSerializationJobs;
+    size_t mNextSerializationJob{ 0 };
+    std::mutex mSerializationJobsMutex; /**< guards the jobs, as all threads of the pool take them */
+    Signal mSerializationJobDone;
+
 #ifdef FWE_FEATURE_VISION_SYSTEM_DATA
     std::shared_ptr<const ActiveCollectionSchemes> mActiveCollectionSchemes;
     std::mutex mActiveCollectionSchemesMutex;
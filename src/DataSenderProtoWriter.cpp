@@ -5,12 +5,28 @@
 #include "SignalTypes.h"
 #include <array>
 #include <google/protobuf/message.h>
+#include <google/protobuf/wire_format_lite.h>
 #include <memory>
 
 namespace Aws
 {
 namespace IoTFleetWise
 {
+namespace
+{
+
+using WireFormatLite = google::protobuf::internal::WireFormatLite;
+
+// One byte each for the tag and the length of the message, as it is always shorter than 128 bytes, plus the tags
+// and values of the relative time (varint up to 10 bytes), the signal ID (varint up to 5 bytes) and the double
+constexpr size_t MAX_ENCODED_SIGNAL_SIZE = 2 + ( 1 + 10 ) + ( 1 + 5 ) + ( 1 + 8 );
+// All field numbers are below 16, so every tag has one byte. Lengths are counted with their largest size of 5 bytes.
+// A column has a tag and a length, the signal ID and a tag and a length for each of the other three fields.
+constexpr size_t MAX_COLUMN_OVERHEAD_SIZE = ( 1 + 5 ) + ( 1 + 5 ) + ( 3 * ( 1 + 5 ) );
+// The DTC info has a tag and a length and the relative time
+constexpr size_t MAX_DTC_INFO_OVERHEAD_SIZE = ( 1 + 5 ) + ( 1 + 10 );
+
+} // namespace
 
 DataSenderProtoWriter::DataSenderProtoWriter( CANInterfaceIDTranslator &canIDTranslator )
     : mTriggerTime( 0U )
@@ -30,20 +46,117 @@ DataSenderProtoWriter::setupVehicleData( const TriggeredCollectionSchemeDataPtr
     mVehicleDataMsgCount = 0U;
 
     mVehicleData.Clear();
+    mEncodedSignals.clear();
     mVehicleData.set_campaign_sync_id( triggeredCollectionSchemeData->metadata.collectionSchemeID );
     mVehicleData.set_decoder_sync_id( triggeredCollectionSchemeData->metadata.decoderID );
     mVehicleData.set_collection_event_id( collectionEventID );
     mTriggerTime = triggeredCollectionSchemeData->triggerTime;
     mVehicleData.set_collection_event_time_ms_epoch( mTriggerTime );
+    mEstimatedSize = mVehicleData.ByteSizeLong();
+    mColumnarSignalEncoding = triggeredCollectionSchemeData->metadata.columnarSignalEncoding;
+    mSignalColumns.clear();
+}
+
+bool
+DataSenderProtoWriter::appendToColumn( const CollectedSignal &msg )
+{
+    auto signalValue = msg.getValue();
+    bool integerValue = true;
+    uint64_t integerBits = 0;
+    double doubleValue = 0.0;
+    switch ( signalValue.getType() )
+    {
+    case SignalType::UINT8:
+        integerBits = signalValue.value.uint8Val;
+        break;
+    case SignalType::INT8:
+        integerBits = static_cast<uint64_t>( static_cast<int64_t>( signalValue.value.int8Val ) );
+        break;
+    case SignalType::UINT16:
+        integerBits = signalValue.value.uint16Val;
+        break;
+    case SignalType::INT16:
+        integerBits = static_cast<uint64_t>( static_cast<int64_t>( signalValue.value.int16Val ) );
+        break;
+    case SignalType::UINT32:
+        integerBits = signalValue.value.uint32Val;
+        break;
+    case SignalType::INT32:
+        integerBits = static_cast<uint64_t>( static_cast<int64_t>( signalValue.value.int32Val ) );
+        break;
+    case SignalType::UINT64:
+        integerBits = signalValue.value.uint64Val;
+        break;
+    case SignalType::INT64:
+        integerBits = static_cast<uint64_t>( signalValue.value.int64Val );
+        break;
+    case SignalType::BOOLEAN:
+        integerBits = signalValue.value.boolVal ? 1U : 0U;
+        break;
+    case SignalType::FLOAT:
+        integerValue = false;
+        doubleValue = static_cast<double>( signalValue.value.floatVal );
+        break;
+    case SignalType::DOUBLE:
+        integerValue = false;
+        doubleValue = signalValue.value.doubleVal;
+        break;
+    default:
+        return false;
+    }
+
+    auto it = mSignalColumns.find( msg.signalID );
+    if ( it == mSignalColumns.end() )
+    {
+        SignalColumn newColumn;
+        newColumn.mColumn = mVehicleData.add_captured_signal_columns();
+        newColumn.mColumn->set_signal_id( msg.signalID );
+        newColumn.mIntegerValues = integerValue;
+        it = mSignalColumns.emplace( msg.signalID, newColumn ).first;
+        mEstimatedSize += MAX_COLUMN_OVERHEAD_SIZE;
+    }
+    auto &column = it->second;
+    if ( column.mIntegerValues != integerValue )
+    {
+        return false;
+    }
+
+    // Starting with zeros makes the first entries the time, then the delta and then the delta of deltas
+    auto relativeTime = static_cast<int64_t>( msg.receiveTime ) - static_cast<int64_t>( mTriggerTime );
+    auto timeDelta = relativeTime - column.mLastRelativeTime;
+    auto deltaOfDeltas = timeDelta - column.mLastTimeDelta;
+    column.mColumn->add_relative_time_ms_delta_of_deltas( deltaOfDeltas );
+    mEstimatedSize += WireFormatLite::SInt64Size( deltaOfDeltas );
+    column.mLastTimeDelta = ( column.mColumn->relative_time_ms_delta_of_deltas_size() == 1 ) ? 0 : timeDelta;
+    column.mLastRelativeTime = relativeTime;
+
+    if ( integerValue )
+    {
+        // Unsigned subtraction wraps around, so the difference of any two 64 bit values can be restored
+        auto valueDelta = static_cast<int64_t>( integerBits - column.mLastIntegerValue );
+        column.mColumn->add_integer_value_deltas( valueDelta );
+        mEstimatedSize += WireFormatLite::SInt64Size( valueDelta );
+        column.mLastIntegerValue = integerBits;
+    }
+    else
+    {
+        auto &xorDoubleValues = *column.mColumn->mutable_xor_double_values();
+        auto previousSize = xorDoubleValues.size();
+        column.mDoubleEncoder.append( doubleValue, xorDoubleValues );
+        mEstimatedSize += xorDoubleValues.size() - previousSize;
+    }
+    return true;
 }
+
 void
 DataSenderProtoWriter::append( const CollectedSignal &msg )
 {
-    auto capturedSignals = mVehicleData.add_captured_signals();
+    if ( mColumnarSignalEncoding && appendToColumn( msg ) )
+    {
+        mVehicleDataMsgCount++;
+        return;
+    }
     mVehicleDataMsgCount++;
-    capturedSignals->set_relative_time_ms( static_cast<int64_t>( msg.receiveTime ) -
-                                           static_cast<int64_t>( mTriggerTime ) );
-    capturedSignals->set_signal_id( msg.signalID );
     auto signalValue = msg.getValue();
     // TODO :: Change the datatype of the signal here when the DataPlane supports it
     double signalPhysicalValue{ 0 };
@@ -87,7 +200,35 @@ DataSenderProtoWriter::append( const CollectedSignal &msg )
         signalPhysicalValue = signalValue.value.doubleVal;
         break;
     }
-    capturedSignals->set_double_value( signalPhysicalValue );
+    appendEncodedSignal( static_cast<int64_t>( msg.receiveTime ) - static_cast<int64_t>( mTriggerTime ),
+                         msg.signalID,
+                         signalPhysicalValue );
+}
+
+void
+DataSenderProtoWriter::appendEncodedSignal( int64_t relativeTime, SignalID signalID, double value )
+{
+    using CapturedSignal = Schemas::VehicleDataMsg::CapturedSignal;
+
+    std::array<uint8_t, MAX_ENCODED_SIGNAL_SIZE> buffer{};
+    uint8_t *messageStart = &buffer[2];
+    uint8_t *end = messageStart;
+    // Like the generated code, omit the default value of a field that is not part of a oneof
+    if ( relativeTime != 0 )
+    {
+        end = WireFormatLite::WriteSInt64ToArray( CapturedSignal::kRelativeTimeMsFieldNumber, relativeTime, end );
+    }
+    end = WireFormatLite::WriteUInt32ToArray( CapturedSignal::kSignalIdFieldNumber, signalID, end );
+    end = WireFormatLite::WriteDoubleToArray( CapturedSignal::kDoubleValueFieldNumber, value, end );
+
+    auto *lengthPosition =
+        WireFormatLite::WriteTagToArray( Schemas::VehicleDataMsg::VehicleData::kCapturedSignalsFieldNumber,
+                                         WireFormatLite::WIRETYPE_LENGTH_DELIMITED,
+                                         buffer.data() );
+    *lengthPosition = static_cast<uint8_t>( end - messageStart );
+    auto size = static_cast<size_t>( end - buffer.data() );
+    mEncodedSignals.append( reinterpret_cast<const char *>( buffer.data() ), size );
+    mEstimatedSize += size;
 }
 
 void
@@ -100,11 +241,16 @@ DataSenderProtoWriter::append( const CollectedCanRawFrame &msg )
     rawCanFrames->set_message_id( msg.frameID );
     rawCanFrames->set_interface_id( mIDTranslator.getInterfaceID( msg.channelId ) );
     rawCanFrames->set_byte_values( reinterpret_cast<char const *>( msg.data.data() ), msg.size );
+    mEstimatedSize += 1 + WireFormatLite::LengthDelimitedSize( rawCanFrames->ByteSizeLong() );
 }
 
 void
 DataSenderProtoWriter::setupDTCInfo( const DTCInfo &msg )
 {
+    if ( !mVehicleData.has_dtc_data() )
+    {
+        mEstimatedSize += MAX_DTC_INFO_OVERHEAD_SIZE;
+    }
     auto dtcData = mVehicleData.mutable_dtc_data();
     dtcData->set_relative_time_ms( static_cast<int64_t>( msg.receiveTime ) - static_cast<int64_t>( mTriggerTime ) );
 }
@@ -112,9 +258,14 @@ DataSenderProtoWriter::setupDTCInfo( const DTCInfo &msg )
 void
 DataSenderProtoWriter::append( const std::string &dtc )
 {
+    if ( !mVehicleData.has_dtc_data() )
+    {
+        mEstimatedSize += MAX_DTC_INFO_OVERHEAD_SIZE;
+    }
     auto dtcData = mVehicleData.mutable_dtc_data();
     mVehicleDataMsgCount++;
     dtcData->add_active_dtc_codes( dtc );
+    mEstimatedSize += 1 + WireFormatLite::LengthDelimitedSize( dtc.size() );
 }
 
 #ifdef FWE_FEATURE_VISION_SYSTEM_DATA
@@ -126,6 +277,7 @@ DataSenderProtoWriter::append( const UploadedS3Object &uploadedS3Object )
     uploadedS3Objects->set_key( uploadedS3Object.key );
     uploadedS3Objects->set_data_format(
         static_cast<Schemas::VehicleDataMsg::DataFormat>( uploadedS3Object.dataFormat ) );
+    mEstimatedSize += 1 + WireFormatLite::LengthDelimitedSize( uploadedS3Objects->ByteSizeLong() );
 }
 #endif
 
@@ -135,10 +287,18 @@ DataSenderProtoWriter::getVehicleDataMsgCount() const
     return mVehicleDataMsgCount;
 }
 
+size_t
+DataSenderProtoWriter::getVehicleDataEstimatedSize() const
+{
+    return mEstimatedSize;
+}
+
 bool
-DataSenderProtoWriter::serializeVehicleData( std::string *out ) const
+DataSenderProtoWriter::serializeVehicleData( std::string *out )
 {
-    return mVehicleData.SerializeToString( out );
+    out->swap( mEncodedSignals );
+    mEncodedSignals.clear();
+    return mVehicleData.AppendToString( out );
 }
 
 } // namespace IoTFleetWise
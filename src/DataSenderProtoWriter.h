@@ -7,9 +7,12 @@
 #include "CollectionInspectionAPITypes.h"
 #include "OBDDataTypes.h"
 #include "TimeTypes.h"
+#include "XorDoubleEncoding.h"
 #include "vehicle_data.pb.h"
+#include <cstddef>
 #include <cstdint>
 #include <string>
+#include <unordered_map>
 
 namespace Aws
 {
@@ -19,6 +22,10 @@ namespace IoTFleetWise
 /**
  * @brief Class that does the protobuf setup for the collected data
  *        and serializes the edge to cloud data
+ *
+ * The captured signals are by far the most frequent messages of a payload. Instead of creating a protobuf message for
+ * each of them, they are directly written in the wire format to a buffer, which becomes the start of the serialized
+ * payload. The order of the fields does not matter to a protobuf parser.
  */
 class DataSenderProtoWriter
 {
@@ -51,6 +58,8 @@ public:
     /**
      * @brief Appends the decoded CAN/OBD signal messages to the output protobuf
      *
+     * If the collection scheme requested the columnar signal encoding, the sample is added to the column of its signal.
+     *
      *  @param msg  data and metadata for the captured signal
      */
     void append( const CollectedSignal &msg );
@@ -92,20 +101,62 @@ public:
      */
     unsigned getVehicleDataMsgCount() const;
 
+    /**
+     * @brief Gets the size the vehicle data will have when serialized
+     *
+     * The size is updated with each appended message. It is exact except for the columnar signal encoding and the DTC
+     * info, for which the sizes of the length fields are overestimated. So it is never smaller than the serialized
+     * size.
+     *
+     * @return the estimated size in bytes
+     */
+    size_t getVehicleDataEstimatedSize() const;
+
     /**
      * @brief Serializes the vehicle data to be sent to cloud
      *
+     * The buffer of the encoded signals is swapped with the output, so this can only be called once after
+     * setupVehicleData. Passing the same output string again for the next payload reuses both buffers without
+     * allocations.
+     *
      * @param out  Protobuf
      * @return true if the data was serialized
      */
-
-    bool serializeVehicleData( std::string *out ) const;
+    bool serializeVehicleData( std::string *out );
 
 private:
+    /**
+     * @brief State of the column of one signal, which is needed to encode the next sample
+     */
+    struct SignalColumn
+    {
+        Schemas::VehicleDataMsg::CapturedSignalColumn *mColumn{ nullptr };
+        bool mIntegerValues{ false };
+        int64_t mLastRelativeTime{ 0 };
+        int64_t mLastTimeDelta{ 0 };
+        uint64_t mLastIntegerValue{ 0 };
+        XorDoubleEncoder mDoubleEncoder;
+    };
+
+    /**
+     * @brief Appends the sample to the column of its signal
+     * @return false if the type of the value does not fit into the column
+     */
+    bool appendToColumn( const CollectedSignal &msg );
+
+    /**
+     * @brief Appends a CapturedSignal in the wire format to mEncodedSignals
+     */
+    void appendEncodedSignal( int64_t relativeTime, SignalID signalID, double value );
+
     Timestamp mTriggerTime;
     unsigned mVehicleDataMsgCount{}; // tracks the number of messages being sent in the edge to cloud payload
+    size_t mEstimatedSize{ 0 };      /**< see getVehicleDataEstimatedSize() */
     Schemas::VehicleDataMsg::VehicleData mVehicleData{};
+    std::string mEncodedSignals; /**< captured_signals of mVehicleData, already serialized */
     CANInterfaceIDTranslator mIDTranslator;
+    bool mColumnarSignalEncoding{ false };
+    std::unordered_map<SignalID, SignalColumn> mSignalColumns;
 };
 
 } // namespace IoTFleetWise
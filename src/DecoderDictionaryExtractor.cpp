@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "CollectionSchemeManager.h" // IWYU pragma: associated
+#include "CANDecoder.h"
 #include "EnumUtility.h"
 #include "ICollectionScheme.h"
 #include "LoggingModule.h"
@@ -292,6 +293,13 @@ CollectionSchemeManager::decoderDictionaryExtractor(
             }
         }
     }
+    // Compile the CAN decode plans and frame ID lookup once here instead of resolving them for every received frame
+    auto canDecoderDictionaryPtr =
+        std::dynamic_pointer_cast<CANDecoderDictionary>( decoderDictionaryMap[VehicleDataSourceProtocol::RAW_SOCKET] );
+    if ( canDecoderDictionaryPtr != nullptr )
+    {
+        CANDecoder::compileDictionary( *canDecoderDictionaryPtr );
+    }
 }
 
 #ifdef FWE_FEATURE_VISION_SYSTEM_DATA
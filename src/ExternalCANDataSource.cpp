@@ -5,15 +5,29 @@
 #include "EnumUtility.h"
 #include "LoggingModule.h"
 #include "TraceModule.h"
+#include <string>
+#include <utility>
 
 namespace Aws
 {
 namespace IoTFleetWise
 {
 
-ExternalCANDataSource::ExternalCANDataSource( CANDataConsumer &consumer )
+constexpr uint32_t ExternalCANDataSource::DEFAULT_SHARED_MEMORY_MAX_WAIT_TIME_MS; // NOLINT
+constexpr size_t ExternalCANDataSource::MAX_SHARED_MEMORY_BATCH_SIZE;           // NOLINT
+
+ExternalCANDataSource::ExternalCANDataSource( CANDataConsumer &consumer, uint32_t sharedMemoryMaxWaitTimeMs )
     : mConsumer{ consumer }
+    , mSharedMemoryMaxWaitTimeMs{ sharedMemoryMaxWaitTimeMs }
+{
+}
+
+ExternalCANDataSource::~ExternalCANDataSource()
 {
+    if ( isSharedMemoryConsumerRunning() )
+    {
+        stopSharedMemoryConsumer();
+    }
 }
 
 void
@@ -21,28 +35,152 @@ ExternalCANDataSource::ingestMessage( CANChannelNumericID channelId,
                                       Timestamp timestamp,
                                       uint32_t messageId,
                                       const std::vector<uint8_t> &data )
+{
+    CANFrameInfo frame{ messageId, data.data(), data.size(), timestamp };
+    ingestMessages( channelId, &frame, 1 );
+}
+
+void
+ExternalCANDataSource::ingestMessages( CANChannelNumericID channelId, const CANFrameInfo *frames, size_t numFrames )
 {
     std::lock_guard<std::mutex> lock( mDecoderDictMutex );
-    if ( mDecoderDictionary == nullptr )
+    if ( ( mDecoderDictionary == nullptr ) || ( numFrames == 0 ) )
     {
         return;
     }
-    if ( timestamp == 0 )
-    {
-        TraceModule::get().incrementVariable( TraceVariable::POLLING_TIMESTAMP_COUNTER );
-        timestamp = mClock->systemTimeSinceEpochMs();
-    }
-    if ( timestamp < mLastFrameTime )
+    // Only the frame infos are copied, the data is still read from the caller's buffers
+    mTimestampedFrames.assign( frames, frames + numFrames );
+    Timestamp pollingTime = 0;
+    for ( auto &frame : mTimestampedFrames )
     {
-        TraceModule::get().incrementAtomicVariable( TraceAtomicVariable::NOT_TIME_MONOTONIC_FRAMES );
+        if ( frame.timestamp == 0 )
+        {
+            TraceModule::get().incrementVariable( TraceVariable::POLLING_TIMESTAMP_COUNTER );
+            if ( pollingTime == 0 )
+            {
+                pollingTime = mClock->systemTimeSinceEpochMs();
+            }
+            frame.timestamp = pollingTime;
+        }
+        if ( frame.timestamp < mLastFrameTime )
+        {
+            TraceModule::get().incrementAtomicVariable( TraceAtomicVariable::NOT_TIME_MONOTONIC_FRAMES );
+        }
+        mLastFrameTime = frame.timestamp;
     }
-    mLastFrameTime = timestamp;
     unsigned traceFrames = channelId + toUType( TraceVariable::READ_SOCKET_FRAMES_0 );
-    TraceModule::get().incrementVariable(
+    TraceModule::get().addToVariable(
         ( traceFrames < static_cast<unsigned>( toUType( TraceVariable::READ_SOCKET_FRAMES_19 ) ) )
             ? static_cast<TraceVariable>( traceFrames )
-            : TraceVariable::READ_SOCKET_FRAMES_19 );
-    mConsumer.processMessage( channelId, mDecoderDictionary, messageId, data.data(), data.size(), timestamp );
+            : TraceVariable::READ_SOCKET_FRAMES_19,
+        numFrames );
+    mConsumer.processMessages( channelId, mDecoderDictionary, mTimestampedFrames.data(), mTimestampedFrames.size() );
+}
+
+bool
+ExternalCANDataSource::addSharedMemoryRing( CANChannelNumericID channelId, const std::string &path, uint32_t capacity )
+{
+    std::lock_guard<std::mutex> lock( mThreadMutex );
+    if ( isSharedMemoryConsumerRunning() )
+    {
+        FWE_LOG_ERROR( "Shared memory rings can't be added while the consumer threads are running" );
+        return false;
+    }
+    auto ring = std::make_unique<CANSharedMemoryRing>( path );
+    if ( !ring->create( capacity ) )
+    {
+        return false;
+    }
+    FWE_LOG_INFO( "Created shared memory ring " + path + " for CAN channel " + std::to_string( channelId ) );
+    auto consumer = std::make_unique<SharedMemoryConsumer>();
+    consumer->dataSource = this;
+    consumer->channelId = channelId;
+    consumer->ring = std::move( ring );
+    consumer->frames.reserve( MAX_SHARED_MEMORY_BATCH_SIZE );
+    mSharedMemoryConsumers.push_back( std::move( consumer ) );
+    return true;
+}
+
+bool
+ExternalCANDataSource::isSharedMemoryConsumerRunning() const
+{
+    for ( const auto &consumer : mSharedMemoryConsumers )
+    {
+        if ( consumer->thread.isValid() )
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool
+ExternalCANDataSource::startSharedMemoryConsumer()
+{
+    std::lock_guard<std::mutex> lock( mThreadMutex );
+    mShouldStop.store( false );
+    for ( auto &consumer : mSharedMemoryConsumers )
+    {
+        if ( ( !consumer->thread.create( doWork, consumer.get() ) ) || ( !consumer->thread.isActive() ) )
+        {
+            FWE_LOG_ERROR( "External CAN shared memory thread for CAN channel " +
+                           std::to_string( consumer->channelId ) + " failed to start" );
+            // Don't leave the threads of the other rings running
+            stopSharedMemoryThreads();
+            return false;
+        }
+        FWE_LOG_TRACE( "External CAN shared memory thread for CAN channel " + std::to_string( consumer->channelId ) +
+                       " started" );
+        consumer->thread.setThreadName( "fwVNExtCANShm" );
+    }
+    return true;
+}
+
+bool
+ExternalCANDataSource::stopSharedMemoryConsumer()
+{
+    std::lock_guard<std::mutex> lock( mThreadMutex );
+    auto success = stopSharedMemoryThreads();
+    FWE_LOG_TRACE( "External CAN shared memory threads stopped" );
+    return success;
+}
+
+bool
+ExternalCANDataSource::stopSharedMemoryThreads()
+{
+    mShouldStop.store( true );
+    bool success = true;
+    for ( auto &consumer : mSharedMemoryConsumers )
+    {
+        if ( consumer->thread.isValid() )
+        {
+            consumer->ring->wakeUp();
+            consumer->thread.release();
+        }
+        success = success && ( !consumer->thread.isActive() );
+    }
+    mShouldStop.store( false, std::memory_order_relaxed );
+    return success;
+}
+
+void
+ExternalCANDataSource::doWork( void *data )
+{
+    auto *consumer = static_cast<SharedMemoryConsumer *>( data );
+    auto *dataSource = consumer->dataSource;
+    auto &ring = *consumer->ring;
+    while ( !dataSource->mShouldStop.load( std::memory_order_relaxed ) )
+    {
+        auto numFrames = ring.peek( consumer->frames, MAX_SHARED_MEMORY_BATCH_SIZE );
+        if ( numFrames == 0 )
+        {
+            ring.waitForFrames( dataSource->mSharedMemoryMaxWaitTimeMs, dataSource->mShouldStop );
+            continue;
+        }
+        // The frames point into the shared memory, so they are released only after they were processed
+        dataSource->ingestMessages( consumer->channelId, consumer->frames.data(), numFrames );
+        ring.release( numFrames );
+    }
 }
 
 void
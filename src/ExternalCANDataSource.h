@@ -4,15 +4,20 @@
 #pragma once
 
 #include "CANDataConsumer.h"
+#include "CANSharedMemoryRing.h"
 #include "Clock.h"
 #include "ClockHandler.h"
 #include "IDecoderDictionary.h"
 #include "SignalTypes.h"
+#include "Thread.h"
 #include "TimeTypes.h"
 #include "VehicleDataSourceTypes.h"
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <vector>
 
 namespace Aws
@@ -23,18 +28,28 @@ namespace IoTFleetWise
 /**
  * @brief External CAN Bus implementation. Allows data from external in-process CAN bus sources to
  *        be ingested, for example when FWE is compiled as a shared-library.
+ *
+ * Frames can also be written by an external process to a CANSharedMemoryRing per channel. Each ring is consumed by
+ * its own thread, which sleeps on the ring's futex word while the ring is empty.
  */
 // coverity[cert_dcl60_cpp_violation] false positive - class only defined once
 // coverity[autosar_cpp14_m3_2_2_violation] false positive - class only defined once
 class ExternalCANDataSource
 {
 public:
+    static constexpr uint32_t DEFAULT_SHARED_MEMORY_MAX_WAIT_TIME_MS = 1000;
+    static constexpr size_t MAX_SHARED_MEMORY_BATCH_SIZE = 256;
+
     /**
      * @brief Construct CAN data source
      * @param consumer CAN data consumer
+     * @param sharedMemoryMaxWaitTimeMs Maximum time a consumer thread sleeps on an empty shared memory ring. Producers
+     * following the protocol of CANSharedMemoryRing wake it up immediately, this only bounds the latency of producers
+     * that don't.
      */
-    ExternalCANDataSource( CANDataConsumer &consumer );
-    ~ExternalCANDataSource() = default;
+    ExternalCANDataSource( CANDataConsumer &consumer,
+                           uint32_t sharedMemoryMaxWaitTimeMs = DEFAULT_SHARED_MEMORY_MAX_WAIT_TIME_MS );
+    ~ExternalCANDataSource();
 
     ExternalCANDataSource( const ExternalCANDataSource & ) = delete;
     ExternalCANDataSource &operator=( const ExternalCANDataSource & ) = delete;
@@ -51,15 +66,69 @@ public:
                         uint32_t messageId,
                         const std::vector<uint8_t> &data );
 
+    /** Ingest a batch of CAN messages of one channel. The frame data is only read during the call, it is not copied
+     * to an intermediate buffer.
+     * @param channelId CAN channel ID
+     * @param frames pointer to the first frame. Timestamps are in milliseconds since epoch, or zero if unknown.
+     * @param numFrames number of frames */
+    void ingestMessages( CANChannelNumericID channelId, const CANFrameInfo *frames, size_t numFrames );
+
+    /**
+     * @brief Creates a shared memory ring for an external process to write the frames of one channel into. Must be
+     * called before startSharedMemoryConsumer().
+     * @param channelId CAN channel ID of the frames written to the ring
+     * @param path path of the file backing the shared memory, e.g. "/dev/shm/fwe-can0"
+     * @param capacity number of frames the ring can hold
+     * @return true on success
+     */
+    bool addSharedMemoryRing( CANChannelNumericID channelId, const std::string &path, uint32_t capacity );
+
+    /**
+     * @brief Starts the threads consuming the shared memory rings
+     * @return true on success
+     */
+    bool startSharedMemoryConsumer();
+
+    /**
+     * @brief Stops the threads consuming the shared memory rings
+     * @return true on success
+     */
+    bool stopSharedMemoryConsumer();
+
     void onChangeOfActiveDictionary( ConstDecoderDictionaryConstPtr &dictionary,
                                      VehicleDataSourceProtocol networkProtocol );
 
 private:
+    struct SharedMemoryConsumer
+    {
+        ExternalCANDataSource *dataSource{ nullptr };
+        CANChannelNumericID channelId{ INVALID_CAN_SOURCE_NUMERIC_ID };
+        std::unique_ptr<CANSharedMemoryRing> ring;
+        // Frame infos pointing into the ring, only used by the thread
+        std::vector<CANFrameInfo> frames;
+        Thread thread;
+    };
+
+    // Consumes one shared memory ring
+    static void doWork( void *data );
+
+    bool isSharedMemoryConsumerRunning() const;
+
+    // Stops all started shared memory threads, mThreadMutex must be locked
+    bool stopSharedMemoryThreads();
+
     std::shared_ptr<const Clock> mClock = ClockHandler::getClock();
     std::mutex mDecoderDictMutex;
     std::shared_ptr<const CANDecoderDictionary> mDecoderDictionary;
     CANDataConsumer &mConsumer;
     Timestamp mLastFrameTime{};
+    // Copies of the frame infos with the missing timestamps filled in. Only used with mDecoderDictMutex locked.
+    std::vector<CANFrameInfo> mTimestampedFrames;
+
+    uint32_t mSharedMemoryMaxWaitTimeMs{ DEFAULT_SHARED_MEMORY_MAX_WAIT_TIME_MS };
+    std::vector<std::unique_ptr<SharedMemoryConsumer>> mSharedMemoryConsumers;
+    std::atomic<bool> mShouldStop{ false };
+    std::mutex mThreadMutex;
 };
 
 } // namespace IoTFleetWise
@@ -48,6 +48,12 @@ struct SignalCollectionInfo
      * condition logic with its associated fixed_window_period_ms. Default is false.
      */
     bool isConditionOnlySignal{ false };
+
+    /**
+     * @brief Reduction of the samples when they are collected, to reduce the size of the uploaded data.
+     * By default all samples are collected.
+     */
+    SignalReduction reduction;
 };
 
 struct CanFrameCollectionInfo
@@ -107,6 +113,30 @@ enum class WindowFunction
     PREV_LAST_FIXED_WINDOW_MIN,
     LAST_FIXED_WINDOW_MAX,
     PREV_LAST_FIXED_WINDOW_MAX,
+    LAST_FIXED_WINDOW_COUNT,
+    PREV_LAST_FIXED_WINDOW_COUNT,
+    LAST_FIXED_WINDOW_SUM,
+    PREV_LAST_FIXED_WINDOW_SUM,
+    LAST_FIXED_WINDOW_STDDEV,
+    PREV_LAST_FIXED_WINDOW_STDDEV,
+    LAST_FIXED_WINDOW_FIRST,
+    PREV_LAST_FIXED_WINDOW_FIRST,
+    LAST_FIXED_WINDOW_LAST,
+    PREV_LAST_FIXED_WINDOW_LAST,
+    LAST_FIXED_WINDOW_RATE_OF_CHANGE, // Change per second from the first to the last sample of the window
+    PREV_LAST_FIXED_WINDOW_RATE_OF_CHANGE,
+    LAST_FIXED_WINDOW_P50, // Approximate percentiles
+    PREV_LAST_FIXED_WINDOW_P50,
+    LAST_FIXED_WINDOW_P95,
+    PREV_LAST_FIXED_WINDOW_P95,
+    LAST_FIXED_WINDOW_P99,
+    PREV_LAST_FIXED_WINDOW_P99,
+    SLIDING_WINDOW_COUNT, // Over the samples of the last fixed window period, up to the sample buffer size
+    SLIDING_WINDOW_SUM,
+    SLIDING_WINDOW_AVG,
+    SLIDING_WINDOW_MIN,
+    SLIDING_WINDOW_MAX,
+    SLIDING_WINDOW_STDDEV,
     NONE
 };
 
@@ -349,6 +379,16 @@ public:
      */
     virtual bool isCompressionNeeded() const = 0;
 
+    /**
+     * @brief Should the collected signals be sent in the columnar encoding
+     */
+    virtual bool isColumnarSignalEncodingNeeded() const = 0;
+
+    /**
+     * @brief Returns how the data is compressed if isCompressionNeeded() is true
+     */
+    virtual const CompressionOptions &getCompressionOptions() const = 0;
+
     /**
      * @brief Returns the condition to trigger the collectionScheme
      *
@@ -3,9 +3,12 @@
 
 #pragma once
 
+#include "CANDataTypes.h"
 #include "IDecoderManifest.h"
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 namespace Aws
 {
@@ -35,11 +38,13 @@ enum class CANMessageCollectType
  * collectType: specify whether the message is intended to be decoded or kept as raw or both
  * format: CAN message format specifying the frame ID, number of bytes and whether it's Multiplexed.
  * Note the format only contains the signals intended to be collected.
+ * decodePlan: format compiled for the signals to be collected, see CANDecoder::compileDictionary
  */
 struct CANMessageDecoderMethod
 {
     CANMessageCollectType collectType;
     CANMessageFormat format;
+    CANMessageDecodePlan decodePlan;
 };
 
 /**
@@ -56,6 +61,24 @@ struct DecoderDictionary
     std::unordered_set<SignalID> signalIDsToCollect;
 };
 
+/**
+ * @brief Number of standard (11-bit) CAN frame IDs
+ */
+static constexpr CANRawFrameID CAN_STANDARD_FRAME_ID_COUNT = 2048;
+
+/**
+ * @brief Flat lookup of the decoder methods of one CAN channel, pointing into canMessageDecoderMethod
+ *
+ * standardFrames: indexed by the 11-bit frame ID, nullptr if there is no decoder method. Empty if the channel has no
+ * standard frames.
+ * otherFrames: all other frame IDs with their decoder method, sorted by frame ID for a binary search
+ */
+struct CANChannelDecoderMethodLookup
+{
+    std::vector<const CANMessageDecoderMethod *> standardFrames;
+    std::vector<std::pair<CANRawFrameID, const CANMessageDecoderMethod *>> otherFrames;
+};
+
 /**
  * @brief CAN decoder dictionary to be used to decode CAN Frame message to signals. This dictionary comes from
  * CollectionScheme Management
@@ -64,6 +87,8 @@ struct DecoderDictionary
  * CAN Frame ID which is the CAN Arbitration ID
  * signalIDsToCollect is an unordered_set to specify which SignalID to be collected based on the CollectionScheme
  * pidMessageDecoderMethod is a map from OBD-II PID to its decoding method
+ * canMessageDecoderMethodLookup is indexed by CANChannelNumericID and only valid if isDecoderMethodLookupBuilt is set,
+ * see CANDecoder::compileDictionary. As it points into canMessageDecoderMethod it is not copied with the dictionary.
  */
 struct CANDecoderDictionary : DecoderDictionary
 {
@@ -76,7 +101,32 @@ struct CANDecoderDictionary : DecoderDictionary
         , canMessageDecoderMethod( std::move( canMsgDecoderMethodIn ) )
     {
     }
+    ~CANDecoderDictionary() override = default;
+
+    CANDecoderDictionary( const CANDecoderDictionary &other )
+        : DecoderDictionary( other )
+        , canMessageDecoderMethod( other.canMessageDecoderMethod )
+    {
+    }
+    CANDecoderDictionary &
+    operator=( const CANDecoderDictionary &other )
+    {
+        if ( this != &other )
+        {
+            signalIDsToCollect = other.signalIDsToCollect;
+            canMessageDecoderMethod = other.canMessageDecoderMethod;
+            canMessageDecoderMethodLookup.clear();
+            isDecoderMethodLookupBuilt = false;
+        }
+        return *this;
+    }
+    // Moving the map keeps its nodes, so the lookup stays valid
+    CANDecoderDictionary( CANDecoderDictionary && ) = default;
+    CANDecoderDictionary &operator=( CANDecoderDictionary && ) = default;
+
     CANMsgDecoderMethodType canMessageDecoderMethod;
+    std::vector<CANChannelDecoderMethodLookup> canMessageDecoderMethodLookup;
+    bool isDecoderMethodLookupBuilt{ false };
 };
 
 /**
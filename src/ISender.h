@@ -4,6 +4,7 @@
 #pragma once
 
 #include "IConnectionTypes.h"
+#include "PayloadCompression.h"
 #include <string>
 
 namespace Aws
@@ -22,6 +23,8 @@ struct CollectionSchemeParams
     uint32_t priority{ 0 };    // collectionScheme priority specified by the cloud
     uint64_t triggerTime{ 0 }; // timestamp of event ocurred
     uint32_t eventID{ 0 };     // event id
+    // codec used if compression is true
+    CompressionOptions compressionOptions;
 };
 
 /**
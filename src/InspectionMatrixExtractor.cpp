@@ -93,6 +93,7 @@ CollectionSchemeManager::addConditionData( const ICollectionSchemePtr &collectio
         inspectionSignal.minimumSampleIntervalMs = collectionSignals[i].minimumSampleIntervalMs;
         inspectionSignal.fixedWindowPeriod = collectionSignals[i].fixedWindowPeriod;
         inspectionSignal.isConditionOnlySignal = collectionSignals[i].isConditionOnlySignal;
+        inspectionSignal.reduction = collectionSignals[i].reduction;
         inspectionSignal.signalType = getSignalType( collectionSignals[i].signalID );
         conditionData.signals.emplace_back( inspectionSignal );
     }
@@ -116,6 +117,8 @@ CollectionSchemeManager::addConditionData( const ICollectionSchemePtr &collectio
     }
     // The rest
     conditionData.metadata.compress = collectionScheme->isCompressionNeeded();
+    conditionData.metadata.compressionOptions = collectionScheme->getCompressionOptions();
+    conditionData.metadata.columnarSignalEncoding = collectionScheme->isColumnarSignalEncodingNeeded();
     conditionData.metadata.persist = collectionScheme->isPersistNeeded();
     conditionData.metadata.priority = collectionScheme->getPriority();
     conditionData.metadata.decoderID = collectionScheme->getDecoderManifestID();
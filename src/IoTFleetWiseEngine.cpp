@@ -48,6 +48,7 @@ namespace IoTFleetWise
 {
 
 static constexpr uint64_t DEFAULT_RETRY_UPLOAD_PERSISTED_INTERVAL_MS = 10000;
+static constexpr uint32_t DEFAULT_EXTERNAL_CAN_SHARED_MEMORY_CAPACITY = 4096;
 static const std::string CAN_INTERFACE_TYPE = "canInterface";
 static const std::string EXTERNAL_CAN_INTERFACE_TYPE = "externalCanInterface";
 static const std::string OBD_INTERFACE_TYPE = "obdInterface";
@@ -428,14 +429,27 @@ IoTFleetWiseEngine::connect( const Json::Value &jsonConfig )
         mCollectedDataReadyToPublish = std::make_shared<CollectedDataReadyToPublish>(
             config["staticConfig"]["internalParameters"]["readyToPublishDataBufferSize"].asSizeRequired() );
 
+        uint32_t inspectionEngineShards = 1;
+        if ( config["staticConfig"]["internalParameters"].isMember( "inspectionEngineShards" ) )
+        {
+            inspectionEngineShards =
+                config["staticConfig"]["internalParameters"]["inspectionEngineShards"].asU32Required();
+        }
+        bool zeroCopySignalCollection = config["staticConfig"]["internalParameters"]["zeroCopySignalCollection"]
+                                            .asBoolOptional()
+                                            .get_value_or( false );
+
         // Init and start the Inspection Engine
         mCollectionInspectionWorkerThread = std::make_shared<CollectionInspectionWorkerThread>();
         if ( ( !mCollectionInspectionWorkerThread->init(
                  signalBufferPtr,
                  mCollectedDataReadyToPublish,
-                 config["staticConfig"]["threadIdleTimes"]["inspectionThreadIdleTimeMs"].asU32Required()
+                 config["staticConfig"]["threadIdleTimes"]["inspectionThreadIdleTimeMs"].asU32Required(),
+                 inspectionEngineShards,
+                 zeroCopySignalCollection
 #ifdef FWE_FEATURE_VISION_SYSTEM_DATA
                      ,
+                 CollectionInspectionWorkerThread::SHARD_SIGNAL_BUFFER_SIZE,
                  rawDataBufferManager
 #endif
                  ) ) ||
@@ -492,8 +506,18 @@ IoTFleetWiseEngine::connect( const Json::Value &jsonConfig )
             clientId
 #endif
         );
-        mDataSenderManagerWorkerThread = std::make_shared<DataSenderManagerWorkerThread>(
-            mConnectivityModule, mDataSenderManager, persistencyUploadRetryIntervalMs, mCollectedDataReadyToPublish );
+        uint32_t dataSenderSerializationThreads = 1;
+        if ( config["staticConfig"]["internalParameters"].isMember( "dataSenderSerializationThreads" ) )
+        {
+            dataSenderSerializationThreads =
+                config["staticConfig"]["internalParameters"]["dataSenderSerializationThreads"].asU32Required();
+        }
+        mDataSenderManagerWorkerThread =
+            std::make_shared<DataSenderManagerWorkerThread>( mConnectivityModule,
+                                                             mDataSenderManager,
+                                                             persistencyUploadRetryIntervalMs,
+                                                             mCollectedDataReadyToPublish,
+                                                             dataSenderSerializationThreads );
         if ( !mDataSenderManagerWorkerThread->start() )
         {
             FWE_LOG_ERROR( "Failed to init and start the Data Sender" );
@@ -569,6 +593,7 @@ IoTFleetWiseEngine::connect( const Json::Value &jsonConfig )
         /********************************Data source bootstrap start*******************************/
 
         auto obdOverCANModuleInit = false;
+        auto startExternalCANSharedMemoryConsumer = false;
         mCANDataConsumer = std::make_unique<CANDataConsumer>( signalBufferPtr );
         for ( unsigned i = 0; i < config["networkInterfaces"].getArraySizeRequired(); i++ )
         {
@@ -597,7 +622,11 @@ IoTFleetWiseEngine::connect( const Json::Value &jsonConfig )
                     canConfig["interfaceName"].asStringRequired(),
                     canConfig["protocolName"].asStringRequired() == "CAN-FD",
                     config["staticConfig"]["threadIdleTimes"]["socketCANThreadIdleTimeMs"].asU32Required(),
-                    *mCANDataConsumer );
+                    *mCANDataConsumer,
+                    canConfig["receiveBatchSize"].asU32Optional().get_value_or(
+                        CANDataSource::DEFAULT_RECEIVE_BATCH_SIZE ),
+                    canConfig["maxKernelFilters"].asU32Optional().get_value_or(
+                        CANDataSource::DEFAULT_MAX_KERNEL_FILTERS ) );
                 if ( !canSourcePtr->init() )
                 {
                     FWE_LOG_ERROR( "Failed to initialize CANDataSource" );
@@ -660,6 +689,21 @@ IoTFleetWiseEngine::connect( const Json::Value &jsonConfig )
                                    std::placeholders::_1,
                                    std::placeholders::_2 ) );
                 }
+                auto externalCanConfig = networkInterfaceConfig[EXTERNAL_CAN_INTERFACE_TYPE];
+                auto sharedMemoryPath = externalCanConfig["sharedMemoryPath"].asStringOptional();
+                if ( sharedMemoryPath.has_value() )
+                {
+                    if ( !mExternalCANDataSource->addSharedMemoryRing(
+                             mCANIDTranslator.getChannelNumericID( interfaceId ),
+                             sharedMemoryPath.get(),
+                             externalCanConfig["sharedMemoryCapacity"].asU32Optional().get_value_or(
+                                 DEFAULT_EXTERNAL_CAN_SHARED_MEMORY_CAPACITY ) ) )
+                    {
+                        FWE_LOG_ERROR( "Failed to create shared memory ring " + sharedMemoryPath.get() );
+                        return false;
+                    }
+                    startExternalCANSharedMemoryConsumer = true;
+                }
             }
 #ifdef FWE_FEATURE_ROS2
             else if ( interfaceType == ROS2_INTERFACE_TYPE )
@@ -684,6 +728,12 @@ IoTFleetWiseEngine::connect( const Json::Value &jsonConfig )
             }
         }
 
+        if ( startExternalCANSharedMemoryConsumer && ( !mExternalCANDataSource->startSharedMemoryConsumer() ) )
+        {
+            FWE_LOG_ERROR( "Failed to start the external CAN shared memory consumer" );
+            return false;
+        }
+
         /********************************Data source bootstrap end*******************************/
 
         // Only start the CollectionSchemeManager after all listeners have subscribed, otherwise
@@ -900,6 +950,12 @@ IoTFleetWiseEngine::disconnect()
         }
     }
 
+    if ( ( mExternalCANDataSource != nullptr ) && ( !mExternalCANDataSource->stopSharedMemoryConsumer() ) )
+    {
+        FWE_LOG_ERROR( "Could not stop the external CAN shared memory consumer" );
+        return false;
+    }
+
     if ( mConnectivityModule->isAlive() && ( !mConnectivityModule->disconnect() ) )
     {
         FWE_LOG_ERROR( "Could not disconnect the offboard connectivity" );
@@ -1059,6 +1115,25 @@ IoTFleetWiseEngine::ingestExternalCANMessage( const InterfaceID &interfaceId,
     mExternalCANDataSource->ingestMessage( canChannelId, timestamp, messageId, data );
 }
 
+CANChannelNumericID
+IoTFleetWiseEngine::getExternalCANChannelNumericID( const InterfaceID &interfaceId ) const
+{
+    return mCANIDTranslator.getChannelNumericID( interfaceId );
+}
+
+void
+IoTFleetWiseEngine::ingestExternalCANMessages( CANChannelNumericID channelId,
+                                               const CANFrameInfo *frames,
+                                               size_t numFrames )
+{
+    if ( mExternalCANDataSource == nullptr )
+    {
+        FWE_LOG_ERROR( "No external CAN interface present" );
+        return;
+    }
+    mExternalCANDataSource->ingestMessages( channelId, frames, numFrames );
+}
+
 #ifdef FWE_FEATURE_EXTERNAL_GPS
 void
 IoTFleetWiseEngine::setExternalGpsLocation( double latitude, double longitude )
@@ -28,6 +28,7 @@
 #include "TimeTypes.h"
 #include "Timer.h"
 #include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <json/json.h>
 #include <memory>
@@ -106,6 +107,17 @@ public:
                                    uint32_t messageId,
                                    const std::vector<uint8_t> &data );
 
+    /** Get the numeric channel ID of an interface, to be used with ingestExternalCANMessages
+     * @param interfaceId Interface identifier
+     * @return Channel ID, or INVALID_CAN_SOURCE_NUMERIC_ID if the interface is unknown */
+    CANChannelNumericID getExternalCANChannelNumericID( const InterfaceID &interfaceId ) const;
+
+    /** Ingest a batch of CAN messages from an external source without copying the frame data
+     * @param channelId Channel ID from getExternalCANChannelNumericID
+     * @param frames Frames, with timestamps in milliseconds since epoch, or zero if unknown. Only read during the call.
+     * @param numFrames Number of frames */
+    void ingestExternalCANMessages( CANChannelNumericID channelId, const CANFrameInfo *frames, size_t numFrames );
+
 #ifdef FWE_FEATURE_EXTERNAL_GPS
     /**
      * @brief Sets the location for the ExternalGpsSource
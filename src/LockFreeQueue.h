@@ -0,0 +1,309 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace Aws
+{
+namespace IoTFleetWise
+{
+
+/**
+ * @brief Size in bytes used to separate atomics written by different threads, so that they do not share a cache line
+ */
+static constexpr size_t LOCK_FREE_QUEUE_CACHE_LINE_SIZE = 64;
+
+/**
+ * @brief Resets an element before its storage is handed back to a queue slot
+ *
+ * The queues below never destroy elements: a push swaps the element with the slot content and a pop swaps the slot
+ * content with the (recycled) element of the caller. Hence whatever storage an element owns keeps circulating
+ * between producers, slots and the consumer. Overload this function in the namespace of T for types that can keep
+ * reusable storage (e.g. vector capacity) while dropping their content. The default drops everything.
+ */
+template <typename T>
+inline void
+recycleQueueElement( T &element )
+{
+    element = T();
+}
+
+/**
+ * @brief Bounded, preallocated, lock-free multi-producer single-consumer queue
+ *
+ * Each slot carries a sequence number that tells producers and the consumer whether the slot is free to be written
+ * or ready to be read (Dmitry Vyukov's bounded queue). Producers claim a slot with a single CAS on the write position
+ * and never block each other on a lock. Only one thread may call pop()/consumeAll() at a time.
+ *
+ * For position p a slot is free when its sequence is 2p and filled when it is 2p+1. Using even/odd values instead of
+ * p/p+1 keeps both states distinct even when the queue only has a single slot.
+ *
+ * Elements are swapped in and out of the preallocated slots, see recycleQueueElement().
+ */
+template <typename T>
+class MpscQueue
+{
+public:
+    /**
+     * @param maxSize maximum number of elements that can be held in the queue. Must be greater than zero.
+     */
+    MpscQueue( size_t maxSize )
+        : mMaxSize( maxSize > 0 ? maxSize : 1 )
+        , mSlots( new Slot[mMaxSize] )
+    {
+        for ( size_t i = 0; i < mMaxSize; i++ )
+        {
+            mSlots[i].sequence.store( 2 * i, std::memory_order_relaxed );
+        }
+    }
+
+    ~MpscQueue() = default;
+
+    MpscQueue( const MpscQueue & ) = delete;
+    MpscQueue &operator=( const MpscQueue & ) = delete;
+    MpscQueue( MpscQueue && ) = delete;
+    MpscQueue &operator=( MpscQueue && ) = delete;
+
+    /**
+     * @brief Pushes an element to the queue. Can be called from any thread.
+     * @param element the element that will be moved into the queue. On success it holds recycled storage afterwards.
+     * @return true if the element was pushed, false if the queue is full
+     */
+    bool
+    push( T &&element )
+    {
+        size_t position = mWritePosition.load( std::memory_order_relaxed );
+        Slot *slot = nullptr;
+        for ( ;; )
+        {
+            slot = &mSlots[position % mMaxSize];
+            size_t sequence = slot->sequence.load( std::memory_order_acquire );
+            auto difference = static_cast<intptr_t>( sequence ) - static_cast<intptr_t>( 2 * position );
+            if ( difference == 0 )
+            {
+                if ( mWritePosition.compare_exchange_weak( position, position + 1, std::memory_order_relaxed ) )
+                {
+                    break;
+                }
+            }
+            else if ( difference < 0 )
+            {
+                // The slot still holds an element from the previous lap that was not consumed yet
+                return false;
+            }
+            else
+            {
+                position = mWritePosition.load( std::memory_order_relaxed );
+            }
+        }
+        std::swap( slot->element, element );
+        slot->sequence.store( ( 2 * position ) + 1, std::memory_order_release );
+        return true;
+    }
+
+    /**
+     * @brief Pops an element from the queue. Must only be called from the single consumer thread.
+     * @param element the popped element will be moved into this parameter. Its previous content is recycled.
+     * @return true if an element was popped, false if the queue is empty
+     */
+    bool
+    pop( T &element )
+    {
+        size_t position = mReadPosition.load( std::memory_order_relaxed );
+        Slot &slot = mSlots[position % mMaxSize];
+        size_t sequence = slot.sequence.load( std::memory_order_acquire );
+        if ( sequence != ( ( 2 * position ) + 1 ) )
+        {
+            // Either empty or a producer claimed the slot but did not finish writing it yet
+            return false;
+        }
+        recycleQueueElement( element );
+        std::swap( element, slot.element );
+        mReadPosition.store( position + 1, std::memory_order_relaxed );
+        slot.sequence.store( 2 * ( position + mMaxSize ), std::memory_order_release );
+        return true;
+    }
+
+    /**
+     * @brief Pops all elements and passes each of them to the functor. Must only be called from the consumer thread.
+     * @param functor called for each popped element
+     * @return number of consumed elements
+     */
+    template <typename Functor>
+    size_t
+    consumeAll( const Functor &functor )
+    {
+        size_t consumed = 0;
+        while ( pop( mConsumedElement ) )
+        {
+            functor( mConsumedElement );
+            consumed++;
+        }
+        // Drop the content of the last element right away but keep its storage for the next call
+        recycleQueueElement( mConsumedElement );
+        return consumed;
+    }
+
+    // coverity[misra_cpp_2008_rule_14_7_1_violation] Required in unit tests
+    bool
+    isEmpty() const
+    {
+        size_t position = mReadPosition.load( std::memory_order_relaxed );
+        return mSlots[position % mMaxSize].sequence.load( std::memory_order_acquire ) != ( ( 2 * position ) + 1 );
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> sequence{ 0 };
+        T element{};
+    };
+
+    size_t mMaxSize;
+    std::unique_ptr<Slot[]> mSlots;
+    uint8_t mPaddingBeforeWrite[LOCK_FREE_QUEUE_CACHE_LINE_SIZE]{};
+    std::atomic<size_t> mWritePosition{ 0 };
+    uint8_t mPaddingBeforeRead[LOCK_FREE_QUEUE_CACHE_LINE_SIZE]{};
+    std::atomic<size_t> mReadPosition{ 0 };
+    // Only used by the consumer
+    T mConsumedElement{};
+};
+
+/**
+ * @brief Bounded, preallocated, lock-free single-producer single-consumer queue
+ *
+ * Only one thread may push and only one thread may pop at a time. Each side only writes its own position, so no
+ * read-modify-write atomics are needed. Each side also keeps a cached copy of the other side's position and only
+ * reloads it when the cached value says the queue is full/empty, which keeps cache line transfers to a minimum.
+ *
+ * Elements are swapped in and out of the preallocated slots, see recycleQueueElement().
+ */
+template <typename T>
+class SpscQueue
+{
+public:
+    /**
+     * @param maxSize maximum number of elements that can be held in the queue. Must be greater than zero.
+     */
+    SpscQueue( size_t maxSize )
+        : mMaxSize( maxSize > 0 ? maxSize : 1 )
+        , mSlots( new T[mMaxSize] )
+    {
+    }
+
+    ~SpscQueue() = default;
+
+    SpscQueue( const SpscQueue & ) = delete;
+    SpscQueue &operator=( const SpscQueue & ) = delete;
+    SpscQueue( SpscQueue && ) = delete;
+    SpscQueue &operator=( SpscQueue && ) = delete;
+
+    /**
+     * @brief Pushes an element to the queue. Must only be called from the single producer thread.
+     * @param element the element that will be moved into the queue. On success it holds recycled storage afterwards.
+     * @return true if the element was pushed, false if the queue is full
+     */
+    bool
+    push( T &&element )
+    {
+        size_t writePosition = mWritePosition.load( std::memory_order_relaxed );
+        if ( ( writePosition - mCachedReadPosition ) >= mMaxSize )
+        {
+            mCachedReadPosition = mReadPosition.load( std::memory_order_acquire );
+            if ( ( writePosition - mCachedReadPosition ) >= mMaxSize )
+            {
+                return false;
+            }
+        }
+        std::swap( mSlots[writePosition % mMaxSize], element );
+        mWritePosition.store( writePosition + 1, std::memory_order_release );
+        return true;
+    }
+
+    /**
+     * @brief Checks whether the next push would fail. Must only be called from the single producer thread.
+     * @return true if the queue is full
+     */
+    bool
+    isFull()
+    {
+        size_t writePosition = mWritePosition.load( std::memory_order_relaxed );
+        if ( ( writePosition - mCachedReadPosition ) >= mMaxSize )
+        {
+            mCachedReadPosition = mReadPosition.load( std::memory_order_acquire );
+        }
+        return ( writePosition - mCachedReadPosition ) >= mMaxSize;
+    }
+
+    /**
+     * @brief Pops an element from the queue. Must only be called from the single consumer thread.
+     * @param element the popped element will be moved into this parameter. Its previous content is recycled.
+     * @return true if an element was popped, false if the queue is empty
+     */
+    bool
+    pop( T &element )
+    {
+        size_t readPosition = mReadPosition.load( std::memory_order_relaxed );
+        if ( readPosition == mCachedWritePosition )
+        {
+            mCachedWritePosition = mWritePosition.load( std::memory_order_acquire );
+            if ( readPosition == mCachedWritePosition )
+            {
+                return false;
+            }
+        }
+        recycleQueueElement( element );
+        std::swap( element, mSlots[readPosition % mMaxSize] );
+        mReadPosition.store( readPosition + 1, std::memory_order_release );
+        return true;
+    }
+
+    /**
+     * @brief Pops all elements and passes each of them to the functor. Must only be called from the consumer thread.
+     * @param functor called for each popped element
+     * @return number of consumed elements
+     */
+    template <typename Functor>
+    size_t
+    consumeAll( const Functor &functor )
+    {
+        size_t consumed = 0;
+        while ( pop( mConsumedElement ) )
+        {
+            functor( mConsumedElement );
+            consumed++;
+        }
+        // Drop the content of the last element right away but keep its storage for the next call
+        recycleQueueElement( mConsumedElement );
+        return consumed;
+    }
+
+    // coverity[misra_cpp_2008_rule_14_7_1_violation] Required in unit tests
+    bool
+    isEmpty() const
+    {
+        return mReadPosition.load( std::memory_order_acquire ) == mWritePosition.load( std::memory_order_acquire );
+    }
+
+private:
+    size_t mMaxSize;
+    std::unique_ptr<T[]> mSlots;
+    uint8_t mPaddingBeforeWrite[LOCK_FREE_QUEUE_CACHE_LINE_SIZE]{};
+    // Written by the producer only
+    std::atomic<size_t> mWritePosition{ 0 };
+    size_t mCachedReadPosition{ 0 };
+    uint8_t mPaddingBeforeRead[LOCK_FREE_QUEUE_CACHE_LINE_SIZE]{};
+    // Written by the consumer only
+    std::atomic<size_t> mReadPosition{ 0 };
+    size_t mCachedWritePosition{ 0 };
+    T mConsumedElement{};
+};
+
+} // namespace IoTFleetWise
+} // namespace Aws
@@ -0,0 +1,328 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "PayloadCompression.h"
+#include "LoggingModule.h"
+#include <snappy.h>
+#include <utility>
+
+#ifdef FWE_FEATURE_LZ4_COMPRESSION
+#include <algorithm>
+#include <lz4frame.h>
+#endif
+#ifdef FWE_FEATURE_ZSTD_COMPRESSION
+#include <zstd.h>
+#endif
+
+namespace Aws
+{
+namespace IoTFleetWise
+{
+namespace
+{
+
+#ifdef FWE_FEATURE_LZ4_COMPRESSION
+constexpr size_t MIN_LZ4_DECOMPRESSION_CHUNK_SIZE = 64 * 1024;
+#endif
+
+class SnappyCompressor : public IPayloadCompressor
+{
+public:
+    bool
+    compress( const char *data, size_t size, std::string &output ) override
+    {
+        return snappy::Compress( data, size, &output ) != 0U;
+    }
+
+    bool
+    decompress( const char *data, size_t size, std::string &output ) override
+    {
+        return snappy::Uncompress( data, size, &output );
+    }
+};
+
+#ifdef FWE_FEATURE_LZ4_COMPRESSION
+class Lz4Compressor : public IPayloadCompressor
+{
+public:
+    Lz4Compressor( int32_t level )
+    {
+        mPreferences.compressionLevel = level;
+    }
+
+    ~Lz4Compressor() override
+    {
+        if ( mDecompressionContext != nullptr )
+        {
+            static_cast<void>( LZ4F_freeDecompressionContext( mDecompressionContext ) );
+        }
+    }
+
+    Lz4Compressor( const Lz4Compressor & ) = delete;
+    Lz4Compressor &operator=( const Lz4Compressor & ) = delete;
+    Lz4Compressor( Lz4Compressor && ) = delete;
+    Lz4Compressor &operator=( Lz4Compressor && ) = delete;
+
+    bool
+    compress( const char *data, size_t size, std::string &output ) override
+    {
+        output.resize( LZ4F_compressFrameBound( size, &mPreferences ) );
+        auto result = LZ4F_compressFrame( &output[0], output.size(), data, size, &mPreferences );
+        if ( LZ4F_isError( result ) != 0U )
+        {
+            FWE_LOG_ERROR( std::string( "LZ4 compression failed: " ) + LZ4F_getErrorName( result ) );
+            return false;
+        }
+        output.resize( result );
+        return true;
+    }
+
+    bool
+    decompress( const char *data, size_t size, std::string &output ) override
+    {
+        if ( ( mDecompressionContext == nullptr ) &&
+             ( LZ4F_isError( LZ4F_createDecompressionContext( &mDecompressionContext, LZ4F_VERSION ) ) != 0U ) )
+        {
+            mDecompressionContext = nullptr;
+            return false;
+        }
+        // The frame does not contain the uncompressed size, so the output grows while decompressing
+        size_t chunkSize = std::max( size * 4, MIN_LZ4_DECOMPRESSION_CHUNK_SIZE );
+        size_t consumed = 0;
+        output.clear();
+        while ( true )
+        {
+            auto previousSize = output.size();
+            output.resize( previousSize + chunkSize );
+            size_t decompressedSize = chunkSize;
+            size_t consumedSize = size - consumed;
+            auto result = LZ4F_decompress( mDecompressionContext,
+                                           &output[previousSize],
+                                           &decompressedSize,
+                                           data + consumed,
+                                           &consumedSize,
+                                           nullptr );
+            output.resize( previousSize + decompressedSize );
+            consumed += consumedSize;
+            if ( ( LZ4F_isError( result ) != 0U ) || ( ( consumedSize == 0 ) && ( decompressedSize == 0 ) ) )
+            {
+                // Corrupted or truncated frame
+                LZ4F_resetDecompressionContext( mDecompressionContext );
+                return false;
+            }
+            if ( result == 0 )
+            {
+                return consumed == size;
+            }
+        }
+    }
+
+private:
+    LZ4F_preferences_t mPreferences{};
+    LZ4F_dctx *mDecompressionContext{ nullptr };
+};
+#endif
+
+#ifdef FWE_FEATURE_ZSTD_COMPRESSION
+class ZstdCompressor : public IPayloadCompressor
+{
+public:
+    ZstdCompressor( int32_t level, std::shared_ptr<const std::string> dictionary )
+        : mLevel( level )
+        , mDictionary( std::move( dictionary ) )
+    {
+    }
+
+    /**
+     * @brief Creates the compression context and loads the dictionary, which is the expensive part
+     * @return false if this failed
+     */
+    bool
+    init()
+    {
+        mCompressionContext.reset( ZSTD_createCCtx() );
+        if ( mCompressionContext == nullptr )
+        {
+            return false;
+        }
+        if ( hasDictionary() )
+        {
+            mCompressionDictionary.reset( ZSTD_createCDict( mDictionary->data(), mDictionary->size(), mLevel ) );
+            if ( mCompressionDictionary == nullptr )
+            {
+                FWE_LOG_ERROR( "Could not load the zstd dictionary of size " + std::to_string( mDictionary->size() ) );
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool
+    compress( const char *data, size_t size, std::string &output ) override
+    {
+        output.resize( ZSTD_compressBound( size ) );
+        auto result =
+            hasDictionary()
+                ? ZSTD_compress_usingCDict(
+                      mCompressionContext.get(), &output[0], output.size(), data, size, mCompressionDictionary.get() )
+                : ZSTD_compressCCtx( mCompressionContext.get(), &output[0], output.size(), data, size, mLevel );
+        if ( ZSTD_isError( result ) != 0U )
+        {
+            FWE_LOG_ERROR( std::string( "zstd compression failed: " ) + ZSTD_getErrorName( result ) );
+            return false;
+        }
+        output.resize( result );
+        return true;
+    }
+
+    bool
+    decompress( const char *data, size_t size, std::string &output ) override
+    {
+        // Only needed by tests and benchmarks, so the decompression state is created on first use
+        if ( mDecompressionContext == nullptr )
+        {
+            mDecompressionContext.reset( ZSTD_createDCtx() );
+            if ( mDecompressionContext == nullptr )
+            {
+                return false;
+            }
+        }
+        if ( hasDictionary() && ( mDecompressionDictionary == nullptr ) )
+        {
+            mDecompressionDictionary.reset( ZSTD_createDDict( mDictionary->data(), mDictionary->size() ) );
+            if ( mDecompressionDictionary == nullptr )
+            {
+                return false;
+            }
+        }
+        auto decompressedSize = ZSTD_getFrameContentSize( data, size );
+        if ( ( decompressedSize == ZSTD_CONTENTSIZE_UNKNOWN ) || ( decompressedSize == ZSTD_CONTENTSIZE_ERROR ) )
+        {
+            return false;
+        }
+        output.resize( static_cast<size_t>( decompressedSize ) );
+        auto result = hasDictionary() ? ZSTD_decompress_usingDDict( mDecompressionContext.get(),
+                                                                    &output[0],
+                                                                    output.size(),
+                                                                    data,
+                                                                    size,
+                                                                    mDecompressionDictionary.get() )
+                                      : ZSTD_decompressDCtx(
+                                            mDecompressionContext.get(), &output[0], output.size(), data, size );
+        return ( ZSTD_isError( result ) == 0U ) && ( result == output.size() );
+    }
+
+private:
+    struct Deleter
+    {
+        void
+        operator()( ZSTD_CCtx *context ) const
+        {
+            static_cast<void>( ZSTD_freeCCtx( context ) );
+        }
+        void
+        operator()( ZSTD_DCtx *context ) const
+        {
+            static_cast<void>( ZSTD_freeDCtx( context ) );
+        }
+        void
+        operator()( ZSTD_CDict *dictionary ) const
+        {
+            static_cast<void>( ZSTD_freeCDict( dictionary ) );
+        }
+        void
+        operator()( ZSTD_DDict *dictionary ) const
+        {
+            static_cast<void>( ZSTD_freeDDict( dictionary ) );
+        }
+    };
+
+    bool
+    hasDictionary() const
+    {
+        return ( mDictionary != nullptr ) && ( !mDictionary->empty() );
+    }
+
+    int32_t mLevel;
+    std::shared_ptr<const std::string> mDictionary;
+    std::unique_ptr<ZSTD_CCtx, Deleter> mCompressionContext;
+    std::unique_ptr<ZSTD_CDict, Deleter> mCompressionDictionary; /**< the dictionary digested for mLevel */
+    std::unique_ptr<ZSTD_DCtx, Deleter> mDecompressionContext;
+    std::unique_ptr<ZSTD_DDict, Deleter> mDecompressionDictionary;
+};
+#endif
+
+} // namespace
+
+bool
+isCompressionCodecSupported( CompressionCodec codec )
+{
+    switch ( codec )
+    {
+    case CompressionCodec::SNAPPY:
+        return true;
+    case CompressionCodec::LZ4:
+#ifdef FWE_FEATURE_LZ4_COMPRESSION
+        return true;
+#else
+        return false;
+#endif
+    case CompressionCodec::ZSTD:
+#ifdef FWE_FEATURE_ZSTD_COMPRESSION
+        return true;
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+std::unique_ptr<IPayloadCompressor>
+createPayloadCompressor( const CompressionOptions &options )
+{
+    if ( !isCompressionCodecSupported( options.codec ) )
+    {
+        FWE_LOG_ERROR( std::string( "The agent was built without support for the compression codec " ) +
+                       compressionCodecToString( options.codec ) );
+        return nullptr;
+    }
+    switch ( options.codec )
+    {
+    case CompressionCodec::SNAPPY:
+        return std::make_unique<SnappyCompressor>();
+#ifdef FWE_FEATURE_LZ4_COMPRESSION
+    case CompressionCodec::LZ4:
+        return std::make_unique<Lz4Compressor>( options.level );
+#endif
+#ifdef FWE_FEATURE_ZSTD_COMPRESSION
+    case CompressionCodec::ZSTD: {
+        auto compressor = std::make_unique<ZstdCompressor>( options.level, options.dictionary );
+        if ( !compressor->init() )
+        {
+            return nullptr;
+        }
+        return compressor;
+    }
+#endif
+    default:
+        return nullptr;
+    }
+}
+
+const char *
+compressionCodecToString( CompressionCodec codec )
+{
+    switch ( codec )
+    {
+    case CompressionCodec::SNAPPY:
+        return "snappy";
+    case CompressionCodec::LZ4:
+        return "lz4";
+    case CompressionCodec::ZSTD:
+        return "zstd";
+    }
+    return "unknown";
+}
+
+} // namespace IoTFleetWise
+} // namespace Aws
@@ -0,0 +1,96 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace Aws
+{
+namespace IoTFleetWise
+{
+
+/**
+ * @brief Codecs used to compress the payloads sent to the cloud
+ *
+ * Snappy is always available. LZ4 and zstd are only available if the agent was built with
+ * FWE_FEATURE_LZ4_COMPRESSION or FWE_FEATURE_ZSTD_COMPRESSION.
+ */
+enum class CompressionCodec
+{
+    SNAPPY,
+    LZ4, /**< LZ4 frame format, so that the receiver does not need to know the uncompressed size */
+    ZSTD
+};
+
+/**
+ * @brief How the payloads of a collection scheme are compressed
+ */
+struct CompressionOptions
+{
+    CompressionCodec codec{ CompressionCodec::SNAPPY };
+    int32_t level{ 0 }; /**< zero selects the default level of the codec, ignored by snappy */
+    /** Only used by zstd. Shared between all payloads of a collection scheme, as dictionaries have up to some
+     *  hundred KiB. */
+    std::shared_ptr<const std::string> dictionary;
+
+    /**
+     * @brief Dictionaries are compared by their address, as the content is only loaded once per collection scheme
+     */
+    bool
+    operator==( const CompressionOptions &other ) const
+    {
+        return ( codec == other.codec ) && ( level == other.level ) && ( dictionary == other.dictionary );
+    }
+
+    bool
+    operator!=( const CompressionOptions &other ) const
+    {
+        return !( *this == other );
+    }
+};
+
+/**
+ * @brief Compresses and decompresses payloads with one codec and its options
+ *
+ * An instance keeps the state of the codec like contexts and loaded dictionaries, so it should be reused for all
+ * payloads with the same options. An instance must not be used by several threads at the same time.
+ */
+class IPayloadCompressor
+{
+public:
+    virtual ~IPayloadCompressor() = default;
+
+    /**
+     * @brief Compresses the data
+     * @param output replaced by the compressed data. Its capacity is reused.
+     * @return false if the data could not be compressed
+     */
+    virtual bool compress( const char *data, size_t size, std::string &output ) = 0;
+
+    /**
+     * @brief Decompresses data compressed with the same options
+     * @param output replaced by the decompressed data
+     * @return false if the data is corrupted or was compressed with other options
+     */
+    virtual bool decompress( const char *data, size_t size, std::string &output ) = 0;
+};
+
+/**
+ * @brief Checks whether the agent was built with the given codec
+ */
+bool isCompressionCodecSupported( CompressionCodec codec );
+
+/**
+ * @brief Creates a compressor for the given options
+ * @return nullptr if the codec is not supported or the dictionary can not be loaded
+ */
+std::unique_ptr<IPayloadCompressor> createPayloadCompressor( const CompressionOptions &options );
+
+const char *compressionCodecToString( CompressionCodec codec );
+
+} // namespace IoTFleetWise
+} // namespace Aws
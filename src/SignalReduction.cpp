@@ -0,0 +1,209 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "SignalReduction.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Aws
+{
+namespace IoTFleetWise
+{
+namespace
+{
+
+void
+keepAll( uint32_t count, std::vector<uint32_t> &keptIndices )
+{
+    for ( uint32_t i = 0; i < count; i++ )
+    {
+        keptIndices.push_back( i );
+    }
+}
+
+void
+reduceDeadband( double tolerance, const std::vector<double> &values, std::vector<uint32_t> &keptIndices )
+{
+    auto count = static_cast<uint32_t>( values.size() );
+    uint32_t lastKept = 0;
+    keptIndices.push_back( 0 );
+    for ( uint32_t i = 1; i < count; i++ )
+    {
+        if ( ( std::abs( values[i] - values[lastKept] ) > tolerance ) || ( i == ( count - 1 ) ) )
+        {
+            keptIndices.push_back( i );
+            lastKept = i;
+        }
+    }
+}
+
+/**
+ * Each kept sample is the pivot of a door. The slopes of all lines from the pivot that pass within the tolerance of
+ * every sample seen since then form an interval. As long as the line to the next sample lies within this interval,
+ * all samples in between can be dropped. Otherwise the previous sample is kept and becomes the new pivot.
+ *
+ * A sample that is older than the pivot, which happens with non-monotonic timestamps, has no line from the pivot. It
+ * is kept together with the sample before it and becomes the new pivot.
+ */
+void
+reduceSwingingDoor( double tolerance,
+                    const std::vector<Timestamp> &timestamps,
+                    const std::vector<double> &values,
+                    std::vector<uint32_t> &keptIndices )
+{
+    auto count = static_cast<uint32_t>( values.size() );
+    uint32_t pivot = 0;
+    double lowerSlope = -std::numeric_limits<double>::infinity();
+    double upperSlope = std::numeric_limits<double>::infinity();
+    auto startSegment = [&]( uint32_t index ) {
+        keptIndices.push_back( index );
+        pivot = index;
+        lowerSlope = -std::numeric_limits<double>::infinity();
+        upperSlope = std::numeric_limits<double>::infinity();
+    };
+    // Only called for samples after the pivot, so the unsigned difference does not wrap
+    auto slopeFromPivot = [&]( uint32_t index, double offset ) -> double {
+        return ( values[index] + offset - values[pivot] ) /
+               static_cast<double>( timestamps[index] - timestamps[pivot] );
+    };
+    keptIndices.push_back( 0 );
+    for ( uint32_t i = 1; i < count; i++ )
+    {
+        if ( timestamps[i] > timestamps[pivot] )
+        {
+            double slope = slopeFromPivot( i, 0.0 );
+            if ( ( slope >= lowerSlope ) && ( slope <= upperSlope ) )
+            {
+                lowerSlope = std::max( lowerSlope, slopeFromPivot( i, -tolerance ) );
+                upperSlope = std::min( upperSlope, slopeFromPivot( i, tolerance ) );
+                continue;
+            }
+            // Since the previous sample passed the check it is not the pivot, so it can become the new one
+            startSegment( i - 1 );
+        }
+        if ( timestamps[i] > timestamps[pivot] )
+        {
+            lowerSlope = slopeFromPivot( i, -tolerance );
+            upperSlope = slopeFromPivot( i, tolerance );
+        }
+        // For the same timestamp as the pivot there is no slope to check, the line is at the value of the pivot
+        else if ( ( timestamps[i] < timestamps[pivot] ) || ( std::abs( values[i] - values[pivot] ) > tolerance ) )
+        {
+            // The dropped samples are only within the tolerance of lines in the door, so the segment ends at the
+            // previous sample. Not needed if that has the timestamp of the pivot, as then it is the pivot or a sample
+            // with a value within the tolerance of it.
+            if ( timestamps[i - 1] != timestamps[pivot] )
+            {
+                startSegment( i - 1 );
+            }
+            startSegment( i );
+        }
+    }
+    if ( keptIndices.back() != ( count - 1 ) )
+    {
+        keptIndices.push_back( count - 1 );
+    }
+}
+
+/**
+ * Splits the samples between the first and the last one into buckets and keeps the sample of each bucket that forms
+ * the largest triangle with the sample kept from the previous bucket and the average of the next bucket.
+ */
+void
+reduceLargestTriangleThreeBuckets( uint32_t maxSamples,
+                                   const std::vector<Timestamp> &timestamps,
+                                   const std::vector<double> &values,
+                                   std::vector<uint32_t> &keptIndices )
+{
+    auto count = static_cast<uint32_t>( values.size() );
+    uint32_t buckets = maxSamples - 2;
+    // The first index of a bucket. Integer arithmetic makes sure that the last bucket ends at the last sample.
+    auto bucketStart = [count, buckets]( uint32_t bucket ) -> uint32_t {
+        if ( bucket > buckets )
+        {
+            return count;
+        }
+        return 1 + static_cast<uint32_t>( ( static_cast<uint64_t>( bucket ) * ( count - 2 ) ) / buckets );
+    };
+    // Relative times keep the precision of the areas. Signed, as non-monotonic timestamps can be before the first one.
+    auto time = [&timestamps]( uint32_t i ) -> double {
+        return static_cast<double>( static_cast<int64_t>( timestamps[i] - timestamps[0] ) );
+    };
+    uint32_t previous = 0;
+    keptIndices.push_back( 0 );
+    for ( uint32_t bucket = 0; bucket < buckets; bucket++ )
+    {
+        uint32_t nextStart = bucketStart( bucket + 1 );
+        uint32_t nextEnd = bucketStart( bucket + 2 );
+        double averageTime = 0.0;
+        double averageValue = 0.0;
+        for ( uint32_t i = nextStart; i < nextEnd; i++ )
+        {
+            averageTime += time( i );
+            averageValue += values[i];
+        }
+        averageTime /= static_cast<double>( nextEnd - nextStart );
+        averageValue /= static_cast<double>( nextEnd - nextStart );
+
+        double maxArea = -1.0;
+        uint32_t selected = bucketStart( bucket );
+        for ( uint32_t i = bucketStart( bucket ); i < nextStart; i++ )
+        {
+            // Twice the area, which does not change the result
+            double area = std::abs( ( ( time( previous ) - averageTime ) * ( values[i] - values[previous] ) ) -
+                                    ( ( time( previous ) - time( i ) ) * ( averageValue - values[previous] ) ) );
+            if ( area > maxArea )
+            {
+                maxArea = area;
+                selected = i;
+            }
+        }
+        keptIndices.push_back( selected );
+        previous = selected;
+    }
+    keptIndices.push_back( count - 1 );
+}
+
+} // namespace
+
+void
+reduceSignalSamples( const SignalReduction &reduction,
+                     const std::vector<Timestamp> &timestamps,
+                     const std::vector<double> &values,
+                     std::vector<uint32_t> &keptIndices )
+{
+    keptIndices.clear();
+    auto count = static_cast<uint32_t>( values.size() );
+    if ( count <= 2 )
+    {
+        keepAll( count, keptIndices );
+        return;
+    }
+    double tolerance = std::max( reduction.tolerance, 0.0 );
+    switch ( reduction.type )
+    {
+    case SignalReductionType::DEADBAND:
+        reduceDeadband( tolerance, values, keptIndices );
+        break;
+    case SignalReductionType::SWINGING_DOOR:
+        reduceSwingingDoor( tolerance, timestamps, values, keptIndices );
+        break;
+    case SignalReductionType::LARGEST_TRIANGLE_THREE_BUCKETS:
+        if ( ( reduction.maxSamples < 3 ) || ( reduction.maxSamples >= count ) )
+        {
+            keepAll( count, keptIndices );
+        }
+        else
+        {
+            reduceLargestTriangleThreeBuckets( reduction.maxSamples, timestamps, values, keptIndices );
+        }
+        break;
+    default:
+        keepAll( count, keptIndices );
+        break;
+    }
+}
+
+} // namespace IoTFleetWise
+} // namespace Aws
@@ -0,0 +1,60 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "TimeTypes.h"
+#include <cstdint>
+#include <vector>
+
+namespace Aws
+{
+namespace IoTFleetWise
+{
+
+/**
+ * @brief How the samples of a signal are reduced when they are collected, to reduce the size of the uploaded data
+ */
+enum class SignalReductionType
+{
+    NONE,
+    /**
+     * Drops samples that differ by at most the tolerance from the last kept sample
+     */
+    DEADBAND,
+    /**
+     * Piecewise linear approximation with the swinging door algorithm: drops samples that are at most the tolerance
+     * away from the straight line between the kept samples before and after them
+     */
+    SWINGING_DOOR,
+    /**
+     * Largest-Triangle-Three-Buckets downsampling to a maximum number of samples, which keeps the visual shape
+     */
+    LARGEST_TRIANGLE_THREE_BUCKETS
+};
+
+struct SignalReduction
+{
+    SignalReductionType type{ SignalReductionType::NONE };
+    double tolerance{ 0.0 };  /**< maximum deviation of a dropped sample for deadband and swinging door */
+    uint32_t maxSamples{ 0 }; /**< samples to keep with Largest-Triangle-Three-Buckets, less than 3 keeps all */
+};
+
+/**
+ * @brief Selects the samples of a series to keep
+ *
+ * The first and the last sample are always kept.
+ *
+ * @param reduction the reduction to apply
+ * @param timestamps timestamps of the samples in the order they were received, normally from the oldest to the newest.
+ * Swinging door keeps the samples with a timestamp before the last kept sample.
+ * @param values values of the samples in the same order, as many as timestamps
+ * @param keptIndices cleared and then filled with the ascending indices of the samples to keep
+ */
+void reduceSignalSamples( const SignalReduction &reduction,
+                          const std::vector<Timestamp> &timestamps,
+                          const std::vector<double> &values,
+                          std::vector<uint32_t> &keptIndices );
+
+} // namespace IoTFleetWise
+} // namespace Aws
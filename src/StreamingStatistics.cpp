@@ -0,0 +1,307 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "StreamingStatistics.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Aws
+{
+namespace IoTFleetWise
+{
+
+constexpr size_t QuantileEstimator::EXACT_VALUES;          // NOLINT
+constexpr size_t QuantileEstimator::NUMBER_OF_MARKERS;     // NOLINT
+constexpr size_t SlidingWindowStatistics::BYTES_PER_VALUE; // NOLINT
+
+QuantileEstimator::QuantileEstimator( double quantile )
+    : mQuantile( std::min( std::max( quantile, 0.0 ), 1.0 ) )
+{
+}
+
+void
+QuantileEstimator::reset()
+{
+    mCount = 0;
+}
+
+void
+QuantileEstimator::initMarkers()
+{
+    std::sort( mExactValues.begin(), mExactValues.end() );
+    auto last = static_cast<double>( EXACT_VALUES - 1 );
+    mIncrements = { 0, mQuantile / 2, mQuantile, ( 1 + mQuantile ) / 2, 1 };
+    for ( size_t i = 0; i < NUMBER_OF_MARKERS; i++ )
+    {
+        mDesiredPositions[i] = last * mIncrements[i];
+        mPositions[i] = static_cast<int64_t>( std::round( mDesiredPositions[i] ) );
+    }
+    // The markers need distinct positions, which extreme quantiles would not get by rounding
+    for ( size_t i = NUMBER_OF_MARKERS - 1; i > 0; i-- )
+    {
+        mPositions[i - 1] = std::min( mPositions[i - 1], mPositions[i] - 1 );
+    }
+    for ( size_t i = 1; i < NUMBER_OF_MARKERS; i++ )
+    {
+        mPositions[i] = std::max( mPositions[i], mPositions[i - 1] + 1 );
+    }
+    for ( size_t i = 0; i < NUMBER_OF_MARKERS; i++ )
+    {
+        mHeights[i] = mExactValues[static_cast<size_t>( mPositions[i] )];
+    }
+}
+
+void
+QuantileEstimator::addValue( double value )
+{
+    if ( mCount < EXACT_VALUES )
+    {
+        mExactValues[mCount] = value;
+        mCount++;
+        return;
+    }
+    if ( mCount == EXACT_VALUES )
+    {
+        initMarkers();
+    }
+    mCount++;
+    // Find the cell of the new value and extend the extreme markers if needed
+    size_t cell = 0;
+    if ( value < mHeights[0] )
+    {
+        mHeights[0] = value;
+    }
+    else if ( value >= mHeights[NUMBER_OF_MARKERS - 1] )
+    {
+        mHeights[NUMBER_OF_MARKERS - 1] = value;
+        cell = NUMBER_OF_MARKERS - 2;
+    }
+    else
+    {
+        while ( value >= mHeights[cell + 1] )
+        {
+            cell++;
+        }
+    }
+    for ( size_t i = cell + 1; i < NUMBER_OF_MARKERS; i++ )
+    {
+        mPositions[i]++;
+    }
+    for ( size_t i = 0; i < NUMBER_OF_MARKERS; i++ )
+    {
+        mDesiredPositions[i] += mIncrements[i];
+    }
+    // Move the middle markers towards their desired positions
+    for ( size_t i = 1; i < NUMBER_OF_MARKERS - 1; i++ )
+    {
+        double d = mDesiredPositions[i] - static_cast<double>( mPositions[i] );
+        if ( ( ( d >= 1.0 ) && ( ( mPositions[i + 1] - mPositions[i] ) > 1 ) ) ||
+             ( ( d <= -1.0 ) && ( ( mPositions[i - 1] - mPositions[i] ) < -1 ) ) )
+        {
+            int direction = ( d >= 0.0 ) ? 1 : -1;
+            double height = parabolic( i, static_cast<double>( direction ) );
+            if ( ( mHeights[i - 1] < height ) && ( height < mHeights[i + 1] ) )
+            {
+                mHeights[i] = height;
+            }
+            else
+            {
+                mHeights[i] = linear( i, direction );
+            }
+            mPositions[i] += direction;
+        }
+    }
+}
+
+double
+QuantileEstimator::parabolic( size_t i, double d ) const
+{
+    auto previous = static_cast<double>( mPositions[i - 1] );
+    auto current = static_cast<double>( mPositions[i] );
+    auto next = static_cast<double>( mPositions[i + 1] );
+    double rightSlope = ( mHeights[i + 1] - mHeights[i] ) / ( next - current );
+    double leftSlope = ( mHeights[i] - mHeights[i - 1] ) / ( current - previous );
+    return mHeights[i] + ( ( d / ( next - previous ) ) * ( ( ( ( current - previous ) + d ) * rightSlope ) +
+                                                           ( ( ( next - current ) - d ) * leftSlope ) ) );
+}
+
+double
+QuantileEstimator::linear( size_t i, int d ) const
+{
+    auto neighbor = ( d > 0 ) ? ( i + 1 ) : ( i - 1 );
+    return mHeights[i] + ( static_cast<double>( d ) * ( mHeights[neighbor] - mHeights[i] ) /
+                           static_cast<double>( mPositions[neighbor] - mPositions[i] ) );
+}
+
+bool
+QuantileEstimator::getValue( double &value ) const
+{
+    if ( mCount == 0 )
+    {
+        return false;
+    }
+    if ( mCount > EXACT_VALUES )
+    {
+        value = mHeights[2];
+        return true;
+    }
+    // Interpolate between the two closest ranks
+    std::array<double, EXACT_VALUES> sorted = mExactValues;
+    std::sort( sorted.begin(), sorted.begin() + mCount );
+    double rank = mQuantile * static_cast<double>( mCount - 1 );
+    auto lower = static_cast<size_t>( rank );
+    auto upper = std::min( lower + 1, static_cast<size_t>( mCount - 1 ) );
+    value = sorted[lower] + ( ( rank - static_cast<double>( lower ) ) * ( sorted[upper] - sorted[lower] ) );
+    return true;
+}
+
+void
+SlidingWindowStatistics::init( uint32_t capacity, Timestamp periodMs )
+{
+    mPeriodMs = periodMs;
+    mValues.assign( capacity, 0.0 );
+    mTimestamps.assign( capacity, 0 );
+    mMinQueue.mSequences.assign( capacity, 0 );
+    mMaxQueue.mSequences.assign( capacity, 0 );
+    mMinQueue.mHead = mMinQueue.mTail = 0;
+    mMaxQueue.mHead = mMaxQueue.mTail = 0;
+    mFirstSequence = 0;
+    mNextSequence = 0;
+    mSum = 0;
+    mMean = 0;
+    mSquaredDistance = 0;
+}
+
+template <typename Compare>
+void
+SlidingWindowStatistics::pushToQueue( MonotonicQueue &queue, uint64_t sequence, Compare isBetterOrEqual )
+{
+    auto capacity = mValues.size();
+    double value = mValues[sequence % capacity];
+    // A value that is older and not better than the new one can never be the result again
+    while ( ( queue.mTail > queue.mHead ) &&
+            isBetterOrEqual( value, mValues[queue.mSequences[( queue.mTail - 1 ) % capacity] % capacity] ) )
+    {
+        queue.mTail--;
+    }
+    queue.mSequences[queue.mTail % capacity] = sequence;
+    queue.mTail++;
+}
+
+void
+SlidingWindowStatistics::addValue( double value, Timestamp timestamp )
+{
+    auto capacity = mValues.size();
+    if ( capacity == 0 )
+    {
+        return;
+    }
+    if ( getCount() >= capacity )
+    {
+        removeOldestValue();
+    }
+    auto index = mNextSequence % capacity;
+    mValues[index] = value;
+    mTimestamps[index] = timestamp;
+    mSum += value;
+    double delta = value - mMean;
+    mMean += delta / static_cast<double>( getCount() + 1 );
+    mSquaredDistance += delta * ( value - mMean );
+    pushToQueue( mMinQueue, mNextSequence, []( double newValue, double oldValue ) {
+        return newValue <= oldValue;
+    } );
+    pushToQueue( mMaxQueue, mNextSequence, []( double newValue, double oldValue ) {
+        return newValue >= oldValue;
+    } );
+    mNextSequence++;
+}
+
+void
+SlidingWindowStatistics::removeOldestValue()
+{
+    auto capacity = mValues.size();
+    double value = mValues[mFirstSequence % capacity];
+    mSum -= value;
+    auto remaining = getCount() - 1;
+    if ( remaining > 0 )
+    {
+        // Inverse of the update in addValue
+        double delta = value - mMean;
+        mMean -= delta / static_cast<double>( remaining );
+        mSquaredDistance -= delta * ( value - mMean );
+    }
+    for ( auto *queue : { &mMinQueue, &mMaxQueue } )
+    {
+        if ( ( queue->mTail > queue->mHead ) && ( queue->mSequences[queue->mHead % capacity] == mFirstSequence ) )
+        {
+            queue->mHead++;
+        }
+    }
+    mFirstSequence++;
+    if ( mFirstSequence == mNextSequence )
+    {
+        // Do not carry rounding errors over to the next values
+        mSum = 0;
+        mMean = 0;
+        mSquaredDistance = 0;
+    }
+}
+
+bool
+SlidingWindowStatistics::removeOldValues( Timestamp timestamp )
+{
+    bool removed = false;
+    while ( ( getCount() > 0 ) && ( ( mTimestamps[mFirstSequence % mValues.size()] + mPeriodMs ) <= timestamp ) )
+    {
+        removeOldestValue();
+        removed = true;
+    }
+    return removed;
+}
+
+Timestamp
+SlidingWindowStatistics::getNextRemovalTime() const
+{
+    if ( getCount() == 0 )
+    {
+        return 0;
+    }
+    return mTimestamps[mFirstSequence % mValues.size()] + mPeriodMs;
+}
+
+double
+SlidingWindowStatistics::getMin() const
+{
+    if ( mMinQueue.mTail == mMinQueue.mHead )
+    {
+        return 0;
+    }
+    auto capacity = mValues.size();
+    return mValues[mMinQueue.mSequences[mMinQueue.mHead % capacity] % capacity];
+}
+
+double
+SlidingWindowStatistics::getMax() const
+{
+    if ( mMaxQueue.mTail == mMaxQueue.mHead )
+    {
+        return 0;
+    }
+    auto capacity = mValues.size();
+    return mValues[mMaxQueue.mSequences[mMaxQueue.mHead % capacity] % capacity];
+}
+
+double
+SlidingWindowStatistics::getStandardDeviation() const
+{
+    auto count = getCount();
+    if ( count == 0 )
+    {
+        return 0;
+    }
+    // Removing values can leave a tiny negative rounding error for equal values
+    return std::sqrt( std::max( mSquaredDistance / count, 0.0 ) );
+}
+
+} // namespace IoTFleetWise
+} // namespace Aws
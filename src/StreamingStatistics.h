@@ -0,0 +1,150 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "TimeTypes.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Aws
+{
+namespace IoTFleetWise
+{
+
+/**
+ * @brief Estimates one quantile of a stream of values in constant memory and constant time per value
+ *
+ * Implements the P-square algorithm (Jain and Chlamtac, 1985): five markers track the minimum, the maximum, the
+ * quantile itself and two quantiles half way in between. Their heights are adjusted with a piecewise parabolic
+ * interpolation with every new value. P-square converges slowly for few values and extreme quantiles, so the first
+ * EXACT_VALUES values are kept and give the exact quantile. The markers then start from these values.
+ */
+class QuantileEstimator
+{
+public:
+    /**
+     * @param quantile the quantile to estimate, between 0 and 1, e.g. 0.95 for the 95th percentile
+     */
+    QuantileEstimator( double quantile = 0.5 );
+
+    void addValue( double value );
+
+    /**
+     * @brief Gets the current estimation of the quantile
+     * @return false if no value was added since the last reset
+     */
+    bool getValue( double &value ) const;
+
+    void reset();
+
+    static constexpr size_t EXACT_VALUES = 32;
+
+private:
+    static constexpr size_t NUMBER_OF_MARKERS = 5;
+
+    void initMarkers();
+    double parabolic( size_t i, double d ) const;
+    double linear( size_t i, int d ) const;
+
+    double mQuantile;
+    uint32_t mCount{ 0 };
+    std::array<double, EXACT_VALUES> mExactValues{};
+    std::array<double, NUMBER_OF_MARKERS> mHeights{};          /**< marker heights */
+    std::array<int64_t, NUMBER_OF_MARKERS> mPositions{};       /**< actual marker positions */
+    std::array<double, NUMBER_OF_MARKERS> mDesiredPositions{}; /**< where the markers should be */
+    std::array<double, NUMBER_OF_MARKERS> mIncrements{};       /**< change of the desired positions per value */
+};
+
+/**
+ * @brief Statistics over the values of the last period of time, updated incrementally
+ *
+ * Keeps the values of the window in a ring of a fixed capacity. If more values arrive within one period, the oldest
+ * ones are dropped, like in a signal history buffer of the same size. Count and sum are maintained as running sums,
+ * the standard deviation with Welford's algorithm, which is reversed exactly when a value is removed. So it stays
+ * accurate also for values with a large offset, e.g. an odometer. Minimum and maximum are maintained with monotonic
+ * queues. Adding and removing a value is amortized O(1) and does not allocate memory.
+ */
+class SlidingWindowStatistics
+{
+public:
+    static constexpr size_t BYTES_PER_VALUE = sizeof( double ) + sizeof( Timestamp ) + ( 2 * sizeof( uint64_t ) );
+
+    /**
+     * @brief Allocates the ring and removes all values
+     * @param capacity maximum number of values in the window
+     * @param periodMs values older than this are removed
+     */
+    void init( uint32_t capacity, Timestamp periodMs );
+
+    void addValue( double value, Timestamp timestamp );
+
+    /**
+     * @brief Removes the values that are older than the period
+     * @param timestamp the current time, in the same clock as the timestamps of the values
+     * @return true if at least one value was removed
+     */
+    bool removeOldValues( Timestamp timestamp );
+
+    /**
+     * @return the time at which the oldest value will be removed or 0 if the window is empty
+     */
+    Timestamp getNextRemovalTime() const;
+
+    uint32_t
+    getCount() const
+    {
+        return static_cast<uint32_t>( mNextSequence - mFirstSequence );
+    }
+    double
+    getSum() const
+    {
+        return mSum;
+    }
+    double getMin() const;
+    double getMax() const;
+    double getStandardDeviation() const;
+
+    size_t
+    getCapacity() const
+    {
+        return mValues.size();
+    }
+
+private:
+    void removeOldestValue();
+
+    /**
+     * @brief Ring of the sequence numbers of the values that are candidates for the minimum or maximum
+     *
+     * The values belonging to the sequence numbers are monotonic from front to back, so the front is the result.
+     */
+    struct MonotonicQueue
+    {
+        std::vector<uint64_t> mSequences;
+        uint64_t mHead{ 0 };
+        uint64_t mTail{ 0 };
+    };
+
+    // Removes the entries from the back that the new value makes obsolete and adds it
+    template <typename Compare>
+    void pushToQueue( MonotonicQueue &queue, uint64_t sequence, Compare isBetterOrEqual );
+
+    Timestamp mPeriodMs{ 0 };
+    // Ring of values and their timestamps, the value with sequence number s is at index s % capacity
+    std::vector<double> mValues;
+    std::vector<Timestamp> mTimestamps;
+    uint64_t mFirstSequence{ 0 }; /**< sequence number of the oldest value in the window */
+    uint64_t mNextSequence{ 0 };  /**< sequence number of the next value */
+    double mSum{ 0 };
+    // Welford's algorithm, the mean and the sum of the squared distances from it
+    double mMean{ 0 };
+    double mSquaredDistance{ 0 };
+    MonotonicQueue mMinQueue;
+    MonotonicQueue mMaxQueue;
+};
+
+} // namespace IoTFleetWise
+} // namespace Aws
@@ -157,6 +157,10 @@ TraceModule::getVariableName( TraceVariable variable )
         return "CEProcessedDataFrames";
     case TraceVariable::CE_PROCESSED_DTCS:
         return "CEProcessedDTCs";
+    case TraceVariable::CE_SHARD_BUFFER_FULL:
+        return "CEShardBufferFull";
+    case TraceVariable::MQTT_PAYLOAD_TOO_LARGE:
+        return "MqttPayloadTooLarge";
         // Intentionally omit default so that we can use compiler warnings to remind us about missing values
     }
     return nullptr;
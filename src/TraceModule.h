@@ -72,6 +72,8 @@ enum class TraceVariable
     RAW_DATA_OVERWRITTEN_DATA_WITH_USED_HANDLE,
     RAW_DATA_BUFFER_ELEMENTS_PER_TYPE,
     RAW_DATA_BUFFER_MANAGER_BYTES,
+    CE_SHARD_BUFFER_FULL,
+    MQTT_PAYLOAD_TOO_LARGE,
     // If you add more, remember to add the name to TraceModule::getVariableName
     TRACE_VARIABLE_SIZE
 };
@@ -0,0 +1,187 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "XorDoubleEncoding.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Aws
+{
+namespace IoTFleetWise
+{
+namespace
+{
+
+constexpr uint32_t BITS_PER_VALUE = 64;
+constexpr uint32_t MAX_LEADING_ZEROS = 31;
+
+class BitReader
+{
+public:
+    BitReader( const std::string &data )
+        : mData( data )
+    {
+    }
+
+    bool
+    read( uint32_t numberOfBits, uint64_t &bits )
+    {
+        if ( ( mPosition + numberOfBits ) > ( mData.size() * 8 ) )
+        {
+            return false;
+        }
+        bits = 0;
+        for ( uint32_t i = 0; i < numberOfBits; i++ )
+        {
+            auto byte = static_cast<uint8_t>( mData[mPosition / 8] );
+            bits = ( bits << 1 ) | ( ( byte >> ( 7 - ( mPosition % 8 ) ) ) & 1U );
+            mPosition++;
+        }
+        return true;
+    }
+
+private:
+    const std::string &mData;
+    size_t mPosition{ 0 };
+};
+
+} // namespace
+
+void
+XorDoubleEncoder::reset()
+{
+    mPrevious = 0;
+    mCount = 0;
+    mLeadingZeros = 0;
+    mBlockLength = 0;
+    mFreeBits = 0;
+}
+
+void
+XorDoubleEncoder::writeBits( std::string &output, uint64_t bits, uint32_t numberOfBits )
+{
+    while ( numberOfBits > 0 )
+    {
+        if ( mFreeBits == 0 )
+        {
+            output.push_back( 0 );
+            mFreeBits = 8;
+        }
+        uint32_t chunkSize = std::min( numberOfBits, mFreeBits );
+        auto chunk = static_cast<uint8_t>( ( bits >> ( numberOfBits - chunkSize ) ) & ( ( 1U << chunkSize ) - 1U ) );
+        auto byte = static_cast<uint8_t>( output.back() ) | static_cast<uint8_t>( chunk << ( mFreeBits - chunkSize ) );
+        output.back() = static_cast<char>( byte );
+        mFreeBits -= chunkSize;
+        numberOfBits -= chunkSize;
+    }
+}
+
+void
+XorDoubleEncoder::append( double value, std::string &output )
+{
+    uint64_t bits = 0;
+    std::memcpy( &bits, &value, sizeof( bits ) );
+    if ( mCount == 0 )
+    {
+        writeBits( output, bits, BITS_PER_VALUE );
+    }
+    else
+    {
+        uint64_t xorBits = bits ^ mPrevious;
+        if ( xorBits == 0 )
+        {
+            writeBits( output, 0, 1 );
+        }
+        else
+        {
+            auto leadingZeros = std::min( static_cast<uint32_t>( __builtin_clzll( xorBits ) ), MAX_LEADING_ZEROS );
+            auto trailingZeros = static_cast<uint32_t>( __builtin_ctzll( xorBits ) );
+            if ( ( mBlockLength > 0 ) && ( leadingZeros >= mLeadingZeros ) &&
+                 ( trailingZeros >= ( BITS_PER_VALUE - mLeadingZeros - mBlockLength ) ) )
+            {
+                writeBits( output, 2, 2 );
+                writeBits( output, xorBits >> ( BITS_PER_VALUE - mLeadingZeros - mBlockLength ), mBlockLength );
+            }
+            else
+            {
+                mLeadingZeros = leadingZeros;
+                mBlockLength = BITS_PER_VALUE - leadingZeros - trailingZeros;
+                writeBits( output, 3, 2 );
+                writeBits( output, mLeadingZeros, 5 );
+                // A length of 64 does not fit into 6 bits, but a length of 0 is never needed
+                writeBits( output, mBlockLength % BITS_PER_VALUE, 6 );
+                writeBits( output, xorBits >> trailingZeros, mBlockLength );
+            }
+        }
+    }
+    mPrevious = bits;
+    mCount++;
+}
+
+bool
+decodeXorDoubles( const std::string &data, size_t count, std::vector<double> &values )
+{
+    BitReader reader( data );
+    uint64_t previous = 0;
+    uint32_t leadingZeros = 0;
+    uint32_t blockLength = 0;
+    for ( size_t i = 0; i < count; i++ )
+    {
+        uint64_t bits = 0;
+        if ( i == 0 )
+        {
+            if ( !reader.read( BITS_PER_VALUE, bits ) )
+            {
+                return false;
+            }
+        }
+        else
+        {
+            uint64_t control = 0;
+            if ( !reader.read( 1, control ) )
+            {
+                return false;
+            }
+            if ( control == 0 )
+            {
+                bits = previous;
+            }
+            else
+            {
+                if ( !reader.read( 1, control ) )
+                {
+                    return false;
+                }
+                if ( control == 1 )
+                {
+                    uint64_t header = 0;
+                    if ( !reader.read( 11, header ) )
+                    {
+                        return false;
+                    }
+                    leadingZeros = static_cast<uint32_t>( header >> 6 );
+                    blockLength = static_cast<uint32_t>( header & 0x3FU );
+                    if ( blockLength == 0 )
+                    {
+                        blockLength = BITS_PER_VALUE;
+                    }
+                }
+                uint64_t block = 0;
+                if ( ( blockLength == 0 ) || ( ( leadingZeros + blockLength ) > BITS_PER_VALUE ) ||
+                     ( !reader.read( blockLength, block ) ) )
+                {
+                    return false;
+                }
+                bits = previous ^ ( block << ( BITS_PER_VALUE - leadingZeros - blockLength ) );
+            }
+        }
+        double value = 0;
+        std::memcpy( &value, &bits, sizeof( value ) );
+        values.push_back( value );
+        previous = bits;
+    }
+    return true;
+}
+
+} // namespace IoTFleetWise
+} // namespace Aws
@@ -0,0 +1,56 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Aws
+{
+namespace IoTFleetWise
+{
+
+/**
+ * @brief Compresses a series of doubles by XORing each value with the previous one (Gorilla encoding)
+ *
+ * Slowly changing values share sign, exponent and most significant mantissa bits, so the XOR has many leading and
+ * trailing zero bits that do not need to be stored. The bits are written with the most significant bit first:
+ * - the first value: its 64 bits
+ * - a value equal to the previous one: '0'
+ * - a XOR whose meaningful bits fit in the block of the previous XOR: '10' and the bits of the block
+ * - otherwise: '11', 5 bits of leading zeros, 6 bits of the meaningful length (0 means 64) and the meaningful bits
+ */
+class XorDoubleEncoder
+{
+public:
+    /**
+     * @brief Appends the encoded value to the output, which must only be modified by this encoder since the last reset
+     */
+    void append( double value, std::string &output );
+
+    void reset();
+
+private:
+    void writeBits( std::string &output, uint64_t bits, uint32_t numberOfBits );
+
+    uint64_t mPrevious{ 0 };
+    uint32_t mCount{ 0 };
+    uint32_t mLeadingZeros{ 0 };
+    uint32_t mBlockLength{ 0 }; /**< zero if there is no block yet */
+    uint32_t mFreeBits{ 0 };    /**< unused bits in the last byte of the output */
+};
+
+/**
+ * @brief Decodes values written by XorDoubleEncoder
+ * @param data the encoded bytes
+ * @param count the number of encoded values
+ * @param values the decoded values are appended
+ * @return false if the data ended before all values were decoded
+ */
+bool decodeXorDoubles( const std::string &data, size_t count, std::vector<double> &values );
+
+} // namespace IoTFleetWise
+} // namespace Aws
@@ -0,0 +1,157 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "CANDataConsumer.h"
+#include "CANDecoder.h"
+#include "CollectionInspectionAPITypes.h"
+#include "IDecoderDictionary.h"
+#include "MessageTypes.h"
+#include "SignalTypes.h"
+#include <array>
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <vector>
+
+// Count all heap allocations of the benchmark executable, to prove that the steady state ingestion does not allocate
+static std::atomic<uint64_t> gAllocationCounter{ 0 }; // NOLINT Global allocation counter
+
+void *
+operator new( size_t size )
+{
+    gAllocationCounter++;
+    void *ptr = std::malloc( size > 0 ? size : 1 );
+    if ( ptr == nullptr )
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void
+operator delete( void *ptr ) noexcept
+{
+    std::free( ptr );
+}
+
+void
+operator delete( void *ptr, size_t ) noexcept
+{
+    std::free( ptr );
+}
+
+using namespace Aws::IoTFleetWise;
+
+static constexpr CANRawFrameID BENCHMARK_FRAME_ID = 0x123;
+
+static std::shared_ptr<const CANDecoderDictionary>
+createDictionary( CANMessageCollectType collectType, uint32_t numSignals )
+{
+    CANMessageDecoderMethod decoderMethod;
+    decoderMethod.collectType = collectType;
+    decoderMethod.format.mMessageID = BENCHMARK_FRAME_ID;
+    decoderMethod.format.mSizeInBytes = MAX_CAN_FRAME_BYTE_SIZE;
+    auto dictionary = std::make_shared<CANDecoderDictionary>();
+    for ( uint32_t i = 0; i < numSignals; i++ )
+    {
+        CANSignalFormat signalFormat;
+        signalFormat.mSignalID = i + 1;
+        signalFormat.mFirstBitPosition = static_cast<uint16_t>( i * 8 );
+        signalFormat.mSizeInBits = 8;
+        signalFormat.mFactor = 1.0;
+        signalFormat.mOffset = 0.0;
+        decoderMethod.format.mSignals.push_back( signalFormat );
+        dictionary->signalIDsToCollect.emplace( signalFormat.mSignalID );
+    }
+    dictionary->canMessageDecoderMethod[0][BENCHMARK_FRAME_ID] = decoderMethod;
+    // Like the CollectionSchemeManager does for the dictionaries it publishes
+    CANDecoder::compileDictionary( *dictionary );
+    return dictionary;
+}
+
+// Decodes a CAN frame and consumes it again, like the CAN data source and inspection threads do
+static void
+BM_canDataConsumerProcessMessage( benchmark::State &state )
+{
+    auto collectType = static_cast<CANMessageCollectType>( state.range( 0 ) );
+    auto numSignals = static_cast<uint32_t>( state.range( 1 ) );
+    auto signalBuffer = std::make_shared<SignalBuffer>( 1000 );
+    CANDataConsumer consumer( signalBuffer );
+    auto dictionary = createDictionary( collectType, numSignals );
+    std::array<uint8_t, MAX_CAN_FRAME_BYTE_SIZE> frameData{};
+    for ( size_t i = 0; i < frameData.size(); i++ )
+    {
+        frameData[i] = static_cast<uint8_t>( i );
+    }
+    size_t consumedSignals = 0;
+    auto consumeDataFrame = [&consumedSignals]( const CollectedDataFrame &dataFrame ) {
+        consumedSignals += dataFrame.mCollectedSignals.size();
+    };
+    Timestamp timestamp = 0;
+    // Warm up, so that the buffer slots have storage to recycle
+    for ( int i = 0; i < 1000; i++ )
+    {
+        consumer.processMessage( 0, dictionary, BENCHMARK_FRAME_ID, frameData.data(), frameData.size(), timestamp++ );
+        signalBuffer->consumeAll( consumeDataFrame );
+    }
+
+    auto allocationsBefore = gAllocationCounter.load();
+    for ( auto _ : state )
+    {
+        consumer.processMessage( 0, dictionary, BENCHMARK_FRAME_ID, frameData.data(), frameData.size(), timestamp++ );
+        signalBuffer->consumeAll( consumeDataFrame );
+    }
+    auto allocations = gAllocationCounter.load() - allocationsBefore;
+    benchmark::DoNotOptimize( consumedSignals );
+    state.counters["allocs_per_frame"] =
+        benchmark::Counter( static_cast<double>( allocations ) / static_cast<double>( state.iterations() ) );
+    state.SetItemsProcessed( static_cast<int64_t>( state.iterations() ) );
+}
+BENCHMARK( BM_canDataConsumerProcessMessage )
+    ->ArgNames( { "collectType", "signals" } )
+    ->Args( { static_cast<int64_t>( CANMessageCollectType::DECODE ), 8 } )
+    ->Args( { static_cast<int64_t>( CANMessageCollectType::RAW ), 8 } )
+    ->Args( { static_cast<int64_t>( CANMessageCollectType::RAW_AND_DECODE ), 8 } )
+    ->Args( { static_cast<int64_t>( CANMessageCollectType::RAW_AND_DECODE ), 64 } );
+
+// Decodes batches of CAN frames, like the CAN data source does with the frames of one recvmmsg call
+static void
+BM_canDataConsumerProcessMessages( benchmark::State &state )
+{
+    auto batchSize = static_cast<size_t>( state.range( 0 ) );
+    auto signalBuffer = std::make_shared<SignalBuffer>( 1000 );
+    CANDataConsumer consumer( signalBuffer );
+    auto dictionary = createDictionary( CANMessageCollectType::DECODE, 8 );
+    std::array<uint8_t, MAX_CAN_FRAME_BYTE_SIZE> frameData{};
+    for ( size_t i = 0; i < frameData.size(); i++ )
+    {
+        frameData[i] = static_cast<uint8_t>( i );
+    }
+    std::vector<CANFrameInfo> frames( batchSize );
+    for ( size_t i = 0; i < batchSize; i++ )
+    {
+        frames[i] = CANFrameInfo{ BENCHMARK_FRAME_ID, frameData.data(), frameData.size(), i };
+    }
+    size_t consumedSignals = 0;
+    auto consumeDataFrame = [&consumedSignals]( const CollectedDataFrame &dataFrame ) {
+        consumedSignals += dataFrame.mCollectedSignals.size();
+    };
+    // Warm up, so that the buffer slots have storage to recycle
+    for ( int i = 0; i < 1000; i++ )
+    {
+        consumer.processMessages( 0, dictionary, frames.data(), frames.size() );
+        signalBuffer->consumeAll( consumeDataFrame );
+    }
+
+    for ( auto _ : state )
+    {
+        consumer.processMessages( 0, dictionary, frames.data(), frames.size() );
+        signalBuffer->consumeAll( consumeDataFrame );
+    }
+    benchmark::DoNotOptimize( consumedSignals );
+    state.SetItemsProcessed( static_cast<int64_t>( state.iterations() ) * static_cast<int64_t>( batchSize ) );
+}
+BENCHMARK( BM_canDataConsumerProcessMessages )->ArgName( "batchSize" )->Arg( 1 )->Arg( 10 )->Arg( 64 )->Arg( 256 );
@@ -0,0 +1,132 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "CANDataConsumer.h"
+#include "CANDecoder.h"
+#include "CollectionInspectionAPITypes.h"
+#include "IDecoderDictionary.h"
+#include "MessageTypes.h"
+#include "SignalTypes.h"
+#include <array>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+namespace Aws
+{
+namespace IoTFleetWise
+{
+
+class CANDataConsumerTest : public ::testing::Test
+{
+protected:
+    void
+    SetUp() override
+    {
+        auto dictionary = std::make_shared<CANDecoderDictionary>();
+        // Frame 0x100 is only decoded, frame 0x200 is also collected raw
+        addMessage( *dictionary, 0x100, CANMessageCollectType::DECODE, 1 );
+        addMessage( *dictionary, 0x200, CANMessageCollectType::RAW_AND_DECODE, 2 );
+        CANDecoder::compileDictionary( *dictionary );
+        mDictionary = dictionary;
+        for ( size_t i = 0; i < mFrameData.size(); i++ )
+        {
+            mFrameData[i] = static_cast<uint8_t>( i + 1 );
+        }
+    }
+
+    static void
+    addMessage( CANDecoderDictionary &dictionary,
+                CANRawFrameID messageId,
+                CANMessageCollectType collectType,
+                SignalID signalId )
+    {
+        CANMessageDecoderMethod decoderMethod;
+        decoderMethod.collectType = collectType;
+        decoderMethod.format.mMessageID = messageId;
+        decoderMethod.format.mSizeInBytes = 8;
+        CANSignalFormat signalFormat;
+        signalFormat.mSignalID = signalId;
+        signalFormat.mFirstBitPosition = 0;
+        signalFormat.mSizeInBits = 8;
+        signalFormat.mFactor = 1.0;
+        signalFormat.mOffset = 0.0;
+        decoderMethod.format.mSignals.push_back( signalFormat );
+        dictionary.canMessageDecoderMethod[0][messageId] = decoderMethod;
+        dictionary.signalIDsToCollect.emplace( signalId );
+    }
+
+    CANFrameInfo
+    createFrame( uint32_t messageId, Timestamp timestamp )
+    {
+        return CANFrameInfo{ messageId, mFrameData.data(), mFrameData.size(), timestamp };
+    }
+
+    std::shared_ptr<const CANDecoderDictionary> mDictionary;
+    std::array<uint8_t, 8> mFrameData{};
+};
+
+TEST_F( CANDataConsumerTest, batchOfDecodedFramesIsPushedAsOneDataFramePerFrame )
+{
+    auto signalBuffer = std::make_shared<SignalBuffer>( 10 );
+    CANDataConsumer consumer( signalBuffer );
+    // The unknown frame 0x300 is skipped
+    std::vector<CANFrameInfo> frames{
+        createFrame( 0x100, 1000 ), createFrame( 0x300, 1001 ), createFrame( 0x100, 1002 ) };
+    consumer.processMessages( 0, mDictionary, frames.data(), frames.size() );
+
+    CollectedDataFrame dataFrame;
+    ASSERT_TRUE( signalBuffer->pop( dataFrame ) );
+    ASSERT_EQ( dataFrame.mCollectedCanRawFrame, nullptr );
+    ASSERT_EQ( dataFrame.mCollectedSignals.size(), 1 );
+    ASSERT_EQ( dataFrame.mCollectedSignals[0].signalID, 1 );
+    ASSERT_EQ( dataFrame.mCollectedSignals[0].receiveTime, 1000 );
+    ASSERT_DOUBLE_EQ( dataFrame.mCollectedSignals[0].value.value.doubleVal, 1.0 );
+    ASSERT_TRUE( signalBuffer->pop( dataFrame ) );
+    ASSERT_EQ( dataFrame.mCollectedSignals.size(), 1 );
+    ASSERT_EQ( dataFrame.mCollectedSignals[0].signalID, 1 );
+    ASSERT_EQ( dataFrame.mCollectedSignals[0].receiveTime, 1002 );
+    ASSERT_FALSE( signalBuffer->pop( dataFrame ) );
+}
+
+TEST_F( CANDataConsumerTest, batchWithRawFrames )
+{
+    auto signalBuffer = std::make_shared<SignalBuffer>( 10 );
+    CANDataConsumer consumer( signalBuffer );
+    std::vector<CANFrameInfo> frames{ createFrame( 0x100, 1000 ), createFrame( 0x200, 1001 ) };
+    consumer.processMessages( 0, mDictionary, frames.data(), frames.size() );
+
+    CollectedDataFrame dataFrame;
+    ASSERT_TRUE( signalBuffer->pop( dataFrame ) );
+    ASSERT_EQ( dataFrame.mCollectedCanRawFrame, nullptr );
+    ASSERT_EQ( dataFrame.mCollectedSignals.size(), 1 );
+    ASSERT_EQ( dataFrame.mCollectedSignals[0].receiveTime, 1000 );
+
+    // The raw frame and its decoded signals share one data frame
+    ASSERT_TRUE( signalBuffer->pop( dataFrame ) );
+    ASSERT_NE( dataFrame.mCollectedCanRawFrame, nullptr );
+    ASSERT_EQ( dataFrame.mCollectedCanRawFrame->frameID, 0x200 );
+    ASSERT_EQ( dataFrame.mCollectedCanRawFrame->receiveTime, 1001 );
+    ASSERT_EQ( dataFrame.mCollectedSignals.size(), 1 );
+    ASSERT_EQ( dataFrame.mCollectedSignals[0].signalID, 2 );
+    ASSERT_EQ( dataFrame.mCollectedSignals[0].receiveTime, 1001 );
+    ASSERT_FALSE( signalBuffer->pop( dataFrame ) );
+}
+
+TEST_F( CANDataConsumerTest, batchWithoutKnownFramesPushesNothing )
+{
+    auto signalBuffer = std::make_shared<SignalBuffer>( 10 );
+    CANDataConsumer consumer( signalBuffer );
+    std::vector<CANFrameInfo> frames{ createFrame( 0x300, 1000 ), createFrame( 0x400, 1001 ) };
+    consumer.processMessages( 0, mDictionary, frames.data(), frames.size() );
+    ASSERT_TRUE( signalBuffer->isEmpty() );
+
+    std::shared_ptr<const CANDecoderDictionary> nullDictionary;
+    frames = { createFrame( 0x100, 1002 ) };
+    consumer.processMessages( 0, nullDictionary, frames.data(), frames.size() );
+    ASSERT_TRUE( signalBuffer->isEmpty() );
+}
+
+} // namespace IoTFleetWise
+} // namespace Aws
@@ -316,6 +316,121 @@ TEST_F( CANDataSourceTest, testExtractExtendedID )
     ASSERT_TRUE( dataSource.disconnect() );
 }
 
+TEST_F( CANDataSourceTest, testReceiveBatchSize )
+{
+    ASSERT_TRUE( mSocketFD != -1 );
+    auto signalBufferPtr = std::make_shared<SignalBuffer>( 100 );
+
+    CANDataConsumer consumer{ signalBufferPtr };
+    CANDataSource dataSource{ 0, CanTimestampType::KERNEL_SOFTWARE_TIMESTAMP, "vcan0", false, 100, consumer, 64 };
+    ASSERT_TRUE( dataSource.init() );
+    ASSERT_TRUE( dataSource.isAlive() );
+    mDictionary->canMessageDecoderMethod[0][0x123].collectType = CANMessageCollectType::DECODE;
+    dataSource.onChangeOfActiveDictionary( mDictionary, VehicleDataSourceProtocol::RAW_SOCKET );
+    // Wait until the data source thread receives frames
+    CollectedDataFrame collectedDataFrame;
+    WAIT_ASSERT_TRUE( sendTestMessage( mSocketFD ) && signalBufferPtr->pop( collectedDataFrame ) );
+    while ( signalBufferPtr->pop( collectedDataFrame ) )
+    {
+    }
+
+    constexpr size_t NUM_FRAMES = 50;
+    for ( size_t i = 0; i < NUM_FRAMES; i++ )
+    {
+        sendTestMessage( mSocketFD );
+    }
+    // Frames received in one batch are pushed as one data frame
+    size_t receivedSignals = 0;
+    size_t receivedDataFrames = 0;
+    WAIT_ASSERT_TRUE( ( receivedDataFrames += signalBufferPtr->consumeAll(
+                            [&receivedSignals]( const CollectedDataFrame &dataFrame ) {
+                                receivedSignals += dataFrame.mCollectedSignals.size();
+                            } ),
+                        receivedSignals >= ( NUM_FRAMES * 2 ) ) );
+    ASSERT_LE( receivedDataFrames, NUM_FRAMES );
+    ASSERT_TRUE( dataSource.disconnect() );
+}
+
+TEST_F( CANDataSourceTest, testFramesAreReceivedWithoutWaitingForIdleTime )
+{
+    ASSERT_TRUE( mSocketFD != -1 );
+    auto signalBufferPtr = std::make_shared<SignalBuffer>( 10 );
+
+    CANDataConsumer consumer{ signalBufferPtr };
+    // The idle time is longer than the wait timeout of the test, so frames are only received in time if the thread
+    // wakes up when they arrive
+    constexpr uint32_t IDLE_TIME_MS = 60000;
+    CANDataSource dataSource{ 0, CanTimestampType::KERNEL_SOFTWARE_TIMESTAMP, "vcan0", false, IDLE_TIME_MS, consumer };
+    ASSERT_TRUE( dataSource.init() );
+    ASSERT_TRUE( dataSource.isAlive() );
+    dataSource.onChangeOfActiveDictionary( mDictionary, VehicleDataSourceProtocol::RAW_SOCKET );
+    CollectedDataFrame collectedDataFrame;
+    WAIT_ASSERT_TRUE( sendTestMessage( mSocketFD ) && signalBufferPtr->pop( collectedDataFrame ) );
+    ASSERT_EQ( collectedDataFrame.mCollectedSignals.size(), 2 );
+    // Stopping interrupts the wait as well
+    ASSERT_TRUE( dataSource.disconnect() );
+}
+
+TEST( CANDataSourceKernelFilterTest, createKernelFilters )
+{
+    CANDecoderDictionary dictionary;
+    dictionary.canMessageDecoderMethod[0][0x456] = CANMessageDecoderMethod();
+    dictionary.canMessageDecoderMethod[0][0x123] = CANMessageDecoderMethod();
+    // Same ID as above, but with the extended frame flag
+    dictionary.canMessageDecoderMethod[0][0x123 | CAN_EFF_FLAG] = CANMessageDecoderMethod();
+    dictionary.canMessageDecoderMethod[0][0x1ABCDEF] = CANMessageDecoderMethod();
+    dictionary.canMessageDecoderMethod[1][0x789] = CANMessageDecoderMethod();
+
+    std::vector<struct can_filter> filters;
+    ASSERT_TRUE( CANDataSource::createKernelFilters( &dictionary, 0, 10, filters ) );
+    ASSERT_EQ( filters.size(), 3 );
+    ASSERT_EQ( filters[0].can_id, 0x123 );
+    ASSERT_EQ( filters[1].can_id, 0x456 );
+    ASSERT_EQ( filters[2].can_id, 0x1ABCDEF );
+    for ( const auto &filter : filters )
+    {
+        ASSERT_EQ( filter.can_mask, CAN_EFF_MASK );
+    }
+
+    ASSERT_TRUE( CANDataSource::createKernelFilters( &dictionary, 1, 10, filters ) );
+    ASSERT_EQ( filters.size(), 1 );
+    ASSERT_EQ( filters[0].can_id, 0x789 );
+
+    // No decoder methods on the channel or no dictionary at all: nothing should pass
+    ASSERT_TRUE( CANDataSource::createKernelFilters( &dictionary, 2, 10, filters ) );
+    ASSERT_TRUE( filters.empty() );
+    ASSERT_TRUE( CANDataSource::createKernelFilters( nullptr, 0, 10, filters ) );
+    ASSERT_TRUE( filters.empty() );
+
+    // Too many frame IDs: all frames should pass
+    ASSERT_FALSE( CANDataSource::createKernelFilters( &dictionary, 0, 3, filters ) );
+    ASSERT_TRUE( filters.empty() );
+}
+
+TEST_F( CANDataSourceTest, testKernelFiltersFollowDictionary )
+{
+    ASSERT_TRUE( mSocketFD != -1 );
+    auto signalBufferPtr = std::make_shared<SignalBuffer>( 10 );
+
+    CANDataConsumer consumer{ signalBufferPtr };
+    CANDataSource dataSource{ 0, CanTimestampType::KERNEL_SOFTWARE_TIMESTAMP, "vcan0", false, 100, consumer };
+    ASSERT_TRUE( dataSource.init() );
+    ASSERT_TRUE( dataSource.isAlive() );
+    dataSource.onChangeOfActiveDictionary( mDictionary, VehicleDataSourceProtocol::RAW_SOCKET );
+    CollectedDataFrame collectedDataFrame;
+    WAIT_ASSERT_TRUE( sendTestMessage( mSocketFD ) && signalBufferPtr->pop( collectedDataFrame ) );
+    DELAY_ASSERT_FALSE( sendTestMessage( mSocketFD, 0x456 ) && signalBufferPtr->pop( collectedDataFrame ) );
+
+    // Frame 0x456 passes the kernel filters once the dictionary has a decoder method for it
+    auto dictionary = std::make_shared<CANDecoderDictionary>( *mDictionary );
+    dictionary->canMessageDecoderMethod[0][0x456] = dictionary->canMessageDecoderMethod[0][0x123];
+    dictionary->canMessageDecoderMethod[0][0x456].format.mMessageID = 0x456;
+    dataSource.onChangeOfActiveDictionary( dictionary, VehicleDataSourceProtocol::RAW_SOCKET );
+    WAIT_ASSERT_TRUE( sendTestMessage( mSocketFD, 0x456 ) && signalBufferPtr->pop( collectedDataFrame ) &&
+                      ( collectedDataFrame.mCollectedCanRawFrame->frameID == 0x456 ) );
+    ASSERT_TRUE( dataSource.disconnect() );
+}
+
 TEST_F( CANDataSourceTest, testStringToCanTimestampType )
 {
     CanTimestampType timestampType;
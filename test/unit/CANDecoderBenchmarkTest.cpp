@@ -0,0 +1,132 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "CANDataTypes.h"
+#include "CANDecoder.h"
+#include "MessageTypes.h"
+#include "SignalTypes.h"
+#include <array>
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+using namespace Aws::IoTFleetWise;
+
+// Creates a CAN-FD message filled with signals of mixed endianness and sizes. For multiplexed messages the first byte
+// is the multiplexor and the signals are spread over 4 multiplexor values, all of them sharing the remaining bytes.
+static CANMessageFormat
+createMessageFormat( uint32_t numSignals, bool multiplexed )
+{
+    CANMessageFormat format;
+    format.mMessageID = 0x123;
+    format.mSizeInBytes = MAX_CAN_FRAME_BYTE_SIZE;
+    format.mIsMultiplexed = multiplexed;
+    uint16_t firstBit = 0;
+    if ( multiplexed )
+    {
+        CANSignalFormat multiplexor;
+        multiplexor.mSignalID = 1000;
+        multiplexor.mFirstBitPosition = 0;
+        multiplexor.mSizeInBits = 8;
+        multiplexor.mFactor = 1.0;
+        multiplexor.mOffset = 0.0;
+        multiplexor.mIsMultiplexorSignal = true;
+        format.mSignals.push_back( multiplexor );
+        firstBit = 8;
+    }
+    static constexpr std::array<uint16_t, 4> SIGNAL_SIZES = { 4, 8, 12, 16 };
+    uint16_t bitPosition = firstBit;
+    for ( uint32_t i = 0; i < numSignals; i++ )
+    {
+        CANSignalFormat signal;
+        signal.mSignalID = i + 1;
+        signal.mSizeInBits = SIGNAL_SIZES[i % SIGNAL_SIZES.size()];
+        if ( ( bitPosition + signal.mSizeInBits ) > ( MAX_CAN_FRAME_BYTE_SIZE * BYTE_SIZE ) )
+        {
+            bitPosition = firstBit;
+        }
+        signal.mFirstBitPosition = bitPosition;
+        bitPosition = static_cast<uint16_t>( bitPosition + signal.mSizeInBits );
+        signal.mIsSigned = ( i % 3 ) == 0;
+        signal.mFactor = 0.5;
+        signal.mOffset = 1.0;
+        signal.mMultiplexorValue = multiplexed ? static_cast<uint8_t>( i % 4 ) : UINT8_MAX;
+        format.mSignals.push_back( signal );
+    }
+    return format;
+}
+
+static void
+BM_canDecoderDecodePlan( benchmark::State &state )
+{
+    auto numSignals = static_cast<uint32_t>( state.range( 0 ) );
+    auto multiplexed = state.range( 1 ) != 0;
+    auto format = createMessageFormat( numSignals, multiplexed );
+    std::unordered_set<SignalID> signalIDsToCollect;
+    for ( const auto &signal : format.mSignals )
+    {
+        signalIDsToCollect.insert( signal.mSignalID );
+    }
+    auto decodePlan = CANDecoder::compileDecodePlan( format, signalIDsToCollect );
+    std::array<uint8_t, MAX_CAN_FRAME_BYTE_SIZE> frameData{};
+    for ( size_t i = 0; i < frameData.size(); i++ )
+    {
+        frameData[i] = static_cast<uint8_t>( ( i * 37 ) + 11 );
+    }
+    frameData[0] = 0;
+    std::vector<CANDecodedSignal> decodedSignals;
+    decodedSignals.reserve( numSignals + 1 );
+    size_t totalSignals = 0;
+    for ( auto _ : state )
+    {
+        decodedSignals.clear();
+        CANDecoder::decodeCANMessage( frameData.data(), frameData.size(), decodePlan, decodedSignals );
+        totalSignals += decodedSignals.size();
+        benchmark::DoNotOptimize( decodedSignals.data() );
+    }
+    state.counters["signals_per_frame"] =
+        benchmark::Counter( static_cast<double>( totalSignals ) / static_cast<double>( state.iterations() ) );
+    state.SetItemsProcessed( static_cast<int64_t>( totalSignals ) );
+}
+BENCHMARK( BM_canDecoderDecodePlan )
+    ->ArgNames( { "signals", "multiplexed" } )
+    ->Args( { 8, 0 } )
+    ->Args( { 64, 0 } )
+    ->Args( { 64, 1 } )
+    ->Args( { 256, 1 } );
+
+// Extracts all signals of a message without scaling, to compare the byte wise extraction with the 64-bit load one
+template <bool USE_WORD_EXTRACTION>
+static void
+BM_canDecoderExtractSignals( benchmark::State &state )
+{
+    auto numSignals = static_cast<uint32_t>( state.range( 0 ) );
+    auto format = createMessageFormat( numSignals, false );
+    std::unordered_set<SignalID> signalIDsToCollect;
+    for ( const auto &signal : format.mSignals )
+    {
+        signalIDsToCollect.insert( signal.mSignalID );
+    }
+    auto decodePlan = CANDecoder::compileDecodePlan( format, signalIDsToCollect );
+    CANDecoder::PaddedFrame paddedFrame{};
+    for ( size_t i = 0; i < MAX_CAN_FRAME_BYTE_SIZE; i++ )
+    {
+        paddedFrame[CANDecoder::FRAME_PADDING + i] = static_cast<uint8_t>( ( i * 37 ) + 11 );
+    }
+    const uint8_t *frameData = paddedFrame.data() + CANDecoder::FRAME_PADDING;
+    for ( auto _ : state )
+    {
+        int64_t sum = 0;
+        for ( const auto &signal : decodePlan.mSignals )
+        {
+            sum += USE_WORD_EXTRACTION ? CANDecoder::extractSignalFromPaddedFrame( paddedFrame, signal )
+                                       : CANDecoder::extractSignalFromFrame( frameData, signal );
+        }
+        benchmark::DoNotOptimize( sum );
+    }
+    state.SetItemsProcessed( static_cast<int64_t>( state.iterations() ) * numSignals );
+}
+BENCHMARK_TEMPLATE( BM_canDecoderExtractSignals, false )->ArgName( "signals" )->Arg( 8 )->Arg( 64 );
+BENCHMARK_TEMPLATE( BM_canDecoderExtractSignals, true )->ArgName( "signals" )->Arg( 8 )->Arg( 64 );
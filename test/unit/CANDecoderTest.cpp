@@ -3,6 +3,7 @@
 
 #include "CANDecoder.h"
 #include "CANDataTypes.h"
+#include "IDecoderDictionary.h"
 #include "MessageTypes.h"
 #include "SignalTypes.h"
 #include <cstddef>
@@ -669,5 +670,173 @@ TEST( CANDecoderTest, CANDecoderTestSkippingOutOfBoundSignals2 )
     ASSERT_EQ( decodedSignals.size(), 1 );
 }
 
+TEST( CANDecoderTest, CANDecoderTestDecodePlanMultiplexedMessage )
+{
+    CANSignalFormat multiplexorSignal;
+    multiplexorSignal.mSignalID = 1;
+    multiplexorSignal.mFirstBitPosition = 0;
+    multiplexorSignal.mSizeInBits = 8;
+    multiplexorSignal.mOffset = 0.0;
+    multiplexorSignal.mFactor = 1.0;
+    multiplexorSignal.mIsMultiplexorSignal = true;
+
+    CANMessageFormat msgFormat;
+    msgFormat.mMessageID = 0x100;
+    msgFormat.mSizeInBytes = 4;
+    msgFormat.mIsMultiplexed = true;
+    msgFormat.mSignals.emplace_back( multiplexorSignal );
+    // Interleave the multiplexor values, the decoded signals still have to follow the order of the format
+    for ( uint32_t i = 0; i < 6; i++ )
+    {
+        CANSignalFormat signal;
+        signal.mSignalID = 10 + i;
+        signal.mFirstBitPosition = static_cast<uint16_t>( 8 + ( ( i / 2 ) * 8 ) );
+        signal.mSizeInBits = 8;
+        signal.mOffset = 0.0;
+        signal.mFactor = 1.0;
+        signal.mMultiplexorValue = static_cast<uint8_t>( i % 2 );
+        msgFormat.mSignals.emplace_back( signal );
+    }
+
+    // Signal 14 is not collected, hence it must not be in the plan at all
+    std::unordered_set<SignalID> signalIDsToCollect = { 1, 10, 11, 12, 13, 15 };
+    auto decodePlan = CANDecoder::compileDecodePlan( msgFormat, signalIDsToCollect );
+    ASSERT_TRUE( decodePlan.isCompiled() );
+    ASSERT_TRUE( decodePlan.mCollectMultiplexor );
+    ASSERT_EQ( decodePlan.mSignals.size(), 6 );
+    ASSERT_EQ( decodePlan.mSignalsByMultiplexorValue.size(), 5 );
+
+    std::vector<uint8_t> frameData = { 0x00, 0x11, 0x22, 0x33 };
+    std::vector<CANDecodedSignal> decodedSignals;
+    ASSERT_TRUE( CANDecoder::decodeCANMessage( frameData.data(), frameData.size(), decodePlan, decodedSignals ) );
+    ASSERT_EQ( decodedSignals.size(), 3 );
+    EXPECT_EQ( decodedSignals[0].mSignalID, 1 );
+    EXPECT_EQ( decodedSignals[1].mSignalID, 10 );
+    EXPECT_EQ( decodedSignals[1].mRawValue, 0x11 );
+    EXPECT_EQ( decodedSignals[2].mSignalID, 12 );
+    EXPECT_EQ( decodedSignals[2].mRawValue, 0x22 );
+
+    // The same plan is reused for the next frame with a different multiplexor value
+    frameData[0] = 0x01;
+    decodedSignals.clear();
+    ASSERT_TRUE( CANDecoder::decodeCANMessage( frameData.data(), frameData.size(), decodePlan, decodedSignals ) );
+    ASSERT_EQ( decodedSignals.size(), 4 );
+    EXPECT_EQ( decodedSignals[0].mSignalID, 1 );
+    EXPECT_EQ( decodedSignals[1].mSignalID, 11 );
+    EXPECT_EQ( decodedSignals[1].mRawValue, 0x11 );
+    EXPECT_EQ( decodedSignals[2].mSignalID, 13 );
+    EXPECT_EQ( decodedSignals[2].mRawValue, 0x22 );
+    EXPECT_EQ( decodedSignals[3].mSignalID, 15 );
+    EXPECT_EQ( decodedSignals[3].mRawValue, 0x33 );
+
+    // No signal has multiplexor value 2
+    frameData[0] = 0x02;
+    decodedSignals.clear();
+    ASSERT_TRUE( CANDecoder::decodeCANMessage( frameData.data(), frameData.size(), decodePlan, decodedSignals ) );
+    ASSERT_EQ( decodedSignals.size(), 1 );
+    EXPECT_EQ( decodedSignals[0].mSignalID, 1 );
+}
+
+TEST( CANDecoderTest, CANDecoderTestCompileDictionary )
+{
+    CANSignalFormat sigFormat;
+    sigFormat.mSignalID = 1;
+    sigFormat.mFirstBitPosition = 0;
+    sigFormat.mSizeInBits = 8;
+    sigFormat.mOffset = 0.0;
+    sigFormat.mFactor = 1.0;
+
+    CANMessageDecoderMethod decodeMethod;
+    decodeMethod.collectType = CANMessageCollectType::RAW_AND_DECODE;
+    decodeMethod.format.mMessageID = 0x100;
+    decodeMethod.format.mSizeInBytes = 1;
+    decodeMethod.format.mSignals.emplace_back( sigFormat );
+    CANMessageDecoderMethod rawMethod;
+    rawMethod.collectType = CANMessageCollectType::RAW;
+
+    CANDecoderDictionary dictionary;
+    dictionary.signalIDsToCollect = { 1 };
+    dictionary.canMessageDecoderMethod[0][0x100] = decodeMethod;
+    dictionary.canMessageDecoderMethod[0][0x200] = rawMethod;
+    CANDecoder::compileDictionary( dictionary );
+
+    ASSERT_TRUE( dictionary.isDecoderMethodLookupBuilt );
+    ASSERT_EQ( dictionary.canMessageDecoderMethodLookup.size(), 1 );
+    ASSERT_EQ( dictionary.canMessageDecoderMethodLookup[0].standardFrames[0x100],
+               &dictionary.canMessageDecoderMethod[0][0x100] );
+    ASSERT_EQ( dictionary.canMessageDecoderMethodLookup[0].standardFrames[0x101], nullptr );
+    // The lookup points into the original dictionary, so it must not be copied
+    CANDecoderDictionary dictionaryCopy = dictionary;
+    ASSERT_FALSE( dictionaryCopy.isDecoderMethodLookupBuilt );
+    ASSERT_TRUE( dictionaryCopy.canMessageDecoderMethodLookup.empty() );
+
+    const auto &decodePlan = dictionary.canMessageDecoderMethod[0][0x100].decodePlan;
+    ASSERT_TRUE( decodePlan.isCompiled() );
+    ASSERT_EQ( decodePlan.mSignals.size(), 1 );
+    ASSERT_FALSE( dictionary.canMessageDecoderMethod[0][0x200].decodePlan.isCompiled() );
+
+    std::vector<uint8_t> frameData = { 0x2A };
+    std::vector<CANDecodedSignal> decodedSignals;
+    ASSERT_TRUE( CANDecoder::decodeCANMessage( frameData.data(), frameData.size(), decodePlan, decodedSignals ) );
+    ASSERT_EQ( decodedSignals.size(), 1 );
+    EXPECT_EQ( decodedSignals[0].mPhysicalValue.signalValue.doubleVal, 42.0 );
+    // A frame that is too short is still detected at decoding time
+    decodedSignals.clear();
+    ASSERT_FALSE( CANDecoder::decodeCANMessage( frameData.data(), 0, decodePlan, decodedSignals ) );
+    ASSERT_EQ( decodedSignals.size(), 0 );
+}
+
+TEST( CANDecoderTest, CANDecoderTestWordExtractionIsBitExact )
+{
+    // Compare the 64-bit load based extraction with the byte wise one for every signal layout that fits into a CAN-FD
+    // frame
+    CANMessageFormat msgFormat;
+    std::unordered_set<SignalID> signalIDsToCollect;
+    SignalID signalID = 0;
+    for ( uint16_t firstBit = 0; firstBit < ( MAX_CAN_FRAME_BYTE_SIZE * BYTE_SIZE ); firstBit++ )
+    {
+        for ( uint16_t size = 1; size <= 64; size++ )
+        {
+            for ( int variant = 0; variant < 4; variant++ )
+            {
+                CANSignalFormat sigFormat;
+                sigFormat.mSignalID = signalID++;
+                sigFormat.mIsBigEndian = ( variant & 1 ) != 0;
+                sigFormat.mIsSigned = ( variant & 2 ) != 0;
+                sigFormat.mFirstBitPosition = firstBit;
+                sigFormat.mSizeInBits = size;
+                msgFormat.mSignals.emplace_back( sigFormat );
+                signalIDsToCollect.insert( sigFormat.mSignalID );
+            }
+        }
+    }
+    auto decodePlan = CANDecoder::compileDecodePlan( msgFormat, signalIDsToCollect );
+    ASSERT_EQ( decodePlan.mSignals.size(), msgFormat.mSignals.size() );
+
+    CANDecoder::PaddedFrame paddedFrame{};
+    for ( size_t i = 0; i < MAX_CAN_FRAME_BYTE_SIZE; i++ )
+    {
+        paddedFrame[CANDecoder::FRAME_PADDING + i] = static_cast<uint8_t>( ( i * 167 ) + 13 );
+    }
+    const uint8_t *frameData = paddedFrame.data() + CANDecoder::FRAME_PADDING;
+    size_t wordExtractions = 0;
+    for ( const auto &signal : decodePlan.mSignals )
+    {
+        if ( signal.mMinFrameSizeInBits > ( MAX_CAN_FRAME_BYTE_SIZE * BYTE_SIZE ) )
+        {
+            continue;
+        }
+        ASSERT_EQ( CANDecoder::extractSignalFromPaddedFrame( paddedFrame, signal ),
+                   CANDecoder::extractSignalFromFrame( frameData, signal ) )
+            << "firstBit " << signal.mStartByte * BYTE_SIZE + signal.mStartBitInByte << " size "
+            << signal.mSizeInBits << " big endian " << signal.mIsBigEndian << " signed " << signal.mIsSigned;
+        if ( signal.mUseWordExtraction )
+        {
+            wordExtractions++;
+        }
+    }
+    ASSERT_GT( wordExtractions, decodePlan.mSignals.size() / 2 );
+}
+
 } // namespace IoTFleetWise
 } // namespace Aws
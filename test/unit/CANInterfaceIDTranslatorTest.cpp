@@ -0,0 +1,53 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "CANInterfaceIDTranslator.h"
+#include "SignalTypes.h"
+#include <gtest/gtest.h>
+
+namespace Aws
+{
+namespace IoTFleetWise
+{
+
+TEST( CANInterfaceIDTranslatorTest, translateBothDirections )
+{
+    CANInterfaceIDTranslator translator;
+    ASSERT_EQ( translator.getChannelNumericID( "can0" ), INVALID_CAN_SOURCE_NUMERIC_ID );
+    ASSERT_EQ( translator.getInterfaceID( 0 ), INVALID_INTERFACE_ID );
+
+    translator.add( "can0" );
+    translator.add( "can1" );
+    translator.add( "can2" );
+    ASSERT_EQ( translator.getChannelNumericID( "can0" ), 0 );
+    ASSERT_EQ( translator.getChannelNumericID( "can1" ), 1 );
+    ASSERT_EQ( translator.getChannelNumericID( "can2" ), 2 );
+    ASSERT_EQ( translator.getChannelNumericID( "can3" ), INVALID_CAN_SOURCE_NUMERIC_ID );
+    ASSERT_EQ( translator.getInterfaceID( 0 ), "can0" );
+    ASSERT_EQ( translator.getInterfaceID( 2 ), "can2" );
+    ASSERT_EQ( translator.getInterfaceID( 3 ), INVALID_INTERFACE_ID );
+    ASSERT_EQ( translator.getInterfaceID( INVALID_CAN_SOURCE_NUMERIC_ID ), INVALID_INTERFACE_ID );
+
+    // The same reference is returned every time, no copy is made
+    ASSERT_EQ( &translator.getInterfaceID( 1 ), &translator.getInterfaceID( 1 ) );
+}
+
+TEST( CANInterfaceIDTranslatorTest, duplicateInterfaceID )
+{
+    CANInterfaceIDTranslator translator;
+    translator.add( "can0" );
+    translator.add( "can0" );
+    // Like before, the first numeric ID is found, but both numeric IDs translate back to the interface ID
+    ASSERT_EQ( translator.getChannelNumericID( "can0" ), 0 );
+    ASSERT_EQ( translator.getInterfaceID( 0 ), "can0" );
+    ASSERT_EQ( translator.getInterfaceID( 1 ), "can0" );
+
+    // Copies are independent
+    auto copy = translator;
+    copy.add( "can2" );
+    ASSERT_EQ( copy.getChannelNumericID( "can2" ), 2 );
+    ASSERT_EQ( translator.getChannelNumericID( "can2" ), INVALID_CAN_SOURCE_NUMERIC_ID );
+}
+
+} // namespace IoTFleetWise
+} // namespace Aws
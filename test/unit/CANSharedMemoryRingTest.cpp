@@ -0,0 +1,161 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "CANSharedMemoryRing.h"
+#include "CANDataConsumer.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace Aws
+{
+namespace IoTFleetWise
+{
+
+static std::string
+getTestPath()
+{
+    return "/tmp/fwe-can-ring-test-" + std::to_string( getpid() );
+}
+
+TEST( CANSharedMemoryRingTest, pushPeekAndRelease )
+{
+    CANSharedMemoryRing consumer( getTestPath() );
+    ASSERT_TRUE( consumer.create( 3 ) );
+    CANSharedMemoryRing producer( getTestPath() );
+    ASSERT_TRUE( producer.open() );
+
+    std::array<uint8_t, MAX_CAN_FRAME_BYTE_SIZE + 1> data{};
+    for ( size_t i = 0; i < data.size(); i++ )
+    {
+        data[i] = static_cast<uint8_t>( i );
+    }
+    ASSERT_FALSE( producer.push( 1, 0x100, data.data(), data.size() ) );
+    ASSERT_TRUE( producer.push( 1, 0x100, data.data(), 8 ) );
+    ASSERT_TRUE( producer.push( 2, 0x200, data.data(), MAX_CAN_FRAME_BYTE_SIZE ) );
+    ASSERT_TRUE( producer.push( 3, 0x300, data.data(), 0 ) );
+    ASSERT_FALSE( producer.push( 4, 0x400, data.data(), 8 ) );
+
+    std::vector<CANFrameInfo> frames;
+    ASSERT_EQ( consumer.peek( frames, 2 ), 2 );
+    ASSERT_EQ( frames.size(), 2 );
+    ASSERT_EQ( frames[0].messageId, 0x100 );
+    ASSERT_EQ( frames[0].timestamp, 1 );
+    ASSERT_EQ( frames[0].dataLength, 8 );
+    ASSERT_EQ( frames[1].messageId, 0x200 );
+    ASSERT_EQ( frames[1].dataLength, MAX_CAN_FRAME_BYTE_SIZE );
+    ASSERT_EQ( frames[1].data[MAX_CAN_FRAME_BYTE_SIZE - 1], MAX_CAN_FRAME_BYTE_SIZE - 1 );
+    // Until the frames are released the producer can't reuse their slots
+    ASSERT_FALSE( producer.push( 4, 0x400, data.data(), 8 ) );
+    consumer.release( 2 );
+    ASSERT_TRUE( producer.push( 4, 0x400, data.data(), 8 ) );
+
+    // The frames wrap around the end of the ring
+    ASSERT_EQ( consumer.peek( frames, 10 ), 2 );
+    ASSERT_EQ( frames[0].messageId, 0x300 );
+    ASSERT_EQ( frames[0].dataLength, 0 );
+    ASSERT_EQ( frames[1].messageId, 0x400 );
+    ASSERT_EQ( frames[1].timestamp, 4 );
+    consumer.release( 2 );
+    ASSERT_EQ( consumer.peek( frames, 10 ), 0 );
+    ASSERT_TRUE( frames.empty() );
+}
+
+TEST( CANSharedMemoryRingTest, waitForFrames )
+{
+    CANSharedMemoryRing consumer( getTestPath() );
+    ASSERT_TRUE( consumer.create( 3 ) );
+    CANSharedMemoryRing producer( getTestPath() );
+    ASSERT_TRUE( producer.open() );
+    std::atomic<bool> cancel{ false };
+    std::array<uint8_t, 8> data{};
+
+    // Times out on an empty ring
+    auto start = std::chrono::steady_clock::now();
+    consumer.waitForFrames( 10, cancel );
+    ASSERT_GE( std::chrono::steady_clock::now() - start, std::chrono::milliseconds( 10 ) );
+
+    // Returns immediately if the ring is not empty or canceled
+    ASSERT_TRUE( producer.push( 1, 0x100, data.data(), data.size() ) );
+    consumer.waitForFrames( 1000000, cancel );
+    std::vector<CANFrameInfo> frames;
+    consumer.release( consumer.peek( frames, 10 ) );
+    cancel.store( true );
+    consumer.waitForFrames( 1000000, cancel );
+    cancel.store( false );
+
+    // Woken up by a push and by wakeUp()
+    std::thread producerThread( [&producer, &data]() {
+        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+        producer.push( 2, 0x100, data.data(), data.size() );
+    } );
+    consumer.waitForFrames( 1000000, cancel );
+    producerThread.join();
+    ASSERT_EQ( consumer.peek( frames, 10 ), 1 );
+    consumer.release( 1 );
+    std::thread stopThread( [&consumer, &cancel]() {
+        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+        cancel.store( true );
+        consumer.wakeUp();
+    } );
+    consumer.waitForFrames( 1000000, cancel );
+    stopThread.join();
+}
+
+TEST( CANSharedMemoryRingTest, invalidRing )
+{
+    CANSharedMemoryRing notCreated( getTestPath() );
+    ASSERT_FALSE( notCreated.open() );
+    std::vector<CANFrameInfo> frames;
+    ASSERT_EQ( notCreated.peek( frames, 10 ), 0 );
+
+    CANSharedMemoryRing emptyRing( getTestPath() );
+    ASSERT_FALSE( emptyRing.create( 0 ) );
+
+    {
+        CANSharedMemoryRing consumer( getTestPath() );
+        ASSERT_TRUE( consumer.create( 1 ) );
+    }
+    // The file is removed together with the ring that created it
+    ASSERT_NE( access( getTestPath().c_str(), F_OK ), 0 );
+}
+
+TEST( CANSharedMemoryRingTest, existingFilesAreNotRemoved )
+{
+    auto path = getTestPath();
+    {
+        std::ofstream file( path );
+        file << "content";
+    }
+    {
+        CANSharedMemoryRing consumer( path );
+        ASSERT_FALSE( consumer.create( 1 ) );
+    }
+    std::string content;
+    std::ifstream( path ) >> content;
+    ASSERT_EQ( content, "content" );
+    ASSERT_EQ( std::remove( path.c_str() ), 0 );
+
+    // A file that replaced the created one is left in place as well
+    {
+        CANSharedMemoryRing consumer( path );
+        ASSERT_TRUE( consumer.create( 1 ) );
+        ASSERT_EQ( std::remove( path.c_str() ), 0 );
+        std::ofstream file( path );
+        file << "replaced";
+    }
+    std::ifstream( path ) >> content;
+    ASSERT_EQ( content, "replaced" );
+    ASSERT_EQ( std::remove( path.c_str() ), 0 );
+}
+
+} // namespace IoTFleetWise
+} // namespace Aws
@@ -25,5 +25,3 @@ BM_systemTimeSinceEpochMs( benchmark::State &state )
         clock->systemTimeSinceEpochMs();
 }
 BENCHMARK( BM_systemTimeSinceEpochMs );
-
-BENCHMARK_MAIN();
@@ -0,0 +1,250 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Clock.h"
+#include "ClockHandler.h"
+#include "CollectionInspectionAPITypes.h"
+#include "CollectionInspectionEngine.h"
+#include "CollectionInspectionWorkerThread.h"
+#include "ICollectionScheme.h"
+#include "SignalTypes.h"
+#include "TimeTypes.h"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace Aws::IoTFleetWise;
+
+static constexpr uint32_t BENCHMARK_NUMBER_OF_SIGNALS = 64;
+
+static ExpressionNode *
+addNode( std::vector<std::unique_ptr<ExpressionNode>> &nodes, ExpressionNodeType nodeType )
+{
+    nodes.emplace_back( new ExpressionNode() );
+    nodes.back()->nodeType = nodeType;
+    return nodes.back().get();
+}
+
+static ExpressionNode *
+addOperator( std::vector<std::unique_ptr<ExpressionNode>> &nodes,
+             ExpressionNodeType nodeType,
+             ExpressionNode *left,
+             ExpressionNode *right )
+{
+    auto node = addNode( nodes, nodeType );
+    node->left = left;
+    node->right = right;
+    return node;
+}
+
+static ExpressionNode *
+addSignal( std::vector<std::unique_ptr<ExpressionNode>> &nodes, SignalID signalID )
+{
+    auto node = addNode( nodes, ExpressionNodeType::SIGNAL );
+    node->signalID = signalID;
+    return node;
+}
+
+static ExpressionNode *
+addFloat( std::vector<std::unique_ptr<ExpressionNode>> &nodes, double value )
+{
+    auto node = addNode( nodes, ExpressionNodeType::FLOAT );
+    node->floatingValue = value;
+    return node;
+}
+
+// Conditions that are only true if a signal is above 1000, each using three of the benchmark signals
+static std::shared_ptr<InspectionMatrix>
+createInspectionMatrix( std::vector<std::unique_ptr<ExpressionNode>> &nodes, uint32_t numConditions )
+{
+    auto inspectionMatrix = std::make_shared<InspectionMatrix>();
+    inspectionMatrix->conditions.resize( numConditions );
+    for ( uint32_t i = 0; i < numConditions; i++ )
+    {
+        SignalID signal1 = ( i % BENCHMARK_NUMBER_OF_SIGNALS ) + 1;
+        SignalID signal2 = ( ( i + 1 ) % BENCHMARK_NUMBER_OF_SIGNALS ) + 1;
+        SignalID signal3 = ( ( i + 2 ) % BENCHMARK_NUMBER_OF_SIGNALS ) + 1;
+        auto &condition = inspectionMatrix->conditions[i];
+        for ( auto signalID : { signal1, signal2, signal3 } )
+        {
+            InspectionMatrixSignalCollectionInfo signal{};
+            signal.signalID = signalID;
+            signal.sampleBufferSize = 10;
+            signal.minimumSampleIntervalMs = 0;
+            signal.signalType = SignalType::DOUBLE;
+            condition.signals.push_back( signal );
+        }
+        // (signal1 > 1000) || ((signal2 * 2.0) < (signal3 - 1000))
+        condition.condition = addOperator(
+            nodes,
+            ExpressionNodeType::OPERATOR_LOGICAL_OR,
+            addOperator(
+                nodes, ExpressionNodeType::OPERATOR_BIGGER, addSignal( nodes, signal1 ), addFloat( nodes, 1000.0 ) ),
+            addOperator( nodes,
+                         ExpressionNodeType::OPERATOR_SMALLER,
+                         addOperator( nodes,
+                                      ExpressionNodeType::OPERATOR_ARITHMETIC_MULTIPLY,
+                                      addSignal( nodes, signal2 ),
+                                      addFloat( nodes, 2.0 ) ),
+                         addOperator( nodes,
+                                      ExpressionNodeType::OPERATOR_ARITHMETIC_MINUS,
+                                      addSignal( nodes, signal3 ),
+                                      addFloat( nodes, 1000.0 ) ) ) );
+    }
+    return inspectionMatrix;
+}
+
+// Evaluates the maximum number of conditions after every signal changed, like the inspection thread does
+static void
+BM_collectionInspectionEngineEvaluateConditions( benchmark::State &state )
+{
+    auto numConditions = static_cast<uint32_t>( state.range( 0 ) );
+    std::vector<std::unique_ptr<ExpressionNode>> nodes;
+    // The signal values stay below 1000, so the conditions are never true
+    auto inspectionMatrix = createInspectionMatrix( nodes, numConditions );
+
+    CollectionInspectionEngine engine;
+    TimePoint timestamp{ 1000000, 1000 };
+    engine.onChangeInspectionMatrix( inspectionMatrix, timestamp );
+
+    double value = 0.0;
+    for ( auto _ : state )
+    {
+        timestamp = { timestamp.systemTimeMs + 1, timestamp.monotonicTimeMs + 1 };
+        value = ( value >= 100.0 ) ? 0.0 : value + 1.0;
+        // Every condition uses a changed signal, so all of them are evaluated
+        for ( SignalID signalID = 1; signalID <= BENCHMARK_NUMBER_OF_SIGNALS; signalID++ )
+        {
+            engine.addNewSignal<double>( signalID, timestamp, value );
+        }
+        benchmark::DoNotOptimize( engine.evaluateConditions( timestamp ) );
+    }
+    state.SetItemsProcessed( static_cast<int64_t>( state.iterations() ) * static_cast<int64_t>( numConditions ) );
+}
+BENCHMARK( BM_collectionInspectionEngineEvaluateConditions )
+    ->ArgName( "conditions" )
+    ->Arg( 16 )
+    ->Arg( 256 )
+    ->Arg( 4096 );
+
+// Evaluates the conditions every millisecond without new samples, so only the expiring fixed windows cause work
+static void
+BM_collectionInspectionEngineFixedWindows( benchmark::State &state )
+{
+    static constexpr uint32_t NUMBER_OF_CONDITIONS = 64;
+    static constexpr uint32_t WINDOW_PERIODS_MS[] = { 1000, 10000, 60000 };
+    auto numSignals = static_cast<uint32_t>( state.range( 0 ) );
+    std::vector<std::unique_ptr<ExpressionNode>> nodes;
+    auto inspectionMatrix = std::make_shared<InspectionMatrix>();
+    inspectionMatrix->conditions.resize( NUMBER_OF_CONDITIONS );
+    for ( uint32_t i = 0; i < numSignals; i++ )
+    {
+        InspectionMatrixSignalCollectionInfo signal{};
+        signal.signalID = i + 1;
+        signal.sampleBufferSize = 10;
+        signal.minimumSampleIntervalMs = 0;
+        signal.fixedWindowPeriod = WINDOW_PERIODS_MS[i % 3];
+        signal.signalType = SignalType::DOUBLE;
+        inspectionMatrix->conditions[i % NUMBER_OF_CONDITIONS].signals.push_back( signal );
+    }
+    for ( auto &condition : inspectionMatrix->conditions )
+    {
+        // The condition is never true: LAST_FIXED_WINDOW_AVG(first signal) > 1000000
+        auto function = addNode( nodes, ExpressionNodeType::WINDOWFUNCTION );
+        function->signalID = condition.signals[0].signalID;
+        function->function.windowFunction = WindowFunction::LAST_FIXED_WINDOW_AVG;
+        condition.condition =
+            addOperator( nodes, ExpressionNodeType::OPERATOR_BIGGER, function, addFloat( nodes, 1000000.0 ) );
+    }
+
+    CollectionInspectionEngine engine;
+    TimePoint timestamp{ 1000000, 1000 };
+    engine.onChangeInspectionMatrix( inspectionMatrix, timestamp );
+    // The windows start with the first sample, so spread them to have windows expiring all the time
+    for ( SignalID signalID = 1; signalID <= numSignals; signalID++ )
+    {
+        timestamp = { timestamp.systemTimeMs + 1, timestamp.monotonicTimeMs + 1 };
+        engine.addNewSignal<double>( signalID, timestamp, 1.0 );
+    }
+
+    for ( auto _ : state )
+    {
+        timestamp = { timestamp.systemTimeMs + 1, timestamp.monotonicTimeMs + 1 };
+        benchmark::DoNotOptimize( engine.evaluateConditions( timestamp ) );
+    }
+    state.SetItemsProcessed( static_cast<int64_t>( state.iterations() ) );
+}
+BENCHMARK( BM_collectionInspectionEngineFixedWindows )->ArgName( "signals" )->Arg( 64 )->Arg( 512 );
+
+// Feeds frames with all signals to the inspection thread and waits until the last frame triggered all conditions.
+// With more shards the conditions are evaluated on more threads.
+static void
+BM_collectionInspectionWorkerThreadShards( benchmark::State &state )
+{
+    static constexpr uint32_t NUMBER_OF_CONDITIONS = 256;
+    static constexpr uint32_t FRAMES_PER_ITERATION = 100;
+    auto numShards = static_cast<uint32_t>( state.range( 0 ) );
+    std::vector<std::unique_ptr<ExpressionNode>> nodes;
+    auto inspectionMatrix = createInspectionMatrix( nodes, NUMBER_OF_CONDITIONS );
+    for ( auto &condition : inspectionMatrix->conditions )
+    {
+        condition.triggerOnlyOnRisingEdge = true;
+    }
+
+    auto signalBuffer = std::make_shared<SignalBuffer>( FRAMES_PER_ITERATION * 2 );
+    auto outputCollectedData = std::make_shared<CollectedDataReadyToPublish>( NUMBER_OF_CONDITIONS * 2 );
+    CollectionInspectionWorkerThread worker;
+    worker.init( signalBuffer, outputCollectedData, 1000, numShards );
+    worker.start();
+    worker.onChangeInspectionMatrix( inspectionMatrix );
+    auto clock = ClockHandler::getClock();
+
+    auto pushFrame = [&]( double value ) {
+        CollectedSignalsGroup signals;
+        Timestamp timestamp = clock->systemTimeSinceEpochMs();
+        for ( SignalID signalID = 1; signalID <= BENCHMARK_NUMBER_OF_SIGNALS; signalID++ )
+        {
+            signals.emplace_back( signalID, timestamp, value, SignalType::DOUBLE );
+        }
+        while ( !signalBuffer->push( CollectedDataFrame( signals ) ) )
+        {
+            std::this_thread::yield();
+        }
+    };
+    for ( auto _ : state )
+    {
+        for ( uint32_t i = 0; i < FRAMES_PER_ITERATION; i++ )
+        {
+            pushFrame( static_cast<double>( i ) );
+            if ( ( i % 16 ) == 0 )
+            {
+                worker.onNewDataAvailable();
+            }
+        }
+        // Makes all conditions true
+        pushFrame( 2000.0 );
+        worker.onNewDataAvailable();
+        uint32_t triggered = 0;
+        TriggeredCollectionSchemeDataPtr collectedData;
+        while ( triggered < NUMBER_OF_CONDITIONS )
+        {
+            if ( outputCollectedData->pop( collectedData ) )
+            {
+                triggered++;
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+    worker.stop();
+    state.SetItemsProcessed( static_cast<int64_t>( state.iterations() ) * ( FRAMES_PER_ITERATION + 1 ) );
+}
+BENCHMARK( BM_collectionInspectionWorkerThreadShards )
+    ->ArgName( "shards" )
+    ->DenseRange( 1, 8 )
+    ->UseRealTime()
+    ->Unit( benchmark::kMillisecond );
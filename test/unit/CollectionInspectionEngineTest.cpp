@@ -348,6 +348,14 @@ protected:
         return bigger1;
     }
 
+    std::shared_ptr<ExpressionNode>
+    getWindowFunctionBiggerCondition( SignalID id1, WindowFunction windowFunction, double threshold1 )
+    {
+        auto bigger1 = getLastAvgWindowBiggerCondition( id1, threshold1 );
+        bigger1->left->function.windowFunction = windowFunction;
+        return bigger1;
+    }
+
     std::shared_ptr<ExpressionNode>
     getPrevLastAvgWindowBiggerCondition( SignalID id1, double threshold1 )
     {
@@ -466,6 +474,42 @@ TYPED_TEST( CollectionInspectionEngineTest, TwoSignalsInConditionAndOneSignalToC
     ASSERT_EQ( collectedData->triggerTime, timestamp.systemTimeMs );
 }
 
+TYPED_TEST( CollectionInspectionEngineTest, ConditionOnSignalsOfType )
+{
+    CollectionInspectionEngine engine;
+    InspectionMatrixSignalCollectionInfo s1{};
+    s1.signalID = 1;
+    s1.sampleBufferSize = 50;
+    s1.minimumSampleIntervalMs = 0;
+    s1.fixedWindowPeriod = 77777;
+    s1.isConditionOnlySignal = false;
+    s1.signalType = getSignalType<TypeParam>();
+    InspectionMatrixSignalCollectionInfo s2 = s1;
+    s2.signalID = 2;
+    this->addSignalToCollect( this->collectionSchemes->conditions[0], s1 );
+    this->addSignalToCollect( this->collectionSchemes->conditions[0], s2 );
+
+    // The condition is (signalID(1)>5) && (signalID(2)>5)
+    this->collectionSchemes->conditions[0].condition =
+        this->getTwoSignalsBiggerCondition( s1.signalID, 5.0, s2.signalID, 5.0 ).get();
+
+    TimePoint timestamp = { 160000000, 100 };
+    engine.onChangeInspectionMatrix( this->consCollectionSchemes, timestamp );
+
+    engine.addNewSignal<TypeParam>( s1.signalID, timestamp, 10 );
+    engine.addNewSignal<TypeParam>( s2.signalID, timestamp, 1 );
+    uint32_t waitTimeMs = 0;
+    ASSERT_FALSE( engine.evaluateConditions( timestamp ) );
+    ASSERT_EQ( engine.collectNextDataToSend( timestamp, waitTimeMs ), nullptr );
+
+    timestamp += 1000;
+    engine.addNewSignal<TypeParam>( s2.signalID, timestamp, 20 );
+    ASSERT_TRUE( engine.evaluateConditions( timestamp ) );
+    auto collectedData = engine.collectNextDataToSend( timestamp, waitTimeMs );
+    ASSERT_NE( collectedData, nullptr );
+    ASSERT_EQ( collectedData->signals.size(), 3 );
+}
+
 TEST_F( CollectionInspectionEngineDoubleTest, EndlessCondition )
 {
     CollectionInspectionEngine engine;
@@ -523,6 +567,35 @@ TEST_F( CollectionInspectionEngineDoubleTest, TooBigForSignalBuffer )
     ASSERT_EQ( collectedData->signals.size(), 0 );
 }
 
+TEST_F( CollectionInspectionEngineDoubleTest, TooBigForReducedSampleMemory )
+{
+    InspectionMatrixSignalCollectionInfo s1{};
+    s1.signalID = 3072;
+    s1.sampleBufferSize = 1000; // 16 KB, fits into MAX_SAMPLE_MEMORY but not into the reduced budget
+    s1.minimumSampleIntervalMs = 0;
+    s1.fixedWindowPeriod = 77777;
+    s1.signalType = SignalType::DOUBLE;
+    addSignalToCollect( collectionSchemes->conditions[0], s1 );
+    collectionSchemes->conditions[0].condition = getAlwaysTrueCondition().get();
+
+    for ( uint32_t maxSampleMemory : { CollectionInspectionEngine::MAX_SAMPLE_MEMORY, 10000U } )
+    {
+        CollectionInspectionEngine engine;
+        engine.setMaxSampleMemory( maxSampleMemory );
+        TimePoint timestamp = { 160000000, 100 };
+        engine.onChangeInspectionMatrix( consCollectionSchemes, timestamp );
+
+        engine.addNewSignal<double>( s1.signalID, timestamp, 0.1 );
+        engine.addNewSignal<double>( s1.signalID, timestamp + 1000, 0.2 );
+        engine.evaluateConditions( timestamp + 2000 );
+
+        uint32_t waitTimeMs = 0;
+        auto collectedData = engine.collectNextDataToSend( timestamp + 2000, waitTimeMs );
+        ASSERT_NE( collectedData, nullptr );
+        ASSERT_EQ( collectedData->signals.size(), ( maxSampleMemory == 10000U ) ? 0U : 2U );
+    }
+}
+
 TEST_F( CollectionInspectionEngineDoubleTest, TooBigForSignalBufferOverflow )
 {
     CollectionInspectionEngine engine;
@@ -595,6 +668,36 @@ TEST_F( CollectionInspectionEngineDoubleTest, SignalBufferErasedAfterNewConditio
     EXPECT_EQ( collectedData->signals[0].value.value.doubleVal, 0.4 );
 }
 
+TEST_F( CollectionInspectionEngineDoubleTest, SameSignalWithDifferentTypes )
+{
+    CollectionInspectionEngine engine;
+    InspectionMatrixSignalCollectionInfo s1{};
+    s1.signalID = 1234;
+    s1.sampleBufferSize = 50;
+    s1.minimumSampleIntervalMs = 0;
+    s1.fixedWindowPeriod = 77777;
+    s1.signalType = SignalType::DOUBLE;
+    addSignalToCollect( collectionSchemes->conditions[0], s1 );
+    collectionSchemes->conditions[0].condition = getAlwaysTrueCondition().get();
+    // Only the type of the first condition using the signal is collected
+    s1.signalType = SignalType::FLOAT;
+    addSignalToCollect( collectionSchemes->conditions[1], s1 );
+
+    TimePoint timestamp = { 160000000, 100 };
+    engine.onChangeInspectionMatrix( consCollectionSchemes, timestamp );
+
+    engine.addNewSignal<float>( s1.signalID, timestamp, 0.1F );
+    engine.addNewSignal<double>( s1.signalID, timestamp + 1, 0.2 );
+
+    engine.evaluateConditions( timestamp + 1 );
+
+    uint32_t waitTimeMs = 0;
+    auto collectedData = engine.collectNextDataToSend( timestamp + 1, waitTimeMs );
+    ASSERT_NE( collectedData, nullptr );
+    ASSERT_EQ( collectedData->signals.size(), 1 );
+    EXPECT_EQ( collectedData->signals[0].value.value.doubleVal, 0.2 );
+}
+
 TEST_F( CollectionInspectionEngineDoubleTest, CollectBurstWithoutSubsampling )
 {
     CollectionInspectionEngine engine;
@@ -627,6 +730,71 @@ TEST_F( CollectionInspectionEngineDoubleTest, CollectBurstWithoutSubsampling )
     EXPECT_EQ( collectedData->signals[2].value.value.doubleVal, 0.1 );
 }
 
+TEST_F( CollectionInspectionEngineDoubleTest, ZeroCopySignalCollection )
+{
+    CollectionInspectionEngine copyingEngine;
+    CollectionInspectionEngine engine;
+    engine.setZeroCopySignalCollection( true );
+    InspectionMatrixSignalCollectionInfo s1{};
+    s1.signalID = 1234;
+    // More than two segments, so the collected samples wrap around the end of the buffer
+    s1.sampleBufferSize = 600;
+    s1.minimumSampleIntervalMs = 0;
+    s1.fixedWindowPeriod = 77777;
+    addSignalToCollect( collectionSchemes->conditions[0], s1 );
+    collectionSchemes->conditions[0].condition = getAlwaysTrueCondition().get();
+
+    TimePoint timestamp = { 160000000, 100 };
+    copyingEngine.onChangeInspectionMatrix( consCollectionSchemes, timestamp );
+    engine.onChangeInspectionMatrix( consCollectionSchemes, timestamp );
+
+    for ( int i = 0; i < 1000; i++ )
+    {
+        timestamp += 1;
+        copyingEngine.addNewSignal<double>( s1.signalID, timestamp, i * 0.5 );
+        engine.addNewSignal<double>( s1.signalID, timestamp, i * 0.5 );
+    }
+    copyingEngine.evaluateConditions( timestamp );
+    engine.evaluateConditions( timestamp );
+
+    uint32_t waitTimeMs = 0;
+    auto expectedData = copyingEngine.collectNextDataToSend( timestamp, waitTimeMs );
+    auto collectedData = engine.collectNextDataToSend( timestamp, waitTimeMs );
+    ASSERT_NE( expectedData, nullptr );
+    ASSERT_NE( collectedData, nullptr );
+    ASSERT_EQ( expectedData->signals.size(), 600 );
+    ASSERT_TRUE( collectedData->signals.empty() );
+    EXPECT_EQ( collectedData->triggerTime, expectedData->triggerTime );
+
+    auto checkSlices = [&]() {
+        size_t index = 0;
+        for ( const auto &slice : collectedData->signalSlices )
+        {
+            for ( uint32_t i = 0; i < slice.size; i++ )
+            {
+                ASSERT_LT( index, expectedData->signals.size() );
+                auto sample = slice.getSample( i );
+                const auto &expected = expectedData->signals[index++];
+                EXPECT_EQ( sample.signalID, expected.signalID );
+                EXPECT_EQ( sample.receiveTime, expected.receiveTime );
+                EXPECT_EQ( sample.value.type, expected.value.type );
+                EXPECT_EQ( sample.value.value.doubleVal, expected.value.value.doubleVal );
+            }
+        }
+        EXPECT_EQ( index, expectedData->signals.size() );
+    };
+    checkSlices();
+    ASSERT_GT( collectedData->signalSlices.size(), 1 );
+
+    // Overwriting the samples copies the segments still used by the collected data
+    for ( int i = 0; i < 1000; i++ )
+    {
+        timestamp += 1;
+        engine.addNewSignal<double>( s1.signalID, timestamp, -1.0 );
+    }
+    checkSlices();
+}
+
 TEST_F( CollectionInspectionEngineDoubleTest, IllegalSignalID )
 {
     CollectionInspectionEngine engine;
@@ -971,6 +1139,153 @@ TEST_F( CollectionInspectionEngineDoubleTest, MultipleFixedWindowsOfSameSignalUs
                1 );
 }
 
+TEST_F( CollectionInspectionEngineDoubleTest, FixedWindowsRollOverWithoutNewSamples )
+{
+    CollectionInspectionEngine engine;
+
+    InspectionMatrixSignalCollectionInfo s1{};
+    s1.signalID = 1234;
+    s1.sampleBufferSize = 50;
+    s1.minimumSampleIntervalMs = 0;
+    s1.fixedWindowPeriod = 100;
+    addSignalToCollect( collectionSchemes->conditions[0], s1 );
+    collectionSchemes->conditions[0].condition = getLastAvgWindowBiggerCondition( s1.signalID, 5.0 ).get();
+    collectionSchemes->conditions[0].triggerOnlyOnRisingEdge = true;
+
+    InspectionMatrixSignalCollectionInfo s2{};
+    s2.signalID = 5678;
+    s2.sampleBufferSize = 50;
+    s2.minimumSampleIntervalMs = 0;
+    s2.fixedWindowPeriod = 300;
+    addSignalToCollect( collectionSchemes->conditions[1], s2 );
+    collectionSchemes->conditions[1].condition = getLastAvgWindowBiggerCondition( s2.signalID, 5.0 ).get();
+    collectionSchemes->conditions[1].triggerOnlyOnRisingEdge = true;
+
+    TimePoint timestamp = { 160000000, 100 };
+    engine.onChangeInspectionMatrix( consCollectionSchemes, timestamp );
+
+    engine.addNewSignal<double>( s1.signalID, timestamp, 10 );
+    engine.addNewSignal<double>( s2.signalID, timestamp, 10 );
+    uint32_t waitTimeMs = 0;
+    ASSERT_FALSE( engine.evaluateConditions( timestamp ) );
+    ASSERT_FALSE( engine.evaluateConditions( timestamp + 99 ) );
+
+    // Only the window of the first condition is over, without any new sample
+    ASSERT_TRUE( engine.evaluateConditions( timestamp + 100 ) );
+    auto collectedData = engine.collectNextDataToSend( timestamp + 100, waitTimeMs );
+    ASSERT_NE( collectedData, nullptr );
+    ASSERT_EQ( collectedData->signals.size(), 1 );
+    ASSERT_EQ( collectedData->signals[0].signalID, s1.signalID );
+    ASSERT_EQ( engine.collectNextDataToSend( timestamp + 100, waitTimeMs ), nullptr );
+
+    // The first condition stays true until its next window is over, the window of the second one is still running
+    ASSERT_TRUE( engine.evaluateConditions( timestamp + 199 ) );
+    ASSERT_EQ( engine.collectNextDataToSend( timestamp + 199, waitTimeMs ), nullptr );
+
+    ASSERT_TRUE( engine.evaluateConditions( timestamp + 300 ) );
+    collectedData = engine.collectNextDataToSend( timestamp + 300, waitTimeMs );
+    ASSERT_NE( collectedData, nullptr );
+    ASSERT_EQ( collectedData->signals.size(), 1 );
+    ASSERT_EQ( collectedData->signals[0].signalID, s2.signalID );
+}
+
+TEST_F( CollectionInspectionEngineDoubleTest, StatisticsOfLastFixedWindow )
+{
+    InspectionMatrixSignalCollectionInfo s1{};
+    s1.signalID = 1234;
+    s1.sampleBufferSize = 50;
+    s1.minimumSampleIntervalMs = 0;
+    s1.fixedWindowPeriod = 1000;
+    addSignalToCollect( collectionSchemes->conditions[0], s1 );
+    TimePoint timestamp = { 160000000, 100 };
+
+    // Returns whether LAST_FIXED_WINDOW_x > threshold is true for the samples 2,4,4,4,5,5,7,9 in one window
+    auto isBigger = [&]( WindowFunction function, double threshold ) {
+        CollectionInspectionEngine engine;
+        collectionSchemes->conditions[0].condition =
+            getWindowFunctionBiggerCondition( s1.signalID, function, threshold ).get();
+        engine.onChangeInspectionMatrix( consCollectionSchemes, timestamp );
+        std::vector<double> values = { 2, 4, 4, 4, 5, 5, 7, 9 };
+        for ( size_t i = 0; i < values.size(); i++ )
+        {
+            engine.addNewSignal<double>( s1.signalID, timestamp + static_cast<Timestamp>( i * 100 ), values[i] );
+        }
+        return engine.evaluateConditions( timestamp + 1000 );
+    };
+
+    ASSERT_TRUE( isBigger( WindowFunction::LAST_FIXED_WINDOW_COUNT, 7.5 ) );
+    ASSERT_FALSE( isBigger( WindowFunction::LAST_FIXED_WINDOW_COUNT, 8.5 ) );
+    ASSERT_TRUE( isBigger( WindowFunction::LAST_FIXED_WINDOW_SUM, 39.5 ) );
+    ASSERT_FALSE( isBigger( WindowFunction::LAST_FIXED_WINDOW_SUM, 40.5 ) );
+    ASSERT_TRUE( isBigger( WindowFunction::LAST_FIXED_WINDOW_STDDEV, 1.99 ) );
+    ASSERT_FALSE( isBigger( WindowFunction::LAST_FIXED_WINDOW_STDDEV, 2.01 ) );
+    ASSERT_TRUE( isBigger( WindowFunction::LAST_FIXED_WINDOW_FIRST, 1.5 ) );
+    ASSERT_FALSE( isBigger( WindowFunction::LAST_FIXED_WINDOW_FIRST, 2.5 ) );
+    ASSERT_TRUE( isBigger( WindowFunction::LAST_FIXED_WINDOW_LAST, 8.5 ) );
+    ASSERT_FALSE( isBigger( WindowFunction::LAST_FIXED_WINDOW_LAST, 9.5 ) );
+    // 7 in 700 ms
+    ASSERT_TRUE( isBigger( WindowFunction::LAST_FIXED_WINDOW_RATE_OF_CHANGE, 9.99 ) );
+    ASSERT_FALSE( isBigger( WindowFunction::LAST_FIXED_WINDOW_RATE_OF_CHANGE, 10.01 ) );
+    ASSERT_TRUE( isBigger( WindowFunction::LAST_FIXED_WINDOW_P50, 3.5 ) );
+    ASSERT_FALSE( isBigger( WindowFunction::LAST_FIXED_WINDOW_P50, 5.5 ) );
+    ASSERT_TRUE( isBigger( WindowFunction::LAST_FIXED_WINDOW_P99, 6.5 ) );
+    ASSERT_FALSE( isBigger( WindowFunction::LAST_FIXED_WINDOW_P99, 9.5 ) );
+    // No window before the last one
+    ASSERT_FALSE( isBigger( WindowFunction::PREV_LAST_FIXED_WINDOW_COUNT, -1 ) );
+    ASSERT_FALSE( isBigger( WindowFunction::PREV_LAST_FIXED_WINDOW_P50, -1 ) );
+}
+
+TEST_F( CollectionInspectionEngineDoubleTest, StatisticsOfFixedWindowWithoutSamples )
+{
+    CollectionInspectionEngine engine;
+    InspectionMatrixSignalCollectionInfo s1{};
+    s1.signalID = 1234;
+    s1.sampleBufferSize = 50;
+    s1.minimumSampleIntervalMs = 0;
+    s1.fixedWindowPeriod = 1000;
+    addSignalToCollect( collectionSchemes->conditions[0], s1 );
+    // The condition is LAST_FIXED_WINDOW_COUNT(1234) < 1 i.e. the signal was lost
+    auto condition = getWindowFunctionBiggerCondition( s1.signalID, WindowFunction::LAST_FIXED_WINDOW_COUNT, 1 );
+    condition->nodeType = ExpressionNodeType::OPERATOR_SMALLER;
+    collectionSchemes->conditions[0].condition = condition.get();
+    TimePoint timestamp = { 160000000, 100 };
+    engine.onChangeInspectionMatrix( consCollectionSchemes, timestamp );
+
+    engine.addNewSignal<double>( s1.signalID, timestamp, 1 );
+    ASSERT_FALSE( engine.evaluateConditions( timestamp ) );
+    ASSERT_FALSE( engine.evaluateConditions( timestamp + 1000 ) );
+    ASSERT_TRUE( engine.evaluateConditions( timestamp + 2000 ) );
+}
+
+TEST_F( CollectionInspectionEngineDoubleTest, SlidingWindow )
+{
+    CollectionInspectionEngine engine;
+    InspectionMatrixSignalCollectionInfo s1{};
+    s1.signalID = 1234;
+    s1.sampleBufferSize = 50;
+    s1.minimumSampleIntervalMs = 0;
+    s1.fixedWindowPeriod = 1000;
+    addSignalToCollect( collectionSchemes->conditions[0], s1 );
+    collectionSchemes->conditions[0].condition =
+        getWindowFunctionBiggerCondition( s1.signalID, WindowFunction::SLIDING_WINDOW_MAX, 5 ).get();
+    TimePoint timestamp = { 160000000, 100 };
+    engine.onChangeInspectionMatrix( consCollectionSchemes, timestamp );
+
+    uint32_t waitTimeMs = 0;
+    ASSERT_FALSE( engine.evaluateConditions( timestamp ) );
+    engine.addNewSignal<double>( s1.signalID, timestamp + 100, 9 );
+    ASSERT_TRUE( engine.evaluateConditions( timestamp + 100 ) );
+    ASSERT_NE( engine.collectNextDataToSend( timestamp + 100, waitTimeMs ), nullptr );
+    engine.addNewSignal<double>( s1.signalID, timestamp + 600, 1 );
+    // Unlike a fixed window, the value counts for exactly one period after it arrived, no matter when the window began
+    ASSERT_TRUE( engine.evaluateConditions( timestamp + 1099 ) );
+    ASSERT_NE( engine.collectNextDataToSend( timestamp + 1099, waitTimeMs ), nullptr );
+    // The condition is reevaluated without a new sample, as soon as the sample with 9 is too old
+    ASSERT_FALSE( engine.evaluateConditions( timestamp + 1100 ) );
+    engine.addNewSignal<double>( s1.signalID, timestamp + 1200, 6 );
+    ASSERT_TRUE( engine.evaluateConditions( timestamp + 1200 ) );
+}
+
 TEST_F( CollectionInspectionEngineDoubleTest, Subsampling )
 {
     CollectionInspectionEngine engine;
@@ -1006,6 +1321,55 @@ TEST_F( CollectionInspectionEngineDoubleTest, Subsampling )
     EXPECT_EQ( collectedData->signals[2].value.value.doubleVal, 0.1 );
 }
 
+TEST_F( CollectionInspectionEngineDoubleTest, ReduceCollectedSamples )
+{
+    CollectionInspectionEngine engine;
+    InspectionMatrixSignalCollectionInfo s1{};
+    s1.signalID = 1234;
+    s1.sampleBufferSize = 50;
+    s1.minimumSampleIntervalMs = 0;
+    s1.fixedWindowPeriod = 77777;
+    s1.reduction.type = SignalReductionType::DEADBAND;
+    s1.reduction.tolerance = 1.0;
+    addSignalToCollect( collectionSchemes->conditions[0], s1 );
+    InspectionMatrixSignalCollectionInfo s2{};
+    s2.signalID = 5678;
+    s2.sampleBufferSize = 50;
+    s2.minimumSampleIntervalMs = 0;
+    s2.fixedWindowPeriod = 77777;
+    s2.signalType = SignalType::INT32;
+    addSignalToCollect( collectionSchemes->conditions[0], s2 );
+
+    collectionSchemes->conditions[0].condition = getAlwaysTrueCondition().get();
+
+    TimePoint timestamp = { 160000000, 100 };
+    engine.onChangeInspectionMatrix( consCollectionSchemes, timestamp );
+
+    std::vector<double> values{ 10, 10.5, 12, 11.5, 11.8, 8, 8.1 };
+    for ( uint32_t i = 0; i < values.size(); i++ )
+    {
+        engine.addNewSignal<double>( s1.signalID, timestamp + i, values[i] );
+        engine.addNewSignal<int32_t>( s2.signalID, timestamp + i, static_cast<int32_t>( i ) );
+    }
+
+    engine.evaluateConditions( timestamp + 10 );
+
+    uint32_t waitTimeMs = 0;
+    auto collectedData = engine.collectNextDataToSend( timestamp + 10, waitTimeMs );
+    ASSERT_NE( collectedData, nullptr );
+    // The signal without reduction is collected completely
+    ASSERT_EQ( collectedData->signals.size(), 4 + values.size() );
+    // Collected from the newest to the oldest sample
+    EXPECT_EQ( collectedData->signals[0].value.value.doubleVal, 8.1 );
+    EXPECT_EQ( collectedData->signals[0].receiveTime, ( timestamp + 6 ).systemTimeMs );
+    EXPECT_EQ( collectedData->signals[1].value.value.doubleVal, 8 );
+    EXPECT_EQ( collectedData->signals[2].value.value.doubleVal, 12 );
+    EXPECT_EQ( collectedData->signals[3].value.value.doubleVal, 10 );
+    EXPECT_EQ( collectedData->signals[3].receiveTime, timestamp.systemTimeMs );
+    EXPECT_EQ( collectedData->signals[4].signalID, s2.signalID );
+    EXPECT_EQ( collectedData->signals[4].value.value.int32Val, 6 );
+}
+
 // Only valid when sendDataOnlyOncePerCondition is defined true
 TEST_F( CollectionInspectionEngineDoubleTest, SendoutEverySignalOnlyOnce )
 {
@@ -1045,6 +1409,46 @@ TEST_F( CollectionInspectionEngineDoubleTest, SendoutEverySignalOnlyOnce )
     EXPECT_EQ( res3->signals.size(), 1 );
 }
 
+TEST_F( CollectionInspectionEngineDoubleTest, SendoutEverySignalOnlyOnceForEachCondition )
+{
+    CollectionInspectionEngine engine;
+    InspectionMatrixSignalCollectionInfo s1{};
+    s1.signalID = 1234;
+    s1.sampleBufferSize = 50;
+    s1.minimumSampleIntervalMs = 0;
+    s1.fixedWindowPeriod = 77777;
+    // Both conditions share the same history buffer
+    addSignalToCollect( collectionSchemes->conditions[0], s1 );
+    addSignalToCollect( collectionSchemes->conditions[1], s1 );
+    collectionSchemes->conditions[0].condition = getAlwaysTrueCondition().get();
+    collectionSchemes->conditions[1].condition = getAlwaysTrueCondition().get();
+
+    TimePoint timestamp = { 160000000, 100 };
+    engine.onChangeInspectionMatrix( consCollectionSchemes, timestamp );
+
+    engine.addNewSignal<double>( s1.signalID, timestamp, 0.1 );
+    engine.addNewSignal<double>( s1.signalID, timestamp + 1, 0.2 );
+    engine.evaluateConditions( timestamp + 1 );
+    uint32_t waitTimeMs = 0;
+    auto res1 = engine.collectNextDataToSend( timestamp + 1, waitTimeMs );
+    ASSERT_NE( res1, nullptr );
+    ASSERT_EQ( res1->signals.size(), 2 );
+    auto res2 = engine.collectNextDataToSend( timestamp + 1, waitTimeMs );
+    ASSERT_NE( res2, nullptr );
+    ASSERT_EQ( res2->signals.size(), 2 );
+
+    engine.addNewSignal<double>( s1.signalID, timestamp + 2, 0.3 );
+    engine.evaluateConditions( timestamp + 2 );
+    res1 = engine.collectNextDataToSend( timestamp + 2, waitTimeMs );
+    ASSERT_NE( res1, nullptr );
+    ASSERT_EQ( res1->signals.size(), 1 );
+    EXPECT_EQ( res1->signals[0].value.value.doubleVal, 0.3 );
+    res2 = engine.collectNextDataToSend( timestamp + 2, waitTimeMs );
+    ASSERT_NE( res2, nullptr );
+    ASSERT_EQ( res2->signals.size(), 1 );
+    EXPECT_EQ( res2->signals[0].value.value.doubleVal, 0.3 );
+}
+
 TYPED_TEST( CollectionInspectionEngineTest, HearbeatInterval )
 {
     CollectionInspectionEngine engine;
@@ -1367,6 +1771,40 @@ TEST_F( CollectionInspectionEngineDoubleTest, MoreCollectionSchemesThanSupported
     engine.collectNextDataToSend( timestamp, waitTimeMs );
 }
 
+TEST_F( CollectionInspectionEngineDoubleTest, ThousandsOfConditions )
+{
+    CollectionInspectionEngine engine;
+    InspectionMatrixSignalCollectionInfo s1{};
+    s1.signalID = 1234;
+    s1.sampleBufferSize = 10;
+    s1.minimumSampleIntervalMs = 0;
+    s1.fixedWindowPeriod = 0;
+    const uint32_t numberOfConditions = 3000;
+    ASSERT_LE( numberOfConditions, MAX_NUMBER_OF_ACTIVE_CONDITION );
+    collectionSchemes->conditions.resize( numberOfConditions );
+    for ( uint32_t i = 0; i < numberOfConditions; i++ )
+    {
+        // function is: SignalID(1234) > i
+        auto condition = getLastAvgWindowBiggerCondition( s1.signalID, static_cast<double>( i ) );
+        condition->left->nodeType = ExpressionNodeType::SIGNAL;
+        collectionSchemes->conditions[i].condition = condition.get();
+        addSignalToCollect( collectionSchemes->conditions[i], s1 );
+    }
+
+    TimePoint timestamp = { 160000000, 100 };
+    engine.onChangeInspectionMatrix( consCollectionSchemes, timestamp );
+
+    engine.addNewSignal<double>( s1.signalID, timestamp, 1999.5 );
+    engine.evaluateConditions( timestamp );
+    uint32_t waitTimeMs = 0;
+    uint32_t triggered = 0;
+    while ( engine.collectNextDataToSend( timestamp, waitTimeMs ) != nullptr )
+    {
+        triggered++;
+    }
+    ASSERT_EQ( triggered, 2000 );
+}
+
 TYPED_TEST( CollectionInspectionEngineTest, CollectWithAfterTime )
 {
     CollectionInspectionEngine engine;
@@ -1673,6 +2111,63 @@ TEST_F( CollectionInspectionEngineDoubleTest, TwoSignalsRatioCondition )
     ASSERT_NE( engine.collectNextDataToSend( timestamp, waitTimeMs ), nullptr );
 }
 
+TEST_F( CollectionInspectionEngineDoubleTest, SegmentsWithoutChangedInputsKeepTheirValue )
+{
+    CollectionInspectionEngine engine;
+    InspectionMatrixSignalCollectionInfo s1{};
+    s1.signalID = 123;
+    s1.sampleBufferSize = 50;
+    s1.minimumSampleIntervalMs = 0;
+    s1.fixedWindowPeriod = 100;
+    InspectionMatrixSignalCollectionInfo s2{};
+    s2.signalID = 456;
+    s2.sampleBufferSize = 50;
+    s2.minimumSampleIntervalMs = 0;
+    s2.fixedWindowPeriod = 0;
+    addSignalToCollect( collectionSchemes->conditions[0], s1 );
+    addSignalToCollect( collectionSchemes->conditions[0], s2 );
+
+    // function is: (LAST_FIXED_WINDOW_AVG(SignalID(123)) > 10.0) && (SignalID(456) > 5.0)
+    auto condition = getTwoSignalsBiggerCondition( s1.signalID, 10.0, s2.signalID, 5.0 );
+    expressionNodes.push_back( std::make_shared<ExpressionNode>() );
+    auto function1 = expressionNodes.back();
+    function1->nodeType = ExpressionNodeType::WINDOWFUNCTION;
+    function1->signalID = s1.signalID;
+    function1->function.windowFunction = WindowFunction::LAST_FIXED_WINDOW_AVG;
+    condition->left->left = function1.get();
+    collectionSchemes->conditions[0].condition = condition.get();
+
+    TimePoint timestamp = { 160000000, 100 };
+    engine.onChangeInspectionMatrix( consCollectionSchemes, timestamp );
+
+    // No complete window yet
+    uint32_t waitTimeMs = 0;
+    engine.addNewSignal<double>( s1.signalID, timestamp, 20.0 );
+    engine.addNewSignal<double>( s2.signalID, timestamp, 1.0 );
+    engine.evaluateConditions( timestamp );
+    ASSERT_EQ( engine.collectNextDataToSend( timestamp, waitTimeMs ), nullptr );
+
+    // The window rolls over without a new sample, its average is above the threshold
+    engine.evaluateConditions( timestamp + 100 );
+    ASSERT_EQ( engine.collectNextDataToSend( timestamp + 100, waitTimeMs ), nullptr );
+
+    // Only the second signal changes, the value of the window segment is taken from the last evaluation
+    engine.addNewSignal<double>( s2.signalID, timestamp + 101, 10.0 );
+    engine.evaluateConditions( timestamp + 101 );
+    ASSERT_NE( engine.collectNextDataToSend( timestamp + 101, waitTimeMs ), nullptr );
+
+    // The next window has no samples, so the window segment fails until a new window is complete
+    engine.evaluateConditions( timestamp + 200 );
+    ASSERT_EQ( engine.collectNextDataToSend( timestamp + 200, waitTimeMs ), nullptr );
+    engine.addNewSignal<double>( s2.signalID, timestamp + 201, 20.0 );
+    engine.evaluateConditions( timestamp + 201 );
+    ASSERT_EQ( engine.collectNextDataToSend( timestamp + 201, waitTimeMs ), nullptr );
+
+    engine.addNewSignal<double>( s1.signalID, timestamp + 250, 30.0 );
+    engine.evaluateConditions( timestamp + 300 );
+    ASSERT_NE( engine.collectNextDataToSend( timestamp + 300, waitTimeMs ), nullptr );
+}
+
 TEST_F( CollectionInspectionEngineDoubleTest, UnknownExpressionNode )
 {
     CollectionInspectionEngine engine;
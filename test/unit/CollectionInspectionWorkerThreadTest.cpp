@@ -2,11 +2,15 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "CollectionInspectionWorkerThread.h"
+#include "CANDataConsumer.h"
 #include "CANDataTypes.h"
+#include "CANDecoder.h"
 #include "Clock.h"
 #include "ClockHandler.h"
 #include "CollectionInspectionAPITypes.h"
 #include "ICollectionScheme.h"
+#include "IDecoderDictionary.h"
+#include "MessageTypes.h"
 #include "OBDDataTypes.h"
 #include "SignalTypes.h"
 #include "TimeTypes.h"
@@ -15,6 +19,7 @@
 #include <chrono>
 #include <cstdint>
 #include <gtest/gtest.h>
+#include <map>
 #include <memory>
 #include <string>
 #include <thread>
@@ -415,6 +420,211 @@ TEST_F( CollectionInspectionWorkerThreadTest, ConsumeActiveDTCsCollectionSchemeH
     inspectionWorker.stop();
 }
 
+TEST_F( CollectionInspectionWorkerThreadTest, ShardInspectionMatrix )
+{
+    InspectionMatrixSignalCollectionInfo s1{};
+    s1.signalID = 1111;
+    s1.sampleBufferSize = 10;
+    InspectionMatrixSignalCollectionInfo s2 = s1;
+    s2.signalID = 2222;
+    InspectionMatrixCanFrameCollectionInfo c1{};
+    c1.frameID = 0x380;
+    c1.channelID = 3;
+    c1.sampleBufferSize = 10;
+    collectionSchemes->conditions[0].signals = { s1, s2 };
+    collectionSchemes->conditions[1].signals = { s1 };
+    collectionSchemes->conditions[2].canFrames = { c1 };
+    collectionSchemes->conditions[3].signals = { s2 };
+    collectionSchemes->conditions[2].condition = getAlwaysTrueCondition().get();
+    collectionSchemes->conditions[3].condition = getAlwaysTrueCondition().get();
+
+    auto shards = CollectionInspectionWorkerThread::shardInspectionMatrix( consCollectionSchemes, 2 );
+    ASSERT_EQ( shards.size(), 2 );
+    // Loads after each assignment: 3/0, 3/2, 3/4 and 5/4
+    ASSERT_EQ( shards[0]->conditions.size(), 2 );
+    ASSERT_EQ( shards[1]->conditions.size(), 2 );
+    ASSERT_EQ( shards[0]->conditions[0].condition, collectionSchemes->conditions[0].condition );
+    ASSERT_EQ( shards[0]->conditions[1].condition, collectionSchemes->conditions[3].condition );
+    ASSERT_EQ( shards[1]->conditions[0].condition, collectionSchemes->conditions[1].condition );
+    ASSERT_EQ( shards[1]->conditions[1].condition, collectionSchemes->conditions[2].condition );
+    ASSERT_EQ( shards[1]->conditions[1].canFrames.size(), 1 );
+    // Each shard keeps the original matrix with the expression nodes alive
+    ASSERT_EQ( consCollectionSchemes.use_count(), 4 );
+
+    // A single shard gets all conditions, more shards than conditions leave some empty
+    shards = CollectionInspectionWorkerThread::shardInspectionMatrix( consCollectionSchemes, 1 );
+    ASSERT_EQ( shards.size(), 1 );
+    ASSERT_EQ( shards[0]->conditions.size(), 4 );
+    shards = CollectionInspectionWorkerThread::shardInspectionMatrix( consCollectionSchemes, 6 );
+    ASSERT_EQ( shards.size(), 6 );
+    ASSERT_EQ( shards[4]->conditions.size(), 0 );
+}
+
+TEST_F( CollectionInspectionWorkerThreadTest, ShardedConditionsTrigger )
+{
+    outputCollectedData = std::make_shared<CollectedDataReadyToPublish>( 10 );
+    CollectionInspectionWorkerThread worker;
+    ASSERT_TRUE( worker.init( signalBufferPtr, outputCollectedData, 1000, 3 ) );
+    ASSERT_TRUE( worker.start() );
+    InspectionMatrixSignalCollectionInfo s1{};
+    s1.signalID = 1111;
+    s1.sampleBufferSize = 10;
+    s1.signalType = SignalType::DOUBLE;
+    InspectionMatrixSignalCollectionInfo s2 = s1;
+    s2.signalID = 2222;
+    InspectionMatrixSignalCollectionInfo s3 = s1;
+    s3.signalID = 3333;
+    collectionSchemes->conditions[0].signals = { s1 };
+    collectionSchemes->conditions[0].condition = getSignalsBiggerCondition( s1.signalID, 1 ).get();
+    collectionSchemes->conditions[1].signals = { s2 };
+    collectionSchemes->conditions[1].condition = getSignalsBiggerCondition( s2.signalID, 1 ).get();
+    // Both signals are also used by the first two conditions, which end up in other shards
+    collectionSchemes->conditions[2].signals = { s1, s2 };
+    collectionSchemes->conditions[2].condition = getSignalsBiggerCondition( s1.signalID, 10 ).get();
+    collectionSchemes->conditions[3].signals = { s3 };
+    collectionSchemes->conditions[3].condition = getAlwaysFalseCondition().get();
+    for ( size_t i = 0; i < collectionSchemes->conditions.size(); i++ )
+    {
+        collectionSchemes->conditions[i].triggerOnlyOnRisingEdge = true;
+        collectionSchemes->conditions[i].metadata.collectionSchemeID = "scheme" + std::to_string( i );
+    }
+    worker.onChangeInspectionMatrix( consCollectionSchemes );
+    Timestamp timestamp = fClock->systemTimeSinceEpochMs();
+
+    CollectedSignalsGroup collectedSignalsGroup;
+    collectedSignalsGroup.push_back( CollectedSignal( s1.signalID, timestamp, 0.5 ) );
+    collectedSignalsGroup.push_back( CollectedSignal( s2.signalID, timestamp, 0.5 ) );
+    collectedSignalsGroup.push_back( CollectedSignal( s3.signalID, timestamp, 0.5 ) );
+    ASSERT_TRUE( signalBufferPtr->push( CollectedDataFrame( collectedSignalsGroup ) ) );
+    collectedSignalsGroup.clear();
+    collectedSignalsGroup.push_back( CollectedSignal( s1.signalID, timestamp + 1, 2 ) );
+    ASSERT_TRUE( signalBufferPtr->push( CollectedDataFrame( collectedSignalsGroup ) ) );
+    collectedSignalsGroup.clear();
+    collectedSignalsGroup.push_back( CollectedSignal( s2.signalID, timestamp + 2, 3 ) );
+    ASSERT_TRUE( signalBufferPtr->push( CollectedDataFrame( collectedSignalsGroup ) ) );
+    collectedSignalsGroup.clear();
+    collectedSignalsGroup.push_back( CollectedSignal( s1.signalID, timestamp + 3, 20 ) );
+    ASSERT_TRUE( signalBufferPtr->push( CollectedDataFrame( collectedSignalsGroup ) ) );
+    worker.onNewDataAvailable();
+
+    // The order of the data from different shards is not defined
+    std::map<std::string, std::shared_ptr<const TriggeredCollectionSchemeData>> collected;
+    std::shared_ptr<const TriggeredCollectionSchemeData> collectedData;
+    for ( int i = 0; i < 3; i++ )
+    {
+        WAIT_ASSERT_TRUE( outputCollectedData->pop( collectedData ) );
+        collected[collectedData->metadata.collectionSchemeID] = collectedData;
+    }
+    ASSERT_EQ( collected.size(), 3 );
+    ASSERT_EQ( collected["scheme0"]->signals.size(), 2 );
+    ASSERT_EQ( collected["scheme0"]->signals[0].value.value.doubleVal, 2 );
+    ASSERT_EQ( collected["scheme1"]->signals.size(), 2 );
+    ASSERT_EQ( collected["scheme1"]->signals[0].value.value.doubleVal, 3 );
+    // The shard of this condition got the frames of both signals
+    ASSERT_EQ( collected["scheme2"]->signals.size(), 5 );
+    ASSERT_EQ( collected["scheme2"]->signals[0].value.value.doubleVal, 20 );
+    ASSERT_EQ( collected["scheme2"]->signals[3].value.value.doubleVal, 3 );
+
+    std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+    ASSERT_FALSE( outputCollectedData->pop( collectedData ) );
+    ASSERT_TRUE( worker.isAlive() );
+    ASSERT_TRUE( worker.stop() );
+}
+
+TEST_F( CollectionInspectionWorkerThreadTest, FullShardBufferDoesNotDropFrames )
+{
+    outputCollectedData = std::make_shared<CollectedDataReadyToPublish>( 10 );
+    CollectionInspectionWorkerThread worker;
+    // Much smaller than the frames dispatched before the shards are woken up
+    ASSERT_TRUE( worker.init( signalBufferPtr, outputCollectedData, 1000, 2, false, 2 ) );
+    ASSERT_TRUE( worker.start() );
+    InspectionMatrixSignalCollectionInfo s1{};
+    s1.signalID = 1111;
+    s1.sampleBufferSize = 1000;
+    s1.signalType = SignalType::DOUBLE;
+    // The same condition in both shards
+    collectionSchemes->conditions.resize( 2 );
+    for ( size_t i = 0; i < collectionSchemes->conditions.size(); i++ )
+    {
+        collectionSchemes->conditions[i].signals = { s1 };
+        collectionSchemes->conditions[i].condition = getSignalsBiggerCondition( s1.signalID, 10 ).get();
+        collectionSchemes->conditions[i].triggerOnlyOnRisingEdge = true;
+        collectionSchemes->conditions[i].metadata.collectionSchemeID = "scheme" + std::to_string( i );
+    }
+    worker.onChangeInspectionMatrix( consCollectionSchemes );
+
+    Timestamp timestamp = fClock->systemTimeSinceEpochMs() - 1000;
+    const size_t numberOfFrames = 500;
+    for ( size_t i = 0; i < numberOfFrames; i++ )
+    {
+        CollectedSignalsGroup collectedSignalsGroup;
+        collectedSignalsGroup.push_back(
+            CollectedSignal( s1.signalID, timestamp + i, ( i == ( numberOfFrames - 1 ) ) ? 20.0 : 0.0 ) );
+        ASSERT_TRUE( signalBufferPtr->push( CollectedDataFrame( collectedSignalsGroup ) ) );
+    }
+    worker.onNewDataAvailable();
+
+    // Both shards got every frame
+    std::shared_ptr<const TriggeredCollectionSchemeData> collectedData;
+    for ( int i = 0; i < 2; i++ )
+    {
+        WAIT_ASSERT_TRUE( outputCollectedData->pop( collectedData ) );
+        ASSERT_EQ( collectedData->signals.size(), numberOfFrames );
+        ASSERT_EQ( collectedData->signals[0].value.value.doubleVal, 20 );
+    }
+    ASSERT_TRUE( worker.stop() );
+}
+
+TEST_F( CollectionInspectionWorkerThreadTest, SpikeWithinOneCANBatchTriggers )
+{
+    CollectionInspectionWorkerThread worker;
+    ASSERT_TRUE( worker.init( signalBufferPtr, outputCollectedData, 1000 ) );
+    ASSERT_TRUE( worker.start() );
+    InspectionMatrixSignalCollectionInfo s1{};
+    s1.signalID = 1111;
+    s1.sampleBufferSize = 10;
+    s1.signalType = SignalType::DOUBLE;
+    collectionSchemes->conditions.resize( 1 );
+    collectionSchemes->conditions[0].signals = { s1 };
+    collectionSchemes->conditions[0].condition = getSignalsBiggerCondition( s1.signalID, 10 ).get();
+    collectionSchemes->conditions[0].triggerOnlyOnRisingEdge = true;
+    worker.onChangeInspectionMatrix( consCollectionSchemes );
+
+    auto dictionary = std::make_shared<CANDecoderDictionary>();
+    CANMessageDecoderMethod decoderMethod;
+    decoderMethod.collectType = CANMessageCollectType::DECODE;
+    decoderMethod.format.mMessageID = 0x100;
+    decoderMethod.format.mSizeInBytes = 1;
+    CANSignalFormat signalFormat;
+    signalFormat.mSignalID = s1.signalID;
+    signalFormat.mSizeInBits = 8;
+    signalFormat.mFactor = 1.0;
+    decoderMethod.format.mSignals.push_back( signalFormat );
+    dictionary->canMessageDecoderMethod[0][0x100] = decoderMethod;
+    dictionary->signalIDsToCollect.emplace( s1.signalID );
+    CANDecoder::compileDictionary( *dictionary );
+    std::shared_ptr<const CANDecoderDictionary> constDictionary = dictionary;
+
+    // The signal spikes above the threshold and reverts within the same batch of received frames
+    std::array<uint8_t, 3> values{ 0, 20, 0 };
+    Timestamp timestamp = fClock->systemTimeSinceEpochMs();
+    std::vector<CANFrameInfo> frames;
+    for ( size_t i = 0; i < values.size(); i++ )
+    {
+        frames.push_back( CANFrameInfo{ 0x100, &values[i], 1, timestamp + i } );
+    }
+    CANDataConsumer consumer( signalBufferPtr );
+    consumer.processMessages( 0, constDictionary, frames.data(), frames.size() );
+    worker.onNewDataAvailable();
+
+    std::shared_ptr<const TriggeredCollectionSchemeData> collectedData;
+    WAIT_ASSERT_TRUE( outputCollectedData->pop( collectedData ) );
+    ASSERT_EQ( collectedData->signals.size(), 2 );
+    ASSERT_EQ( collectedData->signals[0].receiveTime, timestamp + 1 );
+    ASSERT_EQ( collectedData->signals[0].value.value.doubleVal, 20 );
+    ASSERT_TRUE( worker.stop() );
+}
+
 TEST_F( CollectionInspectionWorkerThreadTest, StartWithoutInit )
 {
     CollectionInspectionWorkerThread worker;
@@ -9,6 +9,7 @@
 #include "IConnectionTypes.h"
 #include "ISender.h"
 #include "OBDDataTypes.h"
+#include "PayloadCompression.h"
 #include "PayloadManagerMock.h"
 #include "SenderMock.h"
 #include "SignalTypes.h"
@@ -20,6 +21,8 @@
 #include <gtest/gtest.h>
 #include <json/json.h>
 #include <memory>
+#include <numeric>
+#include <random>
 #include <snappy.h>
 #include <string>
 #include <vector>
@@ -44,6 +47,7 @@ namespace IoTFleetWise
 {
 
 using ::testing::_;
+using ::testing::AnyNumber;
 using ::testing::DoAll;
 using ::testing::Gt;
 using ::testing::Invoke;
@@ -74,7 +78,14 @@ public:
         mIonWriter = std::make_shared<StrictMock<Testing::DataSenderIonWriterMock>>();
         mActiveCollectionSchemes = std::make_shared<ActiveCollectionSchemes>();
 #endif
+        EXPECT_CALL( *mMqttSender, getMaxSendSize() ).Times( AnyNumber() ).WillRepeatedly( Return( 128 * 1024 ) );
 
+        createDataSenderManager();
+    }
+
+    void
+    createDataSenderManager()
+    {
         mDataSenderManager = std::make_unique<DataSenderManager>( mMqttSender,
                                                                   mPayloadManager,
                                                                   mCANIDTranslator,
@@ -858,6 +869,200 @@ TEST_F( DataSenderManagerTest, ProcessSingleSignalWithCompression )
     ASSERT_EQ( vehicleData.captured_signals()[0].double_value(), signal1.value.value.doubleVal );
 }
 
+#ifdef FWE_FEATURE_ZSTD_COMPRESSION
+TEST_F( DataSenderManagerTest, ProcessSignalsWithDifferentCodecs )
+{
+    mTriggeredCollectionSchemeData->signals.emplace_back( 1234, 789654, 40.5, SignalType::DOUBLE );
+    mTriggeredCollectionSchemeData->metadata.compress = true;
+    CompressionOptions zstdOptions;
+    zstdOptions.codec = CompressionCodec::ZSTD;
+    zstdOptions.level = 19;
+    zstdOptions.dictionary = std::make_shared<const std::string>( "raw content dictionary with signal values" );
+    auto zstdTrigger = std::make_shared<TriggeredCollectionSchemeData>( *mTriggeredCollectionSchemeData );
+    zstdTrigger->metadata.compressionOptions = zstdOptions;
+
+    EXPECT_CALL( *mMqttSender, mockedSendBuffer( _, Gt( 0 ), _ ) )
+        .Times( 3 )
+        .WillRepeatedly( Return( ConnectivityError::Success ) );
+
+    processCollectedData( mTriggeredCollectionSchemeData );
+    processCollectedData( zstdTrigger );
+    processCollectedData( mTriggeredCollectionSchemeData );
+
+    auto sentBufferData = mMqttSender->getSentBufferData();
+    ASSERT_EQ( sentBufferData.size(), 3 );
+    auto snappyDecompressor = createPayloadCompressor( CompressionOptions() );
+    auto zstdDecompressor = createPayloadCompressor( zstdOptions );
+    for ( size_t i = 0; i < sentBufferData.size(); i++ )
+    {
+        const auto &sent = sentBufferData[i];
+        auto *decompressor = ( i == 1 ) ? zstdDecompressor.get() : snappyDecompressor.get();
+        ASSERT_EQ( sent.collectionSchemeParams.compressionOptions.codec,
+                   ( i == 1 ) ? CompressionCodec::ZSTD : CompressionCodec::SNAPPY );
+        std::string uncompressedData;
+        ASSERT_TRUE( decompressor->decompress( sent.data.c_str(), sent.data.size(), uncompressedData ) );
+        Schemas::VehicleDataMsg::VehicleData vehicleData;
+        ASSERT_TRUE( vehicleData.ParseFromString( uncompressedData ) );
+        ASSERT_EQ( vehicleData.captured_signals_size(), 1 );
+        ASSERT_EQ( vehicleData.captured_signals()[0].signal_id(), 1234 );
+    }
+}
+#endif
+
+TEST_F( DataSenderManagerTest, SplitPayloadsBySize )
+{
+    const size_t maxSendSize = 2000;
+    mTransmitThreshold = 0;
+    createDataSenderManager();
+    EXPECT_CALL( *mMqttSender, getMaxSendSize() ).WillRepeatedly( Return( maxSendSize ) );
+    for ( int i = 0; i < 1000; i++ )
+    {
+        mTriggeredCollectionSchemeData->signals.emplace_back( i, 789654 + i, i * 0.25, SignalType::DOUBLE );
+    }
+    std::array<uint8_t, MAX_CAN_FRAME_BYTE_SIZE> canBuf = { 0xDE, 0xAD, 0xBE, 0xEF, 0x0, 0x0, 0x0, 0x0 };
+    for ( int i = 0; i < 100; i++ )
+    {
+        mTriggeredCollectionSchemeData->canFrames.emplace_back( 0x380, mCanChannelID, 789654, canBuf, 8 );
+    }
+    EXPECT_CALL( *mMqttSender, mockedSendBuffer( _, Gt( 0 ), _ ) )
+        .WillRepeatedly( Return( ConnectivityError::Success ) );
+
+    processCollectedData( mTriggeredCollectionSchemeData );
+
+    auto sentBufferData = mMqttSender->getSentBufferData();
+    ASSERT_GT( sentBufferData.size(), 1 );
+    int signals = 0;
+    int canFrames = 0;
+    for ( size_t i = 0; i < sentBufferData.size(); i++ )
+    {
+        ASSERT_LE( sentBufferData[i].data.size(), maxSendSize );
+        if ( i < ( sentBufferData.size() - 1 ) )
+        {
+            // Only the space for the margin and a few messages is left
+            ASSERT_GT( sentBufferData[i].data.size(), maxSendSize - 150 );
+        }
+        Schemas::VehicleDataMsg::VehicleData vehicleData;
+        ASSERT_TRUE( vehicleData.ParseFromString( sentBufferData[i].data ) );
+        signals += vehicleData.captured_signals_size();
+        canFrames += vehicleData.can_frames_size();
+    }
+    ASSERT_EQ( signals, 1000 );
+    ASSERT_EQ( canFrames, 100 );
+}
+
+TEST_F( DataSenderManagerTest, SplitCompressedPayloadsBySize )
+{
+    const size_t maxSendSize = 2000;
+    mTransmitThreshold = 0;
+    createDataSenderManager();
+    EXPECT_CALL( *mMqttSender, getMaxSendSize() ).WillRepeatedly( Return( maxSendSize ) );
+    for ( int i = 0; i < 5000; i++ )
+    {
+        mTriggeredCollectionSchemeData->signals.emplace_back( 1234, 789654 + i, ( i % 10 ) * 0.5, SignalType::DOUBLE );
+    }
+    mTriggeredCollectionSchemeData->metadata.compress = true;
+    EXPECT_CALL( *mMqttSender, mockedSendBuffer( _, Gt( 0 ), _ ) )
+        .WillRepeatedly( Return( ConnectivityError::Success ) );
+
+    processCollectedData( mTriggeredCollectionSchemeData );
+
+    auto sentBufferData = mMqttSender->getSentBufferData();
+    ASSERT_GT( sentBufferData.size(), 2 );
+    std::vector<int> signals;
+    for ( const auto &sent : sentBufferData )
+    {
+        ASSERT_LE( sent.data.size(), maxSendSize );
+        std::string uncompressedData;
+        ASSERT_TRUE( snappy::Uncompress( sent.data.c_str(), sent.data.size(), &uncompressedData ) );
+        Schemas::VehicleDataMsg::VehicleData vehicleData;
+        ASSERT_TRUE( vehicleData.ParseFromString( uncompressedData ) );
+        signals.push_back( vehicleData.captured_signals_size() );
+    }
+    ASSERT_EQ( std::accumulate( signals.begin(), signals.end(), 0 ), 5000 );
+    // After the first payload the compression ratio is known, so the following payloads are not filled less
+    ASSERT_GE( signals[signals.size() - 2], signals[0] );
+}
+
+TEST_F( DataSenderManagerTest, SplitCompressedPayloadsExceedingTheEstimatedRatio )
+{
+    const size_t maxSendSize = 2000;
+    mTransmitThreshold = 0;
+    createDataSenderManager();
+    EXPECT_CALL( *mMqttSender, getMaxSendSize() ).WillRepeatedly( Return( maxSendSize ) );
+    // The ratio learned from the repetitive signals is far too optimistic for the random ones that follow
+    for ( int i = 0; i < 3000; i++ )
+    {
+        mTriggeredCollectionSchemeData->signals.emplace_back( 1234, 789654, 0.5, SignalType::DOUBLE );
+    }
+    std::mt19937 generator( 11 );
+    std::uniform_int_distribution<uint32_t> idDistribution;
+    std::uniform_real_distribution<double> valueDistribution( -1e6, 1e6 );
+    for ( int i = 0; i < 3000; i++ )
+    {
+        mTriggeredCollectionSchemeData->signals.emplace_back( idDistribution( generator ),
+                                                              789654 + idDistribution( generator ) % 100000,
+                                                              valueDistribution( generator ),
+                                                              SignalType::DOUBLE );
+    }
+    mTriggeredCollectionSchemeData->metadata.compress = true;
+    EXPECT_CALL( *mMqttSender, mockedSendBuffer( _, Gt( 0 ), _ ) )
+        .WillRepeatedly( Return( ConnectivityError::Success ) );
+
+    processCollectedData( mTriggeredCollectionSchemeData );
+
+    auto sentBufferData = mMqttSender->getSentBufferData();
+    int signals = 0;
+    for ( const auto &sent : sentBufferData )
+    {
+        ASSERT_LE( sent.data.size(), maxSendSize );
+        std::string uncompressedData;
+        ASSERT_TRUE( snappy::Uncompress( sent.data.c_str(), sent.data.size(), &uncompressedData ) );
+        Schemas::VehicleDataMsg::VehicleData vehicleData;
+        ASSERT_TRUE( vehicleData.ParseFromString( uncompressedData ) );
+        signals += vehicleData.captured_signals_size();
+    }
+    ASSERT_EQ( signals, 6000 );
+}
+
+TEST_F( DataSenderManagerTest, DropSingleMessageExceedingMaxSendSize )
+{
+    const size_t maxSendSize = 2000;
+    mTransmitThreshold = 0;
+    createDataSenderManager();
+    EXPECT_CALL( *mMqttSender, getMaxSendSize() ).WillRepeatedly( Return( maxSendSize ) );
+    for ( int i = 0; i < 10; i++ )
+    {
+        mTriggeredCollectionSchemeData->signals.emplace_back( i, 789654 + i, i * 0.25, SignalType::DOUBLE );
+    }
+    DTCInfo dtcInfo;
+    dtcInfo.mSID = SID::STORED_DTC;
+    dtcInfo.receiveTime = 789654;
+    dtcInfo.mDTCCodes.emplace_back( "P0143" );
+    dtcInfo.mDTCCodes.emplace_back( std::string( maxSendSize, 'X' ) );
+    mTriggeredCollectionSchemeData->mDTCInfo = dtcInfo;
+    EXPECT_CALL( *mMqttSender, mockedSendBuffer( _, Gt( 0 ), _ ) )
+        .WillRepeatedly( Return( ConnectivityError::Success ) );
+
+    processCollectedData( mTriggeredCollectionSchemeData );
+
+    auto sentBufferData = mMqttSender->getSentBufferData();
+    int signals = 0;
+    std::vector<std::string> dtcCodes;
+    for ( const auto &sent : sentBufferData )
+    {
+        ASSERT_LE( sent.data.size(), maxSendSize );
+        Schemas::VehicleDataMsg::VehicleData vehicleData;
+        ASSERT_TRUE( vehicleData.ParseFromString( sent.data ) );
+        signals += vehicleData.captured_signals_size();
+        for ( const auto &code : vehicleData.dtc_data().active_dtc_codes() )
+        {
+            dtcCodes.push_back( code );
+        }
+    }
+    ASSERT_EQ( signals, 10 );
+    ASSERT_EQ( dtcCodes, std::vector<std::string>{ "P0143" } );
+}
+
 TEST_F( DataSenderManagerTest, PersistencySingleFile )
 {
     Json::Value files( Json::arrayValue );
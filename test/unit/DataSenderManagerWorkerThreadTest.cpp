@@ -8,14 +8,19 @@
 #include "CollectionInspectionAPITypes.h"
 #include "ConnectivityModuleMock.h"
 #include "DataSenderManagerMock.h"
+#include "PayloadManagerMock.h"
+#include "SenderMock.h"
 #include "SignalTypes.h"
 #include "Testing.h"
 #include "TimeTypes.h"
 #include "WaitUntil.h"
+#include "vehicle_data.pb.h"
 #include <cstdint>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <memory>
+#include <snappy.h>
+#include <string>
 #include <vector>
 
 #ifdef FWE_FEATURE_VISION_SYSTEM_DATA
@@ -30,6 +35,7 @@ namespace IoTFleetWise
 
 using ::testing::_;
 using ::testing::InvokeArgument;
+using ::testing::NiceMock;
 using ::testing::Return;
 using ::testing::Sequence;
 using ::testing::StrictMock;
@@ -168,6 +174,105 @@ TEST_F( DataSenderManagerWorkerThreadTest, ProcessMultipleTriggers )
     ASSERT_EQ( processedSignal.value.value.doubleVal, 99.5 );
 }
 
+TEST_F( DataSenderManagerWorkerThreadTest, SerializeTriggersInParallel )
+{
+    auto sender = std::make_shared<NiceMock<Testing::SenderMock>>();
+    ON_CALL( *sender, getMaxSendSize() ).WillByDefault( Return( 128 * 1024 ) );
+    ON_CALL( *sender, mockedSendBuffer( _, _, _ ) ).WillByDefault( Return( ConnectivityError::Success ) );
+    auto payloadManager = std::make_shared<NiceMock<Testing::PayloadManagerMock>>();
+    ON_CALL( *payloadManager, retrievePayloadMetadata( _ ) ).WillByDefault( Return( ErrorCode::EMPTY ) );
+    auto dataSenderManager = std::make_shared<DataSenderManager>( sender,
+                                                                  payloadManager,
+                                                                  canIDTranslator,
+                                                                  0
+#ifdef FWE_FEATURE_VISION_SYSTEM_DATA
+                                                                  ,
+                                                                  nullptr,
+                                                                  nullptr,
+                                                                  ""
+#endif
+    );
+    mDataSenderManagerWorkerThread = std::make_unique<DataSenderManagerWorkerThread>(
+        mConnectivityModule, dataSenderManager, 100, mCollectedDataQueue, 4 );
+
+    // Queue all triggers before starting, so that they are processed as one batch
+    const uint32_t numberOfTriggers = 50;
+    for ( uint32_t i = 0; i < numberOfTriggers; i++ )
+    {
+        auto triggeredCollectionSchemeData = std::make_shared<TriggeredCollectionSchemeData>();
+        triggeredCollectionSchemeData->metadata.collectionSchemeID = "TESTCOLLECTIONSCHEME";
+        triggeredCollectionSchemeData->metadata.compress = ( i % 2 ) == 0;
+        triggeredCollectionSchemeData->triggerTime = mTriggerTime;
+        triggeredCollectionSchemeData->eventID = i;
+        for ( uint32_t j = 0; j <= i * 10; j++ )
+        {
+            triggeredCollectionSchemeData->signals.emplace_back( j, mTriggerTime - j, j * 0.5, SignalType::DOUBLE );
+        }
+        mCollectedDataQueue->push( triggeredCollectionSchemeData );
+    }
+    mDataSenderManagerWorkerThread->start();
+
+    WAIT_ASSERT_EQ( sender->getSentBufferData().size(), numberOfTriggers );
+    ASSERT_TRUE( mDataSenderManagerWorkerThread->stop() );
+
+    // The payloads are sent in the order of the triggers
+    auto sentBufferData = sender->getSentBufferData();
+    for ( uint32_t i = 0; i < numberOfTriggers; i++ )
+    {
+        ASSERT_EQ( sentBufferData[i].collectionSchemeParams.eventID, i );
+        ASSERT_EQ( sentBufferData[i].collectionSchemeParams.compression, ( i % 2 ) == 0 );
+        std::string data = sentBufferData[i].data;
+        if ( sentBufferData[i].collectionSchemeParams.compression )
+        {
+            ASSERT_TRUE( snappy::Uncompress( sentBufferData[i].data.c_str(), sentBufferData[i].data.size(), &data ) );
+        }
+        Schemas::VehicleDataMsg::VehicleData vehicleData;
+        ASSERT_TRUE( vehicleData.ParseFromString( data ) );
+        ASSERT_EQ( vehicleData.collection_event_id(), i );
+        ASSERT_EQ( vehicleData.captured_signals_size(), i * 10 + 1 );
+    }
+}
+
+TEST_F( DataSenderManagerWorkerThreadTest, RestartWithSerializationThreads )
+{
+    auto sender = std::make_shared<NiceMock<Testing::SenderMock>>();
+    ON_CALL( *sender, getMaxSendSize() ).WillByDefault( Return( 128 * 1024 ) );
+    ON_CALL( *sender, mockedSendBuffer( _, _, _ ) ).WillByDefault( Return( ConnectivityError::Success ) );
+    auto payloadManager = std::make_shared<NiceMock<Testing::PayloadManagerMock>>();
+    ON_CALL( *payloadManager, retrievePayloadMetadata( _ ) ).WillByDefault( Return( ErrorCode::EMPTY ) );
+    auto dataSenderManager = std::make_shared<DataSenderManager>( sender,
+                                                                  payloadManager,
+                                                                  canIDTranslator,
+                                                                  0
+#ifdef FWE_FEATURE_VISION_SYSTEM_DATA
+                                                                  ,
+                                                                  nullptr,
+                                                                  nullptr,
+                                                                  ""
+#endif
+    );
+    mDataSenderManagerWorkerThread = std::make_unique<DataSenderManagerWorkerThread>(
+        mConnectivityModule, dataSenderManager, 100, mCollectedDataQueue, 4 );
+
+    // Stopping without a running thread is a no-op
+    ASSERT_TRUE( mDataSenderManagerWorkerThread->stop() );
+    for ( uint32_t i = 0; i < 3; i++ )
+    {
+        ASSERT_TRUE( mDataSenderManagerWorkerThread->start() );
+        auto triggeredCollectionSchemeData = std::make_shared<TriggeredCollectionSchemeData>();
+        triggeredCollectionSchemeData->metadata.collectionSchemeID = "TESTCOLLECTIONSCHEME";
+        triggeredCollectionSchemeData->triggerTime = mTriggerTime;
+        triggeredCollectionSchemeData->eventID = i;
+        triggeredCollectionSchemeData->signals.emplace_back( 1, mTriggerTime, 0.5, SignalType::DOUBLE );
+        mCollectedDataQueue->push( triggeredCollectionSchemeData );
+        mDataSenderManagerWorkerThread->onDataReadyToPublish();
+
+        WAIT_ASSERT_EQ( sender->getSentBufferData().size(), i + 1 );
+        ASSERT_TRUE( mDataSenderManagerWorkerThread->stop() );
+        ASSERT_TRUE( mDataSenderManagerWorkerThread->stop() );
+    }
+}
+
 #ifdef FWE_FEATURE_VISION_SYSTEM_DATA
 TEST_F( DataSenderManagerWorkerThreadTest, ProcessSingleTriggerWithRawData )
 {
@@ -10,6 +10,7 @@
 #include "OBDDataTypes.h"
 #include "SignalTypes.h"
 #include "TimeTypes.h"
+#include "XorDoubleEncoding.h"
 #include "vehicle_data.pb.h"
 #include <array>
 #include <cstdint>
@@ -89,6 +90,153 @@ TEST_F( DataSenderProtoWriterTest, TestVehicleData )
     ASSERT_EQ( testTriggerTime, vehicleDataTest.collection_event_time_ms_epoch() );
 }
 
+// Test the columnar encoding of the captured signals
+TEST_F( DataSenderProtoWriterTest, TestColumnarSignalEncoding )
+{
+    CANInterfaceIDTranslator canIDTranslator;
+    DataSenderProtoWriter protoWriter( canIDTranslator );
+    std::shared_ptr<TriggeredCollectionSchemeData> triggeredCollectionSchemeDataPtr =
+        std::make_shared<TriggeredCollectionSchemeData>();
+    triggeredCollectionSchemeDataPtr->metadata.collectionSchemeID = "123";
+    triggeredCollectionSchemeDataPtr->metadata.decoderID = "456";
+    triggeredCollectionSchemeDataPtr->metadata.columnarSignalEncoding = true;
+    Timestamp testTriggerTime = 1600000000000;
+    triggeredCollectionSchemeDataPtr->triggerTime = testTriggerTime;
+    protoWriter.setupVehicleData( triggeredCollectionSchemeDataPtr, 1 );
+
+    // Newest samples first, like collected by the inspection engine
+    std::vector<int64_t> times{ 10, 0, -10, -20, -35 };
+    std::vector<double> doubleValues{ 20.5, 20.25, 20.25, 20.0, -3.0 };
+    std::vector<uint64_t> uint64Values{ 0, UINT64_MAX, 5, 5, 1 };
+    std::vector<bool> boolValues{ true, false, false, true, true };
+    for ( size_t i = 0; i < times.size(); i++ )
+    {
+        auto receiveTime = static_cast<Timestamp>( static_cast<int64_t>( testTriggerTime ) + times[i] );
+        protoWriter.append( CollectedSignal( 1, receiveTime, doubleValues[i], SignalType::DOUBLE ) );
+        protoWriter.append( CollectedSignal( 2, receiveTime, uint64Values[i], SignalType::UINT64 ) );
+        bool boolValue = boolValues[i];
+        protoWriter.append( CollectedSignal( 3, receiveTime, boolValue, SignalType::BOOLEAN ) );
+    }
+    // A different type than the first sample of the signal can not be added to the column
+    protoWriter.append( CollectedSignal( 3, testTriggerTime, 0.5, SignalType::DOUBLE ) );
+    EXPECT_EQ( protoWriter.getVehicleDataMsgCount(), 16 );
+
+    std::string out;
+    ASSERT_TRUE( protoWriter.serializeVehicleData( &out ) );
+    ASSERT_GE( protoWriter.getVehicleDataEstimatedSize(), out.size() );
+    Schemas::VehicleDataMsg::VehicleData vehicleDataTest{};
+    ASSERT_TRUE( vehicleDataTest.ParseFromString( out ) );
+
+    ASSERT_EQ( vehicleDataTest.captured_signals_size(), 1 );
+    ASSERT_EQ( vehicleDataTest.captured_signals( 0 ).signal_id(), 3 );
+    ASSERT_EQ( vehicleDataTest.captured_signal_columns_size(), 3 );
+    for ( const auto &column : vehicleDataTest.captured_signal_columns() )
+    {
+        // Restore the times from the delta of deltas
+        ASSERT_EQ( column.relative_time_ms_delta_of_deltas_size(), times.size() );
+        int64_t time = 0;
+        int64_t delta = 0;
+        for ( int i = 0; i < column.relative_time_ms_delta_of_deltas_size(); i++ )
+        {
+            if ( i == 0 )
+            {
+                time = column.relative_time_ms_delta_of_deltas( 0 );
+            }
+            else
+            {
+                delta = ( i == 1 ) ? column.relative_time_ms_delta_of_deltas( 1 )
+                                   : ( delta + column.relative_time_ms_delta_of_deltas( i ) );
+                time += delta;
+            }
+            ASSERT_EQ( time, times[static_cast<size_t>( i )] );
+        }
+
+        if ( column.signal_id() == 1 )
+        {
+            ASSERT_EQ( column.integer_value_deltas_size(), 0 );
+            std::vector<double> decoded;
+            ASSERT_TRUE( decodeXorDoubles( column.xor_double_values(), times.size(), decoded ) );
+            ASSERT_EQ( decoded, doubleValues );
+        }
+        else
+        {
+            ASSERT_TRUE( column.xor_double_values().empty() );
+            ASSERT_EQ( column.integer_value_deltas_size(), times.size() );
+            uint64_t value = 0;
+            for ( int i = 0; i < column.integer_value_deltas_size(); i++ )
+            {
+                value += static_cast<uint64_t>( column.integer_value_deltas( i ) );
+                auto expected = ( column.signal_id() == 2 ) ? uint64Values[static_cast<size_t>( i )]
+                                                            : ( boolValues[static_cast<size_t>( i )] ? 1U : 0U );
+                ASSERT_EQ( value, expected );
+            }
+        }
+    }
+
+    // A new payload starts new columns
+    protoWriter.setupVehicleData( triggeredCollectionSchemeDataPtr, 2 );
+    protoWriter.append( CollectedSignal( 1, testTriggerTime + 5, 1.0, SignalType::DOUBLE ) );
+    ASSERT_TRUE( protoWriter.serializeVehicleData( &out ) );
+    ASSERT_TRUE( vehicleDataTest.ParseFromString( out ) );
+    ASSERT_EQ( vehicleDataTest.captured_signal_columns_size(), 1 );
+    ASSERT_EQ( vehicleDataTest.captured_signal_columns( 0 ).relative_time_ms_delta_of_deltas( 0 ), 5 );
+}
+
+// The directly encoded signals must result in the same message as the generated protobuf code
+TEST_F( DataSenderProtoWriterTest, TestEncodedSignalsMatchGeneratedCode )
+{
+    CANInterfaceIDTranslator canIDTranslator;
+    DataSenderProtoWriter protoWriter( canIDTranslator );
+    std::shared_ptr<TriggeredCollectionSchemeData> triggeredCollectionSchemeDataPtr =
+        std::make_shared<TriggeredCollectionSchemeData>();
+    triggeredCollectionSchemeDataPtr->metadata.collectionSchemeID = "123";
+    triggeredCollectionSchemeDataPtr->metadata.decoderID = "456";
+    Timestamp testTriggerTime = 1600000000000;
+    triggeredCollectionSchemeDataPtr->triggerTime = testTriggerTime;
+
+    Schemas::VehicleDataMsg::VehicleData expected{};
+    expected.set_campaign_sync_id( "123" );
+    expected.set_decoder_sync_id( "456" );
+    expected.set_collection_event_id( 7 );
+    expected.set_collection_event_time_ms_epoch( testTriggerTime );
+
+    std::string out;
+    // The second payload reuses the buffers of the first one
+    for ( int payload = 0; payload < 2; payload++ )
+    {
+        protoWriter.setupVehicleData( triggeredCollectionSchemeDataPtr, 7 );
+        expected.clear_captured_signals();
+        std::vector<int64_t> times{ 0, 1, -1, 5000, -100000000000 };
+        std::vector<SignalID> signalIDs{ 0, 1, 127, 128, 0xFFFFFFFE };
+        std::vector<double> values{ 0.0, -1.5, 1e300, 42.0, -0.0 };
+        for ( size_t i = 0; i < times.size(); i++ )
+        {
+            auto receiveTime = static_cast<Timestamp>( static_cast<int64_t>( testTriggerTime ) + times[i] );
+            protoWriter.append( CollectedSignal( signalIDs[i], receiveTime, values[i], SignalType::DOUBLE ) );
+            auto capturedSignal = expected.add_captured_signals();
+            capturedSignal->set_relative_time_ms( times[i] );
+            capturedSignal->set_signal_id( signalIDs[i] );
+            capturedSignal->set_double_value( values[i] );
+        }
+        std::array<uint8_t, MAX_CAN_FRAME_BYTE_SIZE> data = { 1, 2, 3 };
+        protoWriter.append( CollectedCanRawFrame( 12, 1, testTriggerTime, data, 3 ) );
+        auto canFrame = expected.mutable_can_frames()->Add();
+        canFrame->set_message_id( 12 );
+        canFrame->set_interface_id( canIDTranslator.getInterfaceID( 1 ) );
+        canFrame->set_byte_values( reinterpret_cast<const char *>( data.data() ), 3 );
+
+        ASSERT_TRUE( protoWriter.serializeVehicleData( &out ) );
+        Schemas::VehicleDataMsg::VehicleData vehicleDataTest{};
+        ASSERT_TRUE( vehicleDataTest.ParseFromString( out ) );
+        ASSERT_EQ( vehicleDataTest.SerializeAsString(), expected.SerializeAsString() );
+        // Only the order of the fields differs
+        ASSERT_EQ( out.size(), expected.ByteSizeLong() );
+        // Without columns and DTCs the estimated size is exact
+        ASSERT_EQ( protoWriter.getVehicleDataEstimatedSize(), out.size() );
+        expected.clear_can_frames();
+    }
+}
+
 // Test the DTC fields in the proto for the edge to cloud payload
 TEST_F( DataSenderProtoWriterTest, TestDTCData )
 {
@@ -3,17 +3,22 @@
 
 #include "ExternalCANDataSource.h"
 #include "CANDataConsumer.h"
+#include "CANDecoder.h"
+#include "CANSharedMemoryRing.h"
 #include "CollectionInspectionAPITypes.h"
 #include "IDecoderDictionary.h"
 #include "MessageTypes.h"
 #include "SignalTypes.h"
 #include "TimeTypes.h"
 #include "VehicleDataSourceTypes.h"
+#include "WaitUntil.h"
 #include <array>
 #include <cstdint>
 #include <gtest/gtest.h>
 #include <linux/can.h>
 #include <memory>
+#include <string>
+#include <unistd.h>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -165,6 +170,39 @@ TEST_F( ExternalCANDataSourceTest, testValidDecoderDictionary )
     ASSERT_FALSE( signalBufferPtr->pop( collectedDataFrame ) );
 }
 
+TEST_F( ExternalCANDataSourceTest, testDataFramesAreRecycled )
+{
+    auto signalBufferPtr = std::make_shared<SignalBuffer>( 2 );
+
+    CANDataConsumer consumer{ signalBufferPtr };
+    ExternalCANDataSource dataSource{ consumer };
+    dataSource.onChangeOfActiveDictionary( mDictionary, VehicleDataSourceProtocol::RAW_SOCKET );
+    CollectedDataFrame collectedDataFrame;
+    CollectedRawCanFramePtr previousFrame;
+    for ( Timestamp timestamp = 1000; timestamp < 1020; timestamp++ )
+    {
+        sendTestMessage( dataSource, 0, 0x123, timestamp );
+        ASSERT_TRUE( signalBufferPtr->pop( collectedDataFrame ) );
+        ASSERT_EQ( collectedDataFrame.mCollectedSignals.size(), 2 );
+        ASSERT_EQ( collectedDataFrame.mCollectedSignals[0].signalID, 1 );
+        ASSERT_EQ( collectedDataFrame.mCollectedSignals[0].receiveTime, timestamp );
+        ASSERT_EQ( collectedDataFrame.mCollectedSignals[1].signalID, 7 );
+        ASSERT_EQ( collectedDataFrame.mCollectedSignals[1].receiveTime, timestamp );
+        auto frame = collectedDataFrame.mCollectedCanRawFrame;
+        ASSERT_NE( frame, nullptr );
+        ASSERT_EQ( frame->receiveTime, timestamp );
+        ASSERT_EQ( frame->size, 8 );
+        // A raw frame that is still referenced elsewhere must never be reused
+        if ( previousFrame != nullptr )
+        {
+            ASSERT_NE( previousFrame, frame );
+            ASSERT_EQ( previousFrame->receiveTime, timestamp - 1 );
+        }
+        previousFrame = frame;
+        ASSERT_FALSE( signalBufferPtr->pop( collectedDataFrame ) );
+    }
+}
+
 TEST_F( ExternalCANDataSourceTest, testCanFDSocketMode )
 {
     auto signalBufferPtr = std::make_shared<SignalBuffer>( 10 );
@@ -227,5 +265,106 @@ TEST_F( ExternalCANDataSourceTest, testExtractExtendedID )
     ASSERT_FALSE( signalBufferPtr->pop( collectedDataFrame ) );
 }
 
+TEST_F( ExternalCANDataSourceTest, testCompiledDictionaryLookup )
+{
+    // Add an extended frame and a second channel, then use the flat lookup instead of the maps
+    auto extendedDecoderMethod = mDictionary->canMessageDecoderMethod[0][0x123];
+    extendedDecoderMethod.format.mMessageID = 0x1ABCDEF;
+    mDictionary->canMessageDecoderMethod[0][0x1ABCDEF] = extendedDecoderMethod;
+    mDictionary->canMessageDecoderMethod[2][0x456] = mDictionary->canMessageDecoderMethod[0][0x123];
+    CANDecoder::compileDictionary( *mDictionary );
+    ASSERT_TRUE( mDictionary->isDecoderMethodLookupBuilt );
+
+    auto signalBufferPtr = std::make_shared<SignalBuffer>( 10 );
+    CANDataConsumer consumer{ signalBufferPtr };
+    ExternalCANDataSource dataSource{ consumer };
+    dataSource.onChangeOfActiveDictionary( mDictionary, VehicleDataSourceProtocol::RAW_SOCKET );
+    CollectedDataFrame collectedDataFrame;
+
+    sendTestMessage( dataSource, 0, 0x123, 1 );
+    ASSERT_TRUE( signalBufferPtr->pop( collectedDataFrame ) );
+    ASSERT_EQ( collectedDataFrame.mCollectedSignals.size(), 2 );
+    ASSERT_EQ( collectedDataFrame.mCollectedCanRawFrame->frameID, 0x123 );
+
+    sendTestMessageExtendedID( dataSource, 0, 0x1ABCDEF, 2 );
+    ASSERT_TRUE( signalBufferPtr->pop( collectedDataFrame ) );
+    ASSERT_EQ( collectedDataFrame.mCollectedSignals.size(), 2 );
+    ASSERT_EQ( collectedDataFrame.mCollectedCanRawFrame->frameID, 0x1ABCDEF );
+
+    // Standard frame IDs can also be received with the extended flag set
+    sendTestMessageExtendedID( dataSource, 0, 0x123, 3 );
+    ASSERT_TRUE( signalBufferPtr->pop( collectedDataFrame ) );
+    ASSERT_EQ( collectedDataFrame.mCollectedCanRawFrame->frameID, 0x123 );
+
+    sendTestMessage( dataSource, 2, 0x456, 4 );
+    ASSERT_TRUE( signalBufferPtr->pop( collectedDataFrame ) );
+    ASSERT_EQ( collectedDataFrame.mCollectedCanRawFrame->channelId, 2 );
+
+    // Unknown frame IDs and channels
+    sendTestMessage( dataSource, 0, 0x456, 5 );
+    sendTestMessageExtendedID( dataSource, 0, 0x1ABCDEE, 6 );
+    sendTestMessage( dataSource, 1, 0x123, 7 );
+    sendTestMessage( dataSource, 3, 0x123, 8 );
+    ASSERT_FALSE( signalBufferPtr->pop( collectedDataFrame ) );
+}
+
+TEST_F( ExternalCANDataSourceTest, testIngestMessagesBatch )
+{
+    auto signalBufferPtr = std::make_shared<SignalBuffer>( 10 );
+
+    CANDataConsumer consumer{ signalBufferPtr };
+    ExternalCANDataSource dataSource{ consumer };
+    dataSource.onChangeOfActiveDictionary( mDictionary, VehicleDataSourceProtocol::RAW_SOCKET );
+    std::array<uint8_t, 8> data{ 0, 1, 2, 3, 4, 5, 6, 7 };
+    // The second frame has no timestamp, so the current time is used for it
+    std::vector<CANFrameInfo> frames{ { 0x123, data.data(), data.size(), 1000 },
+                                      { 0x123, data.data(), data.size(), 0 },
+                                      { 0x456, data.data(), data.size(), 1002 } };
+    dataSource.ingestMessages( 0, frames.data(), frames.size() );
+    // The frame is collected raw, so every frame needs its own data frame
+    CollectedDataFrame collectedDataFrame;
+    ASSERT_TRUE( signalBufferPtr->pop( collectedDataFrame ) );
+    ASSERT_EQ( collectedDataFrame.mCollectedSignals.size(), 2 );
+    ASSERT_EQ( collectedDataFrame.mCollectedSignals[0].receiveTime, 1000 );
+    ASSERT_DOUBLE_EQ( collectedDataFrame.mCollectedSignals[0].value.value.doubleVal, 0x10203 );
+    ASSERT_TRUE( signalBufferPtr->pop( collectedDataFrame ) );
+    ASSERT_EQ( collectedDataFrame.mCollectedSignals.size(), 2 );
+    ASSERT_GT( collectedDataFrame.mCollectedSignals[0].receiveTime, 1000 );
+    ASSERT_EQ( collectedDataFrame.mCollectedCanRawFrame->receiveTime,
+               collectedDataFrame.mCollectedSignals[0].receiveTime );
+    ASSERT_FALSE( signalBufferPtr->pop( collectedDataFrame ) );
+    // The caller's frame infos are not modified
+    ASSERT_EQ( frames[1].timestamp, 0 );
+}
+
+TEST_F( ExternalCANDataSourceTest, testSharedMemoryRing )
+{
+    auto signalBufferPtr = std::make_shared<SignalBuffer>( 10 );
+    std::string path = "/tmp/fwe-external-can-test-" + std::to_string( getpid() );
+
+    CANDataConsumer consumer{ signalBufferPtr };
+    // The consumer thread must be woken up by the producer and on stop, the timeout of its wait never expires here
+    ExternalCANDataSource dataSource{ consumer, 1000000 };
+    dataSource.onChangeOfActiveDictionary( mDictionary, VehicleDataSourceProtocol::RAW_SOCKET );
+    ASSERT_TRUE( dataSource.addSharedMemoryRing( 0, path, 4 ) );
+    ASSERT_TRUE( dataSource.startSharedMemoryConsumer() );
+    ASSERT_FALSE( dataSource.addSharedMemoryRing( 1, path + "-other", 4 ) );
+
+    // Written by the external process
+    CANSharedMemoryRing producer( path );
+    ASSERT_TRUE( producer.open() );
+    std::array<uint8_t, 8> data{ 0, 1, 2, 3, 4, 5, 6, 7 };
+    CollectedDataFrame collectedDataFrame;
+    for ( Timestamp timestamp = 1000; timestamp < 1010; timestamp++ )
+    {
+        WAIT_ASSERT_TRUE( producer.push( timestamp, 0x123, data.data(), data.size() ) );
+        WAIT_ASSERT_TRUE( signalBufferPtr->pop( collectedDataFrame ) );
+        ASSERT_EQ( collectedDataFrame.mCollectedSignals.size(), 2 );
+        ASSERT_EQ( collectedDataFrame.mCollectedSignals[0].receiveTime, timestamp );
+        ASSERT_DOUBLE_EQ( collectedDataFrame.mCollectedSignals[1].value.value.doubleVal, 0x4050607 );
+    }
+    ASSERT_TRUE( dataSource.stopSharedMemoryConsumer() );
+}
+
 } // namespace IoTFleetWise
 } // namespace Aws
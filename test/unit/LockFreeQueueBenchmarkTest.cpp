@@ -0,0 +1,166 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "CollectionInspectionAPITypes.h"
+#include "LockFreeQueue.h"
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+using namespace Aws::IoTFleetWise;
+
+// The mutex based queue that was used before, kept here as a baseline for comparison
+template <typename T>
+class MutexQueue
+{
+public:
+    MutexQueue( size_t maxSize )
+        : mMaxSize( maxSize )
+    {
+    }
+    bool
+    push( T &&element )
+    {
+        std::lock_guard<std::mutex> lock( mMutex );
+        if ( ( mQueue.size() + 1 ) > mMaxSize )
+        {
+            return false;
+        }
+        mQueue.push( std::move( element ) );
+        return true;
+    }
+    bool
+    pop( T &element )
+    {
+        std::lock_guard<std::mutex> lock( mMutex );
+        if ( mQueue.empty() )
+        {
+            return false;
+        }
+        element = std::move( mQueue.front() );
+        mQueue.pop();
+        return true;
+    }
+    template <typename Functor>
+    size_t
+    consumeAll( const Functor &functor )
+    {
+        size_t consumed = 0;
+        T element;
+        while ( pop( element ) )
+        {
+            functor( element );
+            consumed++;
+        }
+        return consumed;
+    }
+
+private:
+    std::mutex mMutex;
+    size_t mMaxSize;
+    std::queue<T> mQueue;
+};
+
+static constexpr size_t QUEUE_SIZE = 10000;
+static constexpr int64_t FRAMES_PER_PRODUCER = 20000;
+
+static CollectedDataFrame
+createDataFrame()
+{
+    CollectedSignalsGroup signals;
+    signals.emplace_back( 1, 1000, 1.0, SignalType::DOUBLE );
+    signals.emplace_back( 2, 1000, 2.0, SignalType::DOUBLE );
+    return CollectedDataFrame( std::move( signals ) );
+}
+
+// Models the CAN channel threads (producers) and the inspection thread (consumer) contending on the signal buffer
+template <typename QueueType>
+static void
+BM_signalBufferContention( benchmark::State &state )
+{
+    auto numProducers = static_cast<int>( state.range( 0 ) );
+    for ( auto _ : state )
+    {
+        QueueType queue( QUEUE_SIZE );
+        std::vector<std::thread> producers;
+        for ( int p = 0; p < numProducers; p++ )
+        {
+            producers.emplace_back( [&queue]() {
+                for ( int64_t i = 0; i < FRAMES_PER_PRODUCER; )
+                {
+                    if ( queue.push( createDataFrame() ) )
+                    {
+                        i++;
+                    }
+                }
+            } );
+        }
+        int64_t consumedSignals = 0;
+        int64_t consumedFrames = 0;
+        auto consumeFrame = [&consumedSignals]( const CollectedDataFrame &frame ) {
+            consumedSignals += static_cast<int64_t>( frame.mCollectedSignals.size() );
+        };
+        while ( consumedFrames < ( numProducers * FRAMES_PER_PRODUCER ) )
+        {
+            consumedFrames += static_cast<int64_t>( queue.consumeAll( consumeFrame ) );
+        }
+        benchmark::DoNotOptimize( consumedSignals );
+        for ( auto &producer : producers )
+        {
+            producer.join();
+        }
+    }
+    state.SetItemsProcessed( state.iterations() * numProducers * FRAMES_PER_PRODUCER );
+}
+BENCHMARK_TEMPLATE( BM_signalBufferContention, MutexQueue<CollectedDataFrame> )
+    ->RangeMultiplier( 2 )
+    ->Range( 1, 8 )
+    ->UseRealTime()
+    ->Unit( benchmark::kMillisecond );
+BENCHMARK_TEMPLATE( BM_signalBufferContention, SignalBuffer )
+    ->RangeMultiplier( 2 )
+    ->Range( 1, 8 )
+    ->UseRealTime()
+    ->Unit( benchmark::kMillisecond );
+
+// Models the inspection thread (producer) handing over triggered data to the data sender thread (consumer)
+template <typename QueueType>
+static void
+BM_readyToPublishHandover( benchmark::State &state )
+{
+    auto data = std::make_shared<const TriggeredCollectionSchemeData>();
+    for ( auto _ : state )
+    {
+        QueueType queue( QUEUE_SIZE );
+        std::thread producer( [&queue, &data]() {
+            for ( int64_t i = 0; i < FRAMES_PER_PRODUCER; )
+            {
+                if ( queue.push( TriggeredCollectionSchemeDataPtr( data ) ) )
+                {
+                    i++;
+                }
+            }
+        } );
+        int64_t consumed = 0;
+        auto consumeData = []( const TriggeredCollectionSchemeDataPtr &element ) {
+            benchmark::DoNotOptimize( element );
+        };
+        while ( consumed < FRAMES_PER_PRODUCER )
+        {
+            consumed += static_cast<int64_t>( queue.consumeAll( consumeData ) );
+        }
+        producer.join();
+    }
+    state.SetItemsProcessed( state.iterations() * FRAMES_PER_PRODUCER );
+}
+BENCHMARK_TEMPLATE( BM_readyToPublishHandover, MutexQueue<TriggeredCollectionSchemeDataPtr> )
+    ->UseRealTime()
+    ->Unit( benchmark::kMillisecond );
+BENCHMARK_TEMPLATE( BM_readyToPublishHandover, CollectedDataReadyToPublish )
+    ->UseRealTime()
+    ->Unit( benchmark::kMillisecond );
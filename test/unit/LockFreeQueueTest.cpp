@@ -0,0 +1,177 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "LockFreeQueue.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace Aws
+{
+namespace IoTFleetWise
+{
+
+template <typename QueueType>
+class LockFreeQueueTest : public ::testing::Test
+{
+};
+
+using QueueTypes = ::testing::Types<MpscQueue<std::shared_ptr<int>>, SpscQueue<std::shared_ptr<int>>>;
+TYPED_TEST_SUITE( LockFreeQueueTest, QueueTypes );
+
+TYPED_TEST( LockFreeQueueTest, pushAndPopInOrder )
+{
+    TypeParam queue( 3 );
+    ASSERT_TRUE( queue.isEmpty() );
+    ASSERT_TRUE( queue.push( std::make_shared<int>( 1 ) ) );
+    ASSERT_TRUE( queue.push( std::make_shared<int>( 2 ) ) );
+    ASSERT_TRUE( queue.push( std::make_shared<int>( 3 ) ) );
+    ASSERT_FALSE( queue.push( std::make_shared<int>( 4 ) ) );
+    ASSERT_FALSE( queue.isEmpty() );
+
+    std::shared_ptr<int> element;
+    ASSERT_TRUE( queue.pop( element ) );
+    ASSERT_EQ( *element, 1 );
+    ASSERT_TRUE( queue.push( std::make_shared<int>( 5 ) ) );
+    ASSERT_TRUE( queue.pop( element ) );
+    ASSERT_EQ( *element, 2 );
+    ASSERT_TRUE( queue.pop( element ) );
+    ASSERT_EQ( *element, 3 );
+    ASSERT_TRUE( queue.pop( element ) );
+    ASSERT_EQ( *element, 5 );
+    ASSERT_FALSE( queue.pop( element ) );
+    ASSERT_TRUE( queue.isEmpty() );
+}
+
+TYPED_TEST( LockFreeQueueTest, singleSlot )
+{
+    TypeParam queue( 1 );
+    for ( int i = 0; i < 5; i++ )
+    {
+        ASSERT_TRUE( queue.push( std::make_shared<int>( i ) ) );
+        ASSERT_FALSE( queue.push( std::make_shared<int>( i ) ) );
+        std::shared_ptr<int> element;
+        ASSERT_TRUE( queue.pop( element ) );
+        ASSERT_EQ( *element, i );
+        ASSERT_FALSE( queue.pop( element ) );
+    }
+}
+
+TYPED_TEST( LockFreeQueueTest, popReleasesElement )
+{
+    TypeParam queue( 2 );
+    auto element = std::make_shared<int>( 1 );
+    std::weak_ptr<int> weakElement = element;
+    ASSERT_TRUE( queue.push( std::move( element ) ) );
+    ASSERT_FALSE( weakElement.expired() );
+    ASSERT_EQ( queue.consumeAll( []( const std::shared_ptr<int> &e ) {
+        ASSERT_EQ( *e, 1 );
+    } ),
+               1U );
+    // Neither the consumeAll temporary nor the slot of the queue should keep the element alive
+    ASSERT_TRUE( weakElement.expired() );
+}
+
+TYPED_TEST( LockFreeQueueTest, producerAndConsumerThreads )
+{
+    constexpr int NUM_ELEMENTS = 10000;
+    TypeParam queue( 16 );
+    std::thread producer( [&queue]() {
+        for ( int i = 0; i < NUM_ELEMENTS; )
+        {
+            if ( queue.push( std::make_shared<int>( i ) ) )
+            {
+                i++;
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    } );
+    // Consume all elements even after a mismatch, so that the producer can finish and the test fails instead of hangs
+    int expected = 0;
+    int received = 0;
+    bool inOrder = true;
+    while ( received < NUM_ELEMENTS )
+    {
+        auto consumed = queue.consumeAll( [&expected, &inOrder]( const std::shared_ptr<int> &e ) {
+            inOrder = inOrder && ( *e == expected );
+            expected++;
+        } );
+        if ( consumed == 0U )
+        {
+            std::this_thread::yield();
+        }
+        received += static_cast<int>( consumed );
+    }
+    producer.join();
+    ASSERT_TRUE( inOrder );
+    ASSERT_EQ( expected, NUM_ELEMENTS );
+    ASSERT_TRUE( queue.isEmpty() );
+}
+
+TEST( LockFreeQueueTest, mpscMultipleProducers )
+{
+    constexpr int NUM_PRODUCERS = 4;
+    constexpr int NUM_ELEMENTS_PER_PRODUCER = 2500;
+    MpscQueue<std::pair<int, int>> queue( 32 );
+    std::vector<std::thread> producers;
+    for ( int p = 0; p < NUM_PRODUCERS; p++ )
+    {
+        producers.emplace_back( [&queue, p]() {
+            for ( int i = 0; i < NUM_ELEMENTS_PER_PRODUCER; )
+            {
+                if ( queue.push( std::make_pair( p, i ) ) )
+                {
+                    i++;
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+        } );
+    }
+    // Elements from different producers can interleave, but elements of one producer must stay in order
+    std::vector<int> nextExpected( NUM_PRODUCERS, 0 );
+    int total = 0;
+    bool inOrder = true;
+    while ( total < ( NUM_PRODUCERS * NUM_ELEMENTS_PER_PRODUCER ) )
+    {
+        auto consumed = queue.consumeAll( [&nextExpected, &inOrder]( const std::pair<int, int> &e ) {
+            inOrder = inOrder && ( e.second == nextExpected[static_cast<size_t>( e.first )] );
+            nextExpected[static_cast<size_t>( e.first )]++;
+        } );
+        if ( consumed == 0U )
+        {
+            std::this_thread::yield();
+        }
+        total += static_cast<int>( consumed );
+    }
+    for ( auto &producer : producers )
+    {
+        producer.join();
+    }
+    ASSERT_TRUE( inOrder );
+    ASSERT_TRUE( queue.isEmpty() );
+}
+
+TEST( LockFreeQueueTest, spscIsFull )
+{
+    SpscQueue<int> queue( 2 );
+    ASSERT_FALSE( queue.isFull() );
+    ASSERT_TRUE( queue.push( 1 ) );
+    ASSERT_FALSE( queue.isFull() );
+    ASSERT_TRUE( queue.push( 2 ) );
+    ASSERT_TRUE( queue.isFull() );
+    int element = 0;
+    ASSERT_TRUE( queue.pop( element ) );
+    ASSERT_FALSE( queue.isFull() );
+    ASSERT_TRUE( queue.push( 3 ) );
+    ASSERT_TRUE( queue.isFull() );
+}
+
+} // namespace IoTFleetWise
+} // namespace Aws
@@ -0,0 +1,273 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "PayloadCompression.h"
+#include "vehicle_data.pb.h"
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <boost/filesystem.hpp>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifdef FWE_FEATURE_ZSTD_COMPRESSION
+#include <zdict.h>
+#endif
+
+using namespace Aws::IoTFleetWise;
+
+// Replays VehicleData payloads through each codec and reports the compression ratio (compressed size divided by the
+// serialized size) and the throughput in bytes of serialized payloads per second.
+//
+// To replay captured payloads, set FWE_BENCHMARK_PAYLOAD_DIR to a directory with one serialized, uncompressed
+// VehicleData message per file, for example the payloads persisted by a campaign without compression while the
+// vehicle was offline. Otherwise payloads like the ones of a heartbeat campaign are generated. The payloads are split
+// alternately: the zstd dictionary is trained with one half and all codecs are measured with the other half.
+// To compare codecs for a target, build the benchmark for it and run it there.
+
+static constexpr const char *PAYLOAD_DIR_ENV_VAR = "FWE_BENCHMARK_PAYLOAD_DIR";
+static constexpr size_t NUMBER_OF_GENERATED_PAYLOADS = 400;
+static constexpr uint32_t NUMBER_OF_GENERATED_SIGNALS = 40;
+
+static std::string
+generatePayload( std::mt19937 &generator, uint32_t eventID, std::vector<double> &signalValues )
+{
+    std::uniform_int_distribution<int> samples( 1, 10 );
+    std::normal_distribution<double> step( 0, 0.5 );
+    Schemas::VehicleDataMsg::VehicleData vehicleData;
+    vehicleData.set_campaign_sync_id( "arn:aws:iotfleetwise:us-west-2:123456789012:campaign/HeartbeatCampaign" );
+    vehicleData.set_decoder_sync_id( "arn:aws:iotfleetwise:us-west-2:123456789012:decoder-manifest/Manifest" );
+    vehicleData.set_collection_event_id( eventID );
+    vehicleData.set_collection_event_time_ms_epoch( 1700000000000 + ( eventID * 10000ULL ) );
+    for ( uint32_t signalID = 0; signalID < NUMBER_OF_GENERATED_SIGNALS; signalID++ )
+    {
+        auto numberOfSamples = samples( generator );
+        for ( int i = 0; i < numberOfSamples; i++ )
+        {
+            auto &value = signalValues[signalID];
+            // Some signals are flags or counters, the others change continuously
+            if ( ( signalID % 4 ) == 0 )
+            {
+                value = ( step( generator ) > 0.5 ) ? 1.0 : 0.0;
+            }
+            else if ( ( signalID % 4 ) == 1 )
+            {
+                value += 1.0;
+            }
+            else
+            {
+                value = std::round( ( value + step( generator ) ) * 100.0 ) / 100.0;
+            }
+            auto *signal = vehicleData.add_captured_signals();
+            signal->set_relative_time_ms( -1000 * i );
+            signal->set_signal_id( signalID );
+            signal->set_double_value( value );
+        }
+    }
+    return vehicleData.SerializeAsString();
+}
+
+static std::vector<std::string>
+loadPayloads()
+{
+    std::vector<std::string> payloads;
+    const char *payloadDir = std::getenv( PAYLOAD_DIR_ENV_VAR );
+    if ( payloadDir != nullptr )
+    {
+        if ( !boost::filesystem::is_directory( payloadDir ) )
+        {
+            return payloads;
+        }
+        std::vector<boost::filesystem::path> files;
+        for ( const auto &entry : boost::filesystem::directory_iterator( payloadDir ) )
+        {
+            if ( boost::filesystem::is_regular_file( entry.path() ) )
+            {
+                files.push_back( entry.path() );
+            }
+        }
+        std::sort( files.begin(), files.end() );
+        for ( const auto &file : files )
+        {
+            std::ifstream stream( file.string(), std::ios::binary );
+            payloads.emplace_back( std::istreambuf_iterator<char>( stream ), std::istreambuf_iterator<char>() );
+        }
+        return payloads;
+    }
+    std::mt19937 generator( 1 );
+    std::vector<double> signalValues( NUMBER_OF_GENERATED_SIGNALS, 0.0 );
+    for ( size_t i = 0; i < NUMBER_OF_GENERATED_PAYLOADS; i++ )
+    {
+        payloads.push_back( generatePayload( generator, static_cast<uint32_t>( i ), signalValues ) );
+    }
+    return payloads;
+}
+
+// Every second payload is used for the training of the dictionary, the other ones are measured
+static const std::vector<std::string> &
+getPayloads( bool training )
+{
+    static const auto payloads = loadPayloads();
+    static const auto split = [] {
+        std::vector<std::vector<std::string>> halves( 2 );
+        for ( size_t i = 0; i < payloads.size(); i++ )
+        {
+            halves[i % 2].push_back( payloads[i] );
+        }
+        return halves;
+    }();
+    return split[training ? 0 : 1];
+}
+
+#ifdef FWE_FEATURE_ZSTD_COMPRESSION
+static constexpr size_t MAX_DICTIONARY_SIZE = 16 * 1024;
+
+static std::shared_ptr<const std::string>
+getDictionary()
+{
+    static const auto dictionary = []() -> std::shared_ptr<const std::string> {
+        const auto &samples = getPayloads( true );
+        std::string concatenatedSamples;
+        std::vector<size_t> sampleSizes;
+        for ( const auto &sample : samples )
+        {
+            concatenatedSamples += sample;
+            sampleSizes.push_back( sample.size() );
+        }
+        std::string buffer( MAX_DICTIONARY_SIZE, '\0' );
+        auto size = ZDICT_trainFromBuffer( &buffer[0],
+                                           buffer.size(),
+                                           concatenatedSamples.data(),
+                                           sampleSizes.data(),
+                                           static_cast<unsigned>( sampleSizes.size() ) );
+        if ( ZDICT_isError( size ) != 0U )
+        {
+            return nullptr;
+        }
+        buffer.resize( size );
+        return std::make_shared<const std::string>( std::move( buffer ) );
+    }();
+    return dictionary;
+}
+#endif
+
+static std::unique_ptr<IPayloadCompressor>
+createCompressor( benchmark::State &state, CompressionCodec codec, int32_t level, bool useDictionary )
+{
+    if ( getPayloads( false ).empty() )
+    {
+        state.SkipWithError( "No payloads found in FWE_BENCHMARK_PAYLOAD_DIR" );
+        return nullptr;
+    }
+    CompressionOptions options;
+    options.codec = codec;
+    options.level = level;
+    if ( useDictionary )
+    {
+#ifdef FWE_FEATURE_ZSTD_COMPRESSION
+        options.dictionary = getDictionary();
+#endif
+        if ( options.dictionary == nullptr )
+        {
+            state.SkipWithError( "Dictionary training failed, more payloads are needed" );
+            return nullptr;
+        }
+    }
+    auto compressor = createPayloadCompressor( options );
+    if ( compressor == nullptr )
+    {
+        state.SkipWithError( "Codec not supported" );
+    }
+    return compressor;
+}
+
+static void
+BM_compressPayloads( benchmark::State &state, CompressionCodec codec, int32_t level, bool useDictionary )
+{
+    const auto &payloads = getPayloads( false );
+    auto compressor = createCompressor( state, codec, level, useDictionary );
+    if ( compressor == nullptr )
+    {
+        return;
+    }
+    std::string compressed;
+    size_t serializedSize = 0;
+    size_t compressedSize = 0;
+    for ( auto _ : state )
+    {
+        for ( const auto &payload : payloads )
+        {
+            if ( !compressor->compress( payload.data(), payload.size(), compressed ) )
+            {
+                state.SkipWithError( "Compression failed" );
+                return;
+            }
+            serializedSize += payload.size();
+            compressedSize += compressed.size();
+        }
+    }
+    state.counters["ratio"] = static_cast<double>( compressedSize ) / static_cast<double>( serializedSize );
+    auto numberOfPayloads = static_cast<double>( state.iterations() ) * static_cast<double>( payloads.size() );
+    state.counters["payload_bytes"] = static_cast<double>( serializedSize ) / numberOfPayloads;
+    state.SetBytesProcessed( static_cast<int64_t>( serializedSize ) );
+}
+
+static void
+BM_decompressPayloads( benchmark::State &state, CompressionCodec codec, int32_t level, bool useDictionary )
+{
+    const auto &payloads = getPayloads( false );
+    auto compressor = createCompressor( state, codec, level, useDictionary );
+    if ( compressor == nullptr )
+    {
+        return;
+    }
+    std::vector<std::string> compressedPayloads( payloads.size() );
+    for ( size_t i = 0; i < payloads.size(); i++ )
+    {
+        if ( !compressor->compress( payloads[i].data(), payloads[i].size(), compressedPayloads[i] ) )
+        {
+            state.SkipWithError( "Compression failed" );
+            return;
+        }
+    }
+    std::string decompressed;
+    size_t serializedSize = 0;
+    for ( auto _ : state )
+    {
+        for ( const auto &compressed : compressedPayloads )
+        {
+            if ( !compressor->decompress( compressed.data(), compressed.size(), decompressed ) )
+            {
+                state.SkipWithError( "Decompression failed" );
+                return;
+            }
+            serializedSize += decompressed.size();
+        }
+    }
+    state.SetBytesProcessed( static_cast<int64_t>( serializedSize ) );
+}
+
+BENCHMARK_CAPTURE( BM_compressPayloads, snappy, CompressionCodec::SNAPPY, 0, false );
+BENCHMARK_CAPTURE( BM_decompressPayloads, snappy, CompressionCodec::SNAPPY, 0, false );
+#ifdef FWE_FEATURE_LZ4_COMPRESSION
+BENCHMARK_CAPTURE( BM_compressPayloads, lz4, CompressionCodec::LZ4, 0, false );
+BENCHMARK_CAPTURE( BM_compressPayloads, lz4_hc9, CompressionCodec::LZ4, 9, false );
+BENCHMARK_CAPTURE( BM_decompressPayloads, lz4, CompressionCodec::LZ4, 0, false );
+#endif
+#ifdef FWE_FEATURE_ZSTD_COMPRESSION
+BENCHMARK_CAPTURE( BM_compressPayloads, zstd1, CompressionCodec::ZSTD, 1, false );
+BENCHMARK_CAPTURE( BM_compressPayloads, zstd3, CompressionCodec::ZSTD, 3, false );
+BENCHMARK_CAPTURE( BM_compressPayloads, zstd19, CompressionCodec::ZSTD, 19, false );
+BENCHMARK_CAPTURE( BM_compressPayloads, zstd1_dictionary, CompressionCodec::ZSTD, 1, true );
+BENCHMARK_CAPTURE( BM_compressPayloads, zstd3_dictionary, CompressionCodec::ZSTD, 3, true );
+BENCHMARK_CAPTURE( BM_compressPayloads, zstd19_dictionary, CompressionCodec::ZSTD, 19, true );
+BENCHMARK_CAPTURE( BM_decompressPayloads, zstd3, CompressionCodec::ZSTD, 3, false );
+BENCHMARK_CAPTURE( BM_decompressPayloads, zstd3_dictionary, CompressionCodec::ZSTD, 3, true );
+#endif
@@ -0,0 +1,173 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "PayloadCompression.h"
+#include "vehicle_data.pb.h"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Aws
+{
+namespace IoTFleetWise
+{
+
+static std::string
+createPayload( uint32_t eventID, int numberOfSignals )
+{
+    Schemas::VehicleDataMsg::VehicleData vehicleData;
+    vehicleData.set_campaign_sync_id( "arn:aws:iotfleetwise:us-west-2:123456789012:campaign/HeartbeatCampaign" );
+    vehicleData.set_decoder_sync_id( "arn:aws:iotfleetwise:us-west-2:123456789012:decoder-manifest/Manifest" );
+    vehicleData.set_collection_event_id( eventID );
+    vehicleData.set_collection_event_time_ms_epoch( 1700000000000 + eventID );
+    for ( int i = 0; i < numberOfSignals; i++ )
+    {
+        auto *signal = vehicleData.add_captured_signals();
+        signal->set_relative_time_ms( -10 * ( i / 10 ) );
+        signal->set_signal_id( static_cast<uint32_t>( i % 10 ) );
+        signal->set_double_value( ( i % 10 ) * 12.5 + ( i / 10 ) * 0.25 );
+    }
+    return vehicleData.SerializeAsString();
+}
+
+static std::vector<CompressionCodec>
+getSupportedCodecs()
+{
+    std::vector<CompressionCodec> codecs;
+    for ( auto codec : { CompressionCodec::SNAPPY, CompressionCodec::LZ4, CompressionCodec::ZSTD } )
+    {
+        if ( isCompressionCodecSupported( codec ) )
+        {
+            codecs.push_back( codec );
+        }
+    }
+    return codecs;
+}
+
+static std::string
+codecToString( const testing::TestParamInfo<CompressionCodec> &info )
+{
+    return compressionCodecToString( info.param );
+}
+
+class PayloadCompressionCodecTest : public ::testing::TestWithParam<CompressionCodec>
+{
+protected:
+    static std::unique_ptr<IPayloadCompressor>
+    createCompressor( int32_t level = 0 )
+    {
+        CompressionOptions options;
+        options.codec = GetParam();
+        options.level = level;
+        return createPayloadCompressor( options );
+    }
+};
+
+INSTANTIATE_TEST_SUITE_P( SupportedCodecs,
+                          PayloadCompressionCodecTest,
+                          ::testing::ValuesIn( getSupportedCodecs() ),
+                          codecToString );
+
+TEST_P( PayloadCompressionCodecTest, CompressAndDecompress )
+{
+    auto compressor = createCompressor();
+    ASSERT_NE( compressor, nullptr );
+    for ( const auto &payload : { std::string(), createPayload( 1, 10 ), createPayload( 2, 10000 ) } )
+    {
+        std::string compressed = "previous content";
+        ASSERT_TRUE( compressor->compress( payload.data(), payload.size(), compressed ) );
+        std::string decompressed = "previous content";
+        ASSERT_TRUE( compressor->decompress( compressed.data(), compressed.size(), decompressed ) );
+        ASSERT_EQ( decompressed, payload );
+    }
+}
+
+TEST_P( PayloadCompressionCodecTest, CompressionLevels )
+{
+    auto payload = createPayload( 1, 10000 );
+    for ( int32_t level : { 1, 9 } )
+    {
+        auto compressor = createCompressor( level );
+        ASSERT_NE( compressor, nullptr );
+        std::string compressed;
+        ASSERT_TRUE( compressor->compress( payload.data(), payload.size(), compressed ) );
+        std::string decompressed;
+        ASSERT_TRUE( compressor->decompress( compressed.data(), compressed.size(), decompressed ) );
+        ASSERT_EQ( decompressed, payload );
+    }
+}
+
+TEST_P( PayloadCompressionCodecTest, TruncatedData )
+{
+    auto compressor = createCompressor();
+    ASSERT_NE( compressor, nullptr );
+    auto payload = createPayload( 1, 1000 );
+    std::string compressed;
+    ASSERT_TRUE( compressor->compress( payload.data(), payload.size(), compressed ) );
+    std::string decompressed;
+    ASSERT_FALSE( compressor->decompress( compressed.data(), compressed.size() / 2, decompressed ) );
+    // The compressor can still be used afterwards
+    ASSERT_TRUE( compressor->decompress( compressed.data(), compressed.size(), decompressed ) );
+    ASSERT_EQ( decompressed, payload );
+}
+
+TEST( PayloadCompressionTest, UnsupportedCodecs )
+{
+    ASSERT_TRUE( isCompressionCodecSupported( CompressionCodec::SNAPPY ) );
+    for ( auto codec : { CompressionCodec::SNAPPY, CompressionCodec::LZ4, CompressionCodec::ZSTD } )
+    {
+        CompressionOptions options;
+        options.codec = codec;
+        ASSERT_EQ( createPayloadCompressor( options ) != nullptr, isCompressionCodecSupported( codec ) )
+            << compressionCodecToString( codec );
+    }
+}
+
+TEST( PayloadCompressionTest, CompareOptions )
+{
+    CompressionOptions options;
+    options.codec = CompressionCodec::ZSTD;
+    options.level = 3;
+    options.dictionary = std::make_shared<const std::string>( "dictionary" );
+    auto sameOptions = options;
+    ASSERT_EQ( options, sameOptions );
+    sameOptions.level = 4;
+    ASSERT_NE( options, sameOptions );
+    // Dictionaries are compared by their address only
+    auto otherOptions = options;
+    otherOptions.dictionary = std::make_shared<const std::string>( "dictionary" );
+    ASSERT_NE( options, otherOptions );
+}
+
+#ifdef FWE_FEATURE_ZSTD_COMPRESSION
+TEST( PayloadCompressionTest, ZstdDictionary )
+{
+    CompressionOptions options;
+    options.codec = CompressionCodec::ZSTD;
+    auto compressor = createPayloadCompressor( options );
+    // A raw content dictionary, a trained one would contain the common parts of many payloads
+    options.dictionary = std::make_shared<const std::string>( createPayload( 1, 100 ) );
+    auto dictionaryCompressor = createPayloadCompressor( options );
+    ASSERT_NE( compressor, nullptr );
+    ASSERT_NE( dictionaryCompressor, nullptr );
+
+    auto payload = createPayload( 2, 100 );
+    std::string compressed;
+    ASSERT_TRUE( compressor->compress( payload.data(), payload.size(), compressed ) );
+    std::string dictionaryCompressed;
+    ASSERT_TRUE( dictionaryCompressor->compress( payload.data(), payload.size(), dictionaryCompressed ) );
+    ASSERT_LT( dictionaryCompressed.size() * 2, compressed.size() );
+
+    std::string decompressed;
+    ASSERT_TRUE(
+        dictionaryCompressor->decompress( dictionaryCompressed.data(), dictionaryCompressed.size(), decompressed ) );
+    ASSERT_EQ( decompressed, payload );
+    // The dictionary is needed for the decompression
+    ASSERT_FALSE( compressor->decompress( dictionaryCompressed.data(), dictionaryCompressed.size(), decompressed ) );
+}
+#endif
+
+} // namespace IoTFleetWise
+} // namespace Aws
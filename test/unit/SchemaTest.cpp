@@ -16,6 +16,7 @@
 #include "ISender.h"
 #include "MessageTypes.h"
 #include "MqttClientWrapper.h"
+#include "PayloadCompression.h"
 #include "SenderMock.h"
 #include "SignalTypes.h"
 #include "TimeTypes.h"
@@ -445,6 +446,8 @@ TEST_F( SchemaTest, EmptyCollectionSchemeIngestion )
     ASSERT_TRUE( collectionSchemeTest.getCollectRawCanFrames().size() == 0 );
     ASSERT_TRUE( collectionSchemeTest.isPersistNeeded() == false );
     ASSERT_TRUE( collectionSchemeTest.isCompressionNeeded() == false );
+    ASSERT_TRUE( collectionSchemeTest.isColumnarSignalEncodingNeeded() == false );
+    ASSERT_TRUE( collectionSchemeTest.getCompressionOptions() == CompressionOptions() );
     ASSERT_TRUE( collectionSchemeTest.getPriority() == std::numeric_limits<uint32_t>::max() );
     ASSERT_TRUE( collectionSchemeTest.getCondition() == nullptr );
     ASSERT_TRUE( collectionSchemeTest.getMinimumPublishIntervalMs() == std::numeric_limits<uint32_t>::max() );
@@ -473,6 +476,8 @@ TEST_F( SchemaTest, CollectionSchemeIngestionHeartBeat )
     collectionSchemeTestMessage->set_include_active_dtcs( true );
     collectionSchemeTestMessage->set_persist_all_collected_data( true );
     collectionSchemeTestMessage->set_compress_collected_data( true );
+    collectionSchemeTestMessage->set_compression_level( 3 );
+    collectionSchemeTestMessage->set_columnar_signal_encoding( true );
     collectionSchemeTestMessage->set_priority( 9 );
 
     // Add 3 Signals
@@ -482,6 +487,8 @@ TEST_F( SchemaTest, CollectionSchemeIngestionHeartBeat )
     signal1->set_minimum_sample_period_ms( 1000 );
     signal1->set_fixed_window_period_ms( 1000 );
     signal1->set_condition_only_signal( false );
+    signal1->set_reduction_type( Schemas::CollectionSchemesMsg::SignalInformation_ReductionType_SWINGING_DOOR );
+    signal1->set_reduction_tolerance( 0.5 );
 
     Schemas::CollectionSchemesMsg::SignalInformation *signal2 = collectionSchemeTestMessage->add_signal_information();
     signal2->set_signal_id( 1 );
@@ -535,6 +542,10 @@ TEST_F( SchemaTest, CollectionSchemeIngestionHeartBeat )
     ASSERT_TRUE( collectionSchemeTest->getCollectSignals().at( 0 ).minimumSampleIntervalMs == 1000 );
     ASSERT_TRUE( collectionSchemeTest->getCollectSignals().at( 0 ).fixedWindowPeriod == 1000 );
     ASSERT_TRUE( collectionSchemeTest->getCollectSignals().at( 0 ).isConditionOnlySignal == false );
+    ASSERT_TRUE( collectionSchemeTest->getCollectSignals().at( 0 ).reduction.type ==
+                 SignalReductionType::SWINGING_DOOR );
+    ASSERT_DOUBLE_EQ( collectionSchemeTest->getCollectSignals().at( 0 ).reduction.tolerance, 0.5 );
+    ASSERT_TRUE( collectionSchemeTest->getCollectSignals().at( 1 ).reduction.type == SignalReductionType::NONE );
 
     ASSERT_TRUE( collectionSchemeTest->getCollectSignals().at( 1 ).signalID == 1 );
     ASSERT_TRUE( collectionSchemeTest->getCollectSignals().at( 1 ).sampleBufferSize == 10000 );
@@ -561,6 +572,10 @@ TEST_F( SchemaTest, CollectionSchemeIngestionHeartBeat )
 
     ASSERT_TRUE( collectionSchemeTest->isPersistNeeded() == true );
     ASSERT_TRUE( collectionSchemeTest->isCompressionNeeded() == true );
+    ASSERT_TRUE( collectionSchemeTest->isColumnarSignalEncodingNeeded() == true );
+    ASSERT_TRUE( collectionSchemeTest->getCompressionOptions().codec == CompressionCodec::SNAPPY );
+    ASSERT_TRUE( collectionSchemeTest->getCompressionOptions().level == 3 );
+    ASSERT_TRUE( collectionSchemeTest->getCompressionOptions().dictionary == nullptr );
     ASSERT_TRUE( collectionSchemeTest->getPriority() == 9 );
     // For time based collectionScheme the condition is always set to true hence: currentNode.booleanValue=true
     ASSERT_TRUE( collectionSchemeTest->getCondition()->booleanValue == true );
@@ -576,6 +591,55 @@ TEST_F( SchemaTest, CollectionSchemeIngestionHeartBeat )
 #endif
 }
 
+TEST_F( SchemaTest, CollectionSchemeCompressionCodecs )
+{
+    auto buildCollectionScheme = []( Schemas::CollectionSchemesMsg::CollectionScheme_CompressionCodec codec,
+                                     CollectionSchemeIngestion &collectionScheme ) {
+        auto message = std::make_shared<Schemas::CollectionSchemesMsg::CollectionScheme>();
+        message->set_campaign_sync_id( "campaign" );
+        message->set_decoder_manifest_sync_id( "model_manifest_12" );
+        message->set_start_time_ms_epoch( 1621448160000 );
+        message->set_expiry_time_ms_epoch( 2621448160000 );
+        message->mutable_time_based_collection_scheme()->set_time_based_collection_scheme_period_ms( 5000 );
+        message->set_compress_collected_data( true );
+        message->set_compression_codec( codec );
+        message->set_compression_level( 19 );
+        message->set_compression_dictionary( "dictionary" );
+        collectionScheme.copyData( message );
+        return collectionScheme.build();
+    };
+
+    // The codec is only accepted if the agent was built with it, as the cloud expects the data in this format
+    CollectionSchemeIngestion lz4CollectionScheme;
+    ASSERT_EQ( buildCollectionScheme( Schemas::CollectionSchemesMsg::CollectionScheme_CompressionCodec_LZ4,
+                                      lz4CollectionScheme ),
+               isCompressionCodecSupported( CompressionCodec::LZ4 ) );
+    if ( lz4CollectionScheme.isReady() )
+    {
+        ASSERT_EQ( lz4CollectionScheme.getCompressionOptions().codec, CompressionCodec::LZ4 );
+        ASSERT_EQ( lz4CollectionScheme.getCompressionOptions().level, 19 );
+        // Only zstd uses a dictionary
+        ASSERT_EQ( lz4CollectionScheme.getCompressionOptions().dictionary, nullptr );
+    }
+
+    CollectionSchemeIngestion zstdCollectionScheme;
+    ASSERT_EQ( buildCollectionScheme( Schemas::CollectionSchemesMsg::CollectionScheme_CompressionCodec_ZSTD,
+                                      zstdCollectionScheme ),
+               isCompressionCodecSupported( CompressionCodec::ZSTD ) );
+    if ( zstdCollectionScheme.isReady() )
+    {
+        ASSERT_EQ( zstdCollectionScheme.getCompressionOptions().codec, CompressionCodec::ZSTD );
+        ASSERT_EQ( zstdCollectionScheme.getCompressionOptions().level, 19 );
+        ASSERT_NE( zstdCollectionScheme.getCompressionOptions().dictionary, nullptr );
+        ASSERT_EQ( *zstdCollectionScheme.getCompressionOptions().dictionary, "dictionary" );
+    }
+
+    CollectionSchemeIngestion unknownCodecCollectionScheme;
+    ASSERT_FALSE( buildCollectionScheme(
+        static_cast<Schemas::CollectionSchemesMsg::CollectionScheme_CompressionCodec>( 100 ),
+        unknownCodecCollectionScheme ) );
+}
+
 TEST_F( SchemaTest, SchemaCollectionEventBased )
 {
     Schemas::CollectionSchemesMsg::CollectionSchemes protoCollectionSchemesMsg;
@@ -0,0 +1,157 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "SignalReduction.h"
+#include <algorithm>
+#include <cmath>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+namespace Aws
+{
+namespace IoTFleetWise
+{
+
+static SignalReduction
+makeReduction( SignalReductionType type, double tolerance, uint32_t maxSamples = 0 )
+{
+    SignalReduction reduction;
+    reduction.type = type;
+    reduction.tolerance = tolerance;
+    reduction.maxSamples = maxSamples;
+    return reduction;
+}
+
+TEST( SignalReductionTest, noReductionKeepsAllSamples )
+{
+    std::vector<Timestamp> timestamps{ 1, 2, 3, 4 };
+    std::vector<double> values{ 1, 1, 1, 1 };
+    std::vector<uint32_t> kept{ 42 };
+    reduceSignalSamples( SignalReduction(), timestamps, values, kept );
+    ASSERT_EQ( kept, std::vector<uint32_t>( { 0, 1, 2, 3 } ) );
+
+    timestamps.clear();
+    values.clear();
+    reduceSignalSamples( makeReduction( SignalReductionType::DEADBAND, 1 ), timestamps, values, kept );
+    ASSERT_TRUE( kept.empty() );
+}
+
+TEST( SignalReductionTest, deadbandDropsSmallChanges )
+{
+    std::vector<Timestamp> timestamps{ 1, 2, 3, 4, 5, 6, 7 };
+    std::vector<double> values{ 10, 10.5, 11, 11.2, 9.9, 10.1, 10.2 };
+    std::vector<uint32_t> kept;
+    reduceSignalSamples( makeReduction( SignalReductionType::DEADBAND, 0.5 ), timestamps, values, kept );
+    // 11 and 11.2 differ more than 0.5 from 10 and 9.9 from 11, the newest sample is always kept
+    ASSERT_EQ( kept, std::vector<uint32_t>( { 0, 2, 4, 6 } ) );
+}
+
+TEST( SignalReductionTest, swingingDoorKeepsTheCornersOfALine )
+{
+    std::vector<Timestamp> timestamps;
+    std::vector<double> values;
+    // Rising for 10 ms, then constant for 10 ms
+    for ( Timestamp t = 0; t <= 20; t++ )
+    {
+        timestamps.push_back( 1000 + t );
+        values.push_back( t <= 10 ? static_cast<double>( t ) : 10.0 );
+    }
+    std::vector<uint32_t> kept;
+    reduceSignalSamples( makeReduction( SignalReductionType::SWINGING_DOOR, 0.01 ), timestamps, values, kept );
+    ASSERT_EQ( kept, std::vector<uint32_t>( { 0, 10, 20 } ) );
+}
+
+TEST( SignalReductionTest, swingingDoorKeepsTheErrorBound )
+{
+    std::mt19937 generator( 3 );
+    std::normal_distribution<double> step( 0, 1 );
+    std::uniform_int_distribution<Timestamp> interval( 0, 5 );
+    std::vector<Timestamp> timestamps;
+    std::vector<double> values;
+    Timestamp time = 100;
+    double value = 0;
+    for ( int i = 0; i < 2000; i++ )
+    {
+        time += interval( generator );
+        value += step( generator );
+        timestamps.push_back( time );
+        values.push_back( value );
+    }
+    const double tolerance = 2.0;
+    std::vector<uint32_t> kept;
+    reduceSignalSamples( makeReduction( SignalReductionType::SWINGING_DOOR, tolerance ), timestamps, values, kept );
+    ASSERT_LT( kept.size(), values.size() / 2 );
+    ASSERT_EQ( kept.front(), 0 );
+    ASSERT_EQ( kept.back(), values.size() - 1 );
+    // Every dropped sample is within the tolerance of the line between the kept samples around it
+    for ( size_t k = 1; k < kept.size(); k++ )
+    {
+        auto start = kept[k - 1];
+        auto end = kept[k];
+        ASSERT_LT( start, end );
+        for ( auto i = start + 1; i < end; i++ )
+        {
+            double expected = values[start];
+            if ( timestamps[end] != timestamps[start] )
+            {
+                expected += ( values[end] - values[start] ) *
+                            static_cast<double>( timestamps[i] - timestamps[start] ) /
+                            static_cast<double>( timestamps[end] - timestamps[start] );
+            }
+            ASSERT_LE( std::abs( values[i] - expected ), tolerance + 1e-9 ) << "sample " << i;
+        }
+    }
+}
+
+TEST( SignalReductionTest, swingingDoorKeepsSamplesBeforeThePivot )
+{
+    // Two lines, the second one with timestamps before the first one
+    std::vector<Timestamp> timestamps{ 100, 101, 102, 103, 50, 51, 52 };
+    std::vector<double> values{ 0, 1, 2, 3, 10, 11, 12 };
+    std::vector<uint32_t> kept;
+    reduceSignalSamples( makeReduction( SignalReductionType::SWINGING_DOOR, 0.1 ), timestamps, values, kept );
+    ASSERT_EQ( kept, std::vector<uint32_t>( { 0, 3, 4, 6 } ) );
+
+    // The differences to the older timestamps must not wrap around, which would drop samples 2 and 3
+    timestamps = { 101, 104, 106, 89, 91, 92 };
+    values = { 2, 4, 4, 0, 0, 0 };
+    reduceSignalSamples( makeReduction( SignalReductionType::SWINGING_DOOR, 0.5 ), timestamps, values, kept );
+    ASSERT_EQ( kept, std::vector<uint32_t>( { 0, 1, 2, 3, 5 } ) );
+}
+
+TEST( SignalReductionTest, largestTriangleThreeBucketsKeepsPeaks )
+{
+    std::vector<Timestamp> timestamps;
+    std::vector<double> values;
+    for ( Timestamp t = 0; t < 100; t++ )
+    {
+        timestamps.push_back( t );
+        values.push_back( 0 );
+    }
+    values[37] = 50;
+    values[71] = -20;
+    std::vector<uint32_t> kept;
+    reduceSignalSamples(
+        makeReduction( SignalReductionType::LARGEST_TRIANGLE_THREE_BUCKETS, 0, 10 ), timestamps, values, kept );
+    ASSERT_EQ( kept.size(), 10 );
+    ASSERT_EQ( kept.front(), 0 );
+    ASSERT_EQ( kept.back(), 99 );
+    ASSERT_NE( std::find( kept.begin(), kept.end(), 37 ), kept.end() );
+    ASSERT_NE( std::find( kept.begin(), kept.end(), 71 ), kept.end() );
+    for ( size_t k = 1; k < kept.size(); k++ )
+    {
+        ASSERT_LT( kept[k - 1], kept[k] );
+    }
+
+    // Less samples than the maximum and a maximum that is too small keep everything
+    reduceSignalSamples(
+        makeReduction( SignalReductionType::LARGEST_TRIANGLE_THREE_BUCKETS, 0, 100 ), timestamps, values, kept );
+    ASSERT_EQ( kept.size(), 100 );
+    reduceSignalSamples(
+        makeReduction( SignalReductionType::LARGEST_TRIANGLE_THREE_BUCKETS, 0, 2 ), timestamps, values, kept );
+    ASSERT_EQ( kept.size(), 100 );
+}
+
+} // namespace IoTFleetWise
+} // namespace Aws
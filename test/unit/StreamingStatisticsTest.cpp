@@ -0,0 +1,194 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "StreamingStatistics.h"
+#include <algorithm>
+#include <cmath>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+namespace Aws
+{
+namespace IoTFleetWise
+{
+
+TEST( QuantileEstimatorTest, exactWithFewValues )
+{
+    QuantileEstimator median( 0.5 );
+    double value = 0;
+    ASSERT_FALSE( median.getValue( value ) );
+    median.addValue( 3 );
+    ASSERT_TRUE( median.getValue( value ) );
+    ASSERT_DOUBLE_EQ( value, 3 );
+    median.addValue( 1 );
+    median.addValue( 2 );
+    ASSERT_TRUE( median.getValue( value ) );
+    ASSERT_DOUBLE_EQ( value, 2 );
+    median.addValue( 4 );
+    ASSERT_TRUE( median.getValue( value ) );
+    ASSERT_DOUBLE_EQ( value, 2.5 );
+
+    median.reset();
+    ASSERT_FALSE( median.getValue( value ) );
+}
+
+TEST( QuantileEstimatorTest, approximatesPercentilesOfManyValues )
+{
+    std::vector<double> values;
+    for ( int i = 1; i <= 10000; i++ )
+    {
+        values.push_back( i );
+    }
+    std::mt19937 generator( 42 );
+    std::shuffle( values.begin(), values.end(), generator );
+    for ( double quantile : { 0.5, 0.95, 0.99 } )
+    {
+        QuantileEstimator estimator( quantile );
+        for ( auto value : values )
+        {
+            estimator.addValue( value );
+        }
+        double value = 0;
+        ASSERT_TRUE( estimator.getValue( value ) );
+        // Within 1% of the range
+        ASSERT_NEAR( value, quantile * 10000, 100 );
+    }
+}
+
+TEST( QuantileEstimatorTest, continuesFromExactValues )
+{
+    QuantileEstimator estimator( 0.99 );
+    double value = 0;
+    for ( size_t i = 1; i <= QuantileEstimator::EXACT_VALUES; i++ )
+    {
+        estimator.addValue( static_cast<double>( i ) );
+    }
+    ASSERT_TRUE( estimator.getValue( value ) );
+    ASSERT_NEAR( value, 0.99 * static_cast<double>( QuantileEstimator::EXACT_VALUES - 1 ) + 1, 1e-9 );
+    for ( size_t i = QuantileEstimator::EXACT_VALUES + 1; i <= 200; i++ )
+    {
+        estimator.addValue( static_cast<double>( i ) );
+    }
+    ASSERT_TRUE( estimator.getValue( value ) );
+    ASSERT_NEAR( value, 198, 4 );
+}
+
+TEST( SlidingWindowStatisticsTest, removesValuesOlderThanThePeriod )
+{
+    SlidingWindowStatistics window;
+    window.init( 10, 100 );
+    ASSERT_EQ( window.getCount(), 0 );
+    ASSERT_EQ( window.getNextRemovalTime(), 0 );
+
+    window.addValue( 5, 1000 );
+    window.addValue( 1, 1050 );
+    window.addValue( 3, 1080 );
+    ASSERT_EQ( window.getCount(), 3 );
+    ASSERT_DOUBLE_EQ( window.getSum(), 9 );
+    ASSERT_DOUBLE_EQ( window.getMin(), 1 );
+    ASSERT_DOUBLE_EQ( window.getMax(), 5 );
+    ASSERT_NEAR( window.getStandardDeviation(), std::sqrt( 8.0 / 3.0 ), 1e-9 );
+    ASSERT_EQ( window.getNextRemovalTime(), 1100 );
+
+    ASSERT_FALSE( window.removeOldValues( 1099 ) );
+    ASSERT_TRUE( window.removeOldValues( 1100 ) );
+    ASSERT_EQ( window.getCount(), 2 );
+    ASSERT_DOUBLE_EQ( window.getSum(), 4 );
+    ASSERT_DOUBLE_EQ( window.getMin(), 1 );
+    ASSERT_DOUBLE_EQ( window.getMax(), 3 );
+    ASSERT_EQ( window.getNextRemovalTime(), 1150 );
+
+    ASSERT_TRUE( window.removeOldValues( 1150 ) );
+    ASSERT_DOUBLE_EQ( window.getMin(), 3 );
+    ASSERT_DOUBLE_EQ( window.getMax(), 3 );
+    ASSERT_DOUBLE_EQ( window.getStandardDeviation(), 0 );
+
+    ASSERT_TRUE( window.removeOldValues( 2000 ) );
+    ASSERT_EQ( window.getCount(), 0 );
+    ASSERT_DOUBLE_EQ( window.getSum(), 0 );
+    ASSERT_EQ( window.getNextRemovalTime(), 0 );
+}
+
+TEST( SlidingWindowStatisticsTest, dropsOldestValueWhenFull )
+{
+    SlidingWindowStatistics window;
+    window.init( 3, 1000 );
+    window.addValue( 9, 1 );
+    window.addValue( 2, 2 );
+    window.addValue( 4, 3 );
+    window.addValue( 3, 4 );
+    ASSERT_EQ( window.getCount(), 3 );
+    ASSERT_DOUBLE_EQ( window.getSum(), 9 );
+    ASSERT_DOUBLE_EQ( window.getMax(), 4 );
+    ASSERT_DOUBLE_EQ( window.getMin(), 2 );
+    ASSERT_EQ( window.getNextRemovalTime(), 1002 );
+}
+
+TEST( SlidingWindowStatisticsTest, minAndMaxMatchFullScan )
+{
+    SlidingWindowStatistics window;
+    window.init( 50, 20 );
+    std::mt19937 generator( 7 );
+    std::uniform_real_distribution<double> distribution( -100, 100 );
+    std::vector<std::pair<Timestamp, double>> values;
+    for ( Timestamp time = 1; time < 1000; time++ )
+    {
+        double value = distribution( generator );
+        window.addValue( value, time );
+        values.emplace_back( time, value );
+        window.removeOldValues( time );
+        // The last 20 ms, but at most 50 values
+        std::vector<double> expected;
+        for ( auto it = values.rbegin(); ( it != values.rend() ) && ( expected.size() < 50 ); it++ )
+        {
+            if ( it->first + 20 > time )
+            {
+                expected.push_back( it->second );
+            }
+        }
+        ASSERT_EQ( window.getCount(), expected.size() );
+        ASSERT_DOUBLE_EQ( window.getMin(), *std::min_element( expected.begin(), expected.end() ) );
+        ASSERT_DOUBLE_EQ( window.getMax(), *std::max_element( expected.begin(), expected.end() ) );
+    }
+}
+
+TEST( SlidingWindowStatisticsTest, standardDeviationWithLargeOffset )
+{
+    // The squares of values like an odometer reading exceed the precision of a double
+    SlidingWindowStatistics window;
+    window.init( 10, 1000000 );
+    std::mt19937 generator( 3 );
+    std::uniform_real_distribution<double> distribution( -0.5, 0.5 );
+    std::vector<double> values;
+    for ( Timestamp time = 1; time < 10000; time++ )
+    {
+        double value = 1e9 + distribution( generator );
+        window.addValue( value, time );
+        values.push_back( value );
+    }
+    // Exact population standard deviation of the last 10 values
+    double mean = 0;
+    for ( auto it = values.end() - 10; it != values.end(); it++ )
+    {
+        mean += ( *it - 1e9 ) / 10;
+    }
+    double squaredDistance = 0;
+    for ( auto it = values.end() - 10; it != values.end(); it++ )
+    {
+        squaredDistance += ( *it - 1e9 - mean ) * ( *it - 1e9 - mean );
+    }
+    ASSERT_EQ( window.getCount(), 10 );
+    ASSERT_NEAR( window.getStandardDeviation(), std::sqrt( squaredDistance / 10 ), 1e-5 );
+}
+
+TEST( SlidingWindowStatisticsTest, zeroCapacityIgnoresValues )
+{
+    SlidingWindowStatistics window;
+    window.addValue( 1, 1 );
+    ASSERT_EQ( window.getCount(), 0 );
+    ASSERT_FALSE( window.removeOldValues( 1000 ) );
+}
+
+} // namespace IoTFleetWise
+} // namespace Aws
@@ -0,0 +1,113 @@
+// Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "XorDoubleEncoding.h"
+#include <cmath>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace Aws
+{
+namespace IoTFleetWise
+{
+
+static void
+expectSameBits( const std::vector<double> &expected, const std::vector<double> &actual )
+{
+    ASSERT_EQ( expected.size(), actual.size() );
+    for ( size_t i = 0; i < expected.size(); i++ )
+    {
+        // Compare the bits to also cover NaN and negative zero
+        ASSERT_EQ( std::memcmp( &expected[i], &actual[i], sizeof( double ) ), 0 ) << "value " << i;
+    }
+}
+
+TEST( XorDoubleEncodingTest, roundTripOfSpecialValues )
+{
+    std::vector<double> values{ 0.0,
+                                -0.0,
+                                1.0,
+                                1.0,
+                                -1.5,
+                                std::numeric_limits<double>::infinity(),
+                                std::numeric_limits<double>::quiet_NaN(),
+                                std::numeric_limits<double>::lowest(),
+                                std::numeric_limits<double>::max(),
+                                std::numeric_limits<double>::denorm_min(),
+                                1e-300,
+                                123456789.123 };
+    XorDoubleEncoder encoder;
+    std::string encoded;
+    for ( auto value : values )
+    {
+        encoder.append( value, encoded );
+    }
+    std::vector<double> decoded;
+    ASSERT_TRUE( decodeXorDoubles( encoded, values.size(), decoded ) );
+    expectSameBits( values, decoded );
+
+    // Missing data is detected
+    decoded.clear();
+    ASSERT_FALSE( decodeXorDoubles( encoded.substr( 0, encoded.size() - 2 ), values.size(), decoded ) );
+}
+
+TEST( XorDoubleEncodingTest, compressesSlowlyChangingValues )
+{
+    std::mt19937 generator( 11 );
+    std::uniform_int_distribution<int> step( -2, 2 );
+    std::vector<double> values;
+    double value = 80.0;
+    for ( int i = 0; i < 1000; i++ )
+    {
+        // Like a decoded CAN signal with a factor of 0.25
+        value += step( generator ) * 0.25;
+        values.push_back( value );
+    }
+    XorDoubleEncoder encoder;
+    std::string encoded;
+    for ( auto v : values )
+    {
+        encoder.append( v, encoded );
+    }
+    ASSERT_LT( encoded.size(), values.size() * sizeof( double ) / 3 );
+    std::vector<double> decoded;
+    ASSERT_TRUE( decodeXorDoubles( encoded, values.size(), decoded ) );
+    expectSameBits( values, decoded );
+
+    // After a reset a new series can be written
+    encoder.reset();
+    encoded.clear();
+    encoder.append( 3.5, encoded );
+    decoded.clear();
+    ASSERT_TRUE( decodeXorDoubles( encoded, 1, decoded ) );
+    ASSERT_EQ( decoded, std::vector<double>{ 3.5 } );
+}
+
+TEST( XorDoubleEncodingTest, roundTripOfRandomValues )
+{
+    std::mt19937_64 generator( 5 );
+    std::vector<double> values;
+    for ( int i = 0; i < 1000; i++ )
+    {
+        uint64_t bits = generator();
+        double value = 0;
+        std::memcpy( &value, &bits, sizeof( value ) );
+        values.push_back( value );
+    }
+    XorDoubleEncoder encoder;
+    std::string encoded;
+    for ( auto value : values )
+    {
+        encoder.append( value, encoded );
+    }
+    std::vector<double> decoded;
+    ASSERT_TRUE( decodeXorDoubles( encoded, values.size(), decoded ) );
+    expectSameBits( values, decoded );
+}
+
+} // namespace IoTFleetWise
+} // namespace Aws
@@ -84,8 +84,10 @@ apt install -y \
     crossbuild-essential-arm64 \
     curl \
     git \
+    liblz4-dev:arm64 \
     libsnappy-dev:arm64 \
     libssl-dev:arm64 \
+    libzstd-dev:arm64 \
     unzip \
     wget \
     zlib1g-dev:arm64
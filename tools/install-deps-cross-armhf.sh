@@ -84,8 +84,10 @@ apt install -y \
     crossbuild-essential-armhf \
     curl \
     git \
+    liblz4-dev:armhf \
     libsnappy-dev:armhf \
     libssl-dev:armhf \
+    libzstd-dev:armhf \
     unzip \
     wget \
     zlib1g-dev:armhf
@@ -61,8 +61,10 @@ if ${INSTALL_BUILD_TIME_DEPS}; then
         faketime \
         git \
         graphviz \
+        liblz4-dev \
         libsnappy-dev \
         libssl-dev \
+        libzstd-dev \
         unzip \
         wget \
         zlib1g-dev